@@ -4,6 +4,10 @@
 #include <Logger.h>
 #include <Worker.h>
 #include <WebRtcServer.h>
+#include <Router.h>
+#include <Transport.h>
+#include <Producer.h>
+#include <Consumer.h>
 #include "Utils.h"
 #include "Room.hpp"
 #include "WebSocketServer.hpp"
@@ -13,8 +17,6 @@
 
 #define MEDIASOUP_USE_WEBRTC_SERVER true
 
-static int nextMediasoupWorkerIdx = 0;
-
 
 /* Instance methods. */
 ClusterServer::ClusterServer()
@@ -132,14 +134,13 @@ async_simple::coro::Lazy<void> ClusterServer::runMediasoupWorkers()
 	int numWorkers = config["mediasoup"].value("numWorkers", cpu_count);
 	bool singleProcess = config["mediasoup"].value("singleProcess", false);
 	bool useWebrtcServer = config["mediasoup"].value("useWebrtcServer", MEDIASOUP_USE_WEBRTC_SERVER);
+	bool workerCpuAffinity = config["mediasoup"].value("workerCpuAffinity", false);
 
-	if (numWorkers <= 0 || numWorkers >= cpu_count)
+	if (numWorkers <= 0 || numWorkers > cpu_count)
 	{
 		numWorkers = cpu_count;
 	}
 
-	numWorkers = 1;
-
 	MSC_DEBUG("running %d mediasoup Workers...", numWorkers);
 
 	for (int i = 0; i < numWorkers; ++i)
@@ -152,6 +153,18 @@ async_simple::coro::Lazy<void> ClusterServer::runMediasoupWorkers()
 			{ "rtcMaxPort", workerSettings["rtcMaxPort"] }
 		};
 
+		// Pin each in-process worker thread to its own core.
+		if (singleProcess && workerCpuAffinity)
+		{
+			settings["cpuAffinity"] = i % cpu_count;
+		}
+
+		// Worker::Create() passes it to the worker and sets the same format on our Channel.
+		if (workerSettings.contains("channelFormat"))
+		{
+			settings["channelFormat"] = workerSettings["channelFormat"];
+		}
+
 		Worker* worker = Worker::Create(settings, singleProcess);
 
 		worker->on("died", [=]()
@@ -163,19 +176,25 @@ async_simple::coro::Lazy<void> ClusterServer::runMediasoupWorkers()
 
 		_mediasoupWorkers.push_back(worker);
 
+		trackWorkerLoad(worker);
+
 		// Create a WebRtcServer in this Worker.
 		if (useWebrtcServer != false)
 		{
 			// Each mediasoup Worker will run its own WebRtcServer, so those cannot
-			// share the same listening ports. Hence we increase the value in config.js
-			// for each Worker.
+			// share the same listening ports unless they use reusePort (UDP only).
+			// Hence we increase the value in config.js of the other ones for each
+			// Worker.
 
 			WebRtcServerOptions webRtcServerOptions = config["mediasoup"]["webRtcServerOptions"];
 			int portIncrement = _mediasoupWorkers.size() - 1;
 
 			for (auto& listenInfo : webRtcServerOptions.listenInfos)
 			{
-				listenInfo.port += portIncrement;
+				if (listenInfo.reusePort)
+					webRtcServerOptions.reusePortIndex = portIncrement;
+				else
+					listenInfo.port += portIncrement;
 			}
 
 			WebRtcServer* webRtcServer = co_await worker->createWebRtcServer(webRtcServerOptions);
@@ -314,14 +333,59 @@ async_simple::coro::Lazy<void> ClusterServer::runHttpsServer()
 	co_return;
 }
 
+void ClusterServer::trackWorkerLoad(Worker* worker)
+{
+	WorkerLoad& load = _workerLoads[worker];
+
+	worker->observer()->on("newrouter", [&load](Router* router)
+	{
+		++load.routers;
+
+		router->observer()->on("close", [&load]() { --load.routers; });
+
+		router->observer()->on("newtransport", [&load](Transport* transport)
+		{
+			transport->observer()->on("newproducer", [&load](Producer* producer)
+			{
+				++load.producers;
+
+				producer->observer()->on("close", [&load]() { --load.producers; });
+			});
+
+			transport->observer()->on("newconsumer", [&load](Consumer* consumer)
+			{
+				++load.consumers;
+
+				consumer->observer()->on("close", [&load]() { --load.consumers; });
+			});
+		});
+	});
+}
+
 Worker* ClusterServer::getMediasoupWorker()
 {
-	Worker* worker = _mediasoupWorkers[nextMediasoupWorkerIdx];
+	return getMediasoupWorkers(1).front();
+}
+
+std::vector<Worker*> ClusterServer::getMediasoupWorkers(size_t count)
+{
+	// Pick the workers forwarding to the fewest consumers, then the ones with
+	// the fewest producers and routers. Workers are visited in creation order so
+	// ties resolve deterministically.
+	std::vector<Worker*> workers = _mediasoupWorkers;
+
+	std::stable_sort(workers.begin(), workers.end(), [this](Worker* a, Worker* b)
+	{
+		const WorkerLoad& loadA = _workerLoads[a];
+		const WorkerLoad& loadB = _workerLoads[b];
+
+		return std::tie(loadA.consumers, loadA.producers, loadA.routers) <
+			std::tie(loadB.consumers, loadB.producers, loadB.routers);
+	});
 
-	if (++nextMediasoupWorkerIdx == _mediasoupWorkers.size())
-		nextMediasoupWorkerIdx = 0;
+	workers.resize(std::min(count, workers.size()));
 
-	return worker;
+	return workers;
 }
 
 async_simple::coro::Lazy<Room*> ClusterServer::getOrCreateRoom(std::string roomId)
@@ -333,11 +397,16 @@ async_simple::coro::Lazy<Room*> ClusterServer::getOrCreateRoom(std::string roomI
 	{
 		MSC_DEBUG("creating a new Room [roomId:%s]", roomId.c_str());
 
-		Worker* mediasoupWorker = getMediasoupWorker();
+		// The Room Producers go to the least loaded Worker and, with follower
+		// Routers, its Consumers are spread over the next least loaded ones.
+		int numFollowerRouters = config["mediasoup"].value("numFollowerRouters", 0);
+
+		if (numFollowerRouters < 0)
+			numFollowerRouters = 0;
 
-		WebRtcServer* webRtcServer = _workerWebRtcServers[mediasoupWorker];
+		std::vector<Worker*> mediasoupWorkers = getMediasoupWorkers(1 + numFollowerRouters);
 
-		room = co_await Room::create(mediasoupWorker, roomId, webRtcServer);
+		room = co_await Room::create(mediasoupWorkers, roomId, _workerWebRtcServers);
 
 		_rooms.insert(std::make_pair(roomId, room));
 		room->on("close", [=]() { _rooms.erase(roomId); });
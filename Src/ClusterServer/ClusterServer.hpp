@@ -38,13 +38,27 @@ protected:
 
 	Worker* getMediasoupWorker();
 
+	std::vector<Worker*> getMediasoupWorkers(size_t count);
+
 	async_simple::coro::Lazy<Room*> getOrCreateRoom(std::string roomId);
 
+	void trackWorkerLoad(Worker* worker);
+
+private:
+	struct WorkerLoad
+	{
+		uint32_t routers{ 0 };
+		uint32_t producers{ 0 };
+		uint32_t consumers{ 0 };
+	};
+
 private:
 	protoo::WebSocketServer* _webSocketServer;
 
 	std::vector<Worker*> _mediasoupWorkers;
 
+	std::map<Worker*, WorkerLoad> _workerLoads;
+
 	std::map<Worker*, WebRtcServer*> _workerWebRtcServers;
 
 	std::map<std::string, Room*> _rooms;
@@ -5,6 +5,7 @@
 #include "Peer.hpp"
 #include "Request.hpp"
 #include "Bot.hpp"
+#include "RouterGroup.hpp"
 #include "WebSocketClient.hpp"
 #include <Logger.h>
 #include <errors.h>
@@ -26,15 +27,20 @@ const uint32_t MIN_BITRATE = 50000;
 const float BITRATE_FACTOR = 0.75;
 
 
-async_simple::coro::Lazy<Room*> Room::create(Worker* mediasoupWorker, std::string roomId, WebRtcServer* webRtcServer)
+async_simple::coro::Lazy<Room*> Room::create(std::vector<Worker*> mediasoupWorkers, std::string roomId, std::map<Worker*, WebRtcServer*> webRtcServers)
 {
 	MSC_DEBUG("create() [roomId:%s]", roomId.c_str());
 
 	// Router media codecs.
 	json mediaCodecs = config["mediasoup"]["routerOptions"]["mediaCodecs"];
 
-	// Create a mediasoup Router.
-	Router* mediasoupRouter = co_await mediasoupWorker->createRouter(mediaCodecs);
+	// Workers running as threads of this process pipe their Routers through
+	// memory.
+	bool inProcess = config["mediasoup"].value("singleProcess", false);
+
+	// Create the mediasoup Routers.
+	RouterGroup* routerGroup = co_await RouterGroup::create(mediasoupWorkers, mediaCodecs, inProcess);
+	Router* mediasoupRouter = routerGroup->ingestRouter();
 
 	// Create a mediasoup AudioLevelObserver.
 	json options{
@@ -46,13 +52,14 @@ async_simple::coro::Lazy<Room*> Room::create(Worker* mediasoupWorker, std::strin
 
 	Bot* bot = co_await Bot::create(mediasoupRouter);
 
-	co_return new Room(roomId, webRtcServer, mediasoupRouter, audioLevelObserver, bot);
+	co_return new Room(roomId, webRtcServers, routerGroup, audioLevelObserver, bot);
 }
 
-Room::Room(std::string roomId, WebRtcServer* webRtcServer, Router* router, AudioLevelObserver* audioLevelObserver, Bot* bot)
+Room::Room(std::string roomId, std::map<Worker*, WebRtcServer*> webRtcServers, RouterGroup* routerGroup, AudioLevelObserver* audioLevelObserver, Bot* bot)
 	: _roomId(roomId)
-	, _webRtcServer(webRtcServer)
-	, _mediasoupRouter(router)
+	, _webRtcServers(webRtcServers)
+	, _routerGroup(routerGroup)
+	, _mediasoupRouter(routerGroup->ingestRouter())
 	, _audioLevelObserver(audioLevelObserver)
 	, _bot(bot)
 {
@@ -75,10 +82,11 @@ void Room::close()
 
 	this->_closed = true;
 
-	// Close the mediasoup Room.
-	this->_mediasoupRouter->close();
+	// Close the mediasoup Routers.
+	this->_routerGroup->close();
 
-	delete this->_mediasoupRouter;
+	delete this->_routerGroup;
+	this->_routerGroup = nullptr;
 	this->_mediasoupRouter = nullptr;
 
 	// Close the Bot.
@@ -351,8 +359,14 @@ async_simple::coro::Lazy<void> Room::_handleProtooRequest(protoo::Peer* peer, pr
 		bool consuming = data["consuming"];
 		json sctpCapabilities = data["sctpCapabilities"];
 
+		// Transports just for consuming go to the least loaded follower Router
+		// (if any), where Producers are piped on demand.
+		Router* router = (consuming && !producing)
+			? this->_routerGroup->getConsumingRouter()
+			: this->_mediasoupRouter;
+
 		WebRtcTransportOptions options = config["mediasoup"]["webRtcTransportOptions"];
-		options.webRtcServer = this->_webRtcServer;
+		options.webRtcServer = GetMapValue(this->_webRtcServers, this->_routerGroup->getWorker(router));
 		options.enableSctp = sctpCapabilities.is_object();
 		options.numSctpStreams = sctpCapabilities.value("numStreams", json::object());
 		options.appData = { { "producing", producing }, { "consuming", consuming } };
@@ -363,7 +377,7 @@ async_simple::coro::Lazy<void> Room::_handleProtooRequest(protoo::Peer* peer, pr
 			options.enableUdp = true;
 		}
 
-		WebRtcTransport* transport = co_await this->_mediasoupRouter->createWebRtcTransport(
+		WebRtcTransport* transport = co_await router->createWebRtcTransport(
 			options);
 
 		transport->on("sctpstatechange", [=](std::string sctpState)
@@ -957,6 +971,18 @@ async_simple::coro::Lazy<void> Room::_createConsumer(protoo::Peer* consumerPeer,
 		co_return;
 	}
 
+	// Make the Producer available in the Router of the Transport.
+	try
+	{
+		co_await this->_routerGroup->pipeProducer(producer, this->_routerGroup->getTransportRouter(transport));
+	}
+	catch (std::exception& error)
+	{
+		MSC_WARN("_createConsumer() | pipeProducer():%s", error.what());
+
+		co_return;
+	}
+
 	// Create the Consumer in paused mode.
 	Consumer* consumer;
 
@@ -1138,6 +1164,18 @@ async_simple::coro::Lazy<void> Room::_createDataConsumer(protoo::Peer* dataConsu
 		co_return;
 	}
 
+	// Make the DataProducer available in the Router of the Transport.
+	try
+	{
+		co_await this->_routerGroup->pipeDataProducer(dataProducer, this->_routerGroup->getTransportRouter(transport));
+	}
+	catch (std::exception& error)
+	{
+		MSC_WARN("_createDataConsumer() | pipeDataProducer():%s", error.what());
+
+		co_return;
+	}
+
 	// Create the dataConsumer->
 	DataConsumer* dataConsumer{ nullptr };
 
@@ -23,13 +23,18 @@ namespace mediasoup {
 using namespace mediasoup;
 
 class Bot;
+class RouterGroup;
 
 class Room : public protoo::Peer::Listener , public EnhancedEventEmitter
 {
 public:
-	static async_simple::coro::Lazy<Room*> create(Worker* mediasoupWorker, std::string roomId, WebRtcServer* webRtcServer);
+	/**
+	 * Creates the ingest Router in the first given Worker and, if more are
+	 * given, a follower Router for consuming in each one of the others.
+	 */
+	static async_simple::coro::Lazy<Room*> create(std::vector<Worker*> mediasoupWorkers, std::string roomId, std::map<Worker*, WebRtcServer*> webRtcServers);
 
-	Room(std::string roomId, WebRtcServer* webRtcServer, Router* router, AudioLevelObserver* audioLevelObserver, Bot* bot);
+	Room(std::string roomId, std::map<Worker*, WebRtcServer*> webRtcServers, RouterGroup* routerGroup, AudioLevelObserver* audioLevelObserver, Bot* bot);
 	~Room();
 
 public:
@@ -79,11 +84,15 @@ private:
 	// @type {Map<String, Object>}
 	//this._broadcasters = new Map();
 
-	// mediasoup WebRtcServer instance.
-	// @type {mediasoup.WebRtcServer}
-	WebRtcServer* _webRtcServer{ nullptr };
+	// mediasoup WebRtcServer instances indexed by Worker.
+	// @type {Map<mediasoup.Worker, mediasoup.WebRtcServer>}
+	std::map<Worker*, WebRtcServer*> _webRtcServers;
+
+	// mediasoup Routers of the Room.
+	// @type {RouterGroup}
+	RouterGroup* _routerGroup{ nullptr };
 
-	// mediasoup Router instance.
+	// mediasoup Router where Producers are created (the ingest one).
 	// @type {mediasoup.Router}
 	Router* _mediasoupRouter{ nullptr };
 
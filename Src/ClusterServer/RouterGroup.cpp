@@ -0,0 +1,237 @@
+#define MSC_CLASS "RouterGroup"
+
+#include "RouterGroup.hpp"
+#include <Logger.h>
+#include <errors.h>
+#include <Worker.h>
+#include <Router.h>
+#include <Transport.h>
+#include <Producer.h>
+#include <Consumer.h>
+#include <DataProducer.h>
+
+
+async_simple::coro::Lazy<RouterGroup*> RouterGroup::create(std::vector<Worker*> workers, json mediaCodecs, bool inProcess)
+{
+	MSC_DEBUG("create() [workers:%zu, inProcess:%d]", workers.size(), inProcess);
+
+	std::vector<std::pair<Worker*, Router*>> routers;
+
+	for (Worker* worker : workers)
+	{
+		Router* router = co_await worker->createRouter(mediaCodecs);
+
+		routers.push_back(std::make_pair(worker, router));
+	}
+
+	co_return new RouterGroup(routers, inProcess);
+}
+
+RouterGroup::RouterGroup(std::vector<std::pair<Worker*, Router*>> routers, bool inProcess)
+	: _ingestWorker(routers.front().first)
+	, _ingestRouter(routers.front().second)
+	, _inProcess(inProcess)
+{
+	_trackRouter(this->_ingestRouter);
+
+	for (size_t i = 1; i < routers.size(); ++i)
+	{
+		Follower follower;
+		follower.worker = routers[i].first;
+		follower.router = routers[i].second;
+
+		this->_followers.push_back(std::move(follower));
+	}
+
+	// Followers are not added nor removed from now on, so they can be referenced
+	// from the Router events.
+	for (auto& follower : this->_followers)
+	{
+		_trackRouter(follower.router);
+	}
+}
+
+RouterGroup::~RouterGroup()
+{
+}
+
+void RouterGroup::close()
+{
+	MSC_DEBUG("close()");
+
+	// Followers first, as they consume from the ingest Router.
+	for (auto& follower : this->_followers)
+	{
+		follower.router->close();
+
+		delete follower.router;
+	}
+
+	this->_followers.clear();
+
+	this->_ingestRouter->close();
+
+	delete this->_ingestRouter;
+	this->_ingestRouter = nullptr;
+
+	this->_transportRouters.clear();
+}
+
+Router* RouterGroup::ingestRouter()
+{
+	return this->_ingestRouter;
+}
+
+Worker* RouterGroup::getWorker(Router* router)
+{
+	if (router == this->_ingestRouter)
+		return this->_ingestWorker;
+
+	Follower* follower = _getFollower(router);
+
+	return follower ? follower->worker : nullptr;
+}
+
+Router* RouterGroup::getConsumingRouter()
+{
+	Follower* minFollower = nullptr;
+
+	// Followers are visited in creation order so ties resolve deterministically.
+	for (auto& follower : this->_followers)
+	{
+		if (!minFollower || follower.consumers < minFollower->consumers)
+			minFollower = &follower;
+	}
+
+	return minFollower ? minFollower->router : this->_ingestRouter;
+}
+
+Router* RouterGroup::getTransportRouter(Transport* transport)
+{
+	auto it = this->_transportRouters.find(transport);
+
+	return it != this->_transportRouters.end() ? it->second : this->_ingestRouter;
+}
+
+async_simple::coro::Lazy<void> RouterGroup::pipeProducer(Producer* producer, Router* router)
+{
+	PipeToRouterOptions options;
+	options.producerId = producer->id();
+	options.router = router;
+	options.inProcess = this->_inProcess;
+
+	co_await _pipeToRouter(options, producer->id());
+}
+
+async_simple::coro::Lazy<void> RouterGroup::pipeDataProducer(DataProducer* dataProducer, Router* router)
+{
+	PipeToRouterOptions options;
+	options.dataProducerId = dataProducer->id();
+	options.router = router;
+	options.inProcess = this->_inProcess;
+
+	co_await _pipeToRouter(options, dataProducer->id());
+}
+
+RouterGroup::Follower* RouterGroup::_getFollower(Router* router)
+{
+	for (auto& follower : this->_followers)
+	{
+		if (follower.router == router)
+			return &follower;
+	}
+
+	return nullptr;
+}
+
+void RouterGroup::_trackRouter(Router* router)
+{
+	Follower* follower = _getFollower(router);
+
+	router->observer()->on("newtransport", [=](Transport* transport)
+	{
+		this->_transportRouters[transport] = router;
+
+		transport->observer()->on("close", [=]() { this->_transportRouters.erase(transport); });
+
+		if (!follower)
+			return;
+
+		transport->observer()->on("newconsumer", [=](Consumer* consumer)
+		{
+			++follower->consumers;
+
+			consumer->observer()->on("close", [=]() { --follower->consumers; });
+		});
+	});
+}
+
+async_simple::coro::Lazy<void> RouterGroup::_pipeToRouter(const PipeToRouterOptions& options, const std::string& id)
+{
+	// Everything lives in the ingest Router.
+	if (options.router == this->_ingestRouter)
+		co_return;
+
+	Follower* follower = _getFollower(options.router);
+
+	if (!follower)
+		MSC_THROW_TYPE_ERROR("Router not in the group");
+
+	if (follower->pipedIds.count(id))
+		co_return;
+
+	// Being piped by another call, so wait for it.
+	if (follower->piping.count(id))
+	{
+		async_simple::Promise<bool> waiter;
+		auto future = waiter.getFuture();
+
+		follower->piping[id].push_back(std::move(waiter));
+
+		// This throws if it could not be piped.
+		co_await std::move(future);
+
+		co_return;
+	}
+
+	follower->piping[id];
+
+	PipeToRouterResult result;
+
+	try
+	{
+		result = co_await this->_ingestRouter->pipeToRouter(options);
+	}
+	catch (std::exception& error)
+	{
+		MSC_ERROR("_pipeToRouter() | pipeToRouter() failed [id:%s]:%s", id.c_str(), error.what());
+
+		auto waiters = std::move(follower->piping[id]);
+
+		follower->piping.erase(id);
+
+		for (auto& waiter : waiters)
+		{
+			waiter.setException(std::current_exception());
+		}
+
+		throw;
+	}
+
+	follower->pipedIds.insert(id);
+
+	// The pipe Producer is closed along with the original one.
+	if (result.pipeProducer)
+		result.pipeProducer->observer()->on("close", [=]() { follower->pipedIds.erase(id); });
+	else
+		result.pipeDataProducer->observer()->on("close", [=]() { follower->pipedIds.erase(id); });
+
+	auto waiters = std::move(follower->piping[id]);
+
+	follower->piping.erase(id);
+
+	for (auto& waiter : waiters)
+	{
+		waiter.setValue(true);
+	}
+}
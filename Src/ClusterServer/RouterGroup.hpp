@@ -0,0 +1,100 @@
+#ifndef MEDIA_ROUTER_GROUP_HPP
+#define MEDIA_ROUTER_GROUP_HPP
+
+#include "common.h"
+
+namespace mediasoup {
+	class Worker;
+	class Router;
+	class Transport;
+	class Producer;
+	class DataProducer;
+	struct PipeToRouterOptions;
+}
+
+using namespace mediasoup;
+
+/**
+ * Routers of a Room spread over several Workers. Producers live in the ingest
+ * Router and are piped on demand to the follower Routers, where the Transports
+ * used for consuming are created, so a single Room is not limited to the CPU
+ * of a single Worker.
+ */
+class RouterGroup
+{
+public:
+	/**
+	 * Creates the ingest Router in the first given Worker and a follower
+	 * Router in each one of the others. With inProcess, the Workers run in this
+	 * process and Producers are piped through memory rather than through UDP.
+	 */
+	static async_simple::coro::Lazy<RouterGroup*> create(std::vector<Worker*> workers, json mediaCodecs, bool inProcess = false);
+
+	RouterGroup(std::vector<std::pair<Worker*, Router*>> routers, bool inProcess);
+	~RouterGroup();
+
+public:
+	void close();
+
+	Router* ingestRouter();
+
+	Worker* getWorker(Router* router);
+
+	/**
+	 * Router in which a new Transport for consuming must be created: the
+	 * follower with fewest Consumers or, if none, the ingest Router.
+	 */
+	Router* getConsumingRouter();
+
+	/**
+	 * Router the given Transport was created in.
+	 */
+	Router* getTransportRouter(Transport* transport);
+
+	/**
+	 * Ensures that the given Producer of the ingest Router can be consumed in
+	 * the given Router.
+	 */
+	async_simple::coro::Lazy<void> pipeProducer(Producer* producer, Router* router);
+
+	/**
+	 * Ensures that the given DataProducer of the ingest Router can be consumed
+	 * in the given Router.
+	 */
+	async_simple::coro::Lazy<void> pipeDataProducer(DataProducer* dataProducer, Router* router);
+
+private:
+	struct Follower;
+
+	Follower* _getFollower(Router* router);
+
+	void _trackRouter(Router* router);
+
+	async_simple::coro::Lazy<void> _pipeToRouter(const PipeToRouterOptions& options, const std::string& id);
+
+private:
+	struct Follower
+	{
+		Worker* worker{ nullptr };
+		Router* router{ nullptr };
+		uint32_t consumers{ 0 };
+		// Ids of the Producers and DataProducers piped into this Router.
+		std::set<std::string> pipedIds;
+		// Calls waiting for a Producer or DataProducer being piped, indexed by
+		// its id.
+		std::map<std::string, std::vector<async_simple::Promise<bool>>> piping;
+	};
+
+private:
+	Worker* _ingestWorker{ nullptr };
+
+	Router* _ingestRouter{ nullptr };
+
+	std::vector<Follower> _followers;
+
+	std::map<Transport*, Router*> _transportRouters;
+
+	bool _inProcess{ false };
+};
+
+#endif
@@ -0,0 +1,120 @@
+#ifndef MS_CHANNEL_METHODS_HPP
+#define MS_CHANNEL_METHODS_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <string_view>
+
+// Every Channel request method as MS_CHANNEL_METHOD(name, method, id), where
+// id is the number the binary Channel format sends instead of the method
+// string. The worker (Channel::ChannelRequest::MethodId) and the SDK are both
+// generated from this list so they always agree on the ids. New methods go
+// at the end with the next id.
+// clang-format off
+#define MS_CHANNEL_METHODS(MS_CHANNEL_METHOD) \
+	MS_CHANNEL_METHOD(WORKER_CLOSE,                                    "worker.close",                                1) \
+	MS_CHANNEL_METHOD(WORKER_DUMP,                                     "worker.dump",                                 2) \
+	MS_CHANNEL_METHOD(WORKER_GET_RESOURCE_USAGE,                       "worker.getResourceUsage",                     3) \
+	MS_CHANNEL_METHOD(WORKER_UPDATE_SETTINGS,                          "worker.updateSettings",                       4) \
+	MS_CHANNEL_METHOD(WORKER_CREATE_WEBRTC_SERVER,                     "worker.createWebRtcServer",                   5) \
+	MS_CHANNEL_METHOD(WORKER_CREATE_ROUTER,                            "worker.createRouter",                         6) \
+	MS_CHANNEL_METHOD(WORKER_WEBRTC_SERVER_CLOSE,                      "worker.closeWebRtcServer",                    7) \
+	MS_CHANNEL_METHOD(WEBRTC_SERVER_DUMP,                              "webRtcServer.dump",                           8) \
+	MS_CHANNEL_METHOD(WORKER_CLOSE_ROUTER,                             "worker.closeRouter",                          9) \
+	MS_CHANNEL_METHOD(ROUTER_DUMP,                                     "router.dump",                                10) \
+	MS_CHANNEL_METHOD(ROUTER_CREATE_WEBRTC_TRANSPORT,                  "router.createWebRtcTransport",               11) \
+	MS_CHANNEL_METHOD(ROUTER_CREATE_WEBRTC_TRANSPORT_WITH_SERVER,      "router.createWebRtcTransportWithServer",     12) \
+	MS_CHANNEL_METHOD(ROUTER_CREATE_PLAIN_TRANSPORT,                   "router.createPlainTransport",                13) \
+	MS_CHANNEL_METHOD(ROUTER_CREATE_PIPE_TRANSPORT,                    "router.createPipeTransport",                 14) \
+	MS_CHANNEL_METHOD(ROUTER_CREATE_DIRECT_TRANSPORT,                  "router.createDirectTransport",               15) \
+	MS_CHANNEL_METHOD(ROUTER_CLOSE_TRANSPORT,                          "router.closeTransport",                      16) \
+	MS_CHANNEL_METHOD(ROUTER_CREATE_ACTIVE_SPEAKER_OBSERVER,           "router.createActiveSpeakerObserver",         17) \
+	MS_CHANNEL_METHOD(ROUTER_CREATE_AUDIO_LEVEL_OBSERVER,              "router.createAudioLevelObserver",            18) \
+	MS_CHANNEL_METHOD(ROUTER_CLOSE_RTP_OBSERVER,                       "router.closeRtpObserver",                    19) \
+	MS_CHANNEL_METHOD(TRANSPORT_DUMP,                                  "transport.dump",                             20) \
+	MS_CHANNEL_METHOD(TRANSPORT_GET_STATS,                             "transport.getStats",                         21) \
+	MS_CHANNEL_METHOD(TRANSPORT_CONNECT,                               "transport.connect",                          22) \
+	MS_CHANNEL_METHOD(TRANSPORT_SET_MAX_INCOMING_BITRATE,              "transport.setMaxIncomingBitrate",            23) \
+	MS_CHANNEL_METHOD(TRANSPORT_SET_MAX_OUTGOING_BITRATE,              "transport.setMaxOutgoingBitrate",            24) \
+	MS_CHANNEL_METHOD(TRANSPORT_RESTART_ICE,                           "transport.restartIce",                       25) \
+	MS_CHANNEL_METHOD(TRANSPORT_PRODUCE,                               "transport.produce",                          26) \
+	MS_CHANNEL_METHOD(TRANSPORT_CONSUME,                               "transport.consume",                          27) \
+	MS_CHANNEL_METHOD(TRANSPORT_PRODUCE_DATA,                          "transport.produceData",                      28) \
+	MS_CHANNEL_METHOD(TRANSPORT_CONSUME_DATA,                          "transport.consumeData",                      29) \
+	MS_CHANNEL_METHOD(TRANSPORT_ENABLE_TRACE_EVENT,                    "transport.enableTraceEvent",                 30) \
+	MS_CHANNEL_METHOD(TRANSPORT_CLOSE_PRODUCER,                        "transport.closeProducer",                    31) \
+	MS_CHANNEL_METHOD(PRODUCER_DUMP,                                   "producer.dump",                              32) \
+	MS_CHANNEL_METHOD(PRODUCER_GET_STATS,                              "producer.getStats",                          33) \
+	MS_CHANNEL_METHOD(PRODUCER_PAUSE,                                  "producer.pause",                             34) \
+	MS_CHANNEL_METHOD(PRODUCER_RESUME,                                 "producer.resume",                            35) \
+	MS_CHANNEL_METHOD(PRODUCER_ENABLE_TRACE_EVENT,                     "producer.enableTraceEvent",                  36) \
+	MS_CHANNEL_METHOD(TRANSPORT_CLOSE_CONSUMER,                        "transport.closeConsumer",                    37) \
+	MS_CHANNEL_METHOD(CONSUMER_DUMP,                                   "consumer.dump",                              38) \
+	MS_CHANNEL_METHOD(CONSUMER_GET_STATS,                              "consumer.getStats",                          39) \
+	MS_CHANNEL_METHOD(CONSUMER_PAUSE,                                  "consumer.pause",                             40) \
+	MS_CHANNEL_METHOD(CONSUMER_RESUME,                                 "consumer.resume",                            41) \
+	MS_CHANNEL_METHOD(CONSUMER_SET_PREFERRED_LAYERS,                   "consumer.setPreferredLayers",                42) \
+	MS_CHANNEL_METHOD(CONSUMER_SET_PRIORITY,                           "consumer.setPriority",                       43) \
+	MS_CHANNEL_METHOD(CONSUMER_REQUEST_KEY_FRAME,                      "consumer.requestKeyFrame",                   44) \
+	MS_CHANNEL_METHOD(CONSUMER_ENABLE_TRACE_EVENT,                     "consumer.enableTraceEvent",                  45) \
+	MS_CHANNEL_METHOD(TRANSPORT_CLOSE_DATA_PRODUCER,                   "transport.closeDataProducer",                46) \
+	MS_CHANNEL_METHOD(DATA_PRODUCER_DUMP,                              "dataProducer.dump",                          47) \
+	MS_CHANNEL_METHOD(DATA_PRODUCER_GET_STATS,                         "dataProducer.getStats",                      48) \
+	MS_CHANNEL_METHOD(TRANSPORT_CLOSE_DATA_CONSUMER,                   "transport.closeDataConsumer",                49) \
+	MS_CHANNEL_METHOD(DATA_CONSUMER_DUMP,                              "dataConsumer.dump",                          50) \
+	MS_CHANNEL_METHOD(DATA_CONSUMER_GET_STATS,                         "dataConsumer.getStats",                      51) \
+	MS_CHANNEL_METHOD(DATA_CONSUMER_GET_BUFFERED_AMOUNT,               "dataConsumer.getBufferedAmount",             52) \
+	MS_CHANNEL_METHOD(DATA_CONSUMER_SET_BUFFERED_AMOUNT_LOW_THRESHOLD, "dataConsumer.setBufferedAmountLowThreshold", 53) \
+	MS_CHANNEL_METHOD(RTP_OBSERVER_PAUSE,                              "rtpObserver.pause",                          54) \
+	MS_CHANNEL_METHOD(RTP_OBSERVER_RESUME,                             "rtpObserver.resume",                         55) \
+	MS_CHANNEL_METHOD(RTP_OBSERVER_ADD_PRODUCER,                       "rtpObserver.addProducer",                    56) \
+	MS_CHANNEL_METHOD(RTP_OBSERVER_REMOVE_PRODUCER,                    "rtpObserver.removeProducer",                 57) \
+	MS_CHANNEL_METHOD(WORKER_GET_METRICS,                              "worker.getMetrics",                          58) \
+	MS_CHANNEL_METHOD(WORKER_SUBSCRIBE_STATS,                          "worker.subscribeStats",                      59)
+// clang-format on
+
+namespace Channel
+{
+	// Whether ids are 1, 2, 3... in list order, so none is repeated or skipped.
+	constexpr bool ChannelMethodIdsAreSequential()
+	{
+		uint16_t expectedId{ 1u };
+
+#define MS_CHANNEL_METHOD_CHECK_ID(name, method, id) \
+	if ((id) != expectedId++) \
+		return false;
+
+		MS_CHANNEL_METHODS(MS_CHANNEL_METHOD_CHECK_ID)
+
+#undef MS_CHANNEL_METHOD_CHECK_ID
+
+		return true;
+	}
+
+	// Whether no method string is repeated.
+	constexpr bool ChannelMethodsAreUnique()
+	{
+#define MS_CHANNEL_METHOD_STRING(name, method, id) std::string_view(method),
+
+		constexpr std::string_view methods[] = { MS_CHANNEL_METHODS(MS_CHANNEL_METHOD_STRING) };
+
+#undef MS_CHANNEL_METHOD_STRING
+
+		for (size_t i{ 0u }; i < std::size(methods); ++i)
+		{
+			for (size_t j{ i + 1 }; j < std::size(methods); ++j)
+			{
+				if (methods[i] == methods[j])
+					return false;
+			}
+		}
+
+		return true;
+	}
+
+	static_assert(ChannelMethodIdsAreSequential(), "Channel method ids must be sequential");
+	static_assert(ChannelMethodsAreUnique(), "Channel methods must be unique");
+} // namespace Channel
+
+#endif
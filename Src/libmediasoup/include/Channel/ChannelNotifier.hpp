@@ -16,9 +16,15 @@ namespace Channel
 		explicit ChannelNotifier(Channel::ChannelSocket* channel);
 
 	public:
+		bool IsBinary() const
+		{
+			return this->channel->IsBinary();
+		}
 		void Emit(uint64_t targetId, const char* event);
 		void Emit(const std::string& targetId, const char* event);
 		void Emit(const std::string& targetId, const char* event, json& data);
+		// For data already serialized as JSON text. In binary mode it must be
+		// parsed, so callers should use the json overload when IsBinary().
 		void Emit(const std::string& targetId, const char* event, const std::string& data);
 
 	private:
@@ -6,6 +6,7 @@
 #include "handles/UnixStreamSocket.hpp"
 #include <nlohmann/json.hpp>
 #include <string>
+#include <vector>
 
 using json = nlohmann::json;
 
@@ -74,6 +75,26 @@ namespace Channel
 			virtual void OnChannelClosed(Channel::ChannelSocket* channel) = 0;
 		};
 
+		/*
+		 * Binary format (selected with --channelFormat=binary). Integers use host
+		 * byte order since both ends run on the same machine.
+		 *
+		 * Request:      [id:u32][methodId:u16][handlerIdLen:u16][handlerId][data]
+		 * Response:     [kind:u8][id:u32][data] (accepted) or [kind:u8][id:u32][reason]
+		 * Notification: [kind:u8][targetIdLen:u16][targetId][eventLen:u16][event][data]
+		 *
+		 * `data` is MessagePack and may be empty. `methodId` is the numeric value
+		 * of ChannelRequest::MethodId. Kinds are below any printable character so
+		 * they never collide with log lines, which stay as text.
+		 */
+		enum class MessageKind : uint8_t
+		{
+			RESPONSE_ACCEPTED = 1,
+			RESPONSE_ERROR,
+			RESPONSE_TYPE_ERROR,
+			NOTIFICATION
+		};
+
 	public:
 		explicit ChannelSocket(int consumerFd, int producerFd);
 		explicit ChannelSocket(
@@ -89,10 +110,18 @@ namespace Channel
 		void Send(json& jsonMessage);
 		void Send(const std::string& message);
 		void SendLog(const char* message, uint32_t messageLen);
+		void SetBinary(bool binary);
+		bool IsBinary() const
+		{
+			return this->binary;
+		}
+		void SendBinaryResponse(uint32_t id, MessageKind kind, const json* data, const char* reason);
+		void SendBinaryNotification(const std::string& targetId, const char* event, const json* data);
 		bool CallbackRead();
 
 	private:
 		void SendImpl(const uint8_t* payload, uint32_t payloadLen);
+		void SendBinaryImpl();
 
 		/* Pure virtual methods inherited from ConsumerSocket::Listener. */
 	public:
@@ -112,6 +141,9 @@ namespace Channel
 		ChannelWriteCtx channelWriteCtx{ nullptr };
 		uv_async_t* uvReadHandle{ nullptr };
 		uint8_t* writeBuffer{ nullptr };
+		bool binary{ false };
+		// Reused buffer for encoding binary messages.
+		std::vector<uint8_t> binaryBuffer;
 	};
 } // namespace Channel
 
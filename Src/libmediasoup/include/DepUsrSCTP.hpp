@@ -3,46 +3,85 @@
 
 #include "common.hpp"
 #include "RTC/SctpAssociation.hpp"
-#include "handles/Timer.hpp"
 #include <absl/container/flat_hash_map.h>
+#include <uv.h>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
 
 class DepUsrSCTP
 {
+public:
+	// Task run in the Worker thread owning an SctpAssociation. It gets nullptr
+	// if the SctpAssociation was closed meanwhile.
+	using Task = std::function<void(RTC::SctpAssociation* sctpAssociation)>;
+
 private:
-	class Checker : public Timer::Listener
+	// The usrsctp stack is shared by all the Workers of the process, so its
+	// timers are driven by a single thread with a single clock.
+	class Checker
 	{
 	public:
 		Checker();
-		~Checker() override;
+		~Checker();
 
 	public:
 		void Start();
 		void Stop();
 
-		/* Pure virtual methods inherited from Timer::Listener. */
-	public:
-		void OnTimer(Timer* timer) override;
+	private:
+		void Run();
 
 	private:
-		Timer* timer{ nullptr };
+		std::thread thread;
+		std::mutex mutex;
+		std::condition_variable condition;
+		// Guarded by mutex.
+		bool running{ false };
+		bool closed{ false };
 		uint64_t lastCalledAtMs{ 0u };
 	};
 
+	// Tasks posted to a Worker thread by usrsctp callbacks run in other threads.
+	struct Inbox
+	{
+		uv_async_t* uvHandle{ nullptr };
+		// Guarded by GlobalSyncMutex.
+		std::vector<std::pair<uintptr_t, Task>> tasks;
+	};
+
+	struct Entry
+	{
+		RTC::SctpAssociation* sctpAssociation{ nullptr };
+		Inbox* inbox{ nullptr };
+	};
+
 public:
 	static void ClassInit();
 	static void ClassDestroy();
-	static void CreateChecker();
-	static void CloseChecker();
+	static void CreateInbox();
+	static void CloseInbox();
 	static uintptr_t GetNextSctpAssociationId();
 	static void RegisterSctpAssociation(RTC::SctpAssociation* sctpAssociation);
 	static void DeregisterSctpAssociation(RTC::SctpAssociation* sctpAssociation);
+	// Returns nullptr if not found or if it belongs to another Worker thread.
 	static RTC::SctpAssociation* RetrieveSctpAssociation(uintptr_t id);
+	// Returns false if not found.
+	static bool PostTask(uintptr_t id, Task task);
+
+public:
+	/* Callbacks fired by UV events. */
+	static void OnUvAsync();
 
 private:
-	thread_local static Checker* checker;
+	static Checker* checker;
+	thread_local static Inbox* inbox;
 	static uint64_t numSctpAssociations;
 	static uintptr_t nextSctpAssociationId;
-	static absl::flat_hash_map<uintptr_t, RTC::SctpAssociation*> mapIdSctpAssociation;
+	static absl::flat_hash_map<uintptr_t, Entry> mapIdSctpAssociation;
 };
 
 #endif
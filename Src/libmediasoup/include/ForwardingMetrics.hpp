@@ -0,0 +1,155 @@
+#ifndef MS_FORWARDING_METRICS_HPP
+#define MS_FORWARDING_METRICS_HPP
+
+#include "common.hpp"
+#include <nlohmann/json.hpp>
+#include <array>
+#if defined(_MSC_VER)
+#include <intrin.h> // __rdtsc(), _BitScanReverse64()
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h> // __rdtsc()
+#else
+#include <uv.h> // uv_hrtime()
+#endif
+
+using json = nlohmann::json;
+
+// Per Worker (thread local) latency histograms of the stages a forwarded RTP
+// packet goes through. Durations are measured in TSC ticks and converted to
+// nanoseconds when reported.
+class ForwardingMetrics
+{
+public:
+	enum class Stage : uint8_t
+	{
+		// From the datagram being read until the Router fan-out is sent.
+		FORWARDING = 0,
+		SRTP_DECRYPT,
+		TRANSPORT_RECEIVE_RTP_PACKET,
+		ROUTER_FAN_OUT,
+		CONSUMER_SEND_RTP_PACKET,
+		SRTP_ENCRYPT,
+		UDP_SEND,
+		// Time spent by RTP packets in the Transport pacer queue.
+		PACER_QUEUE_DELAY,
+		// Must be the last one.
+		MAX
+	};
+
+private:
+	// Log-linear buckets: values below SubBuckets have their own bucket, then
+	// every power of two is split into SubBuckets buckets (~12% precision).
+	static constexpr size_t SubBucketBits{ 3u };
+	static constexpr size_t SubBuckets{ 1u << SubBucketBits };
+	// Values with more significant bits (over ~5 minutes at 3 GHz) are
+	// accounted in the last bucket.
+	static constexpr size_t MaxValueBits{ 40u };
+	static constexpr size_t NumBuckets{ (MaxValueBits - SubBucketBits + 2) * SubBuckets };
+
+	struct Histogram
+	{
+		uint64_t count{ 0u };
+		uint64_t sum{ 0u };
+		uint64_t max{ 0u };
+		std::array<uint64_t, NumBuckets> buckets{};
+	};
+
+public:
+	// Measures the lifetime of the instance into the given stage.
+	class ScopedStage
+	{
+	public:
+		explicit ScopedStage(Stage stage) : stage(stage), start(ForwardingMetrics::Now())
+		{
+		}
+		~ScopedStage()
+		{
+			ForwardingMetrics::Record(this->stage, ForwardingMetrics::Now() - this->start);
+		}
+
+	private:
+		Stage stage;
+		uint64_t start;
+	};
+
+public:
+	static void ClassInit();
+	static void FillJson(json& jsonObject);
+	static void Reset();
+	static uint64_t Now()
+	{
+#if defined(_MSC_VER) || defined(__x86_64__) || defined(__i386__)
+		return __rdtsc();
+#else
+		return uv_hrtime();
+#endif
+	}
+	static void Record(Stage stage, uint64_t ticks)
+	{
+		auto& histogram = ForwardingMetrics::histograms[static_cast<size_t>(stage)];
+
+		++histogram.count;
+		histogram.sum += ticks;
+
+		if (ticks > histogram.max)
+			histogram.max = ticks;
+
+		++histogram.buckets[GetBucketIndex(ticks)];
+	}
+	// Called when a datagram is read, before it is processed.
+	static void SetPacketReceived()
+	{
+		ForwardingMetrics::packetReceivedAt = Now();
+	}
+	// Called once the datagram has been processed.
+	static void ClearPacketReceived()
+	{
+		ForwardingMetrics::packetReceivedAt = 0u;
+	}
+	// Called once the packet being processed has been sent to its consumers.
+	static void PacketForwarded()
+	{
+		// Packets not read from a socket (e.g. DirectTransport) are not
+		// accounted.
+		if (ForwardingMetrics::packetReceivedAt == 0u)
+			return;
+
+		Record(Stage::FORWARDING, Now() - ForwardingMetrics::packetReceivedAt);
+	}
+
+private:
+	static size_t GetBucketIndex(uint64_t value)
+	{
+		if (value < SubBuckets)
+			return static_cast<size_t>(value);
+
+		size_t msb;
+
+#if defined(_MSC_VER)
+		unsigned long index;
+
+		_BitScanReverse64(&index, value);
+		msb = static_cast<size_t>(index);
+#else
+		msb = static_cast<size_t>(63 - __builtin_clzll(value));
+#endif
+
+		if (msb > MaxValueBits)
+			return NumBuckets - 1;
+
+		const size_t shift = msb - SubBucketBits;
+
+		return ((msb - SubBucketBits + 1) * SubBuckets) +
+		       static_cast<size_t>((value >> shift) & (SubBuckets - 1));
+	}
+	static uint64_t GetBucketUpperValue(size_t index);
+
+private:
+	thread_local static std::array<Histogram, static_cast<size_t>(Stage::MAX)> histograms;
+	thread_local static uint64_t packetReceivedAt;
+	// Calibration of ticks against uv_hrtime() and start of the measured period.
+	thread_local static uint64_t startTicks;
+	thread_local static uint64_t startNs;
+};
+
+#endif
@@ -14,6 +14,17 @@
  * If the macro MS_LOG_FILE_LINE is defied, all the logging macros print more
  * verbose information, including current file and line.
  *
+ * The macros logging through the ChannelSocket do not format the message.
+ * They write a fixed size binary record (a pointer to the static call site,
+ * which holds the format, and the raw arguments) into the ring of the current
+ * Worker, and a formatting thread shared by all the Workers formats it later.
+ * Formatted records are sent through the ChannelSocket in the Worker loop.
+ * Arguments must be integers, enums, floating point numbers, C strings
+ * (copied into the record and truncated if needed) or pointers. Records are
+ * dropped (and counted) if the ring is full. MS_TRACE(), MS_DEBUG_XXX() and
+ * MS_WARN_XXX() log at most MaxRecordsPerSitePerSecond records per call site
+ * and Worker, the following ones are suppressed (and counted).
+ *
  * MS_TRACE()
  *
  *   Logs the current method/function if MS_LOG_TRACE macro is defined and the
@@ -89,10 +100,19 @@
 #include "common.hpp"
 #include "LogLevel.hpp"
 #include "Settings.hpp"
+#include "DepLibUV.hpp"
 #include "Channel/ChannelSocket.hpp"
+#include <uv.h>
+#include <atomic>
+#include <condition_variable>
 #include <cstdio>  // std::snprintf(), std::fprintf(), stdout, stderr
 #include <cstdlib> // std::abort()
 #include <cstring>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
 
 // clang-format off
 
@@ -128,16 +148,266 @@
 
 class Logger
 {
+public:
+	// Call site of a logging macro. Its format starts with the log prefix,
+	// whose arguments (file and line if given, class and function) are taken
+	// from here instead of from the records.
+	struct Site
+	{
+		const char* format;
+		const char* className; // nullptr if the format has no prefix.
+		const char* function;
+		const char* file; // nullptr unless MS_LOG_FILE_LINE is defined.
+		int line;
+	};
+
+	// Rate limit state of a call site in a Worker.
+	struct SiteRate
+	{
+		uint64_t periodStartMs{ 0u };
+		uint32_t count{ 0u };
+		uint32_t suppressed{ 0u };
+	};
+
+	// Number of records of the ring of each Worker (about 1.5 MB).
+	static constexpr size_t NumSlots{ 2048u };
+	// Room for the raw arguments of a record.
+	static constexpr size_t ArgsSize{ 240u };
+	// Max length of a formatted record.
+	static constexpr size_t TextSize{ 512u };
+	// Interval at which the formatting thread checks the rings (1 ms while
+	// they fill quickly).
+	static constexpr uint64_t FormatIntervalMs{ 10u };
+	static constexpr uint32_t MaxRecordsPerSitePerSecond{ 100u };
+	static constexpr size_t ScalarArgSize{ 2u + sizeof(uint64_t) };
+
+	enum class ArgType : uint8_t
+	{
+		INT = 0,
+		UINT,
+		DOUBLE,
+		STRING,
+		POINTER
+	};
+
+	struct Slot
+	{
+		const Site* site{ nullptr };
+		uint32_t suppressed{ 0u };
+		uint16_t argsLen{ 0u };
+		uint16_t textLen{ 0u };
+		// [type:u8][size:u8][value:8] for scalars, [type:u8][0][len:u16][chars]
+		// for strings.
+		uint8_t args[ArgsSize];
+		char text[TextSize];
+	};
+
+	// Records of a Worker. The Worker writes them (head), the formatting
+	// thread formats them in place (formatted) and the Worker sends and
+	// releases them (tail).
+	struct Ring
+	{
+		Ring();
+
+		// Written by the Worker.
+		alignas(64) std::atomic<size_t> head{ 0u };
+		// Written by the formatting thread (or by the Worker while holding
+		// ringsMutex).
+		alignas(64) std::atomic<size_t> formatted{ 0u };
+		// Whether the Worker has a wakeup pending, so the formatting thread wakes
+		// it up once per batch of records.
+		alignas(64) std::atomic<bool> wakeupPending{ false };
+		// Only used by the Worker.
+		size_t tail{ 0u };
+		uint64_t records{ 0u };
+		uint64_t droppedRecords{ 0u };
+		uint64_t reportedDroppedRecords{ 0u };
+		uint64_t suppressedRecords{ 0u };
+		uv_async_t* uvHandle{ nullptr };
+		std::unique_ptr<Slot[]> slots;
+	};
+
 public:
 	static void ClassInit(Channel::ChannelSocket* channel);
+	// Sends the pending records and stops deferring the logs of this Worker.
+	static void ClassDestroy();
+	static void FillJson(json& jsonObject);
+	template<typename... Args>
+	static void Log(const Site& site, SiteRate* siteRate, Args... args);
+	// Sends the records formatted by the formatting thread.
+	static void SendFormattedRecords();
+
+private:
+	// The given room is kept for the following arguments, so long strings do
+	// not leave them out.
+	template<typename T>
+	static void WriteArg(Slot* slot, T arg, size_t reservedLen);
+	static void WriteScalar(Slot* slot, ArgType type, size_t size, uint64_t value);
+	static void WriteString(Slot* slot, const char* str, size_t reservedLen);
+	static size_t FormatRecords(Ring* ring);
+	static void FormatRecord(Slot* slot);
+	static void RunFormatter(uint64_t generation);
 
 public:
 	static const uint64_t pid;
 	thread_local static Channel::ChannelSocket* channel;
 	static const size_t bufferSize {50000};
 	thread_local static char buffer[];
+	thread_local static Ring* ring;
+
+private:
+	// Rings of all the Workers of the process, guarded by ringsMutex, and the
+	// thread formatting them.
+	static std::mutex ringsMutex;
+	static std::condition_variable formatterCondition;
+	static std::vector<Ring*> rings;
+	static std::thread formatterThread;
+	// Incremented to stop the running formatting thread.
+	static uint64_t formatterGeneration;
 };
 
+/* Inline static methods. */
+
+template<typename... Args>
+inline void Logger::Log(const Site& site, SiteRate* siteRate, Args... args)
+{
+	Ring* ring = Logger::ring;
+
+	// Not initialized or already destroyed in this thread.
+	if (!ring)
+		return;
+
+	if (siteRate)
+	{
+		const uint64_t nowMs = DepLibUV::GetTimeMs();
+
+		if (nowMs - siteRate->periodStartMs >= 1000u)
+		{
+			siteRate->periodStartMs = nowMs;
+			siteRate->count         = 0u;
+		}
+
+		if (++siteRate->count > MaxRecordsPerSitePerSecond)
+		{
+			++siteRate->suppressed;
+			++ring->suppressedRecords;
+
+			return;
+		}
+	}
+
+	const size_t head = ring->head.load(std::memory_order_relaxed);
+
+	if (head - ring->tail == NumSlots)
+	{
+		++ring->droppedRecords;
+
+		return;
+	}
+
+	Slot* slot = std::addressof(ring->slots[head % NumSlots]);
+
+	slot->site       = std::addressof(site);
+	slot->suppressed = siteRate ? siteRate->suppressed : 0u;
+	slot->argsLen    = 0u;
+
+	size_t pendingArgs = sizeof...(Args);
+
+	((--pendingArgs, Logger::WriteArg(slot, args, pendingArgs * ScalarArgSize)), ...);
+
+	ring->head.store(head + 1, std::memory_order_release);
+	++ring->records;
+
+	if (siteRate)
+		siteRate->suppressed = 0u;
+}
+
+template<typename T>
+inline void Logger::WriteArg(Slot* slot, T arg, size_t reservedLen)
+{
+	if constexpr (std::is_same_v<T, const char*> || std::is_same_v<T, char*>)
+	{
+		Logger::WriteString(slot, arg, reservedLen);
+	}
+	else if constexpr (std::is_same_v<T, std::nullptr_t>)
+	{
+		Logger::WriteScalar(slot, ArgType::POINTER, sizeof(void*), 0u);
+	}
+	else if constexpr (std::is_pointer_v<T>)
+	{
+		Logger::WriteScalar(
+		  slot, ArgType::POINTER, sizeof(T), static_cast<uint64_t>(reinterpret_cast<uintptr_t>(arg)));
+	}
+	else if constexpr (std::is_enum_v<T>)
+	{
+		Logger::WriteArg(slot, static_cast<std::underlying_type_t<T>>(arg), reservedLen);
+	}
+	else if constexpr (std::is_floating_point_v<T>)
+	{
+		const double value = static_cast<double>(arg);
+		uint64_t bits;
+
+		std::memcpy(&bits, &value, sizeof(bits));
+
+		Logger::WriteScalar(slot, ArgType::DOUBLE, sizeof(double), bits);
+	}
+	else
+	{
+		static_assert(std::is_integral_v<T>, "unsupported log argument type");
+
+		if constexpr (std::is_signed_v<T>)
+		{
+			Logger::WriteScalar(
+			  slot, ArgType::INT, sizeof(T), static_cast<uint64_t>(static_cast<int64_t>(arg)));
+		}
+		else
+		{
+			Logger::WriteScalar(slot, ArgType::UINT, sizeof(T), static_cast<uint64_t>(arg));
+		}
+	}
+}
+
+inline void Logger::WriteScalar(Slot* slot, ArgType type, size_t size, uint64_t value)
+{
+	// No room left. The formatting thread prints missing arguments as "?".
+	if (slot->argsLen + ScalarArgSize > ArgsSize)
+		return;
+
+	uint8_t* arg = slot->args + slot->argsLen;
+
+	arg[0] = static_cast<uint8_t>(type);
+	arg[1] = static_cast<uint8_t>(size);
+	std::memcpy(arg + 2, &value, sizeof(value));
+
+	slot->argsLen += ScalarArgSize;
+}
+
+inline void Logger::WriteString(Slot* slot, const char* str, size_t reservedLen)
+{
+	if (slot->argsLen + 4u > ArgsSize)
+		return;
+
+	if (!str)
+		str = "(null)";
+
+	uint8_t* arg        = slot->args + slot->argsLen;
+	const size_t room   = ArgsSize - slot->argsLen - 4u;
+	const size_t maxLen = room > reservedLen ? room - reservedLen : 0u;
+	uint16_t len{ 0u };
+
+	while (len < maxLen && str[len] != '\0')
+	{
+		++len;
+	}
+
+	arg[0] = static_cast<uint8_t>(ArgType::STRING);
+	arg[1] = 0u;
+	std::memcpy(arg + 2, &len, sizeof(len));
+	std::memcpy(arg + 4, str, len);
+
+	slot->argsLen += 4u + len;
+}
+
 /* Logging macros. */
 
 #define _MS_LOG_SEPARATOR_CHAR_STD "\n"
@@ -153,14 +423,38 @@ public:
 	#define _MS_LOG_ARG MS_CLASS, __FUNCTION__
 #endif
 
+#ifdef MS_LOG_FILE_LINE
+	#define _MS_LOG_SITE(format) { format, MS_CLASS, __FUNCTION__, _MS_FILE, __LINE__ }
+#else
+	#define _MS_LOG_SITE(format) { format, MS_CLASS, __FUNCTION__, nullptr, 0 }
+#endif
+
+// Writes a record, at most MaxRecordsPerSitePerSecond per call site.
+#define _MS_LOG_RECORD(format, ...) \
+	do \
+	{ \
+		static const Logger::Site loggerSite _MS_LOG_SITE(format); \
+		thread_local Logger::SiteRate loggerSiteRate; \
+		Logger::Log(loggerSite, &loggerSiteRate, ##__VA_ARGS__); \
+	} \
+	while (false)
+
+// Writes a record, without rate limit.
+#define _MS_LOG_RECORD_ALWAYS(format, ...) \
+	do \
+	{ \
+		static const Logger::Site loggerSite _MS_LOG_SITE(format); \
+		Logger::Log(loggerSite, nullptr, ##__VA_ARGS__); \
+	} \
+	while (false)
+
 #ifdef MS_LOG_TRACE
 	#define MS_TRACE() \
 		do \
 		{ \
 			if (Settings::configuration.logLevel == LogLevel::LOG_DEBUG) \
 			{ \
-				const int loggerWritten = std::snprintf(Logger::buffer, Logger::bufferSize, "D(trace) " _MS_LOG_STR, _MS_LOG_ARG); \
-				Logger::channel->SendLog(Logger::buffer, static_cast<uint32_t>(loggerWritten)); \
+				_MS_LOG_RECORD("D(trace) " _MS_LOG_STR); \
 			} \
 		} \
 		while (false)
@@ -191,8 +485,7 @@ public:
 	{ \
 		if (Settings::configuration.logLevel == LogLevel::LOG_DEBUG && _MS_TAG_ENABLED(tag)) \
 		{ \
-			const int loggerWritten = std::snprintf(Logger::buffer, Logger::bufferSize, "D" _MS_LOG_STR_DESC desc, _MS_LOG_ARG, ##__VA_ARGS__); \
-			Logger::channel->SendLog(Logger::buffer, static_cast<uint32_t>(loggerWritten)); \
+			_MS_LOG_RECORD("D" _MS_LOG_STR_DESC desc, ##__VA_ARGS__); \
 		} \
 	} \
 	while (false)
@@ -213,8 +506,7 @@ public:
 	{ \
 		if (Settings::configuration.logLevel >= LogLevel::LOG_WARN && _MS_TAG_ENABLED(tag)) \
 		{ \
-			const int loggerWritten = std::snprintf(Logger::buffer, Logger::bufferSize, "W" _MS_LOG_STR_DESC desc, _MS_LOG_ARG, ##__VA_ARGS__); \
-			Logger::channel->SendLog(Logger::buffer, static_cast<uint32_t>(loggerWritten)); \
+			_MS_LOG_RECORD("W" _MS_LOG_STR_DESC desc, ##__VA_ARGS__); \
 		} \
 	} \
 	while (false)
@@ -235,8 +527,7 @@ public:
 	{ \
 		if (Settings::configuration.logLevel == LogLevel::LOG_DEBUG && _MS_TAG_ENABLED_2(tag1, tag2)) \
 		{ \
-			const int loggerWritten = std::snprintf(Logger::buffer, Logger::bufferSize, "D" _MS_LOG_STR_DESC desc, _MS_LOG_ARG, ##__VA_ARGS__); \
-			Logger::channel->SendLog(Logger::buffer, static_cast<uint32_t>(loggerWritten)); \
+			_MS_LOG_RECORD("D" _MS_LOG_STR_DESC desc, ##__VA_ARGS__); \
 		} \
 	} \
 	while (false)
@@ -257,8 +548,7 @@ public:
 	{ \
 		if (Settings::configuration.logLevel >= LogLevel::LOG_WARN && _MS_TAG_ENABLED_2(tag1, tag2)) \
 		{ \
-			const int loggerWritten = std::snprintf(Logger::buffer, Logger::bufferSize, "W" _MS_LOG_STR_DESC desc, _MS_LOG_ARG, ##__VA_ARGS__); \
-			Logger::channel->SendLog(Logger::buffer, static_cast<uint32_t>(loggerWritten)); \
+			_MS_LOG_RECORD("W" _MS_LOG_STR_DESC desc, ##__VA_ARGS__); \
 		} \
 	} \
 	while (false)
@@ -278,8 +568,7 @@ public:
 	#define MS_DEBUG_DEV(desc, ...) \
 		do \
 		{ \
-			const int loggerWritten = std::snprintf(Logger::buffer, Logger::bufferSize, "D" _MS_LOG_STR_DESC desc, _MS_LOG_ARG, ##__VA_ARGS__); \
-			Logger::channel->SendLog(Logger::buffer, static_cast<uint32_t>(loggerWritten)); \
+			_MS_LOG_RECORD("D" _MS_LOG_STR_DESC desc, ##__VA_ARGS__); \
 		} \
 		while (false)
 
@@ -300,8 +589,7 @@ public:
 	#define MS_WARN_DEV(desc, ...) \
 		do \
 		{ \
-			const int loggerWritten = std::snprintf(Logger::buffer, Logger::bufferSize, "W" _MS_LOG_STR_DESC desc, _MS_LOG_ARG, ##__VA_ARGS__); \
-			Logger::channel->SendLog(Logger::buffer, static_cast<uint32_t>(loggerWritten)); \
+			_MS_LOG_RECORD("W" _MS_LOG_STR_DESC desc, ##__VA_ARGS__); \
 		} \
 		while (false)
 
@@ -320,8 +608,7 @@ public:
 #define MS_DUMP(desc, ...) \
 	do \
 	{ \
-		const int loggerWritten = std::snprintf(Logger::buffer, Logger::bufferSize, "X" _MS_LOG_STR_DESC desc, _MS_LOG_ARG, ##__VA_ARGS__); \
-		Logger::channel->SendLog(Logger::buffer, static_cast<uint32_t>(loggerWritten)); \
+		_MS_LOG_RECORD_ALWAYS("X" _MS_LOG_STR_DESC desc, ##__VA_ARGS__); \
 	} \
 	while (false)
 
@@ -336,8 +623,8 @@ public:
 #define MS_DUMP_DATA(data, len) \
 	do \
 	{ \
-		const int loggerWritten = std::snprintf(Logger::buffer, Logger::bufferSize, "X(data) " _MS_LOG_STR, _MS_LOG_ARG); \
-		Logger::channel->SendLog(Logger::buffer, static_cast<uint32_t>(loggerWritten)); \
+		static const Logger::Site loggerDataSite{ "%s", nullptr, nullptr, nullptr, 0 }; \
+		_MS_LOG_RECORD_ALWAYS("X(data) " _MS_LOG_STR); \
 		size_t bufferDataLen{ 0 }; \
 		for (size_t i{0}; i < len; ++i) \
 		{ \
@@ -345,7 +632,7 @@ public:
 		  { \
 		  	if (bufferDataLen != 0) \
 		  	{ \
-		  		Logger::channel->SendLog(Logger::buffer, static_cast<uint32_t>(bufferDataLen)); \
+		  		Logger::Log(loggerDataSite, nullptr, static_cast<const char*>(Logger::buffer)); \
 		  		bufferDataLen = 0; \
 		  	} \
 		    const int loggerWritten = std::snprintf(Logger::buffer + bufferDataLen, Logger::bufferSize, "X%06X ", static_cast<unsigned int>(i)); \
@@ -355,7 +642,7 @@ public:
 		  bufferDataLen += loggerWritten; \
 		} \
 		if (bufferDataLen != 0) \
-			Logger::channel->SendLog(Logger::buffer, static_cast<uint32_t>(bufferDataLen)); \
+			Logger::Log(loggerDataSite, nullptr, static_cast<const char*>(Logger::buffer)); \
 	} \
 	while (false)
 
@@ -394,8 +681,7 @@ public:
 	{ \
 		if (Settings::configuration.logLevel >= LogLevel::LOG_ERROR || MS_LOG_DEV_LEVEL >= 1) \
 		{ \
-			const int loggerWritten = std::snprintf(Logger::buffer, Logger::bufferSize, "E" _MS_LOG_STR_DESC desc, _MS_LOG_ARG, ##__VA_ARGS__); \
-			Logger::channel->SendLog(Logger::buffer, static_cast<uint32_t>(loggerWritten)); \
+			_MS_LOG_RECORD_ALWAYS("E" _MS_LOG_STR_DESC desc, ##__VA_ARGS__); \
 		} \
 	} \
 	while (false)
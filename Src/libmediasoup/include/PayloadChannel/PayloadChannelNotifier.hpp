@@ -29,10 +29,20 @@ namespace PayloadChannel
 		  const std::string& data,
 		  const uint8_t* payload,
 		  size_t payloadLen);
+		// `data` is serialized JSON. The payload is not copied by the in-process
+		// PayloadChannel.
+		void Emit(
+		  const std::string& targetId,
+		  const char* event,
+		  const std::string& data,
+		  RTC::MessageBuffer* payload);
 
 	private:
 		// Passed by argument.
 		PayloadChannel::PayloadChannelSocket* payloadChannel{ nullptr };
+		// Others.
+		// Reused to build the notifications of shared payloads.
+		std::string notification;
 	};
 } // namespace PayloadChannel
 
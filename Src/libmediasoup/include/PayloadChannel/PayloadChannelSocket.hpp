@@ -4,6 +4,7 @@
 #include "common.hpp"
 #include "PayloadChannel/PayloadChannelNotification.hpp"
 #include "PayloadChannel/PayloadChannelRequest.hpp"
+#include "RTC/MessageBuffer.hpp"
 #include "handles/UnixStreamSocket.hpp"
 #include <nlohmann/json.hpp>
 #include <string>
@@ -98,6 +99,8 @@ namespace PayloadChannel
 		void SetListener(Listener* listener);
 		void Send(json& jsonMessage, const uint8_t* payload, size_t payloadLen);
 		void Send(const std::string& message, const uint8_t* payload, size_t payloadLen);
+		// The in-process writer may keep a reference to the payload.
+		void Send(const std::string& message, RTC::MessageBuffer* payload);
 		void Send(json& jsonMessage);
 		void Send(const std::string& message);
 		bool CallbackRead();
@@ -105,7 +108,11 @@ namespace PayloadChannel
 	private:
 		void SendImpl(const uint8_t* message, uint32_t messageLen);
 		void SendImpl(
-		  const uint8_t* message, uint32_t messageLen, const uint8_t* payload, uint32_t payloadLen);
+		  const uint8_t* message,
+		  uint32_t messageLen,
+		  const uint8_t* payload,
+		  uint32_t payloadLen,
+		  RTC::MessageBuffer* payloadRef);
 
 		/* Pure virtual methods inherited from ConsumerSocket::Listener. */
 	public:
@@ -25,7 +25,8 @@ namespace RTC
 			};
 
 		public:
-			static Opus::PayloadDescriptor* Parse(const uint8_t* data, size_t len);
+			// Fills the given (value initialized) payloadDescriptor.
+			static bool Parse(const uint8_t* data, size_t len, PayloadDescriptor& payloadDescriptor);
 			static void ProcessRtpPacket(RTC::RtpPacket* packet);
 
 		public:
@@ -53,13 +54,13 @@ namespace RTC
 			class PayloadDescriptorHandler : public RTC::Codecs::PayloadDescriptorHandler
 			{
 			public:
-				explicit PayloadDescriptorHandler(PayloadDescriptor* payloadDescriptor);
+				explicit PayloadDescriptorHandler(const PayloadDescriptor& payloadDescriptor);
 				~PayloadDescriptorHandler() = default;
 
 			public:
 				void Dump() const override
 				{
-					this->payloadDescriptor->Dump();
+					this->payloadDescriptor.Dump();
 				}
 				bool Process(RTC::Codecs::EncodingContext* encodingContext, uint8_t* data, bool& marker) override;
 				void Restore(uint8_t* data) override
@@ -80,7 +81,7 @@ namespace RTC
 				}
 
 			private:
-				std::unique_ptr<PayloadDescriptor> payloadDescriptor;
+				PayloadDescriptor payloadDescriptor;
 			};
 		};
 	} // namespace Codecs
@@ -71,9 +71,12 @@ namespace RTC
 			};
 
 		public:
-			static VP8::PayloadDescriptor* Parse(
+			// Fills the given (value initialized) payloadDescriptor. Returns false if
+			// the payload is not valid.
+			static bool Parse(
 			  const uint8_t* data,
 			  size_t len,
+			  PayloadDescriptor& payloadDescriptor,
 			  RTC::RtpPacket::FrameMarking* frameMarking = nullptr,
 			  uint8_t frameMarkingLen                    = 0);
 			static void ProcessRtpPacket(RTC::RtpPacket* packet);
@@ -105,13 +108,13 @@ namespace RTC
 			class PayloadDescriptorHandler : public RTC::Codecs::PayloadDescriptorHandler
 			{
 			public:
-				explicit PayloadDescriptorHandler(PayloadDescriptor* payloadDescriptor);
+				explicit PayloadDescriptorHandler(const PayloadDescriptor& payloadDescriptor);
 				~PayloadDescriptorHandler() = default;
 
 			public:
 				void Dump() const override
 				{
-					this->payloadDescriptor->Dump();
+					this->payloadDescriptor.Dump();
 				}
 				bool Process(RTC::Codecs::EncodingContext* encodingContext, uint8_t* data, bool& marker) override;
 				void Restore(uint8_t* data) override;
@@ -121,15 +124,15 @@ namespace RTC
 				}
 				uint8_t GetTemporalLayer() const override
 				{
-					return this->payloadDescriptor->hasTlIndex ? this->payloadDescriptor->tlIndex : 0u;
+					return this->payloadDescriptor.hasTlIndex ? this->payloadDescriptor.tlIndex : 0u;
 				}
 				bool IsKeyFrame() const override
 				{
-					return this->payloadDescriptor->isKeyFrame;
+					return this->payloadDescriptor.isKeyFrame;
 				}
 
 			private:
-				std::unique_ptr<PayloadDescriptor> payloadDescriptor;
+				PayloadDescriptor payloadDescriptor;
 			};
 		};
 	} // namespace Codecs
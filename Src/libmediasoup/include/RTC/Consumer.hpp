@@ -16,8 +16,10 @@
 #include "RTC/RtpStream.hpp"
 #include "RTC/RtpStreamSend.hpp"
 #include "RTC/Shared.hpp"
+#include "RTC/StatsPublisher.hpp"
 #include <absl/container/flat_hash_set.h>
 #include <nlohmann/json.hpp>
+#include <array>
 #include <string>
 #include <vector>
 
@@ -40,6 +42,7 @@ namespace RTC
 			virtual void OnConsumerNeedBitrateChange(RTC::Consumer* consumer)                      = 0;
 			virtual void OnConsumerNeedZeroBitrate(RTC::Consumer* consumer)                        = 0;
 			virtual void OnConsumerProducerClosed(RTC::Consumer* consumer)                         = 0;
+			virtual void OnConsumerForwardingChanged(RTC::Consumer* consumer)                      = 0;
 		};
 
 	public:
@@ -73,6 +76,7 @@ namespace RTC
 		virtual void FillJson(json& jsonObject) const;
 		virtual void FillJsonStats(json& jsonArray) const  = 0;
 		virtual void FillJsonScore(json& jsonObject) const = 0;
+		void FillBinaryStats(RTC::StatsPublisher* statsPublisher) const;
 		RTC::Media::Kind GetKind() const
 		{
 			return this->kind;
@@ -117,6 +121,13 @@ namespace RTC
 			);
 			// clang-format on
 		}
+		// Whether the Consumer just forwards the packets of some Producer RTP
+		// streams. If so, fills their mapped SSRCs (0 if unused) and packets of
+		// any other stream are known to be dropped by SendRtpPacket().
+		virtual bool GetForwardedMappedSsrcs(std::array<uint32_t, 2>& /*mappedSsrcs*/) const
+		{
+			return false;
+		}
 		void TransportConnected();
 		void TransportDisconnected();
 		bool IsPaused() const
@@ -6,8 +6,10 @@
 #include "Channel/ChannelSocket.hpp"
 #include "PayloadChannel/PayloadChannelRequest.hpp"
 #include "PayloadChannel/PayloadChannelSocket.hpp"
+#include "RTC/MessageBuffer.hpp"
 #include "RTC/SctpDictionaries.hpp"
 #include "RTC/Shared.hpp"
+#include "RTC/StatsPublisher.hpp"
 #include <nlohmann/json.hpp>
 #include <string>
 
@@ -33,8 +35,7 @@ namespace RTC
 			virtual void OnDataConsumerSendMessage(
 			  RTC::DataConsumer* dataConsumer,
 			  uint32_t ppid,
-			  const uint8_t* msg,
-			  size_t len,
+			  RTC::MessageBuffer* message,
 			  onQueuedCallback* cb)                                                        = 0;
 			virtual void OnDataConsumerDataProducerClosed(RTC::DataConsumer* dataConsumer) = 0;
 		};
@@ -60,6 +61,7 @@ namespace RTC
 	public:
 		void FillJson(json& jsonObject) const;
 		void FillJsonStats(json& jsonArray) const;
+		void FillBinaryStats(RTC::StatsPublisher* statsPublisher) const;
 		Type GetType() const
 		{
 			return this->type;
@@ -85,7 +87,7 @@ namespace RTC
 		void SctpAssociationBufferedAmount(uint32_t bufferedAmount);
 		void SctpAssociationSendBufferFull();
 		void DataProducerClosed();
-		void SendMessage(uint32_t ppid, const uint8_t* msg, size_t len, onQueuedCallback* = nullptr);
+		void SendMessage(uint32_t ppid, RTC::MessageBuffer* message, onQueuedCallback* = nullptr);
 
 		/* Methods inherited from Channel::ChannelSocket::RequestHandler. */
 	public:
@@ -5,9 +5,11 @@
 #include "Channel/ChannelRequest.hpp"
 #include "Channel/ChannelSocket.hpp"
 #include "PayloadChannel/PayloadChannelSocket.hpp"
+#include "RTC/MessageBuffer.hpp"
 #include "RTC/RTCP/Packet.hpp"
 #include "RTC/SctpDictionaries.hpp"
 #include "RTC/Shared.hpp"
+#include "RTC/StatsPublisher.hpp"
 #include <nlohmann/json.hpp>
 #include <string>
 
@@ -25,7 +27,7 @@ namespace RTC
 		public:
 			virtual void OnDataProducerReceiveData(RTC::DataProducer* producer, size_t len) = 0;
 			virtual void OnDataProducerMessageReceived(
-			  RTC::DataProducer* dataProducer, uint32_t ppid, const uint8_t* msg, size_t len) = 0;
+			  RTC::DataProducer* dataProducer, uint32_t ppid, RTC::MessageBuffer* message) = 0;
 		};
 
 	public:
@@ -47,6 +49,7 @@ namespace RTC
 	public:
 		void FillJson(json& jsonObject) const;
 		void FillJsonStats(json& jsonArray) const;
+		void FillBinaryStats(RTC::StatsPublisher* statsPublisher) const;
 		Type GetType() const
 		{
 			return this->type;
@@ -55,7 +58,7 @@ namespace RTC
 		{
 			return this->sctpStreamParameters;
 		}
-		void ReceiveMessage(uint32_t ppid, const uint8_t* msg, size_t len);
+		void ReceiveMessage(uint32_t ppid, RTC::MessageBuffer* message);
 
 		/* Methods inherited from Channel::ChannelSocket::RequestHandler. */
 	public:
@@ -82,6 +82,9 @@ namespace RTC
 			this->oldPassword = this->password;
 			this->password    = password;
 
+			this->oldHmacSha1.SetKey(this->oldPassword);
+			this->hmacSha1.SetKey(this->password);
+
 			this->remoteNomination = 0u;
 
 			// Notify the listener.
@@ -122,6 +125,9 @@ namespace RTC
 		std::string password;
 		std::string oldUsernameFragment;
 		std::string oldPassword;
+		// Keyed with password and oldPassword.
+		Utils::Crypto::HmacSha1 hmacSha1;
+		Utils::Crypto::HmacSha1 oldHmacSha1;
 		uint32_t remoteNomination{ 0u };
 		IceState state{ IceState::NEW };
 		std::list<RTC::TransportTuple> tuples;
@@ -0,0 +1,124 @@
+#ifndef MS_RTC_IN_PROCESS_PIPE_HPP
+#define MS_RTC_IN_PROCESS_PIPE_HPP
+
+#include "common.hpp"
+#include "RTC/RtpPacket.hpp" // MtuSize.
+#include <nlohmann/json.hpp>
+#include <uv.h>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+using json = nlohmann::json;
+
+namespace RTC
+{
+	// Endpoint of a pipe between two Workers running as threads of the same
+	// process. Each endpoint owns an inbox: a single producer single consumer
+	// ring of packet slots written by the remote endpoint (in its Worker
+	// thread) and drained by this one (in this Worker thread) when woken up
+	// through a uv_async_t. Packets are copied once into a slot and handed
+	// to the listener from there, without crossing the kernel.
+	class InProcessPipe
+	{
+	public:
+		class Listener
+		{
+		public:
+			virtual ~Listener() = default;
+
+		public:
+			// The data is valid (and can be modified in place) until the method
+			// returns.
+			virtual void OnInProcessPipePacketReceived(InProcessPipe* pipe, uint8_t* data, size_t len) = 0;
+		};
+
+	public:
+		// Number of slots of each inbox (about 2 MB), enough for the receiving
+		// Worker thread to be descheduled for some ms at high packet rates.
+		static constexpr size_t NumSlots{ 1024u };
+		// Room left after the packet in its slot, as RtpPacket may grow its
+		// header extension in place (see Producer::MangleRtpPacket()).
+		static constexpr size_t SlotRoom{ 256u };
+		static constexpr size_t MaxPacketSize{ RTC::MtuSize + 100u };
+
+	private:
+		struct Slot
+		{
+			size_t len{ 0u };
+			uint8_t data[MaxPacketSize + SlotRoom];
+		};
+
+		struct Inbox
+		{
+			Inbox();
+
+			// Written by the sender.
+			alignas(64) std::atomic<size_t> head{ 0u };
+			// Written by the receiver.
+			alignas(64) std::atomic<size_t> tail{ 0u };
+			// Whether the receiver has a wakeup pending, so the sender wakes it up
+			// once per batch of packets rather than once per packet.
+			alignas(64) std::atomic<bool> wakeupPending{ false };
+			// Whether a remote endpoint is connected (there can only be one).
+			std::atomic<bool> connected{ false };
+			// Whether the receiver is gone.
+			std::atomic<bool> closed{ false };
+			// Protects uvHandle from being closed while the sender uses it.
+			std::mutex mutex;
+			uv_async_t* uvHandle{ nullptr };
+			std::unique_ptr<Slot[]> slots;
+		};
+
+	public:
+		InProcessPipe(Listener* listener, const std::string& id);
+		InProcessPipe& operator=(const InProcessPipe&) = delete;
+		InProcessPipe(const InProcessPipe&)            = delete;
+		~InProcessPipe();
+
+	public:
+		void FillJsonStats(json& jsonObject) const;
+		// Connects to the endpoint with the given id, which may live in another
+		// Worker of this process. It can connect again once the remote endpoint
+		// is gone.
+		void Connect(const std::string& remoteId);
+		bool IsConnected() const
+		{
+			return this->outbox && !this->outbox->closed.load(std::memory_order_relaxed);
+		}
+		const std::string& GetRemoteId() const
+		{
+			return this->remoteId;
+		}
+		// Returns false if the packet was dropped.
+		bool Send(const uint8_t* data, size_t len);
+
+	private:
+		void Disconnect();
+
+		/* Callbacks fired by UV events. */
+	public:
+		void OnUvAsync();
+
+	private:
+		// Inboxes of all the endpoints of the process, indexed by endpoint id.
+		static std::mutex inboxesMutex;
+		static std::unordered_map<std::string, std::weak_ptr<Inbox>> inboxes;
+
+	private:
+		// Passed by argument.
+		Listener* listener{ nullptr };
+		std::string id;
+		// Others.
+		std::shared_ptr<Inbox> inbox;
+		std::shared_ptr<Inbox> outbox;
+		std::string remoteId;
+		uint64_t sentPackets{ 0u };
+		uint64_t droppedPackets{ 0u };
+		uint64_t recvPackets{ 0u };
+	};
+} // namespace RTC
+
+#endif
@@ -0,0 +1,64 @@
+#ifndef MS_RTC_MESSAGE_BUFFER_HPP
+#define MS_RTC_MESSAGE_BUFFER_HPP
+
+#include "common.hpp"
+#include <atomic>
+
+namespace RTC
+{
+	// Reference counted buffer holding a received DataChannel message. It is
+	// created once per message and handed to every DataConsumer of its
+	// DataProducer, and the in-process PayloadChannel may keep a reference to
+	// it until the notification is processed, so the message is not copied per
+	// DataConsumer. Once shared its content must not change. References may be
+	// dropped from any thread.
+	class MessageBuffer
+	{
+	public:
+		// Allocates a buffer able to hold `capacity` bytes.
+		static MessageBuffer* Create(size_t capacity);
+		// Takes ownership of `data`, which must have been allocated with
+		// std::malloc() (as usrsctp does for received messages).
+		static MessageBuffer* Adopt(uint8_t* data, size_t len);
+		// Allocates a buffer with a copy of the given data.
+		static MessageBuffer* Copy(const uint8_t* data, size_t len);
+
+	private:
+		MessageBuffer(uint8_t* data, size_t size, size_t capacity);
+		~MessageBuffer();
+
+	public:
+		void Ref()
+		{
+			this->refCount.fetch_add(1, std::memory_order_relaxed);
+		}
+		void Unref()
+		{
+			if (this->refCount.fetch_sub(1, std::memory_order_acq_rel) == 1)
+				delete this;
+		}
+		bool IsShared() const
+		{
+			return this->refCount.load(std::memory_order_acquire) > 1;
+		}
+		const uint8_t* GetData() const
+		{
+			return this->data;
+		}
+		size_t GetSize() const
+		{
+			return this->size;
+		}
+		// Appends data, growing the buffer if needed. Must not be called once
+		// the buffer is shared.
+		void Append(const uint8_t* data, size_t len);
+
+	private:
+		std::atomic<uint32_t> refCount{ 1u };
+		uint8_t* data{ nullptr };
+		size_t size{ 0u };
+		size_t capacity{ 0u };
+	};
+} // namespace RTC
+
+#endif
@@ -5,10 +5,7 @@
 #include "RTC/RtpPacket.hpp"
 #include "RTC/SeqManager.hpp"
 #include "handles/Timer.hpp"
-#include <absl/container/btree_map.h>
-#include <absl/container/btree_set.h>
-#include <map>
-#include <set>
+#include <array>
 #include <vector>
 
 namespace RTC
@@ -26,22 +23,58 @@ namespace RTC
 			virtual void OnNackGeneratorKeyFrameRequired()                                    = 0;
 		};
 
+	public:
+		// Number of sequence numbers covered by the bitmaps. A power of 2 bigger
+		// than the max age of a NACKed packet.
+		static constexpr size_t WindowSize{ 16384u };
+		// Capacity of the NACK list. A power of 2 not lower than the max number
+		// of NACKed packets.
+		static constexpr size_t NackListCapacity{ 1024u };
+
 	private:
 		struct NackInfo
 		{
 			NackInfo() = default;
-			explicit NackInfo(uint64_t createdAtMs, uint16_t seq, uint16_t sendAtSeq)
-			  : createdAtMs(createdAtMs), seq(seq), sendAtSeq(sendAtSeq)
+			explicit NackInfo(uint64_t createdAtMs, uint16_t seq) : createdAtMs(createdAtMs), seq(seq)
 			{
 			}
 
 			uint64_t createdAtMs{ 0u };
-			uint16_t seq{ 0u };
-			uint16_t sendAtSeq{ 0u };
 			uint64_t sentAtMs{ 0u };
+			uint16_t seq{ 0u };
 			uint8_t retries{ 0u };
 		};
 
+		// One bit per sequence number, for WindowSize consecutive ones.
+		class SeqBitmap
+		{
+		public:
+			bool Test(uint16_t seq) const
+			{
+				return (this->words[(seq % WindowSize) / 64u] >> (seq % 64u)) & 1u;
+			}
+			void Set(uint16_t seq)
+			{
+				this->words[(seq % WindowSize) / 64u] |= uint64_t{ 1u } << (seq % 64u);
+			}
+			void Reset(uint16_t seq)
+			{
+				this->words[(seq % WindowSize) / 64u] &= ~(uint64_t{ 1u } << (seq % 64u));
+			}
+			// Resets the bits from seqStart (included) to seqEnd (excluded).
+			void Reset(uint16_t seqStart, uint16_t seqEnd);
+			// Returns the first seq with its bit set from seqStart (included) to
+			// seqEnd (excluded), or seqEnd if none.
+			uint16_t FindFirst(uint16_t seqStart, uint16_t seqEnd) const;
+			void Clear()
+			{
+				this->words.fill(0u);
+			}
+
+		private:
+			std::array<uint64_t, WindowSize / 64u> words{};
+		};
+
 		enum class NackFilter
 		{
 			SEQ,
@@ -55,7 +88,7 @@ namespace RTC
 		bool ReceivePacket(RTC::RtpPacket* packet, bool isRecovered);
 		size_t GetNackListLength() const
 		{
-			return this->nackList.size();
+			return this->nackListLength;
 		}
 		void UpdateRtt(uint32_t rtt)
 		{
@@ -64,9 +97,15 @@ namespace RTC
 		void Reset();
 
 	private:
+		void ForgetOldSeqs(uint16_t seq);
 		void AddPacketsToNackList(uint16_t seqStart, uint16_t seqEnd);
 		bool RemoveNackItemsUntilKeyFrame();
-		std::vector<uint16_t> GetNackBatch(NackFilter filter);
+		NackInfo* GetNackInfo(uint16_t seq);
+		void RemoveNackInfo(NackInfo& nackInfo);
+		void TrimNackList(uint16_t seq);
+		void CompactNackList();
+		void ClearNackList();
+		const std::vector<uint16_t>& GetNackBatch(NackFilter filter);
 		void MayRunTimer() const;
 
 		/* Pure virtual methods inherited from Timer::Listener. */
@@ -80,9 +119,18 @@ namespace RTC
 		// Allocated by this.
 		Timer* timer{ nullptr };
 		// Others.
-		absl::btree_map<uint16_t, NackInfo, RTC::SeqManager<uint16_t>::SeqLowerThan> nackList;
-		absl::btree_set<uint16_t, RTC::SeqManager<uint16_t>::SeqLowerThan> keyFrameList;
-		absl::btree_set<uint16_t, RTC::SeqManager<uint16_t>::SeqLowerThan> recoveredList;
+		// Ring of NackInfos sorted by seq. Entries whose bit is not set in
+		// nackBitmap were removed and are skipped until dropped from the front
+		// or compacted.
+		std::vector<NackInfo> nackList;
+		size_t nackListFront{ 0u };
+		size_t nackListSize{ 0u };
+		size_t nackListLength{ 0u }; // Number of entries not removed.
+		SeqBitmap nackBitmap;
+		SeqBitmap keyFrameBitmap;
+		SeqBitmap recoveredBitmap;
+		// Reused for every batch of NACKed seqs.
+		std::vector<uint16_t> nackBatch;
 		bool started{ false };
 		uint16_t lastSeq{ 0u }; // Seq number of last valid packet.
 		uint32_t rtt{ 0u };     // Round trip time (ms).
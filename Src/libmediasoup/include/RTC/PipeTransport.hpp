@@ -1,6 +1,7 @@
 #ifndef MS_RTC_PIPE_TRANSPORT_HPP
 #define MS_RTC_PIPE_TRANSPORT_HPP
 
+#include "RTC/InProcessPipe.hpp"
 #include "RTC/Shared.hpp"
 #include "RTC/SrtpSession.hpp"
 #include "RTC/Transport.hpp"
@@ -9,7 +10,9 @@
 
 namespace RTC
 {
-	class PipeTransport : public RTC::Transport, public RTC::UdpSocket::Listener
+	class PipeTransport : public RTC::Transport,
+	                      public RTC::UdpSocket::Listener,
+	                      public RTC::InProcessPipe::Listener
 	{
 	private:
 		struct ListenIp
@@ -43,17 +46,17 @@ namespace RTC
 	private:
 		bool IsConnected() const override;
 		bool HasSrtp() const;
+		void SendData(const uint8_t* data, size_t len, const RTC::Transport::onSendCallback& cb = {});
 		void SendRtpPacket(
 		  RTC::Consumer* consumer,
 		  RTC::RtpPacket* packet,
-		  RTC::Transport::onSendCallback* cb = nullptr) override;
+		  const RTC::Transport::onSendCallback& cb = {}) override;
 		void SendRtcpPacket(RTC::RTCP::Packet* packet) override;
 		void SendRtcpCompoundPacket(RTC::RTCP::CompoundPacket* packet) override;
 		void SendMessage(
 		  RTC::DataConsumer* dataConsumer,
 		  uint32_t ppid,
-		  const uint8_t* msg,
-		  size_t len,
+		  RTC::MessageBuffer* message,
 		  onQueuedCallback* cb = nullptr) override;
 		void SendSctpData(const uint8_t* data, size_t len) override;
 		void RecvStreamClosed(uint32_t ssrc) override;
@@ -68,9 +71,14 @@ namespace RTC
 		void OnUdpSocketPacketReceived(
 		  RTC::UdpSocket* socket, const uint8_t* data, size_t len, const struct sockaddr* remoteAddr) override;
 
+		/* Pure virtual methods inherited from RTC::InProcessPipe::Listener. */
+	public:
+		void OnInProcessPipePacketReceived(RTC::InProcessPipe* pipe, uint8_t* data, size_t len) override;
+
 	private:
 		// Allocated by this.
 		RTC::UdpSocket* udpSocket{ nullptr };
+		RTC::InProcessPipe* inProcessPipe{ nullptr };
 		RTC::TransportTuple* tuple{ nullptr };
 		RTC::SrtpSession* srtpRecvSession{ nullptr };
 		RTC::SrtpSession* srtpSendSession{ nullptr };
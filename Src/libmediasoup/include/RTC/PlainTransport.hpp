@@ -47,14 +47,13 @@ namespace RTC
 		void SendRtpPacket(
 		  RTC::Consumer* consumer,
 		  RTC::RtpPacket* packet,
-		  RTC::Transport::onSendCallback* cb = nullptr) override;
+		  const RTC::Transport::onSendCallback& cb = {}) override;
 		void SendRtcpPacket(RTC::RTCP::Packet* packet) override;
 		void SendRtcpCompoundPacket(RTC::RTCP::CompoundPacket* packet) override;
 		void SendMessage(
 		  RTC::DataConsumer* dataConsumer,
 		  uint32_t ppid,
-		  const uint8_t* msg,
-		  size_t len,
+		  RTC::MessageBuffer* message,
 		  onQueuedCallback* cb = nullptr) override;
 		void SendSctpData(const uint8_t* data, size_t len) override;
 		void RecvStreamClosed(uint32_t ssrc) override;
@@ -29,6 +29,24 @@ namespace RTC
 		{
 			return reinterpret_cast<uv_udp_t*>(Bind(Transport::UDP, ip, port));
 		}
+		/**
+		 * Binds a UDP socket that shares ip:port with the sockets of other workers
+		 * (SO_REUSEPORT). Their reuseport group steers ICE STUN requests by
+		 * local usernameFragment prefix (see WebRtcServer).
+		 */
+		static uv_udp_t* BindUdpReusePort(std::string& ip, uint16_t port)
+		{
+			return reinterpret_cast<uv_udp_t*>(Bind(Transport::UDP, ip, port, true, nullptr));
+		}
+		/**
+		 * Binds a UDP socket into the reuseport group of ip:port and connects it
+		 * to the given remote address, so the kernel delivers all datagrams from
+		 * that remote to it.
+		 */
+		static uv_udp_t* BindUdpReusePort(std::string& ip, uint16_t port, const struct sockaddr* remoteAddr)
+		{
+			return reinterpret_cast<uv_udp_t*>(Bind(Transport::UDP, ip, port, true, remoteAddr));
+		}
 		static uv_tcp_t* BindTcp(std::string& ip)
 		{
 			return reinterpret_cast<uv_tcp_t*>(Bind(Transport::TCP, ip));
@@ -49,7 +67,12 @@ namespace RTC
 
 	private:
 		static uv_handle_t* Bind(Transport transport, std::string& ip);
-		static uv_handle_t* Bind(Transport transport, std::string& ip, uint16_t port);
+		static uv_handle_t* Bind(
+		  Transport transport,
+		  std::string& ip,
+		  uint16_t port,
+		  bool reusePort                   = false,
+		  const struct sockaddr* remoteAddr = nullptr);
 		static void Unbind(Transport transport, std::string& ip, uint16_t port);
 		static std::vector<bool>& GetPorts(Transport transport, const std::string& ip);
 
@@ -15,6 +15,7 @@
 #include "RTC/RtpPacket.hpp"
 #include "RTC/RtpStreamRecv.hpp"
 #include "RTC/Shared.hpp"
+#include "RTC/StatsPublisher.hpp"
 #include <nlohmann/json.hpp>
 #include <string>
 #include <vector>
@@ -99,6 +100,7 @@ namespace RTC
 	public:
 		void FillJson(json& jsonObject) const;
 		void FillJsonStats(json& jsonArray) const;
+		void FillBinaryStats(RTC::StatsPublisher* statsPublisher) const;
 		RTC::Media::Kind GetKind() const
 		{
 			return this->kind;
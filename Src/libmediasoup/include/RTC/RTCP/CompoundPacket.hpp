@@ -44,6 +44,9 @@ namespace RTC
 				return this->receiverReportPacket.GetCount();
 			}
 			void Dump();
+			// Deletes all the content so the instance can be used for a new
+			// compound packet.
+			void Reset();
 			// RTCP additions per Consumer (non pipe).
 			// Adds the given data and returns true if there is enough space to hold it,
 			// false otherwise.
@@ -39,6 +39,16 @@ namespace RTC
 			{
 				this->items.push_back(item);
 			}
+			// Deletes all the items, keeping the storage for new ones.
+			void DeleteItems()
+			{
+				for (auto* item : this->items)
+				{
+					delete item;
+				}
+
+				this->items.clear();
+			}
 			Iterator Begin()
 			{
 				return this->items.begin();
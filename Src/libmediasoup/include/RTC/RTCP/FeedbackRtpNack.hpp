@@ -41,6 +41,11 @@ namespace RTC
 			FeedbackRtpNackItem(uint16_t packetId, uint16_t lostPacketBitmask);
 			~FeedbackRtpNackItem() override = default;
 
+			// Instances are recycled through the ReportPool since one is generated
+			// for each batch of NACKed seqs.
+			static void* operator new(size_t size);
+			static void operator delete(void* ptr, size_t size);
+
 			uint16_t GetPacketId() const
 			{
 				return uint16_t{ ntohs(this->header->packetId) };
@@ -65,6 +70,8 @@ namespace RTC
 
 		private:
 			Header* header{ nullptr };
+			// Storage of the header of items not parsed from external data.
+			Header data{};
 		};
 
 		// Nack packet declaration.
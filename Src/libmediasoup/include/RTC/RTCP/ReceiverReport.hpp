@@ -43,6 +43,10 @@ namespace RTC
 			{
 			}
 
+			// Instances are recycled through the Worker's RTCP ReportPool.
+			static void* operator new(size_t size);
+			static void operator delete(void* ptr, size_t size);
+
 			void Dump() const;
 			size_t Serialize(uint8_t* buffer);
 			size_t GetSize() const
@@ -172,6 +176,16 @@ namespace RTC
 				if (it != this->reports.end())
 					this->reports.erase(it);
 			}
+			// Deletes all the reports, keeping the storage for new ones.
+			void DeleteReports()
+			{
+				for (auto* report : this->reports)
+				{
+					delete report;
+				}
+
+				this->reports.clear();
+			}
 			Iterator Begin()
 			{
 				return this->reports.begin();
@@ -0,0 +1,47 @@
+#ifndef MS_RTC_RTCP_REPORT_POOL_HPP
+#define MS_RTC_RTCP_REPORT_POOL_HPP
+
+#include "common.hpp"
+#include <nlohmann/json.hpp>
+#include <vector>
+
+using json = nlohmann::json;
+
+namespace RTC
+{
+	namespace RTCP
+	{
+		// Per Worker (thread local) free lists for the reports, SDES chunks and
+		// items and XR blocks that Transports generate on every RTCP tick (one
+		// set per Consumer and Producer), so that building them does not hit
+		// malloc several times per Consumer.
+		class ReportPool
+		{
+		private:
+			struct FreeList
+			{
+				~FreeList();
+
+				std::vector<void*> items;
+			};
+
+		public:
+			// Instances are grouped by size in classes of SizeClass bytes, so
+			// instances of different types with similar size share free lists.
+			static constexpr size_t SizeClass{ 16u };
+			static constexpr size_t NumSizeClasses{ 8u };
+
+		public:
+			static void* Allocate(size_t size);
+			static void Free(void* ptr, size_t size);
+			static void FillJson(json& jsonObject);
+
+		private:
+			thread_local static FreeList freeLists[NumSizeClasses];
+			thread_local static uint64_t hits;
+			thread_local static uint64_t misses;
+		};
+	} // namespace RTCP
+} // namespace RTC
+
+#endif
@@ -50,6 +50,10 @@ namespace RTC
 			SdesItem(SdesItem::Type type, size_t len, const char* value);
 			~SdesItem() = default;
 
+			// Instances are recycled through the Worker's RTCP ReportPool.
+			static void* operator new(size_t size);
+			static void operator delete(void* ptr, size_t size);
+
 			void Dump() const;
 			size_t Serialize(uint8_t* buffer);
 			size_t GetSize() const
@@ -109,6 +113,10 @@ namespace RTC
 				}
 			}
 
+			// Instances are recycled through the Worker's RTCP ReportPool.
+			static void* operator new(size_t size);
+			static void operator delete(void* ptr, size_t size);
+
 			void Dump() const;
 			void Serialize();
 			size_t Serialize(uint8_t* buffer);
@@ -187,6 +195,16 @@ namespace RTC
 				if (it != this->chunks.end())
 					this->chunks.erase(it);
 			}
+			// Deletes all the chunks, keeping the storage for new ones.
+			void DeleteChunks()
+			{
+				for (auto* chunk : this->chunks)
+				{
+					delete chunk;
+				}
+
+				this->chunks.clear();
+			}
 			Iterator Begin()
 			{
 				return this->chunks.begin();
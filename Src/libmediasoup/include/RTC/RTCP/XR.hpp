@@ -58,6 +58,10 @@ namespace RTC
 			}
 			virtual ~ExtendedReportBlock() = default;
 
+			// Instances (of every block type) are recycled through the Worker's RTCP ReportPool.
+			static void* operator new(size_t size);
+			static void operator delete(void* ptr, size_t size);
+
 		public:
 			virtual void Dump() const                 = 0;
 			virtual size_t Serialize(uint8_t* buffer) = 0;
@@ -109,6 +113,16 @@ namespace RTC
 				if (it != this->reports.end())
 					this->reports.erase(it);
 			}
+			// Deletes all the reports, keeping the storage for new ones.
+			void DeleteReports()
+			{
+				for (auto* report : this->reports)
+				{
+					delete report;
+				}
+
+				this->reports.clear();
+			}
 			uint32_t GetSsrc() const
 			{
 				return this->ssrc;
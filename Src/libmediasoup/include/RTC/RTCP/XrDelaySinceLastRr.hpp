@@ -58,6 +58,10 @@ namespace RTC
 				{
 				}
 
+				// Instances are recycled through the Worker's RTCP ReportPool.
+				static void* operator new(size_t size);
+				static void operator delete(void* ptr, size_t size);
+
 				void Dump() const;
 				size_t Serialize(uint8_t* buffer);
 				size_t GetSize() const
@@ -13,12 +13,15 @@
 #include "RTC/RtpPacket.hpp"
 #include "RTC/RtpStream.hpp"
 #include "RTC/Shared.hpp"
+#include "RTC/StatsPublisher.hpp"
 #include "RTC/Transport.hpp"
 #include "RTC/WebRtcServer.hpp"
 #include <absl/container/flat_hash_map.h>
 #include <nlohmann/json.hpp>
+#include <array>
 #include <string>
 #include <unordered_set>
+#include <vector>
 
 using json = nlohmann::json;
 
@@ -39,12 +42,40 @@ namespace RTC
 			  RTC::Router* router, std::string& webRtcServerId) = 0;
 		};
 
+	private:
+		// Forwarding state of a Consumer cached by the Router, so the fan-out of
+		// a packet walks a contiguous array instead of querying every Consumer.
+		// It's updated whenever the state of the Consumer changes.
+		struct FanOutEntry
+		{
+			RTC::Consumer* consumer{ nullptr };
+			// If filterBySsrc is set, mapped SSRCs of the only Producer RTP streams
+			// whose packets the Consumer forwards (0 if unused).
+			std::array<uint32_t, 2> mappedSsrcs{};
+			bool active{ false };
+			bool filterBySsrc{ false };
+			uint8_t midLen{ 0u };
+			std::array<uint8_t, RTC::MidMaxLength> mid{};
+		};
+
+		// Consumers of a Producer.
+		struct FanOut
+		{
+			std::vector<FanOutEntry> entries;
+			// Index of every Consumer in entries.
+			absl::flat_hash_map<RTC::Consumer*, size_t> mapConsumerEntryIndex;
+		};
+
+	private:
+		static void UpdateFanOutEntry(FanOutEntry& entry);
+
 	public:
 		explicit Router(RTC::Shared* shared, const std::string& id, Listener* listener);
 		virtual ~Router();
 
 	public:
 		void FillJson(json& jsonObject) const;
+		void FillBinaryStats(RTC::StatsPublisher* statsPublisher);
 
 		/* Methods inherited from Channel::ChannelSocket::RequestHandler. */
 	public:
@@ -88,14 +119,14 @@ namespace RTC
 		void OnTransportConsumerProducerClosed(RTC::Transport* transport, RTC::Consumer* consumer) override;
 		void OnTransportConsumerKeyFrameRequested(
 		  RTC::Transport* transport, RTC::Consumer* consumer, uint32_t mappedSsrc) override;
+		void OnTransportConsumerForwardingChanged(RTC::Transport* transport, RTC::Consumer* consumer) override;
 		void OnTransportNewDataProducer(RTC::Transport* transport, RTC::DataProducer* dataProducer) override;
 		void OnTransportDataProducerClosed(RTC::Transport* transport, RTC::DataProducer* dataProducer) override;
 		void OnTransportDataProducerMessageReceived(
 		  RTC::Transport* transport,
 		  RTC::DataProducer* dataProducer,
 		  uint32_t ppid,
-		  const uint8_t* msg,
-		  size_t len) override;
+		  RTC::MessageBuffer* message) override;
 		void OnTransportNewDataConsumer(
 		  RTC::Transport* transport, RTC::DataConsumer* dataConsumer, std::string& dataProducerId) override;
 		void OnTransportDataConsumerClosed(RTC::Transport* transport, RTC::DataConsumer* dataConsumer) override;
@@ -121,7 +152,7 @@ namespace RTC
 		absl::flat_hash_map<std::string, RTC::Transport*> mapTransports;
 		absl::flat_hash_map<std::string, RTC::RtpObserver*> mapRtpObservers;
 		// Others.
-		absl::flat_hash_map<RTC::Producer*, absl::flat_hash_set<RTC::Consumer*>> mapProducerConsumers;
+		absl::flat_hash_map<RTC::Producer*, FanOut> mapProducerConsumers;
 		absl::flat_hash_map<RTC::Consumer*, RTC::Producer*> mapConsumerProducer;
 		absl::flat_hash_map<RTC::Producer*, absl::flat_hash_set<RTC::RtpObserver*>> mapProducerRtpObservers;
 		absl::flat_hash_map<std::string, RTC::Producer*> mapProducers;
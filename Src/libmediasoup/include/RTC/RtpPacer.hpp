@@ -0,0 +1,112 @@
+#ifndef MS_RTC_RTP_PACER_HPP
+#define MS_RTC_RTP_PACER_HPP
+
+#include "common.hpp"
+#include "RTC/Consumer.hpp"
+#include "RTC/RtpPacket.hpp"
+#include "handles/Timer.hpp"
+#include <array>
+#include <deque>
+#include <vector>
+
+namespace RTC
+{
+	// Smooths the RTP packets sent by a Transport to its pacing bitrate, so
+	// keyframe bursts across many Consumers don't leave the Worker at line rate.
+	// Audio is never delayed, it just consumes budget. Queued packets are sent
+	// by a Worker level timer shared by all the pacers.
+	class RtpPacer
+	{
+	public:
+		enum class Priority : uint8_t
+		{
+			AUDIO = 0,
+			RETRANSMISSION,
+			VIDEO
+		};
+
+	private:
+		class Scheduler : public Timer::Listener
+		{
+		public:
+			Scheduler();
+			~Scheduler() override;
+
+		public:
+			void Start();
+			void Stop();
+
+			/* Pure virtual methods inherited from Timer::Listener. */
+		public:
+			void OnTimer(Timer* timer) override;
+
+		private:
+			Timer* timer{ nullptr };
+		};
+
+		struct QueuedPacket
+		{
+			RTC::Consumer* consumer{ nullptr };
+			RTC::RtpPacket* packet{ nullptr };
+			uint64_t queuedAtMs{ 0u };
+			// For ForwardingMetrics.
+			uint64_t queuedAtTicks{ 0u };
+		};
+
+	public:
+		class Listener
+		{
+		public:
+			virtual ~Listener() = default;
+
+		public:
+			virtual void OnRtpPacerSendRtpPacket(
+			  RTC::RtpPacer* rtpPacer, RTC::Consumer* consumer, RTC::RtpPacket* packet, Priority priority) = 0;
+		};
+
+	public:
+		RtpPacer(Listener* listener, uint32_t bitrate);
+		~RtpPacer();
+
+	public:
+		// Returns true if the packet has been queued (cloned), in which case it
+		// will be sent later via the listener. Otherwise the caller must send it
+		// right away.
+		bool Enqueue(RTC::Consumer* consumer, RTC::RtpPacket* packet, Priority priority);
+		void SetBitrate(uint32_t bitrate);
+		void RemoveConsumer(RTC::Consumer* consumer);
+		void Clear();
+		size_t GetQueueSize() const
+		{
+			return this->queues[0].size() + this->queues[1].size();
+		}
+
+	private:
+		void UpdateBudget(uint64_t nowUs);
+		bool SendNext(uint64_t nowUs);
+		void Schedule();
+
+	private:
+		// Passed by argument.
+		Listener* listener{ nullptr };
+		// Others.
+		// Retransmission and video queues.
+		std::array<std::deque<QueuedPacket>, 2> queues;
+		uint32_t bitrate{ 0u };
+		// In bytes. May be negative after sending audio or a large packet.
+		int64_t budget{ 0 };
+		uint64_t lastBudgetUpdateUs{ 0u };
+		bool scheduled{ false };
+
+	private:
+		thread_local static Scheduler* scheduler;
+		thread_local static size_t numPacers;
+		// Pacers with queued packets. Pacers cleared while the scheduler runs
+		// leave a nullptr here, removed once it is done.
+		thread_local static std::vector<RtpPacer*> scheduledPacers;
+		// Whether the scheduler is sending queued packets.
+		thread_local static bool processing;
+	};
+} // namespace RTC
+
+#endif
@@ -6,8 +6,11 @@
 #include "RTC/Codecs/PayloadDescriptorHandler.hpp"
 #include <absl/container/flat_hash_map.h>
 #include <array>
+#include <cstddef> // std::max_align_t
+#include <new>     // placement new
 #include <nlohmann/json.hpp>
 #include <string>
+#include <utility> // std::forward()
 #include <vector>
 
 using json = nlohmann::json;
@@ -56,26 +59,15 @@ namespace RTC
 		};
 
 	private:
-		/* Struct for One-Byte extension. */
-		struct OneByteExtension
-		{
-#if defined(MS_LITTLE_ENDIAN)
-			uint8_t len : 4;
-			uint8_t id : 4;
-#elif defined(MS_BIG_ENDIAN)
-			uint8_t id : 4;
-			uint8_t len : 4;
-#endif
-			uint8_t value[1];
-		};
-
-	private:
-		/* Struct for Two-Bytes extension. */
-		struct TwoBytesExtension
-		{
-			uint8_t id;
-			uint8_t len;
-			uint8_t value[1];
+		/* Struct for the index of an extension in the header extension. */
+		struct ExtensionEntry
+		{
+			// Offset of the value from the start of the header extension value, 0
+			// if the extension is not present (a value never starts there).
+			uint16_t offset{ 0u };
+			uint8_t len{ 0u };
+			// Bytes available for the value (len plus following padding bytes).
+			uint8_t room{ 0u };
 		};
 
 	public:
@@ -112,8 +104,15 @@ namespace RTC
 			uint8_t tl0picidx;
 		};
 
+	private:
+		// Highest extension id indexed in the extension table. Two-Bytes extensions
+		// with a higher id are looked up by walking the header extension.
+		static constexpr uint8_t MaxIndexedExtensionId{ 14u };
+
 	public:
 		static const size_t HeaderSize{ 12 };
+		// Room for the payload descriptor handler of any supported codec.
+		static constexpr size_t PayloadDescriptorHandlerSize{ 64u };
 		static bool IsRtp(const uint8_t* data, size_t len)
 		{
 			// NOTE: RtcpPacket::IsRtcp() must always be called before this method.
@@ -143,6 +142,8 @@ namespace RTC
 		  size_t size);
 
 	public:
+		RtpPacket& operator=(const RtpPacket&) = delete;
+		RtpPacket(const RtpPacket&)            = delete;
 		~RtpPacket();
 
 		void Dump() const;
@@ -316,6 +317,7 @@ namespace RTC
 		}
 
 		void UpdateMid(const std::string& mid);
+		void UpdateMid(const uint8_t* mid, size_t midLen);
 
 		bool ReadRid(std::string& rid) const
 		{
@@ -466,88 +468,32 @@ namespace RTC
 
 		bool HasExtension(uint8_t id) const
 		{
-			if (id == 0u)
-			{
-				return false;
-			}
-			else if (HasOneByteExtensions())
-			{
-				if (id > 14)
-					return false;
-
-				// `-1` because we have 14 elements total 0..13 and `id` is in the range 1..14.
-				return this->oneByteExtensions[id - 1] != nullptr;
-			}
-			else if (HasTwoBytesExtensions())
-			{
-				auto it = this->mapTwoBytesExtensions.find(id);
-
-				if (it == this->mapTwoBytesExtensions.end())
-					return false;
-
-				auto* extension = it->second;
-
-				// In Two-Byte extensions value length may be zero. If so, return false.
-				if (extension->len == 0u)
-					return false;
+			const auto entry = GetExtensionEntry(id);
 
-				return true;
-			}
-			else
-			{
-				return false;
-			}
+			// In Two-Byte extensions value length may be zero. If so, return false.
+			return entry.offset != 0u && entry.len != 0u;
 		}
 
 		uint8_t* GetExtension(uint8_t id, uint8_t& len) const
 		{
-			len = 0u;
-
-			if (id == 0u)
-			{
-				return nullptr;
-			}
-			else if (HasOneByteExtensions())
-			{
-				if (id > 14)
-					return nullptr;
-
-				// `-1` because we have 14 elements total 0..13 and `id` is in the range 1..14.
-				auto* extension = this->oneByteExtensions[id - 1];
-
-				if (!extension)
-					return nullptr;
-
-				// In One-Byte extensions value length 0 means 1.
-				len = extension->len + 1;
-
-				return extension->value;
-			}
-			else if (HasTwoBytesExtensions())
-			{
-				auto it = this->mapTwoBytesExtensions.find(id);
+			const auto entry = GetExtensionEntry(id);
 
-				if (it == this->mapTwoBytesExtensions.end())
-					return nullptr;
+			len = entry.len;
 
-				auto* extension = it->second;
-
-				len = extension->len;
-
-				// In Two-Byte extensions value length may be zero. If so, return nullptr.
-				if (extension->len == 0u)
-					return nullptr;
-
-				return extension->value;
-			}
-			else
-			{
+			// In Two-Byte extensions value length may be zero. If so, return nullptr.
+			if (entry.offset == 0u || entry.len == 0u)
 				return nullptr;
-			}
+
+			return this->headerExtension->value + entry.offset;
 		}
 
 		bool SetExtensionLength(uint8_t id, uint8_t len);
 
+		// Rewrites the value of an existing extension in place, without rebuilding
+		// the header extension. `len` cannot exceed the room of the extension
+		// (its current length plus the padding bytes that follow it).
+		bool SetExtensionValue(uint8_t id, const uint8_t* value, uint8_t len);
+
 		uint8_t* GetPayload() const
 		{
 			return this->payloadLength != 0u ? this->payload : nullptr;
@@ -591,13 +537,48 @@ namespace RTC
 
 		RtpPacket* Clone() const;
 
+		// Instances are recycled through the Worker's RtpPacketPool.
+		static void* operator new(size_t size);
+		static void operator delete(void* ptr, size_t size);
+
 		void RtxEncode(uint8_t payloadType, uint32_t ssrc, uint16_t seq);
 
 		bool RtxDecode(uint8_t payloadType, uint32_t ssrc);
 
-		void SetPayloadDescriptorHandler(RTC::Codecs::PayloadDescriptorHandler* payloadDescriptorHandler)
+		// Constructs the payload descriptor handler within the packet, replacing
+		// the current one (if any).
+		template<typename Handler, typename... Args>
+		Handler* SetPayloadDescriptorHandler(Args&&... args)
+		{
+			static_assert(
+			  sizeof(Handler) <= PayloadDescriptorHandlerSize, "payload descriptor handler too big");
+			static_assert(
+			  alignof(Handler) <= alignof(std::max_align_t), "payload descriptor handler over aligned");
+
+			ResetPayloadDescriptorHandler();
+
+			auto* handler =
+			  new (this->payloadDescriptorHandlerStorage) Handler(std::forward<Args>(args)...);
+
+			this->payloadDescriptorHandler = handler;
+			this->copyPayloadDescriptorHandler =
+			  [](const Codecs::PayloadDescriptorHandler* handler, uint8_t* storage)
+			  -> Codecs::PayloadDescriptorHandler*
+			{
+				return new (storage) Handler(*static_cast<const Handler*>(handler));
+			};
+
+			return handler;
+		}
+
+		void ResetPayloadDescriptorHandler()
 		{
-			this->payloadDescriptorHandler.reset(payloadDescriptorHandler);
+			if (!this->payloadDescriptorHandler)
+				return;
+
+			this->payloadDescriptorHandler->~PayloadDescriptorHandler();
+			this->payloadDescriptorHandler     = nullptr;
+			this->copyPayloadDescriptorHandler = nullptr;
 		}
 
 		bool ProcessPayload(RTC::Codecs::EncodingContext* context, bool& marker);
@@ -608,16 +589,30 @@ namespace RTC
 
 	private:
 		void ParseExtensions();
+		ExtensionEntry GetExtensionEntry(uint8_t id) const
+		{
+			if (id == 0u)
+				return {};
+
+			// `-1` because we have 14 elements total 0..13 and `id` is in the range 1..14.
+			if (id <= MaxIndexedExtensionId)
+				return this->extensions[id - 1];
+
+			// Only Two-Bytes extensions can have a higher id.
+			return FindTwoBytesExtension(id);
+		}
+		ExtensionEntry FindTwoBytesExtension(uint8_t id) const;
+		void WriteExtensionLength(uint8_t id, const ExtensionEntry& entry, uint8_t len);
 
 	private:
 		// Passed by argument.
 		Header* header{ nullptr };
 		uint8_t* csrcList{ nullptr };
 		HeaderExtension* headerExtension{ nullptr };
-		// There might be up to 14 one-byte header extensions
-		// (https://datatracker.ietf.org/doc/html/rfc5285#section-4.2), use std::array.
-		std::array<OneByteExtension*, 14> oneByteExtensions;
-		absl::flat_hash_map<uint8_t, TwoBytesExtension*> mapTwoBytesExtensions;
+		// Extensions with id 1..14, in both One-Byte and Two-Bytes forms, indexed
+		// by id once when the packet is parsed
+		// (https://datatracker.ietf.org/doc/html/rfc5285#section-4.2).
+		std::array<ExtensionEntry, MaxIndexedExtensionId> extensions{};
 		uint8_t midExtensionId{ 0u };
 		uint8_t ridExtensionId{ 0u };
 		uint8_t rridExtensionId{ 0u };
@@ -631,8 +626,15 @@ namespace RTC
 		size_t payloadLength{ 0u };
 		uint8_t payloadPadding{ 0u };
 		size_t size{ 0u }; // Full size of the packet in bytes.
-		// Codecs
-		std::shared_ptr<Codecs::PayloadDescriptorHandler> payloadDescriptorHandler;
+		// Codecs.
+		// The payload descriptor handler lives in the storage below, so parsing
+		// the payload of every video packet does not allocate. The copy function
+		// is set along with the handler, and lets Clone() copy it without
+		// knowing the codec.
+		Codecs::PayloadDescriptorHandler* payloadDescriptorHandler{ nullptr };
+		Codecs::PayloadDescriptorHandler* (*copyPayloadDescriptorHandler)(
+		  const Codecs::PayloadDescriptorHandler* handler, uint8_t* storage){ nullptr };
+		alignas(std::max_align_t) uint8_t payloadDescriptorHandlerStorage[PayloadDescriptorHandlerSize];
 		// Buffer where this packet is allocated, can be `nullptr` if packet was
 		// parsed from externally provided buffer.
 		uint8_t* buffer{ nullptr };
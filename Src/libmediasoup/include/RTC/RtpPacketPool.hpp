@@ -0,0 +1,44 @@
+#ifndef MS_RTC_RTP_PACKET_POOL_HPP
+#define MS_RTC_RTP_PACKET_POOL_HPP
+
+#include "common.hpp"
+#include <nlohmann/json.hpp>
+#include <vector>
+
+using json = nlohmann::json;
+
+namespace RTC
+{
+	// Per Worker (thread local) free lists for RtpPacket instances and the
+	// buffers allocated by RtpPacket::Clone(), so that storing packets for
+	// retransmission does not hit malloc for every forwarded packet.
+	class RtpPacketPool
+	{
+	private:
+		struct FreeList
+		{
+			~FreeList();
+
+			std::vector<void*> items;
+			uint64_t hits{ 0u };
+			uint64_t misses{ 0u };
+		};
+
+	public:
+		// Size of buffers returned by AllocateBuffer().
+		static const size_t BufferSize;
+
+	public:
+		static uint8_t* AllocateBuffer();
+		static void FreeBuffer(uint8_t* buffer);
+		static void* AllocatePacket(size_t size);
+		static void FreePacket(void* ptr, size_t size);
+		static void FillJson(json& jsonObject);
+
+	private:
+		thread_local static FreeList buffers;
+		thread_local static FreeList packets;
+	};
+} // namespace RTC
+
+#endif
@@ -14,6 +14,7 @@
 #include "RTC/RTCP/XrReceiverReferenceTime.hpp"
 #include "RTC/RtpDictionaries.hpp"
 #include "RTC/RtxStream.hpp"
+#include "RTC/StatsPublisher.hpp"
 #include <nlohmann/json.hpp>
 #include <string>
 #include <vector>
@@ -63,6 +64,8 @@ namespace RTC
 
 		void FillJson(json& jsonObject) const;
 		virtual void FillJsonStats(json& jsonObject);
+		// Returns the number of counters filled.
+		virtual size_t FillStatsCounters(RTC::StatsPublisher::Counters& counters);
 		uint32_t GetEncodingIdx() const
 		{
 			return this->params.encodingIdx;
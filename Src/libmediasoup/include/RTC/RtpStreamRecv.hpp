@@ -2,6 +2,7 @@
 #define MS_RTC_RTP_STREAM_RECV_HPP
 
 #include "RTC/NackGenerator.hpp"
+#include "RTC/RTCP/FeedbackRtpNack.hpp"
 #include "RTC/RTCP/XrDelaySinceLastRr.hpp"
 #include "RTC/RateCalculator.hpp"
 #include "RTC/RtpStream.hpp"
@@ -49,6 +50,7 @@ namespace RTC
 		~RtpStreamRecv();
 
 		void FillJsonStats(json& jsonObject) override;
+		size_t FillStatsCounters(RTC::StatsPublisher::Counters& counters) override;
 		bool ReceivePacket(RTC::RtpPacket* packet);
 		bool ReceiveRtxPacket(RTC::RtpPacket* packet);
 		RTC::RTCP::ReceiverReport* GetRtcpReceiverReport();
@@ -111,6 +113,8 @@ namespace RTC
 		bool inactive{ false };
 		TransmissionCounter transmissionCounter;      // Valid media + valid RTX.
 		RTC::RtpDataCounter mediaTransmissionCounter; // Just valid media.
+		// Reused for every NACK sent.
+		RTC::RTCP::FeedbackRtpNackPacket nackPacket;
 	};
 } // namespace RTC
 
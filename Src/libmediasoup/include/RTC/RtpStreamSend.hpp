@@ -72,6 +72,7 @@ namespace RTC
 		~RtpStreamSend() override;
 
 		void FillJsonStats(json& jsonObject) override;
+		size_t FillStatsCounters(RTC::StatsPublisher::Counters& counters) override;
 		void SetRtx(uint8_t payloadType, uint32_t ssrc) override;
 		bool ReceivePacket(RTC::RtpPacket* packet, std::shared_ptr<RTC::RtpPacket>& sharedPacket);
 		void ReceiveNack(RTC::RTCP::FeedbackRtpNackPacket* nackPacket);
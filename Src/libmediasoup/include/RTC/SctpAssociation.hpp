@@ -5,6 +5,7 @@
 #include "Utils.hpp"
 #include "RTC/DataConsumer.hpp"
 #include "RTC/DataProducer.hpp"
+#include "RTC/MessageBuffer.hpp"
 #include <usrsctp.h>
 #include <nlohmann/json.hpp>
 
@@ -51,8 +52,7 @@ namespace RTC
 			  RTC::SctpAssociation* sctpAssociation,
 			  uint16_t streamId,
 			  uint32_t ppid,
-			  const uint8_t* msg,
-			  size_t len) = 0;
+			  RTC::MessageBuffer* message) = 0;
 			virtual void OnSctpAssociationBufferedAmount(
 			  RTC::SctpAssociation* sctpAssociation, uint32_t len) = 0;
 		};
@@ -109,8 +109,9 @@ namespace RTC
 		/* Callbacks fired by usrsctp events. */
 	public:
 		void OnUsrSctpSendSctpData(void* buffer, size_t len);
+		// Takes ownership of `data`.
 		void OnUsrSctpReceiveSctpData(
-		  uint16_t streamId, uint16_t ssn, uint32_t ppid, int flags, const uint8_t* data, size_t len);
+		  uint16_t streamId, uint16_t ssn, uint32_t ppid, int flags, uint8_t* data, size_t len);
 		void OnUsrSctpReceiveSctpNotification(union sctp_notification* notification, size_t len);
 		void OnUsrSctpSentData(uint32_t freeBuffer);
 
@@ -127,12 +128,12 @@ namespace RTC
 		size_t sctpBufferedAmount{ 0u };
 		bool isDataChannel{ false };
 		// Allocated by this.
-		uint8_t* messageBuffer{ nullptr };
+		// Message being reassembled from several chunks.
+		RTC::MessageBuffer* messageBuffer{ nullptr };
 		// Others.
 		SctpState state{ SctpState::NEW };
 		struct socket* socket{ nullptr };
 		uint16_t desiredOs{ 0u };
-		size_t messageBufferLen{ 0u };
 		uint16_t lastSsnReceived{ 0u }; // Valid for us since no SCTP I-DATA support.
 	};
 } // namespace RTC
@@ -49,6 +49,7 @@ namespace RTC
 			);
 			// clang-format on
 		}
+		bool GetForwardedMappedSsrcs(std::array<uint32_t, 2>& mappedSsrcs) const override;
 		void ProducerRtpStream(RTC::RtpStream* rtpStream, uint32_t mappedSsrc) override;
 		void ProducerNewRtpStream(RTC::RtpStream* rtpStream, uint32_t mappedSsrc) override;
 		void ProducerRtpStreamScore(RTC::RtpStream* rtpStream, uint8_t score, uint8_t previousScore) override;
@@ -0,0 +1,145 @@
+#ifndef MS_RTC_STATS_PUBLISHER_HPP
+#define MS_RTC_STATS_PUBLISHER_HPP
+
+#include "common.hpp"
+#include "PayloadChannel/PayloadChannelNotifier.hpp"
+#include "handles/Timer.hpp"
+#include <absl/container/flat_hash_map.h>
+#include <array>
+#include <string>
+#include <vector>
+
+namespace RTC
+{
+	// Periodically collects the counters of every Transport, RTP stream,
+	// DataProducer and DataConsumer of the Worker and sends the ones that
+	// changed since the previous snapshot in a single binary PayloadChannel
+	// notification ("stats" event), so monitoring does not need a getStats
+	// request and its JSON per entity.
+	//
+	// Snapshot layout (varints are LEB128, deltas are zigzag encoded):
+	//   u8 version | u8 flags | varint seq | varint timestamp (ms)
+	// followed by records, each one starting with its u8 type:
+	//   ENTITY:   varint key | u8 entryType | varint ssrc | varint idLen | id |
+	//             u8 numCounters
+	//   COUNTERS: varint key | varint changedMask | varint delta per set bit
+	//   REMOVED:  varint key
+	// An ENTITY record is sent the first time an entry is seen and its
+	// counters follow as deltas from zero. The first snapshot of a publisher
+	// has the FULL flag, so the receiver can drop any previous state.
+	class StatsPublisher : public Timer::Listener
+	{
+	public:
+		class Listener
+		{
+		public:
+			virtual ~Listener() = default;
+
+		public:
+			// Must call FillBinaryStats() on every entity.
+			virtual void OnStatsPublisherCollect(RTC::StatsPublisher* statsPublisher) = 0;
+		};
+
+	public:
+		enum class EntryType : uint8_t
+		{
+			TRANSPORT = 1,
+			INBOUND_RTP,
+			OUTBOUND_RTP,
+			DATA_PRODUCER,
+			DATA_CONSUMER
+		};
+
+		enum class RecordType : uint8_t
+		{
+			ENTITY = 1,
+			COUNTERS,
+			REMOVED
+		};
+
+	public:
+		static constexpr uint8_t Version{ 1u };
+		static constexpr uint8_t FlagFull{ 0x01 };
+		static constexpr size_t MaxCounters{ 16u };
+		static constexpr uint64_t MinIntervalMs{ 100u };
+
+	public:
+		using Counters = std::array<uint64_t, MaxCounters>;
+
+	private:
+		struct Entry
+		{
+			uint32_t key{ 0u };
+			EntryType type;
+			uint32_t ssrc{ 0u };
+			std::string id;
+			uint8_t numCounters{ 0u };
+			Counters counters{};
+			uint64_t lastSeq{ 0u };
+		};
+
+	public:
+		StatsPublisher(
+		  Listener* listener,
+		  PayloadChannel::PayloadChannelNotifier* payloadChannelNotifier,
+		  const std::string& targetId,
+		  uint64_t intervalMs);
+		~StatsPublisher() override;
+
+	public:
+		// Called by the entities while a snapshot is collected. The owner
+		// identifies the entry across snapshots.
+		void AddEntry(
+		  const void* owner,
+		  EntryType type,
+		  const std::string& id,
+		  uint32_t ssrc,
+		  const Counters& counters,
+		  size_t numCounters);
+
+	private:
+		void Publish();
+		void WriteByte(uint8_t value)
+		{
+			this->buffer.push_back(value);
+		}
+		void WriteVarint(uint64_t value)
+		{
+			while (value >= 0x80)
+			{
+				this->buffer.push_back(static_cast<uint8_t>(value) | 0x80);
+				value >>= 7;
+			}
+
+			this->buffer.push_back(static_cast<uint8_t>(value));
+		}
+		void WriteDelta(uint64_t value, uint64_t previous)
+		{
+			// Counters may also decrease (e.g. bitrates and scores).
+			const auto delta = static_cast<int64_t>(value - previous);
+
+			WriteVarint((static_cast<uint64_t>(delta) << 1) ^ static_cast<uint64_t>(delta >> 63));
+		}
+
+		/* Pure virtual methods inherited from Timer::Listener. */
+	public:
+		void OnTimer(Timer* timer) override;
+
+	private:
+		// Passed by argument.
+		Listener* listener{ nullptr };
+		PayloadChannel::PayloadChannelNotifier* payloadChannelNotifier{ nullptr };
+		std::string targetId;
+		// Allocated by this.
+		Timer* timer{ nullptr };
+		// Others.
+		absl::flat_hash_map<const void*, Entry> mapOwnerEntry;
+		std::vector<uint8_t> buffer;
+		uint64_t seq{ 0u };
+		uint32_t nextKey{ 1u };
+		// Number of records written into the current snapshot.
+		size_t numRecords{ 0u };
+	};
+} // namespace RTC
+
+#endif
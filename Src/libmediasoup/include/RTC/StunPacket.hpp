@@ -2,6 +2,7 @@
 #define MS_RTC_STUN_PACKET_HPP
 
 #include "common.hpp"
+#include "Utils.hpp"
 #include <string>
 
 namespace RTC
@@ -72,6 +73,10 @@ namespace RTC
 
 	private:
 		static const uint8_t magicCookie[];
+		// Binding success responses with XOR-MAPPED-ADDRESS, MESSAGE-INTEGRITY
+		// and FINGERPRINT, to be patched with the values of each response.
+		static const uint8_t successResponseTemplateIPv4[64];
+		static const uint8_t successResponseTemplateIPv6[76];
 
 	public:
 		StunPacket(
@@ -181,11 +186,27 @@ namespace RTC
 		}
 		Authentication CheckAuthentication(
 		  const std::string& localUsername, const std::string& localPassword);
+		// Same as above with an HMAC-SHA1 context keyed with the local password.
+		Authentication CheckAuthentication(
+		  const std::string& localUsername, Utils::Crypto::HmacSha1& localHmacSha1);
 		StunPacket* CreateSuccessResponse();
+		// Writes into the given buffer the Binding success response to this
+		// request, authenticated with the given HMAC-SHA1 context, and returns
+		// its size (0 if the address family is not valid). It does the same as
+		// CreateSuccessResponse(), SetXorMappedAddress(), Authenticate() and
+		// Serialize() without allocating a packet.
+		size_t SerializeSuccessResponse(
+		  uint8_t* buffer, const struct sockaddr* xorMappedAddress, Utils::Crypto::HmacSha1& hmacSha1) const;
 		StunPacket* CreateErrorResponse(uint16_t errorCode);
 		void Authenticate(const std::string& password);
 		void Serialize(uint8_t* buffer);
 
+	private:
+		Authentication CheckAuthentication(
+		  const std::string& localUsername,
+		  const std::string* localPassword,
+		  Utils::Crypto::HmacSha1* localHmacSha1);
+
 	private:
 		// Passed by argument.
 		Class klass;                             // 2 bytes.
@@ -18,17 +18,21 @@
 #include "RTC/RateCalculator.hpp"
 #include "RTC/RtpHeaderExtensionIds.hpp"
 #include "RTC/RtpListener.hpp"
+#include "RTC/RtpPacer.hpp"
 #include "RTC/RtpPacket.hpp"
 #include "RTC/SctpAssociation.hpp"
 #include "RTC/SctpListener.hpp"
 #include "RTC/Shared.hpp"
+#include "RTC/StatsPublisher.hpp"
 #ifdef ENABLE_RTC_SENDER_BANDWIDTH_ESTIMATOR
 #include "RTC/SenderBandwidthEstimator.hpp"
 #endif
 #include "RTC/TransportCongestionControlClient.hpp"
 #include "RTC/TransportCongestionControlServer.hpp"
+#include "handles/SendCallback.hpp"
 #include "handles/Timer.hpp"
 #include <absl/container/flat_hash_map.h>
+#include <libwebrtc/modules/rtp_rtcp/include/rtp_rtcp_defines.h> // webrtc::RtpPacketSendInfo
 #include <nlohmann/json.hpp>
 #include <string>
 
@@ -43,6 +47,7 @@ namespace RTC
 	                  public RTC::SctpAssociation::Listener,
 	                  public RTC::TransportCongestionControlClient::Listener,
 	                  public RTC::TransportCongestionControlServer::Listener,
+	                  public RTC::RtpPacer::Listener,
 	                  public Channel::ChannelSocket::RequestHandler,
 	                  public PayloadChannel::PayloadChannelSocket::RequestHandler,
 	                  public PayloadChannel::PayloadChannelSocket::NotificationHandler,
@@ -52,9 +57,22 @@ namespace RTC
 	                  public Timer::Listener
 	{
 	protected:
-		using onSendCallback   = const std::function<void(bool sent)>;
+		using onSendCallback   = ::SendCallback;
 		using onQueuedCallback = const std::function<void(bool queued, bool sctpSendBufferFull)>;
 
+	private:
+		// Data needed to notify the sending of a RTP packet once the socket
+		// reports it.
+		struct SentRtpPacketRecord
+		{
+			uint32_t seq{ 0u };
+			bool pending{ false };
+			webrtc::RtpPacketSendInfo packetInfo;
+#ifdef ENABLE_RTC_SENDER_BANDWIDTH_ESTIMATOR
+			RTC::SenderBandwidthEstimator::SentInfo sentInfo;
+#endif
+		};
+
 	public:
 		class Listener
 		{
@@ -93,6 +111,8 @@ namespace RTC
 			  RTC::Transport* transport, RTC::Consumer* consumer) = 0;
 			virtual void OnTransportConsumerKeyFrameRequested(
 			  RTC::Transport* transport, RTC::Consumer* consumer, uint32_t mappedSsrc) = 0;
+			virtual void OnTransportConsumerForwardingChanged(
+			  RTC::Transport* transport, RTC::Consumer* consumer) = 0;
 			virtual void OnTransportNewDataProducer(
 			  RTC::Transport* transport, RTC::DataProducer* dataProducer) = 0;
 			virtual void OnTransportDataProducerClosed(
@@ -101,8 +121,7 @@ namespace RTC
 			  RTC::Transport* transport,
 			  RTC::DataProducer* dataProducer,
 			  uint32_t ppid,
-			  const uint8_t* msg,
-			  size_t len) = 0;
+			  RTC::MessageBuffer* message) = 0;
 			virtual void OnTransportNewDataConsumer(
 			  RTC::Transport* transport, RTC::DataConsumer* dataConsumer, std::string& dataProducerId) = 0;
 			virtual void OnTransportDataConsumerClosed(
@@ -129,6 +148,7 @@ namespace RTC
 		// Subclasses must also invoke the parent Close().
 		virtual void FillJson(json& jsonObject) const;
 		virtual void FillJsonStats(json& jsonArray);
+		void FillBinaryStats(RTC::StatsPublisher* statsPublisher);
 
 		/* Methods inherited from Channel::ChannelSocket::RequestHandler. */
 	public:
@@ -168,10 +188,17 @@ namespace RTC
 		void SetNewDataConsumerIdFromData(json& data, std::string& dataConsumerId) const;
 		RTC::DataConsumer* GetDataConsumerFromData(json& data) const;
 
+	private:
+		static void OnSendCallback(uint64_t id, bool sent);
+
 	private:
 		virtual bool IsConnected() const = 0;
 		virtual void SendRtpPacket(
-		  RTC::Consumer* consumer, RTC::RtpPacket* packet, onSendCallback* cb = nullptr) = 0;
+		  RTC::Consumer* consumer, RTC::RtpPacket* packet, const onSendCallback& cb = {}) = 0;
+		onSendCallback CreateSendCallback(
+		  const webrtc::RtpPacketSendInfo& packetInfo, RTC::RtpPacket* packet, bool isProbation);
+		void OnRtpPacketSent(uint32_t seq, bool sent);
+		void SendConsumerRtpPacket(RTC::Consumer* consumer, RTC::RtpPacket* packet, bool retransmission);
 		void HandleRtcpPacket(RTC::RTCP::Packet* packet);
 		void SendRtcp(uint64_t nowMs);
 		virtual void SendRtcpPacket(RTC::RTCP::Packet* packet)                 = 0;
@@ -179,8 +206,7 @@ namespace RTC
 		virtual void SendMessage(
 		  RTC::DataConsumer* dataConsumer,
 		  uint32_t ppid,
-		  const uint8_t* msg,
-		  size_t len,
+		  RTC::MessageBuffer* message,
 		  onQueuedCallback* = nullptr)                             = 0;
 		virtual void SendSctpData(const uint8_t* data, size_t len) = 0;
 		virtual void RecvStreamClosed(uint32_t ssrc)               = 0;
@@ -221,6 +247,7 @@ namespace RTC
 		void OnConsumerNeedBitrateChange(RTC::Consumer* consumer) override;
 		void OnConsumerNeedZeroBitrate(RTC::Consumer* consumer) override;
 		void OnConsumerProducerClosed(RTC::Consumer* consumer) override;
+		void OnConsumerForwardingChanged(RTC::Consumer* consumer) override;
 
 		/* Pure virtual methods inherited from RTC::DataProducer::Listener. */
 	public:
@@ -229,15 +256,14 @@ namespace RTC
 			this->DataReceived(len);
 		}
 		void OnDataProducerMessageReceived(
-		  RTC::DataProducer* dataProducer, uint32_t ppid, const uint8_t* msg, size_t len) override;
+		  RTC::DataProducer* dataProducer, uint32_t ppid, RTC::MessageBuffer* message) override;
 
 		/* Pure virtual methods inherited from RTC::DataConsumer::Listener. */
 	public:
 		void OnDataConsumerSendMessage(
 		  RTC::DataConsumer* dataConsumer,
 		  uint32_t ppid,
-		  const uint8_t* msg,
-		  size_t len,
+		  RTC::MessageBuffer* message,
 		  onQueuedCallback* = nullptr) override;
 		void OnDataConsumerDataProducerClosed(RTC::DataConsumer* dataConsumer) override;
 
@@ -253,8 +279,7 @@ namespace RTC
 		  RTC::SctpAssociation* sctpAssociation,
 		  uint16_t streamId,
 		  uint32_t ppid,
-		  const uint8_t* msg,
-		  size_t len) override;
+		  RTC::MessageBuffer* message) override;
 		void OnSctpAssociationBufferedAmount(
 		  RTC::SctpAssociation* sctpAssociation, uint32_t bufferedAmount) override;
 
@@ -273,6 +298,14 @@ namespace RTC
 		void OnTransportCongestionControlServerSendRtcpPacket(
 		  RTC::TransportCongestionControlServer* tccServer, RTC::RTCP::Packet* packet) override;
 
+		/* Pure virtual methods inherited from RTC::RtpPacer::Listener. */
+	public:
+		void OnRtpPacerSendRtpPacket(
+		  RTC::RtpPacer* rtpPacer,
+		  RTC::Consumer* consumer,
+		  RTC::RtpPacket* packet,
+		  RTC::RtpPacer::Priority priority) override;
+
 #ifdef ENABLE_RTC_SENDER_BANDWIDTH_ESTIMATOR
 		/* Pure virtual methods inherited from RTC::SenderBandwidthEstimator::Listener. */
 	public:
@@ -309,6 +342,7 @@ namespace RTC
 		Timer* rtcpTimer{ nullptr };
 		std::shared_ptr<RTC::TransportCongestionControlClient> tccClient{ nullptr };
 		std::shared_ptr<RTC::TransportCongestionControlServer> tccServer{ nullptr };
+		RTC::RtpPacer* rtpPacer{ nullptr };
 #ifdef ENABLE_RTC_SENDER_BANDWIDTH_ESTIMATOR
 		std::shared_ptr<RTC::SenderBandwidthEstimator> senderBwe{ nullptr };
 #endif
@@ -325,11 +359,29 @@ namespace RTC
 		RTC::RtpDataCounter recvRtxTransmission;
 		RTC::RtpDataCounter sendRtxTransmission;
 		RTC::RtpDataCounter sendProbationTransmission;
+		RTC::RTCP::CompoundPacket rtcpCompoundPacket;
+		// Time spent building and sending RTCP in the RTCP timer.
+		uint64_t rtcpTicks{ 0u };
+		uint64_t rtcpTickTimeNs{ 0u };
+		uint64_t maxRtcpTickTimeNs{ 0u };
 		uint16_t transportWideCcSeq{ 0u };
 		uint32_t initialAvailableOutgoingBitrate{ 600000u };
 		uint32_t maxIncomingBitrate{ 0u };
 		uint32_t maxOutgoingBitrate{ 0u };
 		struct TraceEventTypes traceEventTypes;
+		// Records of the RTP packets whose sending is pending to be notified,
+		// indexed by seq. Its size is a power of 2.
+		std::vector<SentRtpPacketRecord> sentRtpPacketRecords;
+		uint32_t sentRtpPacketRecordSeq{ 0u };
+		// Index in sendCallbackSlots.
+		uint32_t sendCallbackSlot{ 0u };
+
+	private:
+		// Transports which send callbacks may refer to, plus a generation which
+		// is bumped when the slot is released so callbacks of a closed Transport
+		// are ignored.
+		thread_local static std::vector<std::pair<Transport*, uint16_t>> sendCallbackSlots;
+		thread_local static std::vector<uint32_t> freeSendCallbackSlots;
 	};
 } // namespace RTC
 
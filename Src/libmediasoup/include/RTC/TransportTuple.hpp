@@ -15,7 +15,7 @@ namespace RTC
 	class TransportTuple
 	{
 	protected:
-		using onSendCallback = const std::function<void(bool sent)>;
+		using onSendCallback = ::SendCallback;
 
 	public:
 		enum class Protocol
@@ -85,7 +85,8 @@ namespace RTC
 			this->localAnnouncedIp = localAnnouncedIp;
 		}
 
-		void Send(const uint8_t* data, size_t len, RTC::TransportTuple::onSendCallback* cb = nullptr)
+		void Send(
+		  const uint8_t* data, size_t len, const RTC::TransportTuple::onSendCallback& cb = {})
 		{
 			if (this->protocol == Protocol::UDP)
 				this->udpSocket->Send(data, len, this->udpRemoteAddr, cb);
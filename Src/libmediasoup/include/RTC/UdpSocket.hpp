@@ -23,6 +23,10 @@ namespace RTC
 	public:
 		UdpSocket(Listener* listener, std::string& ip);
 		UdpSocket(Listener* listener, std::string& ip, uint16_t port);
+		// Socket sharing ip:port with other workers (SO_REUSEPORT).
+		UdpSocket(Listener* listener, std::string& ip, uint16_t port, bool reusePort);
+		// Socket in the ip:port reuseport group connected to the given remote.
+		UdpSocket(Listener* listener, std::string& ip, uint16_t port, const struct sockaddr* remoteAddr);
 		~UdpSocket() override;
 
 		/* Pure virtual methods inherited from ::UdpSocketHandler. */
@@ -31,20 +31,26 @@ namespace RTC
 			std::string ip;
 			std::string announcedIp;
 			uint16_t port;
+			bool reusePort{ false };
 		};
 
 	private:
 		struct UdpSocketOrTcpServer
 		{
 			// Expose a constructor to use vector.emplace_back().
-			UdpSocketOrTcpServer(RTC::UdpSocket* udpSocket, RTC::TcpServer* tcpServer, std::string& announcedIp)
-			  : udpSocket(udpSocket), tcpServer(tcpServer), announcedIp(announcedIp)
+			UdpSocketOrTcpServer(
+			  RTC::UdpSocket* udpSocket,
+			  RTC::TcpServer* tcpServer,
+			  std::string& announcedIp,
+			  bool reusePort = false)
+			  : udpSocket(udpSocket), tcpServer(tcpServer), announcedIp(announcedIp), reusePort(reusePort)
 			{
 			}
 
 			RTC::UdpSocket* udpSocket;
 			RTC::TcpServer* tcpServer;
 			std::string announcedIp;
+			bool reusePort;
 		};
 
 	public:
@@ -65,6 +71,8 @@ namespace RTC
 		void OnPacketReceived(RTC::TransportTuple* tuple, const uint8_t* data, size_t len);
 		void OnStunDataReceived(RTC::TransportTuple* tuple, const uint8_t* data, size_t len);
 		void OnNonStunDataReceived(RTC::TransportTuple* tuple, const uint8_t* data, size_t len);
+		void ConnectUdpSocket(RTC::TransportTuple* tuple);
+		void DisconnectUdpSocket(RTC::TransportTuple* tuple);
 
 		/* Pure virtual methods inherited from RTC::WebRtcTransport::WebRtcTransportListener. */
 	public:
@@ -78,6 +86,8 @@ namespace RTC
 		  RTC::WebRtcTransport* webRtcTransport, RTC::TransportTuple* tuple) override;
 		void OnWebRtcTransportTransportTupleRemoved(
 		  RTC::WebRtcTransport* webRtcTransport, RTC::TransportTuple* tuple) override;
+		const std::string& OnWebRtcTransportNeedLocalIceUsernameFragmentPrefix(
+		  RTC::WebRtcTransport* webRtcTransport) override;
 
 		/* Pure virtual methods inherited from RTC::UdpSocket::Listener. */
 	public:
@@ -108,6 +118,14 @@ namespace RTC
 		absl::flat_hash_map<std::string, RTC::WebRtcTransport*> mapLocalIceUsernameFragmentWebRtcTransport;
 		// Map of WebRtcTransports indexed by TransportTuple.hash.
 		absl::flat_hash_map<uint64_t, RTC::WebRtcTransport*> mapTupleWebRtcTransport;
+		// Prefix of local ICE usernameFragments (index of this worker in the
+		// reuseport group of the shared UDP ports). Empty if no port is shared.
+		std::string localIceUsernameFragmentPrefix;
+		// Sockets connected to the remote of a tuple of a shared UDP port, indexed
+		// by TransportTuple.hash.
+		absl::flat_hash_map<uint64_t, RTC::UdpSocket*> mapTupleConnectedUdpSocket;
+		// Shared UDP socket of each connected socket.
+		absl::flat_hash_map<RTC::UdpSocket*, RTC::UdpSocket*> mapConnectedUdpSocketUdpSocket;
 	};
 } // namespace RTC
 
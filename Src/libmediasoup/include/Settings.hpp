@@ -39,6 +39,8 @@ public:
 		std::string dtlsCertificateFile;
 		std::string dtlsPrivateKeyFile;
 		std::string libwebrtcFieldTrials{ "WebRTC-Bwe-AlrLimitedBackoff/Enabled/" };
+		// Channel messages use the binary format instead of JSON text.
+		bool binaryChannel{ false };
 	};
 
 public:
@@ -49,6 +51,7 @@ public:
 private:
 	static void SetLogLevel(std::string& level);
 	static void SetLogTags(const std::vector<std::string>& tags);
+	static void SetChannelFormat(const std::string& format);
 	static void SetDtlsCertificateAndPrivateKeyFiles();
 
 public:
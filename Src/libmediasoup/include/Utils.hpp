@@ -198,6 +198,27 @@ namespace Utils
 
 	class Crypto
 	{
+	public:
+		// HMAC-SHA1 context keyed once, so computing the HMAC of every message
+		// authenticated with the same key (e.g. the STUN messages of an ICE
+		// session) does not pay for the key setup and the digest lookup.
+		class HmacSha1
+		{
+		public:
+			HmacSha1() = default;
+			HmacSha1& operator=(const HmacSha1&) = delete;
+			HmacSha1(const HmacSha1&)            = delete;
+			~HmacSha1();
+
+		public:
+			void SetKey(const std::string& key);
+			const uint8_t* GetHmac(const uint8_t* data, size_t len);
+
+		private:
+			EVP_MAC_CTX* ctx{ nullptr };
+			uint8_t buffer[20];
+		};
+
 	public:
 		static void ClassInit();
 		static void ClassDestroy();
@@ -9,6 +9,7 @@
 #include "PayloadChannel/PayloadChannelSocket.hpp"
 #include "RTC/Router.hpp"
 #include "RTC/Shared.hpp"
+#include "RTC/StatsPublisher.hpp"
 #include "RTC/WebRtcServer.hpp"
 #include "handles/SignalsHandler.hpp"
 #include <absl/container/flat_hash_map.h>
@@ -20,7 +21,8 @@ using json = nlohmann::json;
 class Worker : public Channel::ChannelSocket::Listener,
                public PayloadChannel::PayloadChannelSocket::Listener,
                public SignalsHandler::Listener,
-               public RTC::Router::Listener
+               public RTC::Router::Listener,
+               public RTC::StatsPublisher::Listener
 {
 public:
 	explicit Worker(Channel::ChannelSocket* channel, PayloadChannel::PayloadChannelSocket* payloadChannel);
@@ -63,6 +65,10 @@ public:
 public:
 	RTC::WebRtcServer* OnRouterNeedWebRtcServer(RTC::Router* router, std::string& webRtcServerId) override;
 
+	/* Pure virtual methods inherited from RTC::StatsPublisher::Listener. */
+public:
+	void OnStatsPublisherCollect(RTC::StatsPublisher* statsPublisher) override;
+
 private:
 	// Passed by argument.
 	Channel::ChannelSocket* channel{ nullptr };
@@ -72,6 +78,7 @@ private:
 	RTC::Shared* shared{ nullptr };
 	absl::flat_hash_map<std::string, RTC::WebRtcServer*> mapWebRtcServers;
 	absl::flat_hash_map<std::string, RTC::Router*> mapRouters;
+	RTC::StatsPublisher* statsPublisher{ nullptr };
 	// Others.
 	bool closed{ false };
 };
@@ -54,12 +54,17 @@ using PayloadChannelReadFn = PayloadChannelReadFreeFn (*)(
   const void* /* handle */,
   PayloadChannelReadCtx /* ctx */);
 
-using PayloadChannelWriteCtx = void*;
-using PayloadChannelWriteFn  = void (*)(
+// Reference counted buffer holding `payload`, or null. Given it, the writer may keep the payload
+// (with `mediasoup_payload_ref()`) instead of copying it, and must then release it (with
+// `mediasoup_payload_unref()`) once done with it.
+using PayloadChannelPayloadRef = void*;
+using PayloadChannelWriteCtx   = void*;
+using PayloadChannelWriteFn    = void (*)(
   const uint8_t* /* message */,
   uint32_t /* messageLen */,
   const uint8_t* /* payload */,
   uint32_t /* payloadLen */,
+  PayloadChannelPayloadRef /* payloadRef */,
   ChannelWriteCtx /* ctx */);
 
 #endif
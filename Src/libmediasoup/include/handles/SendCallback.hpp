@@ -0,0 +1,36 @@
+#ifndef MS_SEND_CALLBACK_HPP
+#define MS_SEND_CALLBACK_HPP
+
+#include "common.hpp"
+
+// Notifies whether a datagram or a TCP write was sent. It is a plain function
+// plus an opaque id, so it is copied around and queued without allocating.
+// The callback may be invoked once the sender is gone, so the handler must
+// validate the id.
+class SendCallback
+{
+public:
+	using Handler = void (*)(uint64_t id, bool sent);
+
+public:
+	SendCallback() = default;
+	SendCallback(Handler handler, uint64_t id) : handler(handler), id(id)
+	{
+	}
+
+public:
+	explicit operator bool() const
+	{
+		return this->handler != nullptr;
+	}
+	void operator()(bool sent) const
+	{
+		this->handler(this->id, sent);
+	}
+
+private:
+	Handler handler{ nullptr };
+	uint64_t id{ 0u };
+};
+
+#endif
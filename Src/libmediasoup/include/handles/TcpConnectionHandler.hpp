@@ -2,13 +2,14 @@
 #define MS_TCP_CONNECTION_HPP
 
 #include "common.hpp"
+#include "handles/SendCallback.hpp"
 #include <uv.h>
 #include <string>
 
 class TcpConnectionHandler
 {
 protected:
-	using onSendCallback = const std::function<void(bool sent)>;
+	using onSendCallback = SendCallback;
 
 public:
 	class Listener
@@ -35,12 +36,11 @@ public:
 		~UvWriteData()
 		{
 			delete[] this->store;
-			delete this->cb;
 		}
 
 		uv_write_t req;
 		uint8_t* store{ nullptr };
-		TcpConnectionHandler::onSendCallback* cb{ nullptr };
+		TcpConnectionHandler::onSendCallback cb;
 	};
 
 public:
@@ -71,7 +71,7 @@ public:
 	  size_t len1,
 	  const uint8_t* data2,
 	  size_t len2,
-	  TcpConnectionHandler::onSendCallback* cb);
+	  const TcpConnectionHandler::onSendCallback& cb);
 	void ErrorReceiving();
 	const struct sockaddr* GetLocalAddress() const
 	{
@@ -117,7 +117,7 @@ private:
 public:
 	void OnUvReadAlloc(size_t suggestedSize, uv_buf_t* buf);
 	void OnUvRead(ssize_t nread, const uv_buf_t* buf);
-	void OnUvWrite(int status, onSendCallback* cb);
+	void OnUvWrite(int status, const onSendCallback& cb);
 
 	/* Pure virtual methods that must be implemented by the subclass. */
 protected:
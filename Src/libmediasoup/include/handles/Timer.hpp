@@ -2,10 +2,12 @@
 #define MS_TIMER_HPP
 
 #include "common.hpp"
-#include <uv.h>
+#include "handles/TimerWheel.hpp"
 
 class Timer
 {
+	friend class TimerWheel;
+
 public:
 	class Listener
 	{
@@ -38,22 +40,26 @@ public:
 	}
 	bool IsActive() const
 	{
-		return uv_is_active(reinterpret_cast<uv_handle_t*>(this->uvHandle)) != 0;
+		return this->slot != nullptr;
 	}
 
-	/* Callbacks fired by UV events. */
+	/* Callbacks fired by the TimerWheel. */
 public:
-	void OnUvTimer();
+	void OnTimer();
 
 private:
 	// Passed by argument.
 	Listener* listener{ nullptr };
-	// Allocated by this.
-	uv_timer_t* uvHandle{ nullptr };
 	// Others.
+	TimerWheel* wheel{ nullptr };
 	bool closed{ false };
 	uint64_t timeout{ 0u };
 	uint64_t repeat{ 0u };
+	// Managed by the TimerWheel.
+	TimerWheel::Slot* slot{ nullptr };
+	Timer* prev{ nullptr };
+	Timer* next{ nullptr };
+	uint64_t expiresAt{ 0u };
 };
 
 #endif
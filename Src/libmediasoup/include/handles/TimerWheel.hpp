@@ -0,0 +1,73 @@
+#ifndef MS_TIMER_WHEEL_HPP
+#define MS_TIMER_WHEEL_HPP
+
+#include "common.hpp"
+#include <uv.h>
+#include <array>
+
+class Timer;
+
+// Per Worker (thread local) hierarchical timer wheel with 1 ms resolution
+// which drives all the Timer instances with a single uv_timer_t, so starting
+// and stopping a Timer is O(1) regardless of how many of them are active.
+class TimerWheel
+{
+public:
+	// List of the Timers expiring in the same tick (or range of ticks in upper
+	// levels).
+	struct Slot
+	{
+		Timer* head{ nullptr };
+	};
+
+private:
+	static constexpr size_t SlotBits{ 8u };
+	static constexpr size_t NumSlots{ 1u << SlotBits };
+	static constexpr uint64_t SlotMask{ NumSlots - 1 };
+	// 4 levels cover up to 2^32 ms (~49 days), longer timeouts are clamped.
+	static constexpr size_t NumLevels{ 4u };
+
+public:
+	// Called by every Timer on creation and destruction.
+	static TimerWheel* Acquire();
+	static void Release();
+
+private:
+	static void Unlink(Timer* timer, Slot* slot);
+
+private:
+	TimerWheel();
+	~TimerWheel();
+
+public:
+	void Add(Timer* timer, uint64_t timeout);
+	void Remove(Timer* timer);
+
+	/* Callbacks fired by UV events. */
+public:
+	void OnUvTimer();
+
+private:
+	void Insert(Timer* timer);
+	void Cascade(size_t level, size_t index);
+	void Arm(uint64_t wakeAt);
+	void ArmNext();
+
+private:
+	// Allocated by this.
+	uv_timer_t* uvHandle{ nullptr };
+	// Others.
+	std::array<std::array<Slot, NumSlots>, NumLevels> levels;
+	// Next tick (loop time in ms) to be processed.
+	uint64_t nextTick{ 0u };
+	// Loop time at which the uv_timer_t fires, 0 if not armed.
+	uint64_t armedAt{ 0u };
+	size_t numActiveTimers{ 0u };
+	bool processing{ false };
+
+private:
+	thread_local static TimerWheel* wheel;
+	thread_local static size_t numTimers;
+};
+
+#endif
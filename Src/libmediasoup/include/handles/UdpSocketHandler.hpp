@@ -2,13 +2,18 @@
 #define MS_UDP_SOCKET_HPP
 
 #include "common.hpp"
+#include "handles/SendCallback.hpp"
+#include <nlohmann/json.hpp>
 #include <uv.h>
 #include <string>
+#include <vector>
+
+using json = nlohmann::json;
 
 class UdpSocketHandler
 {
 protected:
-	using onSendCallback = const std::function<void(bool sent)>;
+	using onSendCallback = SendCallback;
 
 public:
 	/* Struct for the data field of uv_req_t when sending a datagram. */
@@ -25,14 +30,52 @@ public:
 		~UvSendData()
 		{
 			delete[] this->store;
-			delete this->cb;
 		}
 
 		uv_udp_send_t req;
 		uint8_t* store{ nullptr };
-		UdpSocketHandler::onSendCallback* cb{ nullptr };
+		UdpSocketHandler::onSendCallback cb;
 	};
 
+private:
+	/* Result of SendDatagram(). */
+	enum SendResult : int
+	{
+		FAILED = 0,
+		SENT,
+		// Sent asynchronously, the callback is invoked once done.
+		PENDING
+	};
+
+	/* Datagram queued until the socket is flushed. */
+	struct PendingDatagram
+	{
+		size_t GetSize() const
+		{
+			return this->len + this->borrowedLen;
+		}
+
+		// Head of the datagram, copied into the batch buffer.
+		const uint8_t* data{ nullptr };
+		size_t len{ 0u };
+		// Rest of the datagram, referenced within a borrowed buffer.
+		const uint8_t* borrowedData{ nullptr };
+		size_t borrowedLen{ 0u };
+		struct sockaddr_storage addr;
+		UdpSocketHandler::onSendCallback cb;
+	};
+
+public:
+	static void ClassInit();
+	static void ClassDestroy();
+	// Sends the datagrams queued by every UdpSocketHandler in this thread.
+	static void FlushAll();
+	// Datagrams sent from now on are referenced instead of copied as far as
+	// they lie within the given buffer, which must stay valid and unchanged
+	// until FlushAll() is called.
+	static void BorrowBuffer(const uint8_t* data, size_t len);
+	static void FillJsonSendStats(json& jsonObject);
+
 public:
 	/**
 	 * uvHandle must be an already initialized and binded uv_udp_t pointer.
@@ -50,7 +93,11 @@ public:
 	}
 	virtual void Dump() const;
 	void Send(
-	  const uint8_t* data, size_t len, const struct sockaddr* addr, UdpSocketHandler::onSendCallback* cb);
+	  const uint8_t* data,
+	  size_t len,
+	  const struct sockaddr* addr,
+	  const UdpSocketHandler::onSendCallback& cb);
+	void Flush();
 	const struct sockaddr* GetLocalAddress() const
 	{
 		return reinterpret_cast<const struct sockaddr*>(&this->localAddr);
@@ -78,12 +125,21 @@ public:
 
 private:
 	bool SetLocalAddress();
+	void FlushPending();
+	size_t SendBatch(std::vector<PendingDatagram>& datagrams);
+	int SendDatagram(
+	  const uint8_t* data,
+	  size_t len,
+	  const uint8_t* borrowedData,
+	  size_t borrowedLen,
+	  const struct sockaddr* addr,
+	  const UdpSocketHandler::onSendCallback& cb);
 
 	/* Callbacks fired by UV events. */
 public:
 	void OnUvRecvAlloc(size_t suggestedSize, uv_buf_t* buf);
 	void OnUvRecv(ssize_t nread, const uv_buf_t* buf, const struct sockaddr* addr, unsigned int flags);
-	void OnUvSend(int status, UdpSocketHandler::onSendCallback* cb);
+	void OnUvSend(int status, const UdpSocketHandler::onSendCallback& cb);
 
 	/* Pure virtual methods that must be implemented by the subclass. */
 protected:
@@ -102,6 +158,10 @@ private:
 	bool closed{ false };
 	size_t recvBytes{ 0u };
 	size_t sentBytes{ 0u };
+	// Datagrams queued during the current loop iteration.
+	std::vector<PendingDatagram> pendingDatagrams;
+	bool pendingFlush{ false };
+	bool gsoDisabled{ false };
 };
 
 #endif
@@ -16,3 +16,8 @@ extern "C" int mediasoup_worker_run(
   PayloadChannelReadCtx payloadChannelReadCtx,
   PayloadChannelWriteFn payloadChannelWriteFn,
   PayloadChannelWriteCtx payloadChannelWriteCtx);
+
+// Keeps and releases the payload given to `PayloadChannelWriteFn` along with `payloadRef`. They
+// may be called from any thread.
+extern "C" void mediasoup_payload_ref(PayloadChannelPayloadRef payloadRef);
+extern "C" void mediasoup_payload_unref(PayloadChannelPayloadRef payloadRef);
@@ -15,6 +15,13 @@ namespace Channel
 	{
 		MS_TRACE();
 
+		if (this->channel->IsBinary())
+		{
+			this->channel->SendBinaryNotification(std::to_string(targetId), event, nullptr);
+
+			return;
+		}
+
 		json jsonNotification = json::object();
 
 		jsonNotification["targetId"] = targetId;
@@ -27,6 +34,13 @@ namespace Channel
 	{
 		MS_TRACE();
 
+		if (this->channel->IsBinary())
+		{
+			this->channel->SendBinaryNotification(targetId, event, nullptr);
+
+			return;
+		}
+
 		json jsonNotification = json::object();
 
 		jsonNotification["targetId"] = targetId;
@@ -39,6 +53,13 @@ namespace Channel
 	{
 		MS_TRACE();
 
+		if (this->channel->IsBinary())
+		{
+			this->channel->SendBinaryNotification(targetId, event, std::addressof(data));
+
+			return;
+		}
+
 		json jsonNotification = json::object();
 
 		jsonNotification["targetId"] = targetId;
@@ -52,6 +73,15 @@ namespace Channel
 	{
 		MS_TRACE();
 
+		if (this->channel->IsBinary())
+		{
+			json jsonData = json::parse(data);
+
+			this->channel->SendBinaryNotification(targetId, event, std::addressof(jsonData));
+
+			return;
+		}
+
 		std::string notification("{\"targetId\":\"");
 
 		notification.append(targetId);
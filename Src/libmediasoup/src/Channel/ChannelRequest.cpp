@@ -5,73 +5,31 @@
 #include "Logger.hpp"
 #include "MediaSoupErrors.hpp"
 #include "Utils.hpp"
+#include "Channel/ChannelSocket.hpp"
+#include <cstring> // std::memcpy()
 
 namespace Channel
 {
 	/* Class variables. */
 
-	// clang-format off
 	absl::flat_hash_map<std::string, ChannelRequest::MethodId> ChannelRequest::string2MethodId =
 	{
-		{ "worker.close",                                ChannelRequest::MethodId::WORKER_CLOSE                                     },
-		{ "worker.dump",                                 ChannelRequest::MethodId::WORKER_DUMP                                      },
-		{ "worker.getResourceUsage",                     ChannelRequest::MethodId::WORKER_GET_RESOURCE_USAGE                        },
-		{ "worker.updateSettings",                       ChannelRequest::MethodId::WORKER_UPDATE_SETTINGS                           },
-		{ "worker.createWebRtcServer",                   ChannelRequest::MethodId::WORKER_CREATE_WEBRTC_SERVER                      },
-		{ "worker.createRouter",                         ChannelRequest::MethodId::WORKER_CREATE_ROUTER                             },
-		{ "worker.closeWebRtcServer",                    ChannelRequest::MethodId::WORKER_WEBRTC_SERVER_CLOSE                       },
-		{ "webRtcServer.dump",                           ChannelRequest::MethodId::WEBRTC_SERVER_DUMP                               },
-		{ "worker.closeRouter",                          ChannelRequest::MethodId::WORKER_CLOSE_ROUTER                              },
-		{ "router.dump",                                 ChannelRequest::MethodId::ROUTER_DUMP                                      },
-		{ "router.createWebRtcTransport",                ChannelRequest::MethodId::ROUTER_CREATE_WEBRTC_TRANSPORT                   },
-		{ "router.createWebRtcTransportWithServer",      ChannelRequest::MethodId::ROUTER_CREATE_WEBRTC_TRANSPORT_WITH_SERVER       },
-		{ "router.createPlainTransport",                 ChannelRequest::MethodId::ROUTER_CREATE_PLAIN_TRANSPORT                    },
-		{ "router.createPipeTransport",                  ChannelRequest::MethodId::ROUTER_CREATE_PIPE_TRANSPORT                     },
-		{ "router.createDirectTransport",                ChannelRequest::MethodId::ROUTER_CREATE_DIRECT_TRANSPORT                   },
-		{ "router.closeTransport",                       ChannelRequest::MethodId::ROUTER_CLOSE_TRANSPORT                           },
-		{ "router.createActiveSpeakerObserver",          ChannelRequest::MethodId::ROUTER_CREATE_ACTIVE_SPEAKER_OBSERVER            },
-		{ "router.createAudioLevelObserver",             ChannelRequest::MethodId::ROUTER_CREATE_AUDIO_LEVEL_OBSERVER               },
-		{ "router.closeRtpObserver",                     ChannelRequest::MethodId::ROUTER_CLOSE_RTP_OBSERVER                        },
-		{ "transport.dump",                              ChannelRequest::MethodId::TRANSPORT_DUMP                                   },
-		{ "transport.getStats",                          ChannelRequest::MethodId::TRANSPORT_GET_STATS                              },
-		{ "transport.connect",                           ChannelRequest::MethodId::TRANSPORT_CONNECT                                },
-		{ "transport.setMaxIncomingBitrate",             ChannelRequest::MethodId::TRANSPORT_SET_MAX_INCOMING_BITRATE               },
-		{ "transport.setMaxOutgoingBitrate",             ChannelRequest::MethodId::TRANSPORT_SET_MAX_OUTGOING_BITRATE               },
-		{ "transport.restartIce",                        ChannelRequest::MethodId::TRANSPORT_RESTART_ICE                            },
-		{ "transport.produce",                           ChannelRequest::MethodId::TRANSPORT_PRODUCE                                },
-		{ "transport.consume",                           ChannelRequest::MethodId::TRANSPORT_CONSUME                                },
-		{ "transport.produceData",                       ChannelRequest::MethodId::TRANSPORT_PRODUCE_DATA                           },
-		{ "transport.consumeData",                       ChannelRequest::MethodId::TRANSPORT_CONSUME_DATA                           },
-		{ "transport.enableTraceEvent",                  ChannelRequest::MethodId::TRANSPORT_ENABLE_TRACE_EVENT                     },
-		{ "transport.closeProducer",                     ChannelRequest::MethodId::TRANSPORT_CLOSE_PRODUCER                         },
-		{ "transport.closeConsumer",                     ChannelRequest::MethodId::TRANSPORT_CLOSE_CONSUMER                         },
-		{ "transport.closeDataProducer",                 ChannelRequest::MethodId::TRANSPORT_CLOSE_DATA_PRODUCER                    },
-		{ "transport.closeDataConsumer",                 ChannelRequest::MethodId::TRANSPORT_CLOSE_DATA_CONSUMER                    },
-		{ "producer.dump",                               ChannelRequest::MethodId::PRODUCER_DUMP                                    },
-		{ "producer.getStats",                           ChannelRequest::MethodId::PRODUCER_GET_STATS                               },
-		{ "producer.pause",                              ChannelRequest::MethodId::PRODUCER_PAUSE                                   },
-		{ "producer.resume" ,                            ChannelRequest::MethodId::PRODUCER_RESUME                                  },
-		{ "producer.enableTraceEvent",                   ChannelRequest::MethodId::PRODUCER_ENABLE_TRACE_EVENT                      },
-		{ "consumer.dump",                               ChannelRequest::MethodId::CONSUMER_DUMP                                    },
-		{ "consumer.getStats",                           ChannelRequest::MethodId::CONSUMER_GET_STATS                               },
-		{ "consumer.pause",                              ChannelRequest::MethodId::CONSUMER_PAUSE                                   },
-		{ "consumer.resume",                             ChannelRequest::MethodId::CONSUMER_RESUME                                  },
-		{ "consumer.setPreferredLayers",                 ChannelRequest::MethodId::CONSUMER_SET_PREFERRED_LAYERS                    },
-		{ "consumer.setPriority",                        ChannelRequest::MethodId::CONSUMER_SET_PRIORITY                            },
-		{ "consumer.requestKeyFrame",                    ChannelRequest::MethodId::CONSUMER_REQUEST_KEY_FRAME                       },
-		{ "consumer.enableTraceEvent",                   ChannelRequest::MethodId::CONSUMER_ENABLE_TRACE_EVENT                      },
-		{ "dataProducer.dump",                           ChannelRequest::MethodId::DATA_PRODUCER_DUMP                               },
-		{ "dataProducer.getStats",                       ChannelRequest::MethodId::DATA_PRODUCER_GET_STATS                          },
-		{ "dataConsumer.dump",                           ChannelRequest::MethodId::DATA_CONSUMER_DUMP                               },
-		{ "dataConsumer.getStats",                       ChannelRequest::MethodId::DATA_CONSUMER_GET_STATS                          },
-		{ "dataConsumer.getBufferedAmount",              ChannelRequest::MethodId::DATA_CONSUMER_GET_BUFFERED_AMOUNT                },
-		{ "dataConsumer.setBufferedAmountLowThreshold",  ChannelRequest::MethodId::DATA_CONSUMER_SET_BUFFERED_AMOUNT_LOW_THRESHOLD  },
-		{ "rtpObserver.pause",                           ChannelRequest::MethodId::RTP_OBSERVER_PAUSE                               },
-		{ "rtpObserver.resume",                          ChannelRequest::MethodId::RTP_OBSERVER_RESUME                              },
-		{ "rtpObserver.addProducer",                     ChannelRequest::MethodId::RTP_OBSERVER_ADD_PRODUCER                        },
-		{ "rtpObserver.removeProducer",                  ChannelRequest::MethodId::RTP_OBSERVER_REMOVE_PRODUCER                     }
+#define MS_CHANNEL_METHOD_ENTRY(name, method, id) { method, ChannelRequest::MethodId::name },
+		MS_CHANNEL_METHODS(MS_CHANNEL_METHOD_ENTRY)
+#undef MS_CHANNEL_METHOD_ENTRY
 	};
-	// clang-format on
+
+	absl::flat_hash_map<ChannelRequest::MethodId, std::string> ChannelRequest::methodId2String = []()
+	{
+		absl::flat_hash_map<ChannelRequest::MethodId, std::string> map;
+
+		for (const auto& kv : ChannelRequest::string2MethodId)
+		{
+			map[kv.second] = kv.first;
+		}
+
+		return map;
+	}();
 
 	/* Instance methods. */
 
@@ -86,52 +44,10 @@ namespace Channel
 	{
 		MS_TRACE();
 
-		auto info = Utils::String::Split(std::string(msg, msgLen), ':', 3);
-
-		if (info.size() < 2)
-			MS_THROW_ERROR("too few arguments");
-
-		this->id     = std::stoul(info[0]);
-		this->method = info[1];
-
-		auto methodIdIt = ChannelRequest::string2MethodId.find(this->method);
-
-		if (methodIdIt == ChannelRequest::string2MethodId.end())
-		{
-			Error("unknown method");
-
-			MS_THROW_ERROR("unknown method '%s'", this->method.c_str());
-		}
-
-		this->methodId = methodIdIt->second;
-
-		if (info.size() > 2)
-		{
-			auto& handlerId = info[2];
-
-			if (handlerId != "undefined")
-				this->handlerId = handlerId;
-		}
-
-		if (info.size() > 3)
-		{
-			auto& data = info[3];
-
-			if (data != "undefined")
-			{
-				try
-				{
-					this->data = json::parse(data);
-
-					if (!this->data.is_object())
-						this->data = json::object();
-				}
-				catch (const json::parse_error& error)
-				{
-					MS_THROW_TYPE_ERROR("JSON parsing error: %s", error.what());
-				}
-			}
-		}
+		if (this->channel->IsBinary())
+			ParseBinary(msg, msgLen);
+		else
+			ParseText(msg, msgLen);
 	}
 
 	ChannelRequest::~ChannelRequest()
@@ -147,6 +63,14 @@ namespace Channel
 
 		this->replied = true;
 
+		if (this->channel->IsBinary())
+		{
+			this->channel->SendBinaryResponse(
+			  this->id, ChannelSocket::MessageKind::RESPONSE_ACCEPTED, nullptr, nullptr);
+
+			return;
+		}
+
 		std::string response("{\"id\":");
 
 		response.append(std::to_string(this->id));
@@ -163,12 +87,23 @@ namespace Channel
 
 		this->replied = true;
 
+		if (this->channel->IsBinary())
+		{
+			this->channel->SendBinaryResponse(
+			  this->id,
+			  ChannelSocket::MessageKind::RESPONSE_ACCEPTED,
+			  data.is_null() ? nullptr : std::addressof(data),
+			  nullptr);
+
+			return;
+		}
+
 		json jsonResponse = json::object();
 
 		jsonResponse["id"]       = this->id;
 		jsonResponse["accepted"] = true;
 
-		if (data.is_structured())
+		if (!data.is_null())
 			jsonResponse["data"] = data;
 
 		this->channel->Send(jsonResponse);
@@ -182,6 +117,14 @@ namespace Channel
 
 		this->replied = true;
 
+		if (this->channel->IsBinary())
+		{
+			this->channel->SendBinaryResponse(
+			  this->id, ChannelSocket::MessageKind::RESPONSE_ERROR, nullptr, reason);
+
+			return;
+		}
+
 		json jsonResponse = json::object();
 
 		jsonResponse["id"]    = this->id;
@@ -201,6 +144,14 @@ namespace Channel
 
 		this->replied = true;
 
+		if (this->channel->IsBinary())
+		{
+			this->channel->SendBinaryResponse(
+			  this->id, ChannelSocket::MessageKind::RESPONSE_TYPE_ERROR, nullptr, reason);
+
+			return;
+		}
+
 		json jsonResponse = json::object();
 
 		jsonResponse["id"]    = this->id;
@@ -211,4 +162,110 @@ namespace Channel
 
 		this->channel->Send(jsonResponse);
 	}
+
+	void ChannelRequest::ParseText(const char* msg, size_t msgLen)
+	{
+		MS_TRACE();
+
+		auto info = Utils::String::Split(std::string(msg, msgLen), ':', 3);
+
+		if (info.size() < 2)
+			MS_THROW_ERROR("too few arguments");
+
+		this->id     = std::stoul(info[0]);
+		this->method = info[1];
+
+		auto methodIdIt = ChannelRequest::string2MethodId.find(this->method);
+
+		if (methodIdIt == ChannelRequest::string2MethodId.end())
+		{
+			Error("unknown method");
+
+			MS_THROW_ERROR("unknown method '%s'", this->method.c_str());
+		}
+
+		this->methodId = methodIdIt->second;
+
+		if (info.size() > 2)
+		{
+			auto& handlerId = info[2];
+
+			if (handlerId != "undefined")
+				this->handlerId = handlerId;
+		}
+
+		if (info.size() > 3)
+		{
+			auto& data = info[3];
+
+			if (data != "undefined")
+			{
+				try
+				{
+					this->data = json::parse(data);
+
+					if (!this->data.is_object())
+						this->data = json::object();
+				}
+				catch (const json::parse_error& error)
+				{
+					MS_THROW_TYPE_ERROR("JSON parsing error: %s", error.what());
+				}
+			}
+		}
+	}
+
+
+	void ChannelRequest::ParseBinary(const char* msg, size_t msgLen)
+	{
+		MS_TRACE();
+
+		static constexpr size_t HeaderLen{ sizeof(uint32_t) + 2 * sizeof(uint16_t) };
+
+		if (msgLen < HeaderLen)
+			MS_THROW_ERROR("too few arguments");
+
+		uint16_t methodId;
+		uint16_t handlerIdLen;
+
+		std::memcpy(&this->id, msg, sizeof(uint32_t));
+		std::memcpy(&methodId, msg + sizeof(uint32_t), sizeof(uint16_t));
+		std::memcpy(&handlerIdLen, msg + sizeof(uint32_t) + sizeof(uint16_t), sizeof(uint16_t));
+
+		auto methodIt = ChannelRequest::methodId2String.find(static_cast<MethodId>(methodId));
+
+		if (methodIt == ChannelRequest::methodId2String.end())
+		{
+			Error("unknown method");
+
+			MS_THROW_ERROR("unknown method id %" PRIu16, methodId);
+		}
+
+		this->methodId = methodIt->first;
+		this->method   = methodIt->second;
+
+		if (msgLen < HeaderLen + handlerIdLen)
+			MS_THROW_ERROR("wrong handlerId length");
+
+		this->handlerId.assign(msg + HeaderLen, handlerIdLen);
+
+		size_t dataOffset = HeaderLen + handlerIdLen;
+
+		if (msgLen > dataOffset)
+		{
+			try
+			{
+				this->data = json::from_msgpack(
+				  reinterpret_cast<const uint8_t*>(msg) + dataOffset,
+				  reinterpret_cast<const uint8_t*>(msg) + msgLen);
+
+				if (!this->data.is_object())
+					this->data = json::object();
+			}
+			catch (const json::parse_error& error)
+			{
+				MS_THROW_TYPE_ERROR("MessagePack parsing error: %s", error.what());
+			}
+		}
+	}
 } // namespace Channel
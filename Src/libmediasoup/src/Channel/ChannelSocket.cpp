@@ -176,6 +176,77 @@ namespace Channel
 		SendImpl(reinterpret_cast<const uint8_t*>(message), messageLen);
 	}
 
+	void ChannelSocket::SetBinary(bool binary)
+	{
+		MS_TRACE_STD();
+
+		this->binary = binary;
+	}
+
+	void ChannelSocket::SendBinaryResponse(
+	  uint32_t id, MessageKind kind, const json* data, const char* reason)
+	{
+		MS_TRACE_STD();
+
+		if (this->closed)
+			return;
+
+		this->binaryBuffer.clear();
+		this->binaryBuffer.push_back(static_cast<uint8_t>(kind));
+		this->binaryBuffer.insert(
+		  this->binaryBuffer.end(),
+		  reinterpret_cast<const uint8_t*>(&id),
+		  reinterpret_cast<const uint8_t*>(&id) + sizeof(id));
+
+		if (kind == MessageKind::RESPONSE_ACCEPTED)
+		{
+			if (data)
+				json::to_msgpack(*data, this->binaryBuffer);
+		}
+		else if (reason)
+		{
+			this->binaryBuffer.insert(
+			  this->binaryBuffer.end(),
+			  reinterpret_cast<const uint8_t*>(reason),
+			  reinterpret_cast<const uint8_t*>(reason) + std::strlen(reason));
+		}
+
+		SendBinaryImpl();
+	}
+
+	void ChannelSocket::SendBinaryNotification(
+	  const std::string& targetId, const char* event, const json* data)
+	{
+		MS_TRACE_STD();
+
+		if (this->closed)
+			return;
+
+		auto appendString = [this](const char* str, size_t len) {
+			auto len16 = static_cast<uint16_t>(len);
+
+			this->binaryBuffer.insert(
+			  this->binaryBuffer.end(),
+			  reinterpret_cast<const uint8_t*>(&len16),
+			  reinterpret_cast<const uint8_t*>(&len16) + sizeof(len16));
+			this->binaryBuffer.insert(
+			  this->binaryBuffer.end(),
+			  reinterpret_cast<const uint8_t*>(str),
+			  reinterpret_cast<const uint8_t*>(str) + len);
+		};
+
+		this->binaryBuffer.clear();
+		this->binaryBuffer.push_back(static_cast<uint8_t>(MessageKind::NOTIFICATION));
+
+		appendString(targetId.c_str(), targetId.length());
+		appendString(event, std::strlen(event));
+
+		if (data)
+			json::to_msgpack(*data, this->binaryBuffer);
+
+		SendBinaryImpl();
+	}
+
 	bool ChannelSocket::CallbackRead()
 	{
 		MS_TRACE_STD();
@@ -260,6 +331,20 @@ namespace Channel
 		}
 	}
 
+	inline void ChannelSocket::SendBinaryImpl()
+	{
+		MS_TRACE_STD();
+
+		if (this->binaryBuffer.size() > PayloadMaxLen)
+		{
+			MS_ERROR_STD("message too big");
+
+			return;
+		}
+
+		SendImpl(this->binaryBuffer.data(), static_cast<uint32_t>(this->binaryBuffer.size()));
+	}
+
 	void ChannelSocket::OnConsumerSocketMessage(ConsumerSocket* /*consumerSocket*/, char* msg, size_t msgLen)
 	{
 		MS_TRACE_STD();
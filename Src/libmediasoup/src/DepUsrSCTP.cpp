@@ -5,31 +5,66 @@
 #include "DepLibUV.hpp"
 #include "Logger.hpp"
 #include <usrsctp.h>
+#include <chrono>
 #include <cstdio> // std::vsnprintf()
 #include <mutex>
 
 /* Static. */
 
 static constexpr size_t CheckerInterval{ 10u }; // In ms.
+// Guards the SctpAssociations of all the Workers and their Inboxes.
 static std::mutex GlobalSyncMutex;
+// Guards the usrsctp stack initialization. The Checker thread is joined with it
+// held, so the usrsctp callbacks must not take it.
+static std::mutex ClassSyncMutex;
 static size_t GlobalInstances{ 0u };
 
+/* Static methods for UV callbacks. */
+
+inline static void onAsync(uv_async_t* /*handle*/)
+{
+	DepUsrSCTP::OnUvAsync();
+}
+
+inline static void onClose(uv_handle_t* handle)
+{
+	delete reinterpret_cast<uv_async_t*>(handle);
+}
+
 /* Static methods for usrsctp global callbacks. */
 
 inline static int onSendSctpData(void* addr, void* data, size_t len, uint8_t /*tos*/, uint8_t /*setDf*/)
 {
-	auto* sctpAssociation = DepUsrSCTP::RetrieveSctpAssociation(reinterpret_cast<uintptr_t>(addr));
+	auto id               = reinterpret_cast<uintptr_t>(addr);
+	auto* sctpAssociation = DepUsrSCTP::RetrieveSctpAssociation(id);
 
-	if (!sctpAssociation)
+	if (sctpAssociation)
 	{
-		MS_WARN_TAG(sctp, "no SctpAssociation found");
+		sctpAssociation->OnUsrSctpSendSctpData(data, len);
 
-		return -1;
+		// NOTE: Must not free data, usrsctp lib does it.
+
+		return 0;
 	}
 
-	sctpAssociation->OnUsrSctpSendSctpData(data, len);
+	// usrsctp timers run in the Checker thread, so the SctpAssociation may
+	// belong to another Worker. Send a copy of the data from its thread.
+	std::vector<uint8_t> buffer(static_cast<uint8_t*>(data), static_cast<uint8_t*>(data) + len);
 
-	// NOTE: Must not free data, usrsctp lib does it.
+	auto posted = DepUsrSCTP::PostTask(
+	  id,
+	  [buffer = std::move(buffer)](RTC::SctpAssociation* sctpAssociation) mutable
+	  {
+		  if (sctpAssociation)
+			  sctpAssociation->OnUsrSctpSendSctpData(buffer.data(), buffer.size());
+	  });
+
+	if (!posted)
+	{
+		MS_WARN_TAG(sctp, "no SctpAssociation found");
+
+		return -1;
+	}
 
 	return 0;
 }
@@ -53,10 +88,11 @@ inline static void sctpDebug(const char* format, ...)
 
 /* Static variables. */
 
-thread_local DepUsrSCTP::Checker* DepUsrSCTP::checker{ nullptr };
+DepUsrSCTP::Checker* DepUsrSCTP::checker{ nullptr };
+thread_local DepUsrSCTP::Inbox* DepUsrSCTP::inbox{ nullptr };
 uint64_t DepUsrSCTP::numSctpAssociations{ 0u };
 uintptr_t DepUsrSCTP::nextSctpAssociationId{ 0u };
-absl::flat_hash_map<uintptr_t, RTC::SctpAssociation*> DepUsrSCTP::mapIdSctpAssociation;
+absl::flat_hash_map<uintptr_t, DepUsrSCTP::Entry> DepUsrSCTP::mapIdSctpAssociation;
 
 /* Static methods. */
 
@@ -66,7 +102,7 @@ void DepUsrSCTP::ClassInit()
 
 	MS_DEBUG_TAG(info, "usrsctp");
 
-	std::lock_guard<std::mutex> lock(GlobalSyncMutex);
+	std::lock_guard<std::mutex> lock(ClassSyncMutex);
 
 	if (GlobalInstances == 0)
 	{
@@ -78,6 +114,8 @@ void DepUsrSCTP::ClassInit()
 #ifdef SCTP_DEBUG
 		usrsctp_sysctl_set_sctp_debug_on(SCTP_DEBUG_ALL);
 #endif
+
+		DepUsrSCTP::checker = new DepUsrSCTP::Checker();
 	}
 
 	++GlobalInstances;
@@ -87,13 +125,20 @@ void DepUsrSCTP::ClassDestroy()
 {
 	MS_TRACE();
 
-	std::lock_guard<std::mutex> lock(GlobalSyncMutex);
+	std::lock_guard<std::mutex> lock(ClassSyncMutex);
+
 	--GlobalInstances;
 
 	if (GlobalInstances == 0)
 	{
+		// Stop the usrsctp timers before finishing usrsctp.
+		delete DepUsrSCTP::checker;
+		DepUsrSCTP::checker = nullptr;
+
 		usrsctp_finish();
 
+		std::lock_guard<std::mutex> syncLock(GlobalSyncMutex);
+
 		numSctpAssociations   = 0u;
 		nextSctpAssociationId = 0u;
 
@@ -101,22 +146,42 @@ void DepUsrSCTP::ClassDestroy()
 	}
 }
 
-void DepUsrSCTP::CreateChecker()
+void DepUsrSCTP::CreateInbox()
 {
 	MS_TRACE();
 
-	MS_ASSERT(DepUsrSCTP::checker == nullptr, "Checker already created");
+	MS_ASSERT(DepUsrSCTP::inbox == nullptr, "Inbox already created");
+
+	auto* inbox = new Inbox();
+
+	inbox->uvHandle = new uv_async_t;
+
+	const int err =
+	  uv_async_init(DepLibUV::GetLoop(), inbox->uvHandle, static_cast<uv_async_cb>(onAsync));
 
-	DepUsrSCTP::checker = new DepUsrSCTP::Checker();
+	if (err != 0)
+		MS_ABORT("uv_async_init() failed: %s", uv_strerror(err));
+
+	// Pending tasks must not keep the loop alive.
+	uv_unref(reinterpret_cast<uv_handle_t*>(inbox->uvHandle));
+
+	DepUsrSCTP::inbox = inbox;
 }
 
-void DepUsrSCTP::CloseChecker()
+void DepUsrSCTP::CloseInbox()
 {
 	MS_TRACE();
 
-	MS_ASSERT(DepUsrSCTP::checker != nullptr, "Checker not created");
+	MS_ASSERT(DepUsrSCTP::inbox != nullptr, "Inbox not created");
+
+	// All the SctpAssociations of this Worker are closed, so no more tasks come.
+	// Let the pending ones release their data.
+	DepUsrSCTP::OnUvAsync();
+
+	uv_close(reinterpret_cast<uv_handle_t*>(DepUsrSCTP::inbox->uvHandle), static_cast<uv_close_cb>(onClose));
 
-	delete DepUsrSCTP::checker;
+	delete DepUsrSCTP::inbox;
+	DepUsrSCTP::inbox = nullptr;
 }
 
 uintptr_t DepUsrSCTP::GetNextSctpAssociationId()
@@ -150,6 +215,7 @@ void DepUsrSCTP::RegisterSctpAssociation(RTC::SctpAssociation* sctpAssociation)
 	std::lock_guard<std::mutex> lock(GlobalSyncMutex);
 
 	MS_ASSERT(DepUsrSCTP::checker != nullptr, "Checker not created");
+	MS_ASSERT(DepUsrSCTP::inbox != nullptr, "Inbox not created");
 
 	auto it = DepUsrSCTP::mapIdSctpAssociation.find(sctpAssociation->id);
 
@@ -157,7 +223,7 @@ void DepUsrSCTP::RegisterSctpAssociation(RTC::SctpAssociation* sctpAssociation)
 	  it == DepUsrSCTP::mapIdSctpAssociation.end(),
 	  "the id of the SctpAssociation is already in the map");
 
-	DepUsrSCTP::mapIdSctpAssociation[sctpAssociation->id] = sctpAssociation;
+	DepUsrSCTP::mapIdSctpAssociation[sctpAssociation->id] = { sctpAssociation, DepUsrSCTP::inbox };
 
 	if (++DepUsrSCTP::numSctpAssociations == 1u)
 		DepUsrSCTP::checker->Start();
@@ -191,7 +257,55 @@ RTC::SctpAssociation* DepUsrSCTP::RetrieveSctpAssociation(uintptr_t id)
 	if (it == DepUsrSCTP::mapIdSctpAssociation.end())
 		return nullptr;
 
-	return it->second;
+	auto& entry = it->second;
+
+	// Only its own Worker thread may touch it.
+	if (entry.inbox != DepUsrSCTP::inbox)
+		return nullptr;
+
+	return entry.sctpAssociation;
+}
+
+bool DepUsrSCTP::PostTask(uintptr_t id, Task task)
+{
+	MS_TRACE();
+
+	std::lock_guard<std::mutex> lock(GlobalSyncMutex);
+
+	auto it = DepUsrSCTP::mapIdSctpAssociation.find(id);
+
+	if (it == DepUsrSCTP::mapIdSctpAssociation.end())
+		return false;
+
+	auto* inbox = it->second.inbox;
+
+	inbox->tasks.emplace_back(id, std::move(task));
+
+	// The Inbox is closed once all the SctpAssociations of its Worker are
+	// deregistered, so the handle is valid while the mutex is held.
+	uv_async_send(inbox->uvHandle);
+
+	return true;
+}
+
+void DepUsrSCTP::OnUvAsync()
+{
+	MS_TRACE();
+
+	std::vector<std::pair<uintptr_t, Task>> tasks;
+
+	{
+		std::lock_guard<std::mutex> lock(GlobalSyncMutex);
+
+		std::swap(tasks, DepUsrSCTP::inbox->tasks);
+	}
+
+	// A task may close the SctpAssociation of the next ones, so retrieve each
+	// one right before running its task.
+	for (auto& [id, task] : tasks)
+	{
+		task(DepUsrSCTP::RetrieveSctpAssociation(id));
+	}
 }
 
 /* DepUsrSCTP::Checker instance methods. */
@@ -200,14 +314,21 @@ DepUsrSCTP::Checker::Checker()
 {
 	MS_TRACE();
 
-	this->timer = new Timer(this);
+	this->thread = std::thread(&DepUsrSCTP::Checker::Run, this);
 }
 
 DepUsrSCTP::Checker::~Checker()
 {
 	MS_TRACE();
 
-	delete this->timer;
+	{
+		std::lock_guard<std::mutex> lock(this->mutex);
+
+		this->closed = true;
+	}
+
+	this->condition.notify_one();
+	this->thread.join();
 }
 
 void DepUsrSCTP::Checker::Start()
@@ -216,9 +337,14 @@ void DepUsrSCTP::Checker::Start()
 
 	MS_DEBUG_TAG(sctp, "usrsctp periodic check started");
 
-	this->lastCalledAtMs = 0u;
+	{
+		std::lock_guard<std::mutex> lock(this->mutex);
+
+		this->running        = true;
+		this->lastCalledAtMs = 0u;
+	}
 
-	this->timer->Start(CheckerInterval, CheckerInterval);
+	this->condition.notify_one();
 }
 
 void DepUsrSCTP::Checker::Stop()
@@ -227,19 +353,41 @@ void DepUsrSCTP::Checker::Stop()
 
 	MS_DEBUG_TAG(sctp, "usrsctp periodic check stopped");
 
-	this->lastCalledAtMs = 0u;
+	std::lock_guard<std::mutex> lock(this->mutex);
 
-	this->timer->Stop();
+	this->running        = false;
+	this->lastCalledAtMs = 0u;
 }
 
-void DepUsrSCTP::Checker::OnTimer(Timer* /*timer*/)
+void DepUsrSCTP::Checker::Run()
 {
-	MS_TRACE();
+	std::unique_lock<std::mutex> lock(this->mutex);
+
+	while (!this->closed)
+	{
+		if (!this->running)
+		{
+			this->condition.wait(lock);
+
+			continue;
+		}
+
+		this->condition.wait_for(lock, std::chrono::milliseconds(CheckerInterval));
 
-	auto nowMs          = DepLibUV::GetTimeMs();
-	const int elapsedMs = this->lastCalledAtMs ? static_cast<int>(nowMs - this->lastCalledAtMs) : 0;
+		if (this->closed || !this->running)
+			continue;
 
-	usrsctp_handle_timers(elapsedMs);
+		auto nowMs          = DepLibUV::GetTimeMs();
+		const int elapsedMs = this->lastCalledAtMs ? static_cast<int>(nowMs - this->lastCalledAtMs) : 0;
 
-	this->lastCalledAtMs = nowMs;
+		this->lastCalledAtMs = nowMs;
+
+		// usrsctp callbacks take GlobalSyncMutex, which is held while calling
+		// Start() and Stop().
+		lock.unlock();
+
+		usrsctp_handle_timers(elapsedMs);
+
+		lock.lock();
+	}
 }
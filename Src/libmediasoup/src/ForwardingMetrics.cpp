@@ -0,0 +1,139 @@
+#define MS_CLASS "ForwardingMetrics"
+// #define MS_LOG_DEV_LEVEL 3
+
+#include "ForwardingMetrics.hpp"
+#include "Logger.hpp"
+#include <algorithm> // std::min()
+#include <uv.h>      // uv_hrtime()
+
+/* Static. */
+
+static const char* StageNames[] = {
+	"forwarding",
+	"srtpDecrypt",
+	"transportReceiveRtpPacket",
+	"routerFanOut",
+	"consumerSendRtpPacket",
+	"srtpEncrypt",
+	"udpSend",
+	"pacerQueueDelay",
+};
+
+static_assert(
+  sizeof(StageNames) / sizeof(StageNames[0]) == static_cast<size_t>(ForwardingMetrics::Stage::MAX),
+  "StageNames must have an entry per Stage");
+
+/* Class variables. */
+
+thread_local std::array<ForwardingMetrics::Histogram, static_cast<size_t>(ForwardingMetrics::Stage::MAX)>
+  ForwardingMetrics::histograms;
+thread_local uint64_t ForwardingMetrics::packetReceivedAt{ 0u };
+thread_local uint64_t ForwardingMetrics::startTicks{ 0u };
+thread_local uint64_t ForwardingMetrics::startNs{ 0u };
+
+/* Class methods. */
+
+void ForwardingMetrics::ClassInit()
+{
+	MS_TRACE();
+
+	ForwardingMetrics::Reset();
+}
+
+void ForwardingMetrics::Reset()
+{
+	MS_TRACE();
+
+	for (auto& histogram : ForwardingMetrics::histograms)
+	{
+		histogram = Histogram();
+	}
+
+	ForwardingMetrics::startTicks = Now();
+	ForwardingMetrics::startNs    = uv_hrtime();
+}
+
+void ForwardingMetrics::FillJson(json& jsonObject)
+{
+	MS_TRACE();
+
+	static constexpr double Percentiles[] = { 50, 90, 99, 99.9 };
+	static const char* PercentileNames[]  = { "p50", "p90", "p99", "p999" };
+
+	const uint64_t elapsedTicks = Now() - ForwardingMetrics::startTicks;
+	const uint64_t elapsedNs    = uv_hrtime() - ForwardingMetrics::startNs;
+	// Ticks are nanoseconds when there is no TSC.
+	const double nsPerTick =
+	  elapsedTicks > 0u ? static_cast<double>(elapsedNs) / static_cast<double>(elapsedTicks) : 1.0;
+
+	auto toNs = [nsPerTick](uint64_t ticks) { return static_cast<uint64_t>(ticks * nsPerTick); };
+
+	// Add elapsedMs.
+	jsonObject["elapsedMs"] = elapsedNs / 1000000u;
+
+	// Add stages.
+	jsonObject["stages"] = json::object();
+	auto jsonStagesIt    = jsonObject.find("stages");
+
+	for (size_t stageIdx{ 0u }; stageIdx < ForwardingMetrics::histograms.size(); ++stageIdx)
+	{
+		const auto& histogram = ForwardingMetrics::histograms[stageIdx];
+
+		(*jsonStagesIt)[StageNames[stageIdx]] = json::object();
+		auto& jsonStage                       = (*jsonStagesIt)[StageNames[stageIdx]];
+
+		jsonStage["count"] = histogram.count;
+		// Packets per second.
+		jsonStage["rate"] =
+		  elapsedNs > 0u ? static_cast<double>(histogram.count) * 1e9 / static_cast<double>(elapsedNs)
+		                 : 0.0;
+		// Fraction of the time spent in this stage. The first one to approach 1
+		// is the one saturating the Worker.
+		jsonStage["busyRatio"] =
+		  elapsedNs > 0u ? static_cast<double>(toNs(histogram.sum)) / static_cast<double>(elapsedNs)
+		                 : 0.0;
+		jsonStage["meanNs"] = histogram.count > 0u ? toNs(histogram.sum / histogram.count) : 0u;
+		jsonStage["maxNs"]  = toNs(histogram.max);
+
+		// Percentiles are the upper value of the bucket they fall into.
+		size_t percentileIdx{ 0u };
+		uint64_t accumulated{ 0u };
+
+		for (size_t bucketIdx{ 0u };
+		     bucketIdx < NumBuckets && percentileIdx < sizeof(Percentiles) / sizeof(Percentiles[0]);
+		     ++bucketIdx)
+		{
+			accumulated += histogram.buckets[bucketIdx];
+
+			while (percentileIdx < sizeof(Percentiles) / sizeof(Percentiles[0]) &&
+			       histogram.count > 0u &&
+			       static_cast<double>(accumulated) >=
+			         static_cast<double>(histogram.count) * Percentiles[percentileIdx] / 100)
+			{
+				jsonStage[PercentileNames[percentileIdx]] =
+				  toNs(std::min(GetBucketUpperValue(bucketIdx), histogram.max));
+
+				++percentileIdx;
+			}
+		}
+
+		for (; percentileIdx < sizeof(Percentiles) / sizeof(Percentiles[0]); ++percentileIdx)
+		{
+			jsonStage[PercentileNames[percentileIdx]] = 0u;
+		}
+	}
+}
+
+uint64_t ForwardingMetrics::GetBucketUpperValue(size_t index)
+{
+	MS_TRACE();
+
+	if (index < SubBuckets)
+		return static_cast<uint64_t>(index);
+
+	const size_t msb       = (index / SubBuckets) + SubBucketBits - 1;
+	const size_t subBucket = index % SubBuckets;
+	const size_t shift     = msb - SubBucketBits;
+
+	return ((static_cast<uint64_t>(SubBuckets + subBucket) + 1) << shift) - 1;
+}
@@ -3,12 +3,139 @@
 
 #include "Logger.hpp"
 #include <uv.h>
+#include <chrono>
+
+/* Static. */
+
+// Argument of a record, or of its Site for the log prefix.
+struct LogArg
+{
+	Logger::ArgType type{ Logger::ArgType::INT };
+	size_t size{ 0u };
+	uint64_t value{ 0u };
+	const char* str{ nullptr };
+	size_t strLen{ 0u };
+};
+
+static constexpr size_t MaxSiteArgs{ 4u };
+static constexpr size_t MaxSpecLen{ 32u };
+
+/* Static methods for UV callbacks. */
+
+inline static void onAsync(uv_handle_t* /*handle*/)
+{
+	Logger::SendFormattedRecords();
+}
+
+inline static void onClose(uv_handle_t* handle)
+{
+	delete handle;
+}
+
+/* Static methods. */
+
+inline static LogArg stringArg(const char* str)
+{
+	LogArg arg;
+
+	arg.type   = Logger::ArgType::STRING;
+	arg.str    = str;
+	arg.strLen = std::strlen(str);
+
+	return arg;
+}
+
+// Reads the next argument of the record. Returns false if there is none.
+inline static bool readArg(const Logger::Slot* slot, size_t& offset, LogArg& arg)
+{
+	if (offset + 2u > slot->argsLen)
+		return false;
+
+	const uint8_t* data = slot->args + offset;
+
+	arg.type = static_cast<Logger::ArgType>(data[0]);
+	arg.size = data[1];
+
+	if (arg.type == Logger::ArgType::STRING)
+	{
+		uint16_t len;
+
+		std::memcpy(&len, data + 2, sizeof(len));
+
+		arg.str    = reinterpret_cast<const char*>(data + 4);
+		arg.strLen = len;
+		offset += 4u + len;
+	}
+	else
+	{
+		std::memcpy(&arg.value, data + 2, sizeof(arg.value));
+
+		offset += Logger::ScalarArgSize;
+	}
+
+	return true;
+}
+
+inline static int64_t intValue(const LogArg& arg)
+{
+	if (arg.type == Logger::ArgType::DOUBLE)
+	{
+		double value;
+
+		std::memcpy(&value, &arg.value, sizeof(value));
+
+		return static_cast<int64_t>(value);
+	}
+
+	return static_cast<int64_t>(arg.value);
+}
+
+inline static uint64_t uintValue(const LogArg& arg)
+{
+	// Signed values printed as unsigned ones keep their promoted width, as
+	// with printf(), so -1 as a int32_t prints as "ffffffff".
+	if (arg.type == Logger::ArgType::INT && arg.size < sizeof(uint64_t))
+	{
+		const size_t size = std::max(arg.size, sizeof(int));
+
+		return arg.value & ((uint64_t{ 1u } << (size * 8u)) - 1u);
+	}
+
+	return static_cast<uint64_t>(intValue(arg));
+}
+
+inline static double doubleValue(const LogArg& arg)
+{
+	switch (arg.type)
+	{
+		case Logger::ArgType::DOUBLE:
+		{
+			double value;
+
+			std::memcpy(&value, &arg.value, sizeof(value));
+
+			return value;
+		}
+
+		case Logger::ArgType::INT:
+			return static_cast<double>(static_cast<int64_t>(arg.value));
+
+		default:
+			return static_cast<double>(arg.value);
+	}
+}
 
 /* Class variables. */
 
 const uint64_t Logger::pid{ static_cast<uint64_t>(uv_os_getpid()) };
 thread_local Channel::ChannelSocket* Logger::channel{ nullptr };
 thread_local char Logger::buffer[Logger::bufferSize];
+thread_local Logger::Ring* Logger::ring{ nullptr };
+std::mutex Logger::ringsMutex;
+std::condition_variable Logger::formatterCondition;
+std::vector<Logger::Ring*> Logger::rings;
+std::thread Logger::formatterThread;
+uint64_t Logger::formatterGeneration{ 0u };
 
 /* Class methods. */
 
@@ -16,5 +143,432 @@ void Logger::ClassInit(Channel::ChannelSocket* channel)
 {
 	Logger::channel = channel;
 
+	auto* ring = new Ring();
+
+	ring->uvHandle = new uv_async_t;
+
+	const int err = uv_async_init(
+	  DepLibUV::GetLoop(), ring->uvHandle, reinterpret_cast<uv_async_cb>(onAsync));
+
+	if (err != 0)
+		MS_ABORT("uv_async_init() failed: %s", uv_strerror(err));
+
+	// Pending records must not keep the loop alive.
+	uv_unref(reinterpret_cast<uv_handle_t*>(ring->uvHandle));
+
+	Logger::ring = ring;
+
+	{
+		std::lock_guard<std::mutex> lock(Logger::ringsMutex);
+
+		Logger::rings.push_back(ring);
+
+		if (!Logger::formatterThread.joinable())
+		{
+			Logger::formatterThread = std::thread(Logger::RunFormatter, Logger::formatterGeneration);
+		}
+	}
+
+	MS_TRACE();
+}
+
+void Logger::ClassDestroy()
+{
+	MS_TRACE();
+
+	auto* ring = Logger::ring;
+
+	if (!ring)
+		return;
+
+	std::thread formatterThread;
+
+	{
+		std::lock_guard<std::mutex> lock(Logger::ringsMutex);
+
+		// Format the records the formatting thread did not get to.
+		Logger::FormatRecords(ring);
+
+		Logger::rings.erase(std::find(Logger::rings.begin(), Logger::rings.end(), ring));
+
+		// Stop the formatting thread if this was the last Worker.
+		if (Logger::rings.empty())
+		{
+			++Logger::formatterGeneration;
+
+			formatterThread = std::move(Logger::formatterThread);
+		}
+	}
+
+	Logger::SendFormattedRecords();
+
+	Logger::ring = nullptr;
+
+	if (formatterThread.joinable())
+	{
+		Logger::formatterCondition.notify_all();
+		formatterThread.join();
+	}
+
+	uv_close(reinterpret_cast<uv_handle_t*>(ring->uvHandle), static_cast<uv_close_cb>(onClose));
+
+	delete ring;
+}
+
+void Logger::FillJson(json& jsonObject)
+{
 	MS_TRACE();
+
+	const auto* ring = Logger::ring;
+
+	// Add records.
+	jsonObject["records"] = ring ? ring->records : 0u;
+
+	// Add droppedRecords.
+	jsonObject["droppedRecords"] = ring ? ring->droppedRecords : 0u;
+
+	// Add suppressedRecords.
+	jsonObject["suppressedRecords"] = ring ? ring->suppressedRecords : 0u;
+}
+
+void Logger::SendFormattedRecords()
+{
+	auto* ring = Logger::ring;
+
+	if (!ring)
+		return;
+
+	// Clear the flag before reading so records formatted meanwhile are either
+	// sent below or trigger a new wakeup.
+	ring->wakeupPending.store(false);
+
+	const size_t formatted = ring->formatted.load(std::memory_order_acquire);
+
+	while (ring->tail != formatted)
+	{
+		const auto& slot = ring->slots[ring->tail % NumSlots];
+
+		if (Logger::channel)
+			Logger::channel->SendLog(slot.text, slot.textLen);
+
+		++ring->tail;
+	}
+
+	if (ring->droppedRecords != ring->reportedDroppedRecords)
+	{
+		const int loggerWritten = std::snprintf(
+		  Logger::buffer,
+		  Logger::bufferSize,
+		  "W" _MS_LOG_STR_DESC "%" PRIu64 " log records dropped, ring full",
+		  _MS_LOG_ARG,
+		  ring->droppedRecords - ring->reportedDroppedRecords);
+
+		ring->reportedDroppedRecords = ring->droppedRecords;
+
+		if (Logger::channel)
+			Logger::channel->SendLog(Logger::buffer, static_cast<uint32_t>(loggerWritten));
+	}
+}
+
+// Must be called with ringsMutex locked. Returns the number of formatted
+// records.
+size_t Logger::FormatRecords(Ring* ring)
+{
+	const size_t head = ring->head.load(std::memory_order_acquire);
+	const size_t from = ring->formatted.load(std::memory_order_relaxed);
+
+	if (from == head)
+		return 0u;
+
+	for (size_t formatted{ from }; formatted != head; ++formatted)
+	{
+		Logger::FormatRecord(std::addressof(ring->slots[formatted % NumSlots]));
+	}
+
+	ring->formatted.store(head, std::memory_order_release);
+
+	return head - from;
+}
+
+void Logger::FormatRecord(Slot* slot)
+{
+	const Site* site = slot->site;
+	char* text       = slot->text;
+	size_t textLen{ 0u };
+
+	auto append = [&](const char* str, size_t len) {
+		len = std::min(len, TextSize - textLen);
+
+		std::memcpy(text + textLen, str, len);
+		textLen += len;
+	};
+
+	// snprintf() needs room for the trailing null character, which is not sent.
+	char tmp[TextSize + 1];
+
+	auto appendFormatted = [&](int written) {
+		if (written > 0)
+			append(tmp, std::min(static_cast<size_t>(written), TextSize));
+	};
+
+	// Arguments of the log prefix.
+	LogArg siteArgs[MaxSiteArgs];
+	size_t numSiteArgs{ 0u };
+	size_t siteArgIdx{ 0u };
+	size_t argsOffset{ 0u };
+
+	if (site->className)
+	{
+		if (site->file)
+		{
+			siteArgs[numSiteArgs++] = stringArg(site->file);
+			siteArgs[numSiteArgs].type  = ArgType::INT;
+			siteArgs[numSiteArgs].size  = sizeof(int);
+			siteArgs[numSiteArgs].value = static_cast<uint64_t>(site->line);
+			++numSiteArgs;
+		}
+
+		siteArgs[numSiteArgs++] = stringArg(site->className);
+		siteArgs[numSiteArgs++] = stringArg(site->function);
+	}
+
+	auto nextArg = [&](LogArg& arg) {
+		if (siteArgIdx < numSiteArgs)
+		{
+			arg = siteArgs[siteArgIdx++];
+
+			return true;
+		}
+
+		return readArg(slot, argsOffset, arg);
+	};
+
+	const char* format = site->format;
+
+	while (*format != '\0')
+	{
+		if (*format != '%')
+		{
+			const char* literal = format;
+
+			while (*format != '\0' && *format != '%')
+			{
+				++format;
+			}
+
+			append(literal, format - literal);
+
+			continue;
+		}
+
+		if (format[1] == '%')
+		{
+			append("%", 1u);
+			format += 2;
+
+			continue;
+		}
+
+		// Rebuild the conversion specification, with the values of '*' width or
+		// precision and with the length modifier of the stored argument.
+		char spec[MaxSpecLen];
+		size_t specLen{ 0u };
+		LogArg arg;
+
+		spec[specLen++] = *format++;
+
+		while (*format != '\0' && std::strchr("-+ #0", *format) && specLen < MaxSpecLen - 8u)
+		{
+			spec[specLen++] = *format++;
+		}
+
+		for (int part{ 0 }; part < 2; ++part)
+		{
+			if (part == 1)
+			{
+				if (*format != '.')
+					break;
+
+				spec[specLen++] = *format++;
+			}
+
+			if (*format == '*')
+			{
+				++format;
+
+				const int value = nextArg(arg) ? static_cast<int>(intValue(arg)) : 0;
+				const int written =
+				  std::snprintf(spec + specLen, MaxSpecLen - specLen - 8u, "%d", value);
+
+				if (written > 0)
+					specLen += std::min(static_cast<size_t>(written), MaxSpecLen - specLen - 9u);
+			}
+			else
+			{
+				while (*format >= '0' && *format <= '9' && specLen < MaxSpecLen - 8u)
+				{
+					spec[specLen++] = *format++;
+				}
+			}
+		}
+
+		// Drop the length modifier.
+		while (*format != '\0' && std::strchr("hlLqjzt", *format))
+		{
+			++format;
+		}
+
+		const char conversion = *format;
+
+		if (conversion == '\0')
+			break;
+
+		++format;
+
+		if (!nextArg(arg))
+		{
+			append("?", 1u);
+
+			continue;
+		}
+
+		switch (conversion)
+		{
+			case 'd':
+			case 'i':
+			{
+				spec[specLen++] = 'l';
+				spec[specLen++] = 'l';
+				spec[specLen++] = conversion;
+				spec[specLen]   = '\0';
+
+				appendFormatted(
+				  std::snprintf(tmp, sizeof(tmp), spec, static_cast<long long>(intValue(arg))));
+
+				break;
+			}
+
+			case 'u':
+			case 'o':
+			case 'x':
+			case 'X':
+			{
+				spec[specLen++] = 'l';
+				spec[specLen++] = 'l';
+				spec[specLen++] = conversion;
+				spec[specLen]   = '\0';
+
+				appendFormatted(
+				  std::snprintf(tmp, sizeof(tmp), spec, static_cast<unsigned long long>(uintValue(arg))));
+
+				break;
+			}
+
+			case 'c':
+			{
+				spec[specLen++] = conversion;
+				spec[specLen]   = '\0';
+
+				appendFormatted(std::snprintf(tmp, sizeof(tmp), spec, static_cast<int>(intValue(arg))));
+
+				break;
+			}
+
+			case 'f':
+			case 'F':
+			case 'e':
+			case 'E':
+			case 'g':
+			case 'G':
+			case 'a':
+			case 'A':
+			{
+				spec[specLen++] = conversion;
+				spec[specLen]   = '\0';
+
+				appendFormatted(std::snprintf(tmp, sizeof(tmp), spec, doubleValue(arg)));
+
+				break;
+			}
+
+			case 'p':
+			{
+				spec[specLen++] = conversion;
+				spec[specLen]   = '\0';
+
+				appendFormatted(std::snprintf(
+				  tmp, sizeof(tmp), spec, reinterpret_cast<void*>(static_cast<uintptr_t>(arg.value))));
+
+				break;
+			}
+
+			case 's':
+			{
+				if (arg.type != ArgType::STRING)
+				{
+					append("?", 1u);
+
+					break;
+				}
+
+				// Record strings are not null terminated.
+				char str[ArgsSize + 1];
+				const size_t strLen = std::min(arg.strLen, ArgsSize);
+
+				std::memcpy(str, arg.str, strLen);
+				str[strLen] = '\0';
+
+				spec[specLen++] = conversion;
+				spec[specLen]   = '\0';
+
+				appendFormatted(std::snprintf(tmp, sizeof(tmp), spec, str));
+
+				break;
+			}
+
+			default:
+			{
+				append("?", 1u);
+			}
+		}
+	}
+
+	if (slot->suppressed != 0u)
+	{
+		appendFormatted(std::snprintf(
+		  tmp, sizeof(tmp), " (%" PRIu32 " similar records suppressed)", slot->suppressed));
+	}
+
+	slot->textLen = static_cast<uint16_t>(textLen);
+}
+
+void Logger::RunFormatter(uint64_t generation)
+{
+	std::unique_lock<std::mutex> lock(Logger::ringsMutex);
+
+	while (Logger::formatterGeneration == generation)
+	{
+		size_t maxRecords{ 0u };
+
+		for (auto* ring : Logger::rings)
+		{
+			const size_t records = Logger::FormatRecords(ring);
+
+			if (records != 0u && !ring->wakeupPending.exchange(true))
+				uv_async_send(ring->uvHandle);
+
+			maxRecords = std::max(maxRecords, records);
+		}
+
+		// Come back sooner if some Worker is filling its ring quickly.
+		const uint64_t intervalMs = maxRecords >= NumSlots / 8u ? 1u : FormatIntervalMs;
+
+		Logger::formatterCondition.wait_for(lock, std::chrono::milliseconds(intervalMs));
+	}
+}
+
+/* Instance methods. */
+
+Logger::Ring::Ring() : slots(new Slot[NumSlots])
+{
 }
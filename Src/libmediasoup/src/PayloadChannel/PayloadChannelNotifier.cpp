@@ -40,4 +40,24 @@ namespace PayloadChannel
 
 		this->payloadChannel->Send(jsonNotification, payload, payloadLen);
 	}
+
+	void PayloadChannelNotifier::Emit(
+	  const std::string& targetId,
+	  const char* event,
+	  const std::string& data,
+	  RTC::MessageBuffer* payload)
+	{
+		MS_TRACE();
+
+		// Build it by hand, since this runs for every DataConsumer of a message.
+		this->notification.assign("{\"targetId\":\"");
+		this->notification.append(targetId);
+		this->notification.append("\",\"event\":\"");
+		this->notification.append(event);
+		this->notification.append("\",\"data\":");
+		this->notification.append(data);
+		this->notification.append("}");
+
+		this->payloadChannel->Send(this->notification, payload);
+	}
 } // namespace PayloadChannel
@@ -159,7 +159,36 @@ namespace PayloadChannel
 		  reinterpret_cast<const uint8_t*>(message.c_str()),
 		  static_cast<uint32_t>(message.length()),
 		  payload,
-		  static_cast<uint32_t>(payloadLen));
+		  static_cast<uint32_t>(payloadLen),
+		  nullptr);
+	}
+
+	void PayloadChannelSocket::Send(const std::string& message, RTC::MessageBuffer* payload)
+	{
+		MS_TRACE();
+
+		if (this->closed)
+			return;
+
+		if (message.length() > PayloadMaxLen)
+		{
+			MS_ERROR("message too big");
+
+			return;
+		}
+		else if (payload->GetSize() > PayloadMaxLen)
+		{
+			MS_ERROR("payload too big");
+
+			return;
+		}
+
+		SendImpl(
+		  reinterpret_cast<const uint8_t*>(message.c_str()),
+		  static_cast<uint32_t>(message.length()),
+		  payload->GetData(),
+		  static_cast<uint32_t>(payload->GetSize()),
+		  payload);
 	}
 
 	void PayloadChannelSocket::Send(json& jsonMessage)
@@ -331,7 +360,8 @@ namespace PayloadChannel
 		// Write using function call if provided.
 		if (this->payloadChannelWriteFn)
 		{
-			this->payloadChannelWriteFn(message, messageLen, nullptr, 0, this->payloadChannelWriteCtx);
+			this->payloadChannelWriteFn(
+			  message, messageLen, nullptr, 0, nullptr, this->payloadChannelWriteCtx);
 		}
 		else
 		{
@@ -349,15 +379,25 @@ namespace PayloadChannel
 	}
 
 	inline void PayloadChannelSocket::SendImpl(
-	  const uint8_t* message, uint32_t messageLen, const uint8_t* payload, uint32_t payloadLen)
+	  const uint8_t* message,
+	  uint32_t messageLen,
+	  const uint8_t* payload,
+	  uint32_t payloadLen,
+	  RTC::MessageBuffer* payloadRef)
 	{
 		MS_TRACE();
 
-		// Write using function call if provided.
+		// Write using function call if provided. Given a reference, the writer may
+		// keep the payload instead of copying it.
 		if (this->payloadChannelWriteFn)
 		{
 			this->payloadChannelWriteFn(
-			  message, messageLen, payload, payloadLen, this->payloadChannelWriteCtx);
+			  message,
+			  messageLen,
+			  payload,
+			  payloadLen,
+			  static_cast<PayloadChannelPayloadRef>(payloadRef),
+			  this->payloadChannelWriteCtx);
 		}
 		else
 		{
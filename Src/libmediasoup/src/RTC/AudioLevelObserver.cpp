@@ -6,6 +6,7 @@
 #include "MediaSoupErrors.hpp"
 #include "Utils.hpp"
 #include "RTC/RtpDictionaries.hpp"
+#include <absl/container/btree_map.h>
 #include <cmath> // std::lround()
 #include <map>
 
@@ -236,6 +236,27 @@ namespace RTC
 		jsonObject["traceEventTypes"] = traceEventTypesStream.str();
 	}
 
+	void Consumer::FillBinaryStats(RTC::StatsPublisher* statsPublisher) const
+	{
+		MS_TRACE();
+
+		RTC::StatsPublisher::Counters counters;
+
+		// Stats of our send streams (not of the Producer ones).
+		for (auto* rtpStream : GetRtpStreams())
+		{
+			const size_t numCounters = rtpStream->FillStatsCounters(counters);
+
+			statsPublisher->AddEntry(
+			  rtpStream,
+			  RTC::StatsPublisher::EntryType::OUTBOUND_RTP,
+			  this->id,
+			  rtpStream->GetSsrc(),
+			  counters,
+			  numCounters);
+		}
+	}
+
 	void Consumer::HandleRequest(Channel::ChannelRequest* request)
 	{
 		MS_TRACE();
@@ -282,6 +303,8 @@ namespace RTC
 				if (wasActive)
 					UserOnPaused();
 
+				this->listener->OnConsumerForwardingChanged(this);
+
 				request->Accept();
 
 				break;
@@ -303,6 +326,8 @@ namespace RTC
 				if (IsActive())
 					UserOnResumed();
 
+				this->listener->OnConsumerForwardingChanged(this);
+
 				request->Accept();
 
 				break;
@@ -387,6 +412,8 @@ namespace RTC
 		MS_DEBUG_DEV("Transport connected [consumerId:%s]", this->id.c_str());
 
 		UserOnTransportConnected();
+
+		this->listener->OnConsumerForwardingChanged(this);
 	}
 
 	void Consumer::TransportDisconnected()
@@ -401,6 +428,8 @@ namespace RTC
 		MS_DEBUG_DEV("Transport disconnected [consumerId:%s]", this->id.c_str());
 
 		UserOnTransportDisconnected();
+
+		this->listener->OnConsumerForwardingChanged(this);
 	}
 
 	void Consumer::ProducerPaused()
@@ -138,6 +138,20 @@ namespace RTC
 		jsonObject["bufferedAmount"] = this->bufferedAmount;
 	}
 
+	void DataConsumer::FillBinaryStats(RTC::StatsPublisher* statsPublisher) const
+	{
+		MS_TRACE();
+
+		RTC::StatsPublisher::Counters counters;
+
+		counters[0] = this->messagesSent;
+		counters[1] = this->bytesSent;
+		counters[2] = this->bufferedAmount;
+
+		statsPublisher->AddEntry(
+		  this, RTC::StatsPublisher::EntryType::DATA_CONSUMER, this->id, 0u, counters, 3u);
+	}
+
 	void DataConsumer::HandleRequest(Channel::ChannelRequest* request)
 	{
 		MS_TRACE();
@@ -283,7 +297,13 @@ namespace RTC
 						    sctpSendBufferFull == true ? "sctpsendbufferfull" : "message send failed");
 				  });
 
-				SendMessage(ppid, msg, len, cb);
+				// The payload belongs to the request, but the Transport may keep the
+				// message beyond it.
+				auto* message = RTC::MessageBuffer::Copy(msg, len);
+
+				SendMessage(ppid, message, cb);
+
+				message->Unref();
 
 				break;
 			}
@@ -349,12 +369,23 @@ namespace RTC
 			this->forceTriggerBufferedAmountLow = false;
 
 			// Notify the Node DataConsumer.
-			std::string data(R"({"bufferedAmount":)");
+			if (this->shared->channelNotifier->IsBinary())
+			{
+				json data = json::object();
+
+				data["bufferedAmount"] = this->bufferedAmount;
+
+				this->shared->channelNotifier->Emit(this->id, "bufferedamountlow", data);
+			}
+			else
+			{
+				std::string data(R"({"bufferedAmount":)");
 
-			data.append(std::to_string(this->bufferedAmount));
-			data.append("}");
+				data.append(std::to_string(this->bufferedAmount));
+				data.append("}");
 
-			this->shared->channelNotifier->Emit(this->id, "bufferedamountlow", data);
+				this->shared->channelNotifier->Emit(this->id, "bufferedamountlow", data);
+			}
 		}
 	}
 
@@ -380,13 +411,15 @@ namespace RTC
 		this->listener->OnDataConsumerDataProducerClosed(this);
 	}
 
-	void DataConsumer::SendMessage(uint32_t ppid, const uint8_t* msg, size_t len, onQueuedCallback* cb)
+	void DataConsumer::SendMessage(uint32_t ppid, RTC::MessageBuffer* message, onQueuedCallback* cb)
 	{
 		MS_TRACE();
 
 		if (!IsActive())
 			return;
 
+		const size_t len = message->GetSize();
+
 		if (len > this->maxMessageSize)
 		{
 			MS_WARN_TAG(
@@ -401,6 +434,6 @@ namespace RTC
 		this->messagesSent++;
 		this->bytesSent += len;
 
-		this->listener->OnDataConsumerSendMessage(this, ppid, msg, len, cb);
+		this->listener->OnDataConsumerSendMessage(this, ppid, message, cb);
 	}
 } // namespace RTC
@@ -125,6 +125,19 @@ namespace RTC
 		jsonObject["bytesReceived"] = this->bytesReceived;
 	}
 
+	void DataProducer::FillBinaryStats(RTC::StatsPublisher* statsPublisher) const
+	{
+		MS_TRACE();
+
+		RTC::StatsPublisher::Counters counters;
+
+		counters[0] = this->messagesReceived;
+		counters[1] = this->bytesReceived;
+
+		statsPublisher->AddEntry(
+		  this, RTC::StatsPublisher::EntryType::DATA_PRODUCER, this->id, 0u, counters, 2u);
+	}
+
 	void DataProducer::HandleRequest(Channel::ChannelRequest* request)
 	{
 		MS_TRACE();
@@ -193,7 +206,13 @@ namespace RTC
 					  this->maxMessageSize);
 				}
 
-				this->ReceiveMessage(ppid, msg, len);
+				// The payload belongs to the notification, but DataConsumers may keep
+				// the message beyond it.
+				auto* message = RTC::MessageBuffer::Copy(msg, len);
+
+				this->ReceiveMessage(ppid, message);
+
+				message->Unref();
 
 				// Increase receive transmission.
 				this->listener->OnDataProducerReceiveData(this, len);
@@ -208,13 +227,13 @@ namespace RTC
 		}
 	}
 
-	void DataProducer::ReceiveMessage(uint32_t ppid, const uint8_t* msg, size_t len)
+	void DataProducer::ReceiveMessage(uint32_t ppid, RTC::MessageBuffer* message)
 	{
 		MS_TRACE();
 
 		this->messagesReceived++;
-		this->bytesReceived += len;
+		this->bytesReceived += message->GetSize();
 
-		this->listener->OnDataProducerMessageReceived(this, ppid, msg, len);
+		this->listener->OnDataProducerMessageReceived(this, ppid, message);
 	}
 } // namespace RTC
@@ -110,7 +110,7 @@ namespace RTC
 	}
 
 	void DirectTransport::SendRtpPacket(
-	  RTC::Consumer* consumer, RTC::RtpPacket* packet, RTC::Transport::onSendCallback* cb)
+	  RTC::Consumer* consumer, RTC::RtpPacket* packet, const RTC::Transport::onSendCallback& cb)
 	{
 		MS_TRACE();
 
@@ -129,8 +129,7 @@ namespace RTC
 
 		if (cb)
 		{
-			(*cb)(true);
-			delete cb;
+			cb(true);
 		}
 
 		// Increase send transmission.
@@ -168,19 +167,21 @@ namespace RTC
 	}
 
 	void DirectTransport::SendMessage(
-	  RTC::DataConsumer* dataConsumer, uint32_t ppid, const uint8_t* msg, size_t len, onQueuedCallback* cb)
+	  RTC::DataConsumer* dataConsumer, uint32_t ppid, RTC::MessageBuffer* message, onQueuedCallback* cb)
 	{
 		MS_TRACE();
 
-		// Notify the Node DirectTransport.
-		json data = json::object();
+		// Notify the Node DirectTransport. The in-process PayloadChannel keeps a
+		// reference to the message rather than copying it for each DataConsumer.
+		std::string data("{\"ppid\":");
 
-		data["ppid"] = ppid;
+		data.append(std::to_string(ppid));
+		data.append("}");
 
-		this->shared->payloadChannelNotifier->Emit(dataConsumer->id, "message", data, msg, len);
+		this->shared->payloadChannelNotifier->Emit(dataConsumer->id, "message", data, message);
 
 		// Increase send transmission.
-		RTC::Transport::DataSent(len);
+		RTC::Transport::DataSent(message->GetSize());
 	}
 
 	void DirectTransport::SendSctpData(const uint8_t* /*data*/, size_t /*len*/)
@@ -21,6 +21,8 @@ namespace RTC
 	{
 		MS_TRACE();
 
+		this->hmacSha1.SetKey(this->password);
+
 		// Notify the listener.
 		this->listener->OnIceServerLocalUsernameFragmentAdded(this, usernameFragment);
 	}
@@ -127,7 +129,7 @@ namespace RTC
 				}
 
 				// Check authentication.
-				switch (packet->CheckAuthentication(this->usernameFragment, this->password))
+				switch (packet->CheckAuthentication(this->usernameFragment, this->hmacSha1))
 				{
 					case RTC::StunPacket::Authentication::OK:
 					{
@@ -153,7 +155,7 @@ namespace RTC
 						if (
 							!this->oldUsernameFragment.empty() &&
 							!this->oldPassword.empty() &&
-							packet->CheckAuthentication(this->oldUsernameFragment, this->oldPassword) == RTC::StunPacket::Authentication::OK
+							packet->CheckAuthentication(this->oldUsernameFragment, this->oldHmacSha1) == RTC::StunPacket::Authentication::OK
 						)
 						// clang-format on
 						{
@@ -212,23 +214,25 @@ namespace RTC
 				  static_cast<uint32_t>(packet->GetPriority()),
 				  packet->HasUseCandidate() ? "true" : "false");
 
-				// Create a success response.
-				RTC::StunPacket* response = packet->CreateSuccessResponse();
-
-				// Add XOR-MAPPED-ADDRESS.
-				response->SetXorMappedAddress(tuple->GetRemoteAddress());
-
-				// Authenticate the response.
-				if (this->oldPassword.empty())
-					response->Authenticate(this->password);
-				else
-					response->Authenticate(this->oldPassword);
+				// Create an authenticated success response with XOR-MAPPED-ADDRESS
+				// straight into the buffer.
+				const size_t responseSize = packet->SerializeSuccessResponse(
+				  StunSerializeBuffer,
+				  tuple->GetRemoteAddress(),
+				  this->oldPassword.empty() ? this->hmacSha1 : this->oldHmacSha1);
 
 				// Send back.
-				response->Serialize(StunSerializeBuffer);
-				this->listener->OnIceServerSendStunPacket(this, response, tuple);
-
-				delete response;
+				if (responseSize != 0u)
+				{
+					RTC::StunPacket response(
+					  RTC::StunPacket::Class::SUCCESS_RESPONSE,
+					  RTC::StunPacket::Method::BINDING,
+					  StunSerializeBuffer + 8,
+					  StunSerializeBuffer,
+					  responseSize);
+
+					this->listener->OnIceServerSendStunPacket(this, &response, tuple);
+				}
 
 				uint32_t nomination{ 0u };
 
@@ -0,0 +1,241 @@
+#define MS_CLASS "RTC::InProcessPipe"
+// #define MS_LOG_DEV_LEVEL 3
+
+#include "RTC/InProcessPipe.hpp"
+#include "DepLibUV.hpp"
+#include "Logger.hpp"
+#include "MediaSoupErrors.hpp"
+#include <cstring> // std::memcpy()
+
+namespace RTC
+{
+	/* Static methods for UV callbacks. */
+
+	inline static void onAsync(uv_async_t* handle)
+	{
+		static_cast<InProcessPipe*>(handle->data)->OnUvAsync();
+	}
+
+	inline static void onClose(uv_handle_t* handle)
+	{
+		delete reinterpret_cast<uv_async_t*>(handle);
+	}
+
+	/* Class variables. */
+
+	// Shared by all the Worker threads.
+	std::mutex InProcessPipe::inboxesMutex;
+	std::unordered_map<std::string, std::weak_ptr<InProcessPipe::Inbox>> InProcessPipe::inboxes;
+
+	/* Inbox. */
+
+	InProcessPipe::Inbox::Inbox() : slots(new Slot[InProcessPipe::NumSlots])
+	{
+	}
+
+	/* Instance methods. */
+
+	InProcessPipe::InProcessPipe(Listener* listener, const std::string& id)
+	  : listener(listener), id(id), inbox(std::make_shared<Inbox>())
+	{
+		MS_TRACE();
+
+		this->inbox->uvHandle       = new uv_async_t;
+		this->inbox->uvHandle->data = static_cast<void*>(this);
+
+		const int err = uv_async_init(
+		  DepLibUV::GetLoop(), this->inbox->uvHandle, static_cast<uv_async_cb>(onAsync));
+
+		if (err != 0)
+		{
+			delete this->inbox->uvHandle;
+			this->inbox->uvHandle = nullptr;
+
+			MS_THROW_ERROR("uv_async_init() failed: %s", uv_strerror(err));
+		}
+
+		std::lock_guard<std::mutex> lock(InProcessPipe::inboxesMutex);
+
+		if (!InProcessPipe::inboxes.emplace(this->id, this->inbox).second)
+		{
+			uv_close(reinterpret_cast<uv_handle_t*>(this->inbox->uvHandle), static_cast<uv_close_cb>(onClose));
+			this->inbox->uvHandle = nullptr;
+
+			MS_THROW_ERROR("an in-process pipe with same id already exists");
+		}
+	}
+
+	InProcessPipe::~InProcessPipe()
+	{
+		MS_TRACE();
+
+		{
+			std::lock_guard<std::mutex> lock(InProcessPipe::inboxesMutex);
+
+			InProcessPipe::inboxes.erase(this->id);
+		}
+
+		// Let another endpoint connect to the remote one.
+		Disconnect();
+
+		// The remote endpoint may still hold the inbox, so make sure it does not
+		// touch the UV handle once closed.
+		{
+			std::lock_guard<std::mutex> lock(this->inbox->mutex);
+
+			this->inbox->closed = true;
+
+			uv_close(reinterpret_cast<uv_handle_t*>(this->inbox->uvHandle), static_cast<uv_close_cb>(onClose));
+			this->inbox->uvHandle = nullptr;
+		}
+	}
+
+	void InProcessPipe::FillJsonStats(json& jsonObject) const
+	{
+		MS_TRACE();
+
+		jsonObject["remoteId"]       = this->remoteId;
+		jsonObject["sentPackets"]    = this->sentPackets;
+		jsonObject["droppedPackets"] = this->droppedPackets;
+		jsonObject["recvPackets"]    = this->recvPackets;
+	}
+
+	void InProcessPipe::Connect(const std::string& remoteId)
+	{
+		MS_TRACE();
+
+		// The remote endpoint is gone, drop it.
+		if (this->outbox && this->outbox->closed)
+			Disconnect();
+
+		if (this->outbox)
+			MS_THROW_ERROR("already connected");
+
+		std::shared_ptr<Inbox> outbox;
+
+		{
+			std::lock_guard<std::mutex> lock(InProcessPipe::inboxesMutex);
+
+			auto it = InProcessPipe::inboxes.find(remoteId);
+
+			if (it != InProcessPipe::inboxes.end())
+				outbox = it->second.lock();
+		}
+
+		if (!outbox)
+			MS_THROW_ERROR("in-process pipe with id \"%s\" not found", remoteId.c_str());
+
+		// The inbox is a single producer ring.
+		if (outbox->connected.exchange(true))
+			MS_THROW_ERROR("in-process pipe with id \"%s\" already connected", remoteId.c_str());
+
+		this->outbox   = outbox;
+		this->remoteId = remoteId;
+	}
+
+	bool InProcessPipe::Send(const uint8_t* data, size_t len)
+	{
+		MS_TRACE();
+
+		auto* outbox = this->outbox.get();
+
+		if (!outbox)
+		{
+			++this->droppedPackets;
+
+			return false;
+		}
+
+		// The remote endpoint is gone, drop it so its inbox is freed.
+		if (outbox->closed.load(std::memory_order_relaxed))
+		{
+			Disconnect();
+
+			++this->droppedPackets;
+
+			return false;
+		}
+
+		if (len > InProcessPipe::MaxPacketSize)
+		{
+			MS_WARN_DEV("packet too big for an in-process pipe slot [len:%zu]", len);
+
+			++this->droppedPackets;
+
+			return false;
+		}
+
+		const size_t head = outbox->head.load(std::memory_order_relaxed);
+
+		// Full, the receiver is not keeping up (as if the socket buffer of a
+		// UDP pipe overflowed).
+		if (head - outbox->tail.load(std::memory_order_acquire) == InProcessPipe::NumSlots)
+		{
+			++this->droppedPackets;
+
+			return false;
+		}
+
+		auto& slot = outbox->slots[head % InProcessPipe::NumSlots];
+
+		std::memcpy(slot.data, data, len);
+		slot.len = len;
+
+		outbox->head.store(head + 1, std::memory_order_release);
+
+		++this->sentPackets;
+
+		// Wake up the receiver unless it's already going to drain the inbox.
+		if (!outbox->wakeupPending.exchange(true, std::memory_order_acq_rel))
+		{
+			std::lock_guard<std::mutex> lock(outbox->mutex);
+
+			if (outbox->uvHandle)
+				uv_async_send(outbox->uvHandle);
+		}
+
+		return true;
+	}
+
+	void InProcessPipe::Disconnect()
+	{
+		MS_TRACE();
+
+		if (!this->outbox)
+			return;
+
+		// After the last packet written into the remote inbox, so the next
+		// sender connected to it goes on from there.
+		this->outbox->connected.store(false, std::memory_order_release);
+
+		this->outbox.reset();
+		this->remoteId.clear();
+	}
+
+	inline void InProcessPipe::OnUvAsync()
+	{
+		MS_TRACE();
+
+		auto* inbox = this->inbox.get();
+
+		// Packets sent from now on need another wakeup. This synchronizes with
+		// the last wakeup request, so its packets are seen below.
+		inbox->wakeupPending.exchange(false, std::memory_order_acq_rel);
+
+		size_t tail       = inbox->tail.load(std::memory_order_relaxed);
+		const size_t head = inbox->head.load(std::memory_order_acquire);
+
+		// Just what is there now, so the sender cannot hold this loop forever.
+		while (tail != head)
+		{
+			auto& slot = inbox->slots[tail % InProcessPipe::NumSlots];
+
+			++this->recvPackets;
+
+			this->listener->OnInProcessPipePacketReceived(this, slot.data, slot.len);
+
+			// Give the slot back to the sender.
+			inbox->tail.store(++tail, std::memory_order_release);
+		}
+	}
+} // namespace RTC
@@ -0,0 +1,84 @@
+#define MS_CLASS "RTC::MessageBuffer"
+// #define MS_LOG_DEV_LEVEL 3
+
+#include "RTC/MessageBuffer.hpp"
+#include "Logger.hpp"
+#include "MediaSoupErrors.hpp"
+#include <algorithm> // std::max()
+#include <cstdlib>   // std::malloc(), std::realloc(), std::free()
+#include <cstring>   // std::memcpy()
+
+namespace RTC
+{
+	/* Class methods. */
+
+	MessageBuffer* MessageBuffer::Create(size_t capacity)
+	{
+		MS_TRACE();
+
+		// Allocate at least one byte so the data pointer is always valid.
+		auto* data = static_cast<uint8_t*>(std::malloc(capacity > 0 ? capacity : 1));
+
+		if (!data)
+			MS_THROW_ERROR("std::malloc() failed");
+
+		return new MessageBuffer(data, 0, capacity);
+	}
+
+	MessageBuffer* MessageBuffer::Adopt(uint8_t* data, size_t len)
+	{
+		MS_TRACE();
+
+		return new MessageBuffer(data, len, len);
+	}
+
+	MessageBuffer* MessageBuffer::Copy(const uint8_t* data, size_t len)
+	{
+		MS_TRACE();
+
+		auto* messageBuffer = MessageBuffer::Create(len);
+
+		messageBuffer->Append(data, len);
+
+		return messageBuffer;
+	}
+
+	/* Instance methods. */
+
+	MessageBuffer::MessageBuffer(uint8_t* data, size_t size, size_t capacity)
+	  : data(data), size(size), capacity(capacity)
+	{
+		MS_TRACE();
+	}
+
+	// NOTE: No logging here since the last reference may be dropped out of the
+	// Worker thread.
+	MessageBuffer::~MessageBuffer()
+	{
+		std::free(this->data);
+	}
+
+	void MessageBuffer::Append(const uint8_t* data, size_t len)
+	{
+		MS_TRACE();
+
+		MS_ASSERT(!IsShared(), "cannot append to a shared MessageBuffer");
+
+		if (this->size + len > this->capacity)
+		{
+			size_t capacity = std::max(this->size + len, this->capacity * 2);
+			auto* newData   = static_cast<uint8_t*>(std::realloc(this->data, capacity));
+
+			if (!newData)
+				MS_THROW_ERROR("std::realloc() failed");
+
+			this->data     = newData;
+			this->capacity = capacity;
+		}
+
+		if (len != 0)
+			std::memcpy(this->data + this->size, data, len);
+
+		this->size += len;
+	}
+} // namespace RTC
@@ -4,9 +4,10 @@
 #include "RTC/NackGenerator.hpp"
 #include "DepLibUV.hpp"
 #include "Logger.hpp"
-#include <iterator> // std::ostream_iterator
-#include <sstream>  // std::ostringstream
-#include <utility>  // std::make_pair()
+#include <algorithm> // std::min()
+#include <bit>       // std::countr_zero()
+#include <iterator>  // std::ostream_iterator
+#include <sstream>   // std::ostringstream
 
 namespace RTC
 {
@@ -17,6 +18,67 @@ namespace RTC
 	static constexpr uint32_t DefaultRtt{ 100u };
 	static constexpr uint8_t MaxNackRetries{ 10u };
 	static constexpr uint64_t TimerInterval{ 40u };
+	// Key frames and recovered packets newer than the last seq are only kept
+	// up to this distance from it, so their bits are not taken by older seqs.
+	static constexpr size_t MaxSeqAhead{ NackGenerator::WindowSize - MaxPacketAge };
+
+	static_assert(NackGenerator::WindowSize > MaxPacketAge, "window smaller than the max packet age");
+	static_assert(NackGenerator::NackListCapacity >= MaxNackPackets, "NACK list too small");
+
+	/* SeqBitmap. */
+
+	// Mask with n (from 1 to 64) bits set starting at the given offset.
+	inline static uint64_t getMask(size_t offset, size_t n)
+	{
+		return (n == 64u ? ~uint64_t{ 0u } : (uint64_t{ 1u } << n) - 1u) << offset;
+	}
+
+	void NackGenerator::SeqBitmap::Reset(uint16_t seqStart, uint16_t seqEnd)
+	{
+		size_t count = static_cast<uint16_t>(seqEnd - seqStart);
+
+		if (count >= WindowSize)
+		{
+			Clear();
+
+			return;
+		}
+
+		size_t bit = seqStart % WindowSize;
+
+		while (count != 0u)
+		{
+			const size_t offset = bit % 64u;
+			const size_t n      = std::min(64u - offset, count);
+
+			this->words[bit / 64u] &= ~getMask(offset, n);
+
+			bit = (bit + n) % WindowSize;
+			count -= n;
+		}
+	}
+
+	uint16_t NackGenerator::SeqBitmap::FindFirst(uint16_t seqStart, uint16_t seqEnd) const
+	{
+		const size_t count = std::min<size_t>(static_cast<uint16_t>(seqEnd - seqStart), WindowSize);
+		size_t bit         = seqStart % WindowSize;
+		size_t checked{ 0u };
+
+		while (checked != count)
+		{
+			const size_t offset = bit % 64u;
+			const size_t n      = std::min(64u - offset, count - checked);
+			const uint64_t word = this->words[bit / 64u] & getMask(offset, n);
+
+			if (word != 0u)
+				return static_cast<uint16_t>(seqStart + checked + std::countr_zero(word) - offset);
+
+			bit = (bit + n) % WindowSize;
+			checked += n;
+		}
+
+		return seqEnd;
+	}
 
 	/* Instance methods. */
 
@@ -51,7 +113,7 @@ namespace RTC
 			this->lastSeq = seq;
 
 			if (isKeyFrame)
-				this->keyFrameList.insert(seq);
+				this->keyFrameBitmap.Set(seq);
 
 			return false;
 		}
@@ -64,10 +126,10 @@ namespace RTC
 		// or a retransmitted packet.
 		if (SeqManager<uint16_t>::IsSeqLowerThan(seq, this->lastSeq))
 		{
-			auto it = this->nackList.find(seq);
+			auto* nackInfo = GetNackInfo(seq);
 
 			// It was a nacked packet.
-			if (it != this->nackList.end())
+			if (nackInfo)
 			{
 				MS_DEBUG_DEV(
 				  "NACKed packet received [ssrc:%" PRIu32 ", seq:%" PRIu16 ", recovered:%s]",
@@ -75,9 +137,10 @@ namespace RTC
 				  packet->GetSequenceNumber(),
 				  isRecovered ? "true" : "false");
 
-				auto retries = it->second.retries;
+				auto retries = nackInfo->retries;
 
-				this->nackList.erase(it);
+				RemoveNackInfo(*nackInfo);
+				TrimNackList(this->lastSeq - MaxPacketAge);
 
 				if (retries != 0)
 					return true;
@@ -100,38 +163,33 @@ namespace RTC
 		// If we are here it means that we may have lost some packets so seq is
 		// newer than the latest seq seen.
 
-		if (isKeyFrame)
-			this->keyFrameList.insert(seq);
-
-		// Remove old keyframes.
-		{
-			auto it = this->keyFrameList.lower_bound(seq - MaxPacketAge);
-
-			if (it != this->keyFrameList.begin())
-				this->keyFrameList.erase(this->keyFrameList.begin(), it);
-		}
-
 		if (isRecovered)
 		{
-			this->recoveredList.insert(seq);
+			// Too far to be remembered.
+			if (static_cast<uint16_t>(seq - this->lastSeq) >= MaxSeqAhead)
+				return false;
 
-			// Remove old ones so we don't accumulate recovered packets.
-			auto it = this->recoveredList.lower_bound(seq - MaxPacketAge);
+			if (isKeyFrame)
+				this->keyFrameBitmap.Set(seq);
 
-			if (it != this->recoveredList.begin())
-				this->recoveredList.erase(this->recoveredList.begin(), it);
+			this->recoveredBitmap.Set(seq);
 
 			// Do not let a packet pass if it's newer than last seen seq and came via
 			// RTX.
 			return false;
 		}
 
+		ForgetOldSeqs(seq);
+
+		if (isKeyFrame)
+			this->keyFrameBitmap.Set(seq);
+
 		AddPacketsToNackList(this->lastSeq + 1, seq);
 
 		this->lastSeq = seq;
 
 		// Check if there are any nacks that are waiting for this seq number.
-		std::vector<uint16_t> nackBatch = GetNackBatch(NackFilter::SEQ);
+		const auto& nackBatch = GetNackBatch(NackFilter::SEQ);
 
 		if (!nackBatch.empty())
 			this->listener->OnNackGeneratorNackRequired(nackBatch);
@@ -144,58 +202,78 @@ namespace RTC
 		return false;
 	}
 
+	// Forgets the key frames and recovered packets that become too old once
+	// seq is the last seq, so their bits can be taken by newer seqs.
+	void NackGenerator::ForgetOldSeqs(uint16_t seq)
+	{
+		MS_TRACE();
+
+		const uint16_t seqStart = this->lastSeq - MaxPacketAge;
+		const uint16_t seqEnd   = seq - MaxPacketAge;
+
+		this->keyFrameBitmap.Reset(seqStart, seqEnd);
+		this->recoveredBitmap.Reset(seqStart, seqEnd);
+	}
+
 	void NackGenerator::AddPacketsToNackList(uint16_t seqStart, uint16_t seqEnd)
 	{
 		MS_TRACE();
 
 		// Remove old packets.
-		auto it = this->nackList.lower_bound(seqEnd - MaxPacketAge);
-
-		this->nackList.erase(this->nackList.begin(), it);
+		TrimNackList(seqEnd - MaxPacketAge);
 
 		// If the nack list is too large, remove packets from the nack list until
 		// the latest first packet of a keyframe. If the list is still too large,
 		// clear it and request a keyframe.
 		const uint16_t numNewNacks = seqEnd - seqStart;
 
-		if (static_cast<uint16_t>(this->nackList.size()) + numNewNacks > MaxNackPackets)
+		if (this->nackListLength + numNewNacks > MaxNackPackets)
 		{
 			// clang-format off
 			while (
 				RemoveNackItemsUntilKeyFrame() &&
-				static_cast<uint16_t>(this->nackList.size()) + numNewNacks > MaxNackPackets
+				this->nackListLength + numNewNacks > MaxNackPackets
 			)
 			// clang-format on
 			{
 			}
 
-			if (static_cast<uint16_t>(this->nackList.size()) + numNewNacks > MaxNackPackets)
+			if (this->nackListLength + numNewNacks > MaxNackPackets)
 			{
 				MS_WARN_TAG(
 				  rtx, "NACK list full, clearing it and requesting a key frame [seqEnd:%" PRIu16 "]", seqEnd);
 
-				this->nackList.clear();
+				ClearNackList();
 				this->listener->OnNackGeneratorKeyFrameRequired();
 
 				return;
 			}
 		}
 
+		// Only streams with losses pay for the NACK list.
+		if (this->nackList.empty())
+			this->nackList.resize(NackListCapacity);
+
+		// Make room at the back for the new entries.
+		if (this->nackListSize + numNewNacks > NackListCapacity)
+			CompactNackList();
+
+		const uint64_t nowMs = DepLibUV::GetTimeMs();
+
 		for (uint16_t seq = seqStart; seq != seqEnd; ++seq)
 		{
-			MS_ASSERT(this->nackList.find(seq) == this->nackList.end(), "packet already in the NACK list");
+			MS_ASSERT(!this->nackBitmap.Test(seq), "packet already in the NACK list");
 
 			// Do not send NACK for packets that are already recovered by RTX.
-			if (this->recoveredList.find(seq) != this->recoveredList.end())
+			if (this->recoveredBitmap.Test(seq))
 				continue;
 
-			this->nackList.emplace(std::make_pair(
-			  seq,
-			  NackInfo{
-			    DepLibUV::GetTimeMs(),
-			    seq,
-			    seq,
-			  }));
+			this->nackList[(this->nackListFront + this->nackListSize) % NackListCapacity] =
+			  NackInfo{ nowMs, seq };
+			this->nackBitmap.Set(seq);
+
+			++this->nackListSize;
+			++this->nackListLength;
 		}
 	}
 
@@ -203,114 +281,214 @@ namespace RTC
 	{
 		MS_TRACE();
 
-		while (!this->keyFrameList.empty())
+		if (this->nackListLength == 0u)
+			return false;
+
+		// The front entry is not removed (see TrimNackList()).
+		const uint16_t firstSeq = this->nackList[this->nackListFront].seq;
+		const uint16_t seqEnd   = this->lastSeq + MaxSeqAhead;
+
+		// Key frames older than the first NACKed packet do not remove any packets
+		// from the list, so look for the first newer one.
+		const uint16_t keyFrameSeq = this->keyFrameBitmap.FindFirst(firstSeq + 1, seqEnd);
+
+		if (keyFrameSeq == seqEnd)
+			return false;
+
+		TrimNackList(keyFrameSeq);
+
+		return true;
+	}
+
+	NackGenerator::NackInfo* NackGenerator::GetNackInfo(uint16_t seq)
+	{
+		MS_TRACE();
+
+		// Not NACKed or too old for the NACK list (so its bit belongs to another
+		// seq).
+		// clang-format off
+		if (
+			static_cast<uint16_t>(this->lastSeq - seq) > MaxPacketAge ||
+			!this->nackBitmap.Test(seq)
+		)
+		// clang-format on
 		{
-			auto it = this->nackList.lower_bound(*this->keyFrameList.begin());
+			return nullptr;
+		}
+
+		// Entries are sorted by seq, so look for it by its distance to the first
+		// one.
+		const uint16_t firstSeq = this->nackList[this->nackListFront].seq;
+		const uint16_t distance = seq - firstSeq;
+		size_t low{ 0u };
+		size_t high{ this->nackListSize };
 
-			if (it != this->nackList.begin())
+		while (low < high)
+		{
+			const size_t mid = (low + high) / 2;
+			auto& nackInfo   = this->nackList[(this->nackListFront + mid) % NackListCapacity];
+
+			if (static_cast<uint16_t>(nackInfo.seq - firstSeq) < distance)
+				low = mid + 1;
+			else
+				high = mid;
+		}
+
+		if (low == this->nackListSize)
+			return nullptr;
+
+		auto& nackInfo = this->nackList[(this->nackListFront + low) % NackListCapacity];
+
+		return nackInfo.seq == seq ? &nackInfo : nullptr;
+	}
+
+	// The entry stays in the list until it reaches the front.
+	inline void NackGenerator::RemoveNackInfo(NackInfo& nackInfo)
+	{
+		this->nackBitmap.Reset(nackInfo.seq);
+
+		--this->nackListLength;
+	}
+
+	// Removes the entries lower than seq and drops the removed ones at the
+	// front, so the front entry (if any) is never a removed one.
+	void NackGenerator::TrimNackList(uint16_t seq)
+	{
+		MS_TRACE();
+
+		while (this->nackListSize != 0u)
+		{
+			auto& nackInfo = this->nackList[this->nackListFront];
+
+			if (this->nackBitmap.Test(nackInfo.seq))
 			{
-				// We have found a keyframe that actually is newer than at least one
-				// packet in the nack list.
-				this->nackList.erase(this->nackList.begin(), it);
+				if (!SeqManager<uint16_t>::IsSeqLowerThan(nackInfo.seq, seq))
+					break;
 
-				return true;
+				RemoveNackInfo(nackInfo);
 			}
 
-			// If this keyframe is so old it does not remove any packets from the list,
-			// remove it from the list of keyframes and try the next keyframe.
-			this->keyFrameList.erase(this->keyFrameList.begin());
+			this->nackListFront = (this->nackListFront + 1) % NackListCapacity;
+
+			--this->nackListSize;
 		}
+	}
 
-		return false;
+	void NackGenerator::CompactNackList()
+	{
+		MS_TRACE();
+
+		size_t size{ 0u };
+
+		for (size_t i{ 0u }; i < this->nackListSize; ++i)
+		{
+			auto& nackInfo = this->nackList[(this->nackListFront + i) % NackListCapacity];
+
+			if (!this->nackBitmap.Test(nackInfo.seq))
+				continue;
+
+			if (size != i)
+				this->nackList[(this->nackListFront + size) % NackListCapacity] = nackInfo;
+
+			++size;
+		}
+
+		this->nackListSize = size;
+	}
+
+	void NackGenerator::ClearNackList()
+	{
+		MS_TRACE();
+
+		this->nackBitmap.Clear();
+
+		this->nackListFront  = 0u;
+		this->nackListSize   = 0u;
+		this->nackListLength = 0u;
 	}
 
-	std::vector<uint16_t> NackGenerator::GetNackBatch(NackFilter filter)
+	const std::vector<uint16_t>& NackGenerator::GetNackBatch(NackFilter filter)
 	{
 		MS_TRACE();
 
 		const uint64_t nowMs = DepLibUV::GetTimeMs();
-		std::vector<uint16_t> nackBatch;
 
-		auto it = this->nackList.begin();
+		this->nackBatch.clear();
+
+		size_t first{ 0u };
+
+		// Entries are sent in creation order, so the ones never sent are at the
+		// back of the list and the SEQ filter (which only sends those) does not
+		// need to walk the whole list on every received packet.
+		if (filter == NackFilter::SEQ)
+		{
+			first = this->nackListSize;
+
+			while (first != 0u)
+			{
+				auto& nackInfo = this->nackList[(this->nackListFront + first - 1) % NackListCapacity];
+
+				if (this->nackBitmap.Test(nackInfo.seq) && nackInfo.sentAtMs != 0)
+					break;
+
+				--first;
+			}
+		}
 
-		while (it != this->nackList.end())
+		for (size_t i{ first }; i < this->nackListSize; ++i)
 		{
-			NackInfo& nackInfo = it->second;
+			NackInfo& nackInfo = this->nackList[(this->nackListFront + i) % NackListCapacity];
 			uint16_t seq       = nackInfo.seq;
 
+			// Removed.
+			if (!this->nackBitmap.Test(seq))
+				continue;
+
 			if (this->sendNackDelayMs > 0 && nowMs - nackInfo.createdAtMs < this->sendNackDelayMs)
-			{
-				++it;
 				continue;
-			}
 
+			// All the NACKed seqs are lower than the last seq so, with the SEQ
+			// filter, those never sent are due.
 			// clang-format off
-			if (
-				filter == NackFilter::SEQ &&
-				nackInfo.sentAtMs == 0 &&
+			const bool due =
+				(filter == NackFilter::SEQ && nackInfo.sentAtMs == 0) ||
 				(
-					nackInfo.sendAtSeq == this->lastSeq ||
-					SeqManager<uint16_t>::IsSeqHigherThan(this->lastSeq, nackInfo.sendAtSeq)
-				)
-			)
+					filter == NackFilter::TIME &&
+					(nackInfo.sentAtMs == 0 || nowMs - nackInfo.sentAtMs >= this->rtt)
+				);
 			// clang-format on
-			{
-				nackBatch.emplace_back(seq);
-				nackInfo.retries++;
-				nackInfo.sentAtMs = nowMs;
-
-				if (nackInfo.retries >= MaxNackRetries)
-				{
-					MS_WARN_TAG(
-					  rtx,
-					  "sequence number removed from the NACK list due to max retries [filter:seq, seq:%" PRIu16
-					  "]",
-					  seq);
-
-					it = this->nackList.erase(it);
-				}
-				else
-				{
-					++it;
-				}
 
+			if (!due)
 				continue;
-			}
 
-			if (filter == NackFilter::TIME && (nackInfo.sentAtMs == 0 || nowMs - nackInfo.sentAtMs >= this->rtt))
+			this->nackBatch.emplace_back(seq);
+			nackInfo.retries++;
+			nackInfo.sentAtMs = nowMs;
+
+			if (nackInfo.retries >= MaxNackRetries)
 			{
-				nackBatch.emplace_back(seq);
-				nackInfo.retries++;
-				nackInfo.sentAtMs = nowMs;
-
-				if (nackInfo.retries >= MaxNackRetries)
-				{
-					MS_WARN_TAG(
-					  rtx,
-					  "sequence number removed from the NACK list due to max retries [filter:time, seq:%" PRIu16
-					  "]",
-					  seq);
-
-					it = this->nackList.erase(it);
-				}
-				else
-				{
-					++it;
-				}
+				MS_WARN_TAG(
+				  rtx,
+				  "sequence number removed from the NACK list due to max retries [filter:%s, seq:%" PRIu16
+				  "]",
+				  filter == NackFilter::SEQ ? "seq" : "time",
+				  seq);
 
-				continue;
+				RemoveNackInfo(nackInfo);
 			}
-
-			++it;
 		}
 
+		TrimNackList(this->lastSeq - MaxPacketAge);
+
 #if MS_LOG_DEV_LEVEL == 3
-		if (!nackBatch.empty())
+		if (!this->nackBatch.empty())
 		{
 			std::ostringstream seqsStream;
 			std::copy(
-			  nackBatch.begin(), nackBatch.end() - 1, std::ostream_iterator<uint32_t>(seqsStream, ","));
-			seqsStream << nackBatch.back();
+			  this->nackBatch.begin(),
+			  this->nackBatch.end() - 1,
+			  std::ostream_iterator<uint32_t>(seqsStream, ","));
+			seqsStream << this->nackBatch.back();
 
 			if (filter == NackFilter::SEQ)
 				MS_DEBUG_DEV("[filter:SEQ, asking seqs:%s]", seqsStream.str().c_str());
@@ -319,16 +497,16 @@ namespace RTC
 		}
 #endif
 
-		return nackBatch;
+		return this->nackBatch;
 	}
 
 	void NackGenerator::Reset()
 	{
 		MS_TRACE();
 
-		this->nackList.clear();
-		this->keyFrameList.clear();
-		this->recoveredList.clear();
+		ClearNackList();
+		this->keyFrameBitmap.Clear();
+		this->recoveredBitmap.Clear();
 
 		this->started = false;
 		this->lastSeq = 0u;
@@ -336,7 +514,7 @@ namespace RTC
 
 	inline void NackGenerator::MayRunTimer() const
 	{
-		if (!this->nackList.empty())
+		if (this->nackListLength != 0u)
 			this->timer->Start(TimerInterval);
 	}
 
@@ -344,7 +522,7 @@ namespace RTC
 	{
 		MS_TRACE();
 
-		std::vector<uint16_t> nackBatch = GetNackBatch(NackFilter::TIME);
+		const auto& nackBatch = GetNackBatch(NackFilter::TIME);
 
 		if (!nackBatch.empty())
 			this->listener->OnNackGeneratorNackRequired(nackBatch);
@@ -28,44 +28,55 @@ namespace RTC
 	{
 		MS_TRACE();
 
-		auto jsonListenIpIt = data.find("listenIp");
+		bool inProcess{ false };
+		auto jsonInProcessIt = data.find("inProcess");
 
-		if (jsonListenIpIt == data.end())
-			MS_THROW_TYPE_ERROR("missing listenIp");
-		else if (!jsonListenIpIt->is_object())
-			MS_THROW_TYPE_ERROR("wrong listenIp (not an object)");
+		if (jsonInProcessIt != data.end() && jsonInProcessIt->is_boolean())
+			inProcess = jsonInProcessIt->get<bool>();
 
-		auto jsonIpIt = jsonListenIpIt->find("ip");
+		uint16_t port{ 0 };
 
-		if (jsonIpIt == jsonListenIpIt->end())
-			MS_THROW_TYPE_ERROR("missing listenIp.ip");
-		else if (!jsonIpIt->is_string())
-			MS_THROW_TYPE_ERROR("wrong listenIp.ip (not an string)");
+		// An in-process pipe needs no IP.
+		if (!inProcess)
+		{
+			auto jsonListenIpIt = data.find("listenIp");
 
-		this->listenIp.ip.assign(jsonIpIt->get<std::string>());
+			if (jsonListenIpIt == data.end())
+				MS_THROW_TYPE_ERROR("missing listenIp");
+			else if (!jsonListenIpIt->is_object())
+				MS_THROW_TYPE_ERROR("wrong listenIp (not an object)");
 
-		// This may throw.
-		Utils::IP::NormalizeIp(this->listenIp.ip);
+			auto jsonIpIt = jsonListenIpIt->find("ip");
 
-		auto jsonAnnouncedIpIt = jsonListenIpIt->find("announcedIp");
+			if (jsonIpIt == jsonListenIpIt->end())
+				MS_THROW_TYPE_ERROR("missing listenIp.ip");
+			else if (!jsonIpIt->is_string())
+				MS_THROW_TYPE_ERROR("wrong listenIp.ip (not an string)");
 
-		if (jsonAnnouncedIpIt != jsonListenIpIt->end())
-		{
-			if (!jsonAnnouncedIpIt->is_string())
-				MS_THROW_TYPE_ERROR("wrong listenIp.announcedIp (not an string");
+			this->listenIp.ip.assign(jsonIpIt->get<std::string>());
 
-			this->listenIp.announcedIp.assign(jsonAnnouncedIpIt->get<std::string>());
-		}
+			// This may throw.
+			Utils::IP::NormalizeIp(this->listenIp.ip);
 
-		uint16_t port{ 0 };
-		auto jsonPortIt = data.find("port");
+			auto jsonAnnouncedIpIt = jsonListenIpIt->find("announcedIp");
 
-		if (jsonPortIt != data.end())
-		{
-			if (!(jsonPortIt->is_number() && Utils::Json::IsPositiveInteger(*jsonPortIt)))
-				MS_THROW_TYPE_ERROR("wrong port (not a positive number)");
+			if (jsonAnnouncedIpIt != jsonListenIpIt->end())
+			{
+				if (!jsonAnnouncedIpIt->is_string())
+					MS_THROW_TYPE_ERROR("wrong listenIp.announcedIp (not an string");
+
+				this->listenIp.announcedIp.assign(jsonAnnouncedIpIt->get<std::string>());
+			}
+
+			auto jsonPortIt = data.find("port");
 
-			port = jsonPortIt->get<uint16_t>();
+			if (jsonPortIt != data.end())
+			{
+				if (!(jsonPortIt->is_number() && Utils::Json::IsPositiveInteger(*jsonPortIt)))
+					MS_THROW_TYPE_ERROR("wrong port (not a positive number)");
+
+				port = jsonPortIt->get<uint16_t>();
+			}
 		}
 
 		auto jsonEnableRtxIt = data.find("enableRtx");
@@ -83,6 +94,10 @@ namespace RTC
 		)
 		// clang-format on
 		{
+			// Packets never leave the process.
+			if (inProcess)
+				MS_THROW_TYPE_ERROR("SRTP not supported by in-process pipes");
+
 			this->srtpKey       = Utils::Crypto::GetRandomString(PipeTransport::srtpMasterLength);
 			this->srtpKeyBase64 = Utils::String::Base64Encode(this->srtpKey);
 		}
@@ -90,7 +105,9 @@ namespace RTC
 		try
 		{
 			// This may throw.
-			if (port != 0)
+			if (inProcess)
+				this->inProcessPipe = new RTC::InProcessPipe(this, this->id);
+			else if (port != 0)
 				this->udpSocket = new RTC::UdpSocket(this, this->listenIp.ip, port);
 			else
 				this->udpSocket = new RTC::UdpSocket(this, this->listenIp.ip);
@@ -109,6 +126,9 @@ namespace RTC
 			delete this->udpSocket;
 			this->udpSocket = nullptr;
 
+			delete this->inProcessPipe;
+			this->inProcessPipe = nullptr;
+
 			throw;
 		}
 	}
@@ -122,6 +142,9 @@ namespace RTC
 		delete this->udpSocket;
 		this->udpSocket = nullptr;
 
+		delete this->inProcessPipe;
+		this->inProcessPipe = nullptr;
+
 		delete this->tuple;
 		this->tuple = nullptr;
 
@@ -139,12 +162,15 @@ namespace RTC
 		// Call the parent method.
 		RTC::Transport::FillJson(jsonObject);
 
+		// Add inProcess.
+		jsonObject["inProcess"] = this->inProcessPipe != nullptr;
+
 		// Add tuple.
 		if (this->tuple)
 		{
 			this->tuple->FillJson(jsonObject["tuple"]);
 		}
-		else
+		else if (this->udpSocket)
 		{
 			jsonObject["tuple"] = json::object();
 			auto jsonTupleIt    = jsonObject.find("tuple");
@@ -184,11 +210,15 @@ namespace RTC
 		// Add type.
 		jsonObject["type"] = "pipe-transport";
 
+		// Add inProcessPipe.
+		if (this->inProcessPipe)
+			this->inProcessPipe->FillJsonStats(jsonObject["inProcessPipe"]);
+
 		if (this->tuple)
 		{
 			this->tuple->FillJson(jsonObject["tuple"]);
 		}
-		else
+		else if (this->udpSocket)
 		{
 			// Add tuple.
 			jsonObject["tuple"] = json::object();
@@ -213,9 +243,34 @@ namespace RTC
 			case Channel::ChannelRequest::MethodId::TRANSPORT_CONNECT:
 			{
 				// Ensure this method is not called twice.
-				if (this->tuple)
+				if (IsConnected())
 					MS_THROW_ERROR("connect() already called");
 
+				if (this->inProcessPipe)
+				{
+					auto jsonPipeTransportIdIt = request->data.find("pipeTransportId");
+
+					// clang-format off
+					if (
+						jsonPipeTransportIdIt == request->data.end() ||
+						!jsonPipeTransportIdIt->is_string()
+					)
+					// clang-format on
+					{
+						MS_THROW_TYPE_ERROR("missing pipeTransportId");
+					}
+
+					// This may throw.
+					this->inProcessPipe->Connect(jsonPipeTransportIdIt->get<std::string>());
+
+					request->Accept();
+
+					// Tell the parent class.
+					RTC::Transport::Connected();
+
+					break;
+				}
+
 				try
 				{
 					std::string ip;
@@ -435,6 +490,9 @@ namespace RTC
 
 	inline bool PipeTransport::IsConnected() const
 	{
+		if (this->inProcessPipe)
+			return this->inProcessPipe->IsConnected();
+
 		return this->tuple;
 	}
 
@@ -443,8 +501,28 @@ namespace RTC
 		return !this->srtpKey.empty();
 	}
 
+	inline void PipeTransport::SendData(
+	  const uint8_t* data, size_t len, const RTC::Transport::onSendCallback& cb)
+	{
+		MS_TRACE();
+
+		if (this->inProcessPipe)
+		{
+			const bool sent = this->inProcessPipe->Send(data, len);
+
+			if (cb)
+			{
+				cb(sent);
+			}
+		}
+		else
+		{
+			this->tuple->Send(data, len, cb);
+		}
+	}
+
 	void PipeTransport::SendRtpPacket(
-	  RTC::Consumer* /*consumer*/, RTC::RtpPacket* packet, RTC::Transport::onSendCallback* cb)
+	  RTC::Consumer* /*consumer*/, RTC::RtpPacket* packet, const RTC::Transport::onSendCallback& cb)
 	{
 		MS_TRACE();
 
@@ -452,8 +530,7 @@ namespace RTC
 		{
 			if (cb)
 			{
-				(*cb)(false);
-				delete cb;
+				cb(false);
 			}
 
 			return;
@@ -466,8 +543,7 @@ namespace RTC
 		{
 			if (cb)
 			{
-				(*cb)(false);
-				delete cb;
+				cb(false);
 			}
 
 			return;
@@ -475,7 +551,7 @@ namespace RTC
 
 		auto len = static_cast<size_t>(intLen);
 
-		this->tuple->Send(data, len, cb);
+		SendData(data, len, cb);
 
 		// Increase send transmission.
 		RTC::Transport::DataSent(len);
@@ -496,7 +572,7 @@ namespace RTC
 
 		auto len = static_cast<size_t>(intLen);
 
-		this->tuple->Send(data, len);
+		SendData(data, len);
 
 		// Increase send transmission.
 		RTC::Transport::DataSent(len);
@@ -519,18 +595,19 @@ namespace RTC
 
 		auto len = static_cast<size_t>(intLen);
 
-		this->tuple->Send(data, len);
+		SendData(data, len);
 
 		// Increase send transmission.
 		RTC::Transport::DataSent(len);
 	}
 
 	void PipeTransport::SendMessage(
-	  RTC::DataConsumer* dataConsumer, uint32_t ppid, const uint8_t* msg, size_t len, onQueuedCallback* cb)
+	  RTC::DataConsumer* dataConsumer, uint32_t ppid, RTC::MessageBuffer* message, onQueuedCallback* cb)
 	{
 		MS_TRACE();
 
-		this->sctpAssociation->SendSctpMessage(dataConsumer, ppid, msg, len, cb);
+		this->sctpAssociation->SendSctpMessage(
+		  dataConsumer, ppid, message->GetData(), message->GetSize(), cb);
 	}
 
 	void PipeTransport::SendSctpData(const uint8_t* data, size_t len)
@@ -540,7 +617,7 @@ namespace RTC
 		if (!IsConnected())
 			return;
 
-		this->tuple->Send(data, len);
+		SendData(data, len);
 
 		// Increase send transmission.
 		RTC::Transport::DataSent(len);
@@ -637,7 +714,7 @@ namespace RTC
 		}
 
 		// Verify that the packet's tuple matches our tuple.
-		if (!this->tuple->Compare(tuple))
+		if (this->tuple && !this->tuple->Compare(tuple))
 		{
 			MS_DEBUG_TAG(rtp, "ignoring RTP packet from unknown IP:port");
 
@@ -670,7 +747,7 @@ namespace RTC
 		}
 
 		// Verify that the packet's tuple matches our tuple.
-		if (!this->tuple->Compare(tuple))
+		if (this->tuple && !this->tuple->Compare(tuple))
 		{
 			MS_DEBUG_TAG(rtcp, "ignoring RTCP packet from unknown IP:port");
 
@@ -699,7 +776,7 @@ namespace RTC
 			return;
 
 		// Verify that the packet's tuple matches our tuple.
-		if (!this->tuple->Compare(tuple))
+		if (this->tuple && !this->tuple->Compare(tuple))
 		{
 			MS_DEBUG_TAG(sctp, "ignoring SCTP packet from unknown IP:port");
 
@@ -719,4 +796,13 @@ namespace RTC
 
 		OnPacketReceived(&tuple, data, len);
 	}
+
+	inline void PipeTransport::OnInProcessPipePacketReceived(
+	  RTC::InProcessPipe* /*pipe*/, uint8_t* data, size_t len)
+	{
+		MS_TRACE();
+
+		// No tuple to verify, just the connected remote endpoint writes here.
+		OnPacketReceived(nullptr, data, len);
+	}
 } // namespace RTC
@@ -710,7 +710,7 @@ namespace RTC
 	}
 
 	void PlainTransport::SendRtpPacket(
-	  RTC::Consumer* /*consumer*/, RTC::RtpPacket* packet, RTC::Transport::onSendCallback* cb)
+	  RTC::Consumer* /*consumer*/, RTC::RtpPacket* packet, const RTC::Transport::onSendCallback& cb)
 	{
 		MS_TRACE();
 
@@ -718,8 +718,7 @@ namespace RTC
 		{
 			if (cb)
 			{
-				(*cb)(false);
-				delete cb;
+				cb(false);
 			}
 
 			return;
@@ -732,8 +731,7 @@ namespace RTC
 		{
 			if (cb)
 			{
-				(*cb)(false);
-				delete cb;
+				cb(false);
 			}
 
 			return;
@@ -798,11 +796,12 @@ namespace RTC
 	}
 
 	void PlainTransport::SendMessage(
-	  RTC::DataConsumer* dataConsumer, uint32_t ppid, const uint8_t* msg, size_t len, onQueuedCallback* cb)
+	  RTC::DataConsumer* dataConsumer, uint32_t ppid, RTC::MessageBuffer* message, onQueuedCallback* cb)
 	{
 		MS_TRACE();
 
-		this->sctpAssociation->SendSctpMessage(dataConsumer, ppid, msg, len, cb);
+		this->sctpAssociation->SendSctpMessage(
+		  dataConsumer, ppid, message->GetData(), message->GetSize(), cb);
 	}
 
 	void PlainTransport::SendSctpData(const uint8_t* data, size_t len)
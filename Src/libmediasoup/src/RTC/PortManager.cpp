@@ -7,8 +7,17 @@
 #include "MediaSoupErrors.hpp"
 #include "Settings.hpp"
 #include "Utils.hpp"
+#include <cstring> // std::strerror()
 #include <tuple>   // std:make_tuple()
 #include <utility> // std::piecewise_construct
+#ifdef __linux__
+#include <linux/filter.h> // struct sock_filter, struct sock_fprog
+#include <sys/socket.h>   // setsockopt()
+#endif
+
+#if defined(__linux__) && !defined(SO_ATTACH_REUSEPORT_CBPF)
+#define SO_ATTACH_REUSEPORT_CBPF 51
+#endif
 
 /* Static methods for UV callbacks. */
 
@@ -22,6 +31,85 @@ inline static void onFakeConnection(uv_stream_t* /*handle*/, int /*status*/)
 	// Do nothing.
 }
 
+#ifdef __linux__
+/**
+ * Classic BPF program run by the kernel to choose the socket of a UDP
+ * reuseport group that gets a datagram. The datagram payload starts at
+ * offset 0.
+ *
+ * For STUN Binding requests it looks for the USERNAME attribute within the
+ * first attributes and returns the index encoded (two lowercase hex digits)
+ * at the start of it, which is the local ICE usernameFragment prefix. Any
+ * other datagram returns an out of range index, so the kernel falls back to
+ * its 4-tuple hash. Datagrams of established ICE tuples do not get here since
+ * they match a connected socket first.
+ */
+static std::vector<struct sock_filter> buildIceSteeringFilter()
+{
+	static constexpr size_t MaxAttributes{ 4u };
+	// Instructions per attribute.
+	static constexpr size_t AttributeLen{ 8u };
+	static constexpr uint32_t NoIndex{ 0xFFFFFFFF };
+	// Position of the "return NoIndex" instruction.
+	static constexpr uint8_t NoIndexPos{ 5 + (AttributeLen * MaxAttributes) };
+
+	std::vector<struct sock_filter> filter;
+
+	auto append = [&filter](uint16_t code, uint32_t k, uint8_t jt = 0, uint8_t jf = 0)
+	{
+		filter.push_back(BPF_JUMP(code, k, jt, jf));
+	};
+
+	// Appends the conversion of the hex digit in A into its value.
+	auto appendHexDigit = [&append]()
+	{
+		append(BPF_JMP | BPF_JGE | BPF_K, 'a', 0, 2);
+		append(BPF_ALU | BPF_SUB | BPF_K, 'a' - 10);
+		append(BPF_JMP | BPF_JA, 1);
+		append(BPF_ALU | BPF_SUB | BPF_K, '0');
+	};
+
+	// Binding request with the magic cookie.
+	append(BPF_LD | BPF_H | BPF_ABS, 0);
+	append(BPF_JMP | BPF_JEQ | BPF_K, 0x0001, 0, NoIndexPos - 2);
+	append(BPF_LD | BPF_W | BPF_ABS, 4);
+	append(BPF_JMP | BPF_JEQ | BPF_K, 0x2112A442, 0, NoIndexPos - 4);
+	// X is the offset of the current attribute.
+	append(BPF_LDX | BPF_W | BPF_IMM, 20);
+
+	for (size_t i{ 0u }; i < MaxAttributes; ++i)
+	{
+		// Jump to the decoding (right after NoIndexPos) once USERNAME is found.
+		const auto toDecode = static_cast<uint8_t>((AttributeLen * (MaxAttributes - i)) - 1);
+
+		append(BPF_LD | BPF_H | BPF_IND, 0);
+		append(BPF_JMP | BPF_JEQ | BPF_K, 0x0006, toDecode, 0);
+		// Otherwise skip the attribute (4 bytes header plus padded value).
+		append(BPF_LD | BPF_H | BPF_IND, 2);
+		append(BPF_ALU | BPF_ADD | BPF_K, 3);
+		append(BPF_ALU | BPF_AND | BPF_K, 0xFFFC);
+		append(BPF_ALU | BPF_ADD | BPF_K, 4);
+		append(BPF_ALU | BPF_ADD | BPF_X, 0);
+		append(BPF_MISC | BPF_TAX, 0);
+	}
+
+	append(BPF_RET | BPF_K, NoIndex);
+
+	// Decode the two hex digits at the start of the USERNAME value.
+	append(BPF_LD | BPF_B | BPF_IND, 4);
+	appendHexDigit();
+	append(BPF_ALU | BPF_LSH | BPF_K, 4);
+	append(BPF_ST, 0);
+	append(BPF_LD | BPF_B | BPF_IND, 5);
+	appendHexDigit();
+	append(BPF_LDX | BPF_W | BPF_MEM, 0);
+	append(BPF_ALU | BPF_OR | BPF_X, 0);
+	append(BPF_RET | BPF_A, 0);
+
+	return filter;
+}
+#endif
+
 namespace RTC
 {
 	/* Class variables. */
@@ -314,7 +402,12 @@ namespace RTC
 		return static_cast<uv_handle_t*>(uvHandle);
 	}
 
-	uv_handle_t* PortManager::Bind(Transport transport, std::string& ip, uint16_t port)
+	uv_handle_t* PortManager::Bind(
+	  Transport transport,
+	  std::string& ip,
+	  uint16_t port,
+	  bool reusePort,
+	  const struct sockaddr* remoteAddr)
 	{
 		MS_TRACE();
 
@@ -388,8 +481,12 @@ namespace RTC
 		{
 			case Transport::UDP:
 				uvHandle = reinterpret_cast<uv_handle_t*>(new uv_udp_t());
-				err      = uv_udp_init_ex(
-          DepLibUV::GetLoop(), reinterpret_cast<uv_udp_t*>(uvHandle), UV_UDP_RECVMMSG);
+				// Given a family, the socket is created right away so options can be
+				// set before binding it.
+				err = uv_udp_init_ex(
+				  DepLibUV::GetLoop(),
+				  reinterpret_cast<uv_udp_t*>(uvHandle),
+				  reusePort ? (family | UV_UDP_RECVMMSG) : UV_UDP_RECVMMSG);
 				break;
 
 			case Transport::TCP:
@@ -414,6 +511,33 @@ namespace RTC
 			}
 		}
 
+		if (reusePort)
+		{
+#if defined(__linux__)
+			uv_os_fd_t fd;
+			const int on{ 1 };
+
+			err = uv_fileno(uvHandle, &fd);
+
+			if (err == 0 && setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, &on, sizeof(on)) != 0)
+				err = uv_translate_sys_error(errno);
+#else
+			err = UV_ENOTSUP;
+#endif
+
+			if (err != 0)
+			{
+				uv_close(reinterpret_cast<uv_handle_t*>(uvHandle), static_cast<uv_close_cb>(onClose));
+
+				MS_THROW_ERROR(
+				  "setting SO_REUSEPORT failed [transport:%s, ip:'%s', port:%" PRIu16 "]: %s",
+				  transportStr.c_str(),
+				  ip.c_str(),
+				  port,
+				  uv_strerror(err));
+			}
+		}
+
 		switch (transport)
 		{
 			case Transport::UDP:
@@ -436,6 +560,51 @@ namespace RTC
 					  uv_strerror(err));
 				}
 
+				if (remoteAddr)
+				{
+					err = uv_udp_connect(reinterpret_cast<uv_udp_t*>(uvHandle), remoteAddr);
+
+					if (err != 0)
+					{
+						uv_close(reinterpret_cast<uv_handle_t*>(uvHandle), static_cast<uv_close_cb>(onClose));
+
+						MS_THROW_ERROR(
+						  "uv_udp_connect() failed [transport:%s, ip:'%s', port:%" PRIu16 "]: %s",
+						  transportStr.c_str(),
+						  ip.c_str(),
+						  port,
+						  uv_strerror(err));
+					}
+				}
+#ifdef __linux__
+				else if (reusePort)
+				{
+					// The program applies to the whole group, so every worker attaching it
+					// just replaces it with the same one.
+					static const std::vector<struct sock_filter> IceSteeringFilter =
+					  buildIceSteeringFilter();
+
+					uv_os_fd_t fd;
+					struct sock_fprog prog; // NOLINT(cppcoreguidelines-pro-type-member-init)
+
+					prog.len    = static_cast<unsigned short>(IceSteeringFilter.size());
+					prog.filter = const_cast<struct sock_filter*>(IceSteeringFilter.data());
+
+					// Not fatal, datagrams are then spread by 4-tuple hash.
+					if (
+					  uv_fileno(uvHandle, &fd) != 0 ||
+					  setsockopt(fd, SOL_SOCKET, SO_ATTACH_REUSEPORT_CBPF, &prog, sizeof(prog)) != 0)
+					{
+						MS_WARN_TAG(
+						  ice,
+						  "failed to attach ICE steering program [ip:'%s', port:%" PRIu16 "]: %s",
+						  ip.c_str(),
+						  port,
+						  std::strerror(errno));
+					}
+				}
+#endif
+
 				break;
 			}
 
@@ -477,6 +477,29 @@ namespace RTC
 		}
 	}
 
+	void Producer::FillBinaryStats(RTC::StatsPublisher* statsPublisher) const
+	{
+		MS_TRACE();
+
+		RTC::StatsPublisher::Counters counters;
+
+		for (auto* rtpStream : this->rtpStreamByEncodingIdx)
+		{
+			if (!rtpStream)
+				continue;
+
+			const size_t numCounters = rtpStream->FillStatsCounters(counters);
+
+			statsPublisher->AddEntry(
+			  rtpStream,
+			  RTC::StatsPublisher::EntryType::INBOUND_RTP,
+			  this->id,
+			  rtpStream->GetSsrc(),
+			  counters,
+			  numCounters);
+		}
+	}
+
 	void Producer::HandleRequest(Channel::ChannelRequest* request)
 	{
 		MS_TRACE();
@@ -186,6 +186,18 @@ namespace RTC
 			return false;
 		}
 
+		void CompoundPacket::Reset()
+		{
+			MS_TRACE();
+
+			this->header = nullptr;
+
+			this->senderReportPacket.DeleteReports();
+			this->receiverReportPacket.DeleteReports();
+			this->sdesPacket.DeleteChunks();
+			this->xrPacket.DeleteReports();
+		}
+
 		void CompoundPacket::Dump()
 		{
 			MS_TRACE();
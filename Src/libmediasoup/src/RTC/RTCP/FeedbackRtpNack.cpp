@@ -3,6 +3,7 @@
 
 #include "RTC/RTCP/FeedbackRtpNack.hpp"
 #include "Logger.hpp"
+#include "RTC/RTCP/ReportPool.hpp"
 #include <bitset> // std::bitset()
 #include <cstring>
 
@@ -10,11 +11,22 @@ namespace RTC
 {
 	namespace RTCP
 	{
+		/* Class methods. */
+
+		void* FeedbackRtpNackItem::operator new(size_t size)
+		{
+			return ReportPool::Allocate(size);
+		}
+
+		void FeedbackRtpNackItem::operator delete(void* ptr, size_t size)
+		{
+			ReportPool::Free(ptr, size);
+		}
+
 		/* Instance methods. */
 		FeedbackRtpNackItem::FeedbackRtpNackItem(uint16_t packetId, uint16_t lostPacketBitmask)
+		  : header(&this->data)
 		{
-			this->raw    = new uint8_t[HeaderSize];
-			this->header = reinterpret_cast<Header*>(this->raw);
 
 			this->header->packetId          = uint16_t{ htons(packetId) };
 			this->header->lostPacketBitmask = uint16_t{ htons(lostPacketBitmask) };
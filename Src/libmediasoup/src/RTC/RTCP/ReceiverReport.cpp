@@ -4,6 +4,7 @@
 #include "RTC/RTCP/ReceiverReport.hpp"
 #include "Logger.hpp"
 #include "Utils.hpp"
+#include "RTC/RTCP/ReportPool.hpp"
 #include <cstring>
 
 namespace RTC
@@ -30,6 +31,16 @@ namespace RTC
 			return new ReceiverReport(header);
 		}
 
+		void* ReceiverReport::operator new(size_t size)
+		{
+			return ReportPool::Allocate(size);
+		}
+
+		void ReceiverReport::operator delete(void* ptr, size_t size)
+		{
+			ReportPool::Free(ptr, size);
+		}
+
 		/* Instance methods. */
 
 		void ReceiverReport::Dump() const
@@ -0,0 +1,94 @@
+#define MS_CLASS "RTC::RTCP::ReportPool"
+// #define MS_LOG_DEV_LEVEL 3
+
+#include "RTC/RTCP/ReportPool.hpp"
+#include "Logger.hpp"
+#include <new> // ::operator new(), ::operator delete()
+
+namespace RTC
+{
+	namespace RTCP
+	{
+		/* Static. */
+
+		// Max number of items kept in each free list. Beyond this they are
+		// returned to the system so a peak of Consumers does not pin memory
+		// forever.
+		static constexpr size_t MaxFreeItems{ 8192u };
+
+		/* Class variables. */
+
+		thread_local ReportPool::FreeList ReportPool::freeLists[ReportPool::NumSizeClasses];
+		thread_local uint64_t ReportPool::hits{ 0u };
+		thread_local uint64_t ReportPool::misses{ 0u };
+
+		/* Class methods. */
+
+		void* ReportPool::Allocate(size_t size)
+		{
+			MS_TRACE();
+
+			const size_t idx = (size - 1) / ReportPool::SizeClass;
+
+			// Not pooled.
+			if (idx >= ReportPool::NumSizeClasses)
+				return ::operator new(size);
+
+			auto& freeList = ReportPool::freeLists[idx];
+
+			if (!freeList.items.empty())
+			{
+				void* ptr = freeList.items.back();
+
+				freeList.items.pop_back();
+				++ReportPool::hits;
+
+				return ptr;
+			}
+
+			++ReportPool::misses;
+
+			// Allocate the whole size class so the item can be reused by any
+			// instance in it.
+			return ::operator new((idx + 1) * ReportPool::SizeClass);
+		}
+
+		void ReportPool::Free(void* ptr, size_t size)
+		{
+			MS_TRACE();
+
+			const size_t idx = (size - 1) / ReportPool::SizeClass;
+
+			if (idx < ReportPool::NumSizeClasses && ReportPool::freeLists[idx].items.size() < MaxFreeItems)
+				ReportPool::freeLists[idx].items.push_back(ptr);
+			else
+				::operator delete(ptr);
+		}
+
+		void ReportPool::FillJson(json& jsonObject)
+		{
+			MS_TRACE();
+
+			size_t freeItems{ 0u };
+
+			for (auto& freeList : ReportPool::freeLists)
+			{
+				freeItems += freeList.items.size();
+			}
+
+			jsonObject["hits"]      = ReportPool::hits;
+			jsonObject["misses"]    = ReportPool::misses;
+			jsonObject["freeItems"] = freeItems;
+		}
+
+		/* Instance methods. */
+
+		ReportPool::FreeList::~FreeList()
+		{
+			for (auto* item : this->items)
+			{
+				::operator delete(item);
+			}
+		}
+	} // namespace RTCP
+} // namespace RTC
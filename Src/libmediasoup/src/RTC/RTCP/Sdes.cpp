@@ -4,6 +4,7 @@
 #include "RTC/RTCP/Sdes.hpp"
 #include "Logger.hpp"
 #include "Utils.hpp"
+#include "RTC/RTCP/ReportPool.hpp"
 #include <cstring>
 
 namespace RTC
@@ -62,6 +63,16 @@ namespace RTC
 			return it->second;
 		}
 
+		void* SdesItem::operator new(size_t size)
+		{
+			return ReportPool::Allocate(size);
+		}
+
+		void SdesItem::operator delete(void* ptr, size_t size)
+		{
+			ReportPool::Free(ptr, size);
+		}
+
 		/* Instance methods. */
 
 		SdesItem::SdesItem(SdesItem::Type type, size_t len, const char* value)
@@ -88,7 +99,9 @@ namespace RTC
 			MS_DUMP("<SdesItem>");
 			MS_DUMP("  type   : %s", SdesItem::Type2String(this->GetType()).c_str());
 			MS_DUMP("  length : %" PRIu8, this->header->length);
-			MS_DUMP("  value  : %.*s", this->header->length, this->header->value);
+			// Log arguments are copied as C strings, and the value is not null
+			// terminated.
+			MS_DUMP("  value  : %s", std::string(this->header->value, this->header->length).c_str());
 			MS_DUMP("</SdesItem>");
 		}
 
@@ -139,6 +152,16 @@ namespace RTC
 			return chunk.release();
 		}
 
+		void* SdesChunk::operator new(size_t size)
+		{
+			return ReportPool::Allocate(size);
+		}
+
+		void SdesChunk::operator delete(void* ptr, size_t size)
+		{
+			ReportPool::Free(ptr, size);
+		}
+
 		/* Instance methods. */
 
 		size_t SdesChunk::Serialize(uint8_t* buffer)
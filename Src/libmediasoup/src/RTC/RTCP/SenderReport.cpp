@@ -3,6 +3,7 @@
 
 #include "RTC/RTCP/SenderReport.hpp"
 #include "Logger.hpp"
+#include "RTC/RTCP/ReportPool.hpp"
 #include <cstring>
 
 namespace RTC
@@ -29,6 +30,16 @@ namespace RTC
 			return new SenderReport(header);
 		}
 
+		void* SenderReport::operator new(size_t size)
+		{
+			return ReportPool::Allocate(size);
+		}
+
+		void SenderReport::operator delete(void* ptr, size_t size)
+		{
+			ReportPool::Free(ptr, size);
+		}
+
 		/* Instance methods. */
 
 		void SenderReport::Dump() const
@@ -3,6 +3,7 @@
 
 #include "Logger.hpp"
 #include "Utils.hpp"
+#include "RTC/RTCP/ReportPool.hpp"
 #include "RTC/RTCP/XrDelaySinceLastRr.hpp"
 #include "RTC/RTCP/XrReceiverReferenceTime.hpp"
 
@@ -50,6 +51,16 @@ namespace RTC
 			return nullptr;
 		}
 
+		void* ExtendedReportBlock::operator new(size_t size)
+		{
+			return ReportPool::Allocate(size);
+		}
+
+		void ExtendedReportBlock::operator delete(void* ptr, size_t size)
+		{
+			ReportPool::Free(ptr, size);
+		}
+
 		/* Instance methods. */
 
 		/* Class methods. */
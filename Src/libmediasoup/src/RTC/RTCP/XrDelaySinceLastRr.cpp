@@ -3,6 +3,7 @@
 
 #include "RTC/RTCP/XrDelaySinceLastRr.hpp"
 #include "Logger.hpp"
+#include "RTC/RTCP/ReportPool.hpp"
 #include <cstring>
 
 namespace RTC
@@ -31,6 +32,16 @@ namespace RTC
 			return ssrcInfo;
 		}
 
+		void* DelaySinceLastRr::SsrcInfo::operator new(size_t size)
+		{
+			return ReportPool::Allocate(size);
+		}
+
+		void DelaySinceLastRr::SsrcInfo::operator delete(void* ptr, size_t size)
+		{
+			ReportPool::Free(ptr, size);
+		}
+
 		/* Instance methods. */
 
 		void DelaySinceLastRr::SsrcInfo::Dump() const
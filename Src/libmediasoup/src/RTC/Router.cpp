@@ -2,6 +2,7 @@
 // #define MS_LOG_DEV_LEVEL 3
 
 #include "RTC/Router.hpp"
+#include "ForwardingMetrics.hpp"
 #include "Logger.hpp"
 #include "MediaSoupErrors.hpp"
 #include "Utils.hpp"
@@ -11,9 +12,40 @@
 #include "RTC/PipeTransport.hpp"
 #include "RTC/PlainTransport.hpp"
 #include "RTC/WebRtcTransport.hpp"
+#include "handles/UdpSocketHandler.hpp"
+#include <cstring> // std::memcpy()
 
 namespace RTC
 {
+	/* Class methods. */
+
+	void Router::UpdateFanOutEntry(FanOutEntry& entry)
+	{
+		MS_TRACE();
+
+		auto* consumer  = entry.consumer;
+		const auto& mid = consumer->GetRtpParameters().mid;
+
+		entry.active       = consumer->IsActive();
+		entry.filterBySsrc = consumer->GetForwardedMappedSsrcs(entry.mappedSsrcs);
+
+		if (mid.length() > RTC::MidMaxLength)
+		{
+			MS_ERROR(
+			  "no enough space for MID value [MidMaxLength:%" PRIu8 ", mid:'%s']",
+			  RTC::MidMaxLength,
+			  mid.c_str());
+
+			entry.midLen = 0u;
+		}
+		else
+		{
+			std::memcpy(entry.mid.data(), mid.c_str(), mid.length());
+
+			entry.midLen = static_cast<uint8_t>(mid.length());
+		}
+	}
+
 	/* Instance methods. */
 
 	Router::Router(RTC::Shared* shared, const std::string& id, Listener* listener)
@@ -98,15 +130,15 @@ namespace RTC
 
 		for (const auto& kv : this->mapProducerConsumers)
 		{
-			auto* producer        = kv.first;
-			const auto& consumers = kv.second;
+			auto* producer     = kv.first;
+			const auto& fanOut = kv.second;
 
 			(*jsonMapProducerConsumersIt)[producer->id] = json::array();
 			auto jsonProducerIdIt                       = jsonMapProducerConsumersIt->find(producer->id);
 
-			for (auto* consumer : consumers)
+			for (const auto& entry : fanOut.entries)
 			{
-				jsonProducerIdIt->emplace_back(consumer->id);
+				jsonProducerIdIt->emplace_back(entry.consumer->id);
 			}
 		}
 
@@ -171,6 +203,18 @@ namespace RTC
 		}
 	}
 
+	void Router::FillBinaryStats(RTC::StatsPublisher* statsPublisher)
+	{
+		MS_TRACE();
+
+		for (auto& kv : this->mapTransports)
+		{
+			auto* transport = kv.second;
+
+			transport->FillBinaryStats(statsPublisher);
+		}
+	}
+
 	void Router::HandleRequest(Channel::ChannelRequest* request)
 	{
 		MS_TRACE();
@@ -582,18 +626,18 @@ namespace RTC
 		  "Producer not present in mapProducerRtpObservers");
 
 		// Close all Consumers associated to the closed Producer.
-		auto& consumers = mapProducerConsumersIt->second;
+		auto& fanOut = mapProducerConsumersIt->second;
 
 		// NOTE: While iterating the set of Consumers, we call ProducerClosed() on each
 		// one, which will end calling Router::OnTransportConsumerProducerClosed(),
 		// which will remove the Consumer from mapConsumerProducer but won't remove the
 		// closed Consumer from the set of Consumers in mapProducerConsumers (here will
 		// erase the complete entry in that map).
-		for (auto* consumer : consumers)
+		for (auto& entry : fanOut.entries)
 		{
 			// Call consumer->ProducerClosed() so the Consumer will notify the Node process,
 			// will notify its Transport, and its Transport will delete the Consumer.
-			consumer->ProducerClosed();
+			entry.consumer->ProducerClosed();
 		}
 
 		// Tell all RtpObservers that the Producer has been closed.
@@ -614,11 +658,13 @@ namespace RTC
 	{
 		MS_TRACE();
 
-		auto& consumers = this->mapProducerConsumers.at(producer);
+		auto& fanOut = this->mapProducerConsumers.at(producer);
 
-		for (auto* consumer : consumers)
+		for (auto& entry : fanOut.entries)
 		{
-			consumer->ProducerPaused();
+			entry.consumer->ProducerPaused();
+
+			UpdateFanOutEntry(entry);
 		}
 
 		auto it = this->mapProducerRtpObservers.find(producer);
@@ -638,11 +684,13 @@ namespace RTC
 	{
 		MS_TRACE();
 
-		auto& consumers = this->mapProducerConsumers.at(producer);
+		auto& fanOut = this->mapProducerConsumers.at(producer);
 
-		for (auto* consumer : consumers)
+		for (auto& entry : fanOut.entries)
 		{
-			consumer->ProducerResumed();
+			entry.consumer->ProducerResumed();
+
+			UpdateFanOutEntry(entry);
 		}
 
 		auto it = this->mapProducerRtpObservers.find(producer);
@@ -663,11 +711,13 @@ namespace RTC
 	{
 		MS_TRACE();
 
-		auto& consumers = this->mapProducerConsumers.at(producer);
+		auto& fanOut = this->mapProducerConsumers.at(producer);
 
-		for (auto* consumer : consumers)
+		for (auto& entry : fanOut.entries)
 		{
-			consumer->ProducerNewRtpStream(rtpStream, mappedSsrc);
+			entry.consumer->ProducerNewRtpStream(rtpStream, mappedSsrc);
+
+			UpdateFanOutEntry(entry);
 		}
 	}
 
@@ -680,11 +730,13 @@ namespace RTC
 	{
 		MS_TRACE();
 
-		auto& consumers = this->mapProducerConsumers.at(producer);
+		auto& fanOut = this->mapProducerConsumers.at(producer);
 
-		for (auto* consumer : consumers)
+		for (auto& entry : fanOut.entries)
 		{
-			consumer->ProducerRtpStreamScore(rtpStream, score, previousScore);
+			entry.consumer->ProducerRtpStreamScore(rtpStream, score, previousScore);
+
+			UpdateFanOutEntry(entry);
 		}
 	}
 
@@ -693,11 +745,11 @@ namespace RTC
 	{
 		MS_TRACE();
 
-		auto& consumers = this->mapProducerConsumers.at(producer);
+		auto& fanOut = this->mapProducerConsumers.at(producer);
 
-		for (auto* consumer : consumers)
+		for (auto& entry : fanOut.entries)
 		{
-			consumer->ProducerRtcpSenderReport(rtpStream, first);
+			entry.consumer->ProducerRtcpSenderReport(rtpStream, first);
 		}
 	}
 
@@ -706,25 +758,59 @@ namespace RTC
 	{
 		MS_TRACE();
 
-		auto& consumers = this->mapProducerConsumers.at(producer);
+		ForwardingMetrics::ScopedStage scopedStage(ForwardingMetrics::Stage::ROUTER_FAN_OUT);
+
+		auto& fanOut = this->mapProducerConsumers.at(producer);
 
-		if (!consumers.empty())
+		if (!fanOut.entries.empty())
 		{
 			// Cloned ref-counted packet that RtpStreamSend will store for as long as
 			// needed avoiding multiple allocations unless absolutely necessary.
 			// Clone only happens if needed.
 			std::shared_ptr<RTC::RtpPacket> sharedPacket;
 
-			for (auto* consumer : consumers)
+			// Consumers of audio don't modify the payload, so UDP datagrams carrying
+			// it in clear (no SRTP) reference it instead of copying it.
+			if (producer->GetKind() == RTC::Media::Kind::AUDIO)
 			{
+				UdpSocketHandler::BorrowBuffer(
+				  packet->GetPayload(), packet->GetPayloadLength() + packet->GetPayloadPadding());
+			}
+
+			const uint32_t mappedSsrc = packet->GetSsrc();
+
+			for (auto& entry : fanOut.entries)
+			{
+				// Skip Consumers that would drop the packet anyway.
+				// clang-format off
+				if (
+					!entry.active ||
+					(
+						entry.filterBySsrc &&
+						entry.mappedSsrcs[0] != mappedSsrc &&
+						entry.mappedSsrcs[1] != mappedSsrc
+					)
+				)
+				// clang-format on
+				{
+					continue;
+				}
+
 				// Update MID RTP extension value.
-				const auto& mid = consumer->GetRtpParameters().mid;
+				if (entry.midLen != 0u)
+					packet->UpdateMid(entry.mid.data(), entry.midLen);
 
-				if (!mid.empty())
-					packet->UpdateMid(mid);
+				ForwardingMetrics::ScopedStage consumerScopedStage(
+				  ForwardingMetrics::Stage::CONSUMER_SEND_RTP_PACKET);
 
-				consumer->SendRtpPacket(packet, sharedPacket);
+				entry.consumer->SendRtpPacket(packet, sharedPacket);
 			}
+
+			// Send the datagrams of the whole fan-out with as few syscalls as
+			// possible.
+			UdpSocketHandler::FlushAll();
+
+			ForwardingMetrics::PacketForwarded();
 		}
 
 		auto it = this->mapProducerRtpObservers.find(producer);
@@ -748,11 +834,11 @@ namespace RTC
 	{
 		MS_TRACE();
 
-		auto& consumers = this->mapProducerConsumers.at(producer);
+		auto& fanOut = this->mapProducerConsumers.at(producer);
 
-		for (auto* consumer : consumers)
+		for (auto& entry : fanOut.entries)
 		{
-			consumer->NeedWorstRemoteFractionLost(mappedSsrc, worstRemoteFractionLost);
+			entry.consumer->NeedWorstRemoteFractionLost(mappedSsrc, worstRemoteFractionLost);
 		}
 	}
 
@@ -781,9 +867,11 @@ namespace RTC
 			consumer->ProducerPaused();
 
 		// Insert the Consumer in the maps.
-		auto& consumers = mapProducerConsumersIt->second;
+		auto& fanOut = mapProducerConsumersIt->second;
 
-		consumers.insert(consumer);
+		fanOut.mapConsumerEntryIndex[consumer] = fanOut.entries.size();
+		fanOut.entries.emplace_back();
+		fanOut.entries.back().consumer      = consumer;
 		this->mapConsumerProducer[consumer] = producer;
 
 		// Get all streams in the Producer and provide the Consumer with them.
@@ -797,6 +885,8 @@ namespace RTC
 
 		// Provide the Consumer with the scores of all streams in the Producer.
 		consumer->ProducerRtpStreamScores(producer->GetRtpStreamScores());
+
+		UpdateFanOutEntry(fanOut.entries[fanOut.mapConsumerEntryIndex.at(consumer)]);
 	}
 
 	inline void Router::OnTransportConsumerClosed(RTC::Transport* /*transport*/, RTC::Consumer* consumer)
@@ -821,10 +911,21 @@ namespace RTC
 		  this->mapProducerConsumers.find(producer) != this->mapProducerConsumers.end(),
 		  "Producer not present in mapProducerConsumers");
 
-		// Remove the Consumer from the set of Consumers of the Producer.
-		auto& consumers = this->mapProducerConsumers.at(producer);
+		// Remove the Consumer from the Consumers of the Producer by moving the
+		// last entry into its place.
+		auto& fanOut                 = this->mapProducerConsumers.at(producer);
+		auto mapConsumerEntryIndexIt = fanOut.mapConsumerEntryIndex.find(consumer);
+		const size_t index           = mapConsumerEntryIndexIt->second;
+
+		fanOut.mapConsumerEntryIndex.erase(mapConsumerEntryIndexIt);
+
+		if (index != fanOut.entries.size() - 1)
+		{
+			fanOut.entries[index] = fanOut.entries.back();
+			fanOut.mapConsumerEntryIndex[fanOut.entries[index].consumer] = index;
+		}
 
-		consumers.erase(consumer);
+		fanOut.entries.pop_back();
 
 		// Remove the Consumer from the map.
 		this->mapConsumerProducer.erase(mapConsumerProducerIt);
@@ -860,6 +961,27 @@ namespace RTC
 		producer->RequestKeyFrame(mappedSsrc);
 	}
 
+	inline void Router::OnTransportConsumerForwardingChanged(
+	  RTC::Transport* /*transport*/, RTC::Consumer* consumer)
+	{
+		MS_TRACE();
+
+		auto mapConsumerProducerIt = this->mapConsumerProducer.find(consumer);
+
+		// The Consumer may not be inserted yet or its Producer be closing.
+		if (mapConsumerProducerIt == this->mapConsumerProducer.end())
+			return;
+
+		auto mapProducerConsumersIt = this->mapProducerConsumers.find(mapConsumerProducerIt->second);
+
+		if (mapProducerConsumersIt == this->mapProducerConsumers.end())
+			return;
+
+		auto& fanOut = mapProducerConsumersIt->second;
+
+		UpdateFanOutEntry(fanOut.entries[fanOut.mapConsumerEntryIndex.at(consumer)]);
+	}
+
 	inline void Router::OnTransportNewDataProducer(
 	  RTC::Transport* /*transport*/, RTC::DataProducer* dataProducer)
 	{
@@ -922,16 +1044,16 @@ namespace RTC
 	  RTC::Transport* /*transport*/,
 	  RTC::DataProducer* dataProducer,
 	  uint32_t ppid,
-	  const uint8_t* msg,
-	  size_t len)
+	  RTC::MessageBuffer* message)
 	{
 		MS_TRACE();
 
 		auto& dataConsumers = this->mapDataProducerDataConsumers.at(dataProducer);
 
+		// Every DataConsumer gets the same MessageBuffer.
 		for (auto* consumer : dataConsumers)
 		{
-			consumer->SendMessage(ppid, msg, len);
+			consumer->SendMessage(ppid, message);
 		}
 	}
 
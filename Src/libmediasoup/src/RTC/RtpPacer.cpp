@@ -0,0 +1,317 @@
+#define MS_CLASS "RTC::RtpPacer"
+// #define MS_LOG_DEV_LEVEL 3
+
+#include "RTC/RtpPacer.hpp"
+#include "DepLibUV.hpp"
+#include "ForwardingMetrics.hpp"
+#include "Logger.hpp"
+#include "RTC/TransportCongestionControlClient.hpp"
+#include <algorithm> // std::find(), std::max(), std::min(), std::remove_if()
+
+namespace RTC
+{
+	/* Static. */
+
+	static constexpr uint64_t SchedulerInterval{ 5u }; // In ms.
+	// Same as libwebrtc's PacedSender, so the pacer drains a burst faster than
+	// the estimated bitrate.
+	static constexpr double PacingFactor{ 2.5 };
+	// Budget that can be built up while idle, so sparse packets are never
+	// delayed.
+	static constexpr uint64_t MaxBurstUs{ 10000u };
+	// Packets queued for longer are sent regardless of the budget, so a low
+	// estimation never delays media further.
+	static constexpr uint64_t MaxQueueDelayMs{ 100u };
+
+	/* Class variables. */
+
+	thread_local RtpPacer::Scheduler* RtpPacer::scheduler{ nullptr };
+	thread_local size_t RtpPacer::numPacers{ 0u };
+	thread_local std::vector<RtpPacer*> RtpPacer::scheduledPacers;
+	thread_local bool RtpPacer::processing{ false };
+
+	/* Instance methods. */
+
+	RtpPacer::RtpPacer(Listener* listener, uint32_t bitrate) : listener(listener)
+	{
+		MS_TRACE();
+
+		SetBitrate(bitrate);
+
+		this->lastBudgetUpdateUs = DepLibUV::GetTimeUs();
+
+		// The scheduler may still exist if the last pacer was destroyed while it
+		// was running.
+		if (RtpPacer::numPacers++ == 0u && !RtpPacer::scheduler)
+			RtpPacer::scheduler = new RtpPacer::Scheduler();
+	}
+
+	RtpPacer::~RtpPacer()
+	{
+		MS_TRACE();
+
+		Clear();
+
+		// If the scheduler is running it deletes itself once done.
+		if (--RtpPacer::numPacers == 0u && !RtpPacer::processing)
+		{
+			delete RtpPacer::scheduler;
+			RtpPacer::scheduler = nullptr;
+		}
+	}
+
+	bool RtpPacer::Enqueue(RTC::Consumer* consumer, RTC::RtpPacket* packet, Priority priority)
+	{
+		MS_TRACE();
+
+		UpdateBudget(DepLibUV::GetTimeUs());
+
+		// Send it right away if nothing with the same or higher priority is
+		// waiting and there is budget for it.
+		// clang-format off
+		if (
+			priority == Priority::AUDIO ||
+			(
+				this->budget > 0 &&
+				this->queues[0].empty() &&
+				(priority == Priority::RETRANSMISSION || this->queues[1].empty())
+			)
+		)
+		// clang-format on
+		{
+			this->budget -= static_cast<int64_t>(packet->GetSize());
+
+			return false;
+		}
+
+		auto& queue = this->queues[priority == Priority::RETRANSMISSION ? 0 : 1];
+
+		queue.push_back(
+		  { consumer, packet->Clone(), DepLibUV::GetTimeMs(), ForwardingMetrics::Now() });
+
+		Schedule();
+
+		return true;
+	}
+
+	void RtpPacer::SetBitrate(uint32_t bitrate)
+	{
+		MS_TRACE();
+
+		this->bitrate = std::max(bitrate, RTC::TransportCongestionControlMinOutgoingBitrate);
+	}
+
+	void RtpPacer::RemoveConsumer(RTC::Consumer* consumer)
+	{
+		MS_TRACE();
+
+		for (auto& queue : this->queues)
+		{
+			auto it = std::remove_if(
+			  queue.begin(),
+			  queue.end(),
+			  [consumer](const QueuedPacket& queuedPacket)
+			  {
+				  if (queuedPacket.consumer != consumer)
+					  return false;
+
+				  delete queuedPacket.packet;
+
+				  return true;
+			  });
+
+			queue.erase(it, queue.end());
+		}
+	}
+
+	void RtpPacer::Clear()
+	{
+		MS_TRACE();
+
+		for (auto& queue : this->queues)
+		{
+			for (auto& queuedPacket : queue)
+			{
+				delete queuedPacket.packet;
+			}
+
+			queue.clear();
+		}
+
+		if (this->scheduled)
+		{
+			auto& scheduledPacers = RtpPacer::scheduledPacers;
+			auto it = std::find(scheduledPacers.begin(), scheduledPacers.end(), this);
+
+			this->scheduled = false;
+
+			// The scheduler is iterating the vector, so do not erase from it.
+			if (RtpPacer::processing)
+			{
+				*it = nullptr;
+
+				return;
+			}
+
+			scheduledPacers.erase(it);
+
+			if (scheduledPacers.empty())
+				RtpPacer::scheduler->Stop();
+		}
+	}
+
+	void RtpPacer::UpdateBudget(uint64_t nowUs)
+	{
+		MS_TRACE();
+
+		const uint64_t elapsedUs  = std::min(nowUs - this->lastBudgetUpdateUs, MaxBurstUs);
+		const auto bytesPerSecond = static_cast<double>(this->bitrate) * PacingFactor / 8;
+		const auto maxBudget      = static_cast<int64_t>(bytesPerSecond * MaxBurstUs / 1000000);
+
+		this->budget += static_cast<int64_t>(bytesPerSecond * elapsedUs / 1000000);
+		this->budget             = std::min(this->budget, maxBudget);
+		this->lastBudgetUpdateUs = nowUs;
+	}
+
+	// Sends the next queued packet if the budget allows it. Returns false if
+	// nothing was sent. This may be destroyed by the listener while sending.
+	bool RtpPacer::SendNext(uint64_t nowUs)
+	{
+		MS_TRACE();
+
+		auto* queue = !this->queues[0].empty() ? &this->queues[0]
+		              : !this->queues[1].empty() ? &this->queues[1]
+		                                         : nullptr;
+
+		if (!queue)
+			return false;
+
+		auto queuedPacket = queue->front();
+
+		if (this->budget <= 0 && nowUs / 1000u - queuedPacket.queuedAtMs < MaxQueueDelayMs)
+			return false;
+
+		queue->pop_front();
+
+		this->budget -= static_cast<int64_t>(queuedPacket.packet->GetSize());
+
+		ForwardingMetrics::Record(
+		  ForwardingMetrics::Stage::PACER_QUEUE_DELAY,
+		  ForwardingMetrics::Now() - queuedPacket.queuedAtTicks);
+
+		const auto priority = queue == &this->queues[0] ? Priority::RETRANSMISSION : Priority::VIDEO;
+
+		// The packet is owned here, so it is freed even if this is destroyed.
+		std::unique_ptr<RTC::RtpPacket> packet(queuedPacket.packet);
+
+		this->listener->OnRtpPacerSendRtpPacket(this, queuedPacket.consumer, packet.get(), priority);
+
+		return true;
+	}
+
+	void RtpPacer::Schedule()
+	{
+		MS_TRACE();
+
+		if (this->scheduled)
+			return;
+
+		this->scheduled = true;
+
+		if (RtpPacer::scheduledPacers.empty())
+			RtpPacer::scheduler->Start();
+
+		RtpPacer::scheduledPacers.push_back(this);
+	}
+
+	/* RtpPacer::Scheduler instance methods. */
+
+	RtpPacer::Scheduler::Scheduler()
+	{
+		MS_TRACE();
+
+		this->timer = new Timer(this);
+	}
+
+	RtpPacer::Scheduler::~Scheduler()
+	{
+		MS_TRACE();
+
+		delete this->timer;
+	}
+
+	void RtpPacer::Scheduler::Start()
+	{
+		MS_TRACE();
+
+		this->timer->Start(SchedulerInterval, SchedulerInterval);
+	}
+
+	void RtpPacer::Scheduler::Stop()
+	{
+		MS_TRACE();
+
+		this->timer->Stop();
+	}
+
+	void RtpPacer::Scheduler::OnTimer(Timer* /*timer*/)
+	{
+		MS_TRACE();
+
+		auto& scheduledPacers = RtpPacer::scheduledPacers;
+		const uint64_t nowUs  = DepLibUV::GetTimeUs();
+
+		RtpPacer::processing = true;
+
+		// Sending may destroy pacers and schedule new ones, which clears slots
+		// and appends to the vector. So it is indexed again after every packet
+		// and pacers scheduled meanwhile wait for the next tick.
+		const size_t numScheduledPacers = scheduledPacers.size();
+
+		for (size_t idx{ 0u }; idx < numScheduledPacers; ++idx)
+		{
+			if (!scheduledPacers[idx])
+				continue;
+
+			scheduledPacers[idx]->UpdateBudget(nowUs);
+
+			while (scheduledPacers[idx] && scheduledPacers[idx]->SendNext(nowUs))
+			{
+			}
+		}
+
+		RtpPacer::processing = false;
+
+		// Unschedule the pacers that have been destroyed or drained.
+		auto it = std::remove_if(
+		  scheduledPacers.begin(),
+		  scheduledPacers.end(),
+		  [](RtpPacer* pacer)
+		  {
+			  if (!pacer)
+				  return true;
+
+			  if (pacer->GetQueueSize() != 0u)
+				  return false;
+
+			  pacer->scheduled = false;
+
+			  return true;
+		  });
+
+		scheduledPacers.erase(it, scheduledPacers.end());
+
+		// The last pacer was destroyed meanwhile.
+		if (RtpPacer::numPacers == 0u)
+		{
+			RtpPacer::scheduler = nullptr;
+
+			delete this;
+
+			return;
+		}
+
+		if (scheduledPacers.empty())
+			Stop();
+	}
+} // namespace RTC
@@ -3,9 +3,11 @@
 
 #include "RTC/RtpPacket.hpp"
 #include "Logger.hpp"
-#include <cstring>  // std::memcpy(), std::memmove(), std::memset()
-#include <iterator> // std::ostream_iterator
-#include <sstream>  // std::ostringstream
+#include "RTC/RtpPacketPool.hpp"
+#include <algorithm> // std::min()
+#include <cstring>   // std::memcpy(), std::memmove(), std::memset()
+#include <iterator>  // std::ostream_iterator
+#include <sstream>   // std::ostringstream
 
 namespace RTC
 {
@@ -117,7 +119,13 @@ namespace RTC
 		           payloadLength + size_t{ payloadPadding },
 		  "packet's computed size does not match received size");
 
-		return new RtpPacket(header, headerExtension, payload, payloadLength, payloadPadding, len);
+		auto* packet =
+		  new RtpPacket(header, headerExtension, payload, payloadLength, payloadPadding, len);
+
+		// Parse RFC 5285 header extension.
+		packet->ParseExtensions();
+
+		return packet;
 	}
 
 	/* Instance methods. */
@@ -136,18 +144,17 @@ namespace RTC
 
 		if (this->header->csrcCount != 0u)
 			this->csrcList = reinterpret_cast<uint8_t*>(header) + HeaderSize;
-
-		// Parse RFC 5285 header extension.
-		ParseExtensions();
 	}
 
 	RtpPacket::~RtpPacket()
 	{
 		MS_TRACE();
 
+		ResetPayloadDescriptorHandler();
+
 		if (this->buffer)
 		{
-			delete[] this->buffer;
+			RtpPacketPool::FreeBuffer(this->buffer);
 		}
 	}
 
@@ -177,23 +184,19 @@ namespace RTC
 			std::vector<std::string> extIds;
 			std::ostringstream extIdsStream;
 
-			if (HasOneByteExtensions())
+			for (size_t i{ 0u }; i < this->extensions.size(); ++i)
 			{
-				for (const auto& extension : this->oneByteExtensions)
-				{
-					if (extension != nullptr)
-					{
-						extIds.push_back(std::to_string(extension->id));
-					}
-				}
+				if (this->extensions[i].offset != 0u)
+					extIds.push_back(std::to_string(i + 1));
 			}
-			else
-			{
-				extIds.reserve(this->mapTwoBytesExtensions.size());
 
-				for (const auto& kv : this->mapTwoBytesExtensions)
+			// Two-Bytes extensions with higher ids are not indexed.
+			if (HasTwoBytesExtensions())
+			{
+				for (uint16_t id{ MaxIndexedExtensionId + 1u }; id <= 255u; ++id)
 				{
-					extIds.push_back(std::to_string(kv.first));
+					if (FindTwoBytesExtension(static_cast<uint8_t>(id)).offset != 0u)
+						extIds.push_back(std::to_string(id));
 				}
 			}
 
@@ -382,9 +385,8 @@ namespace RTC
 		this->ssrcAudioLevelExtensionId    = 0u;
 		this->videoOrientationExtensionId  = 0u;
 
-		// Clear the One-Byte and Two-Bytes extension elements maps.
-		std::fill(std::begin(this->oneByteExtensions), std::end(this->oneByteExtensions), nullptr);
-		this->mapTwoBytesExtensions.clear();
+		// Clear the extensions table.
+		this->extensions.fill({});
 
 		// If One-Byte is requested and the packet already has One-Byte extensions,
 		// keep the header extension id.
@@ -490,6 +492,8 @@ namespace RTC
 
 		// Write the new extensions into the header extension value.
 		uint8_t* ptr = this->headerExtension->value;
+		// Last indexed extension, which gets the room of the final padding.
+		ExtensionEntry* lastEntry{ nullptr };
 
 		for (const auto& extension : extensions)
 		{
@@ -498,12 +502,16 @@ namespace RTC
 				if (extension.id == 0 || extension.id > 14 || extension.len == 0 || extension.len > 16)
 					continue;
 
-				// Store the One-Byte extension element in an array.
-				// `-1` because we have 14 elements total 0..13 and `id` is in the range 1..14.
-				this->oneByteExtensions[extension.id - 1] = reinterpret_cast<OneByteExtension*>(ptr);
-
 				*ptr = (extension.id << 4) | ((extension.len - 1) & 0x0F);
 				++ptr;
+
+				// Index the One-Byte extension element.
+				// `-1` because we have 14 elements total 0..13 and `id` is in the range 1..14.
+				lastEntry         = &this->extensions[extension.id - 1];
+				lastEntry->offset = static_cast<uint16_t>(ptr - this->headerExtension->value);
+				lastEntry->len    = extension.len;
+				lastEntry->room   = extension.len;
+
 				std::memmove(ptr, extension.value, extension.len);
 				ptr += extension.len;
 			}
@@ -512,13 +520,24 @@ namespace RTC
 				if (extension.id == 0)
 					continue;
 
-				// Store the Two-Bytes extension element in the map.
-				this->mapTwoBytesExtensions[extension.id] = reinterpret_cast<TwoBytesExtension*>(ptr);
-
 				*ptr = extension.id;
 				++ptr;
 				*ptr = extension.len;
 				++ptr;
+
+				// Index the Two-Bytes extension element.
+				if (extension.id <= MaxIndexedExtensionId)
+				{
+					lastEntry         = &this->extensions[extension.id - 1];
+					lastEntry->offset = static_cast<uint16_t>(ptr - this->headerExtension->value);
+					lastEntry->len    = extension.len;
+					lastEntry->room   = extension.len;
+				}
+				else
+				{
+					lastEntry = nullptr;
+				}
+
 				std::memmove(ptr, extension.value, extension.len);
 				ptr += extension.len;
 			}
@@ -530,6 +549,15 @@ namespace RTC
 			++ptr;
 		}
 
+		// The final padding bytes are room for the last extension, as if the
+		// packet was parsed.
+		if (lastEntry)
+		{
+			const size_t maxLen = type == 1u ? 16u : 255u;
+
+			lastEntry->room = static_cast<uint8_t>(std::min(lastEntry->room + padding, maxLen));
+		}
+
 		MS_ASSERT(ptr == this->payload, "wrong ptr calculation");
 	}
 
@@ -537,13 +565,15 @@ namespace RTC
 	{
 		MS_TRACE();
 
-		uint8_t extenLen;
-		uint8_t* extenValue = GetExtension(this->midExtensionId, extenLen);
+		UpdateMid(reinterpret_cast<const uint8_t*>(mid.c_str()), mid.length());
+	}
 
-		if (!extenValue)
-			return;
+	void RtpPacket::UpdateMid(const uint8_t* mid, size_t midLen)
+	{
+		MS_TRACE();
 
-		const size_t midLen = mid.length();
+		if (!HasExtension(this->midExtensionId))
+			return;
 
 		// Here we assume that there is MidMaxLength available bytes, even if now
 		// they are padding bytes.
@@ -552,20 +582,14 @@ namespace RTC
 			MS_ERROR(
 			  "no enough space for MID value [MidMaxLength:%" PRIu8 ", mid:'%s']",
 			  RTC::MidMaxLength,
-			  mid.c_str());
+			  std::string(reinterpret_cast<const char*>(mid), midLen).c_str());
 
 			return;
 		}
 
-		std::memcpy(extenValue, mid.c_str(), midLen);
-
-		SetExtensionLength(this->midExtensionId, midLen);
+		SetExtensionValue(this->midExtensionId, mid, static_cast<uint8_t>(midLen));
 	}
 
-	/**
-	 * The caller is responsible of not setting a length higher than the
-	 * available one (taking into account existing padding bytes).
-	 */
 	bool RtpPacket::SetExtensionLength(uint8_t id, uint8_t len)
 	{
 		MS_TRACE();
@@ -577,51 +601,72 @@ namespace RTC
 			return false;
 		}
 
-		if (id == 0u)
+		const auto entry = GetExtensionEntry(id);
+
+		if (entry.offset == 0u)
+			return false;
+
+		if (len > entry.room)
 		{
+			MS_ERROR(
+			  "no enough room for extension [id:%" PRIu8 ", len:%" PRIu8 ", room:%" PRIu8 "]",
+			  id,
+			  len,
+			  entry.room);
+
 			return false;
 		}
-		else if (HasOneByteExtensions())
-		{
-			// `-1` because we have 14 elements total 0..13 and `id` is in the range 1..14.
-			auto* extension = this->oneByteExtensions[id - 1];
 
-			if (!extension)
-				return false;
+		uint8_t* value = this->headerExtension->value + entry.offset;
 
-			auto currentLen = extension->len + 1;
+		// Fill with 0's if new length is minor.
+		if (len < entry.len)
+			std::memset(value + len, 0, entry.len - len);
 
-			// Fill with 0's if new length is minor.
-			if (len < currentLen)
-				std::memset(extension->value + len, 0, currentLen - len);
+		WriteExtensionLength(id, entry, len);
 
-			// In One-Byte extensions value length 0 means 1.
-			extension->len = len - 1;
+		return true;
+	}
 
-			return true;
-		}
-		else if (HasTwoBytesExtensions())
-		{
-			auto it = this->mapTwoBytesExtensions.find(id);
+	bool RtpPacket::SetExtensionValue(uint8_t id, const uint8_t* value, uint8_t len)
+	{
+		MS_TRACE();
 
-			if (it == this->mapTwoBytesExtensions.end())
-				return false;
+		if (len == 0u)
+		{
+			MS_ERROR("cannot set extension length to 0");
 
-			auto* extension = it->second;
-			auto currentLen = extension->len;
+			return false;
+		}
 
-			// Fill with 0's if new length is minor.
-			if (len < currentLen)
-				std::memset(extension->value + len, 0, currentLen - len);
+		const auto entry = GetExtensionEntry(id);
 
-			extension->len = len;
+		if (entry.offset == 0u)
+			return false;
 
-			return true;
-		}
-		else
+		if (len > entry.room)
 		{
+			MS_ERROR(
+			  "no enough room for extension [id:%" PRIu8 ", len:%" PRIu8 ", room:%" PRIu8 "]",
+			  id,
+			  len,
+			  entry.room);
+
 			return false;
 		}
+
+		uint8_t* extenValue = this->headerExtension->value + entry.offset;
+
+		std::memcpy(extenValue, value, len);
+
+		// Fill with 0's if new length is minor.
+		if (len < entry.len)
+			std::memset(extenValue + len, 0, entry.len - len);
+
+		if (len != entry.len)
+			WriteExtensionLength(id, entry, len);
+
+		return true;
 	}
 
 	void RtpPacket::SetPayloadLength(size_t length)
@@ -644,7 +689,7 @@ namespace RTC
 	{
 		MS_TRACE();
 
-		auto* buffer = new uint8_t[MtuSize + 100];
+		auto* buffer = RtpPacketPool::AllocateBuffer();
 		auto* ptr    = const_cast<uint8_t*>(buffer);
 
 		size_t numBytes{ 0 };
@@ -705,6 +750,8 @@ namespace RTC
 		auto* packet = new RtpPacket(
 		  newHeader, newHeaderExtension, newPayload, this->payloadLength, this->payloadPadding, this->size);
 
+		// The header extension is copied as is, so is its index.
+		packet->extensions = this->extensions;
 		// Keep already set extension ids.
 		packet->midExtensionId               = this->midExtensionId;
 		packet->ridExtensionId               = this->ridExtensionId;
@@ -715,14 +762,29 @@ namespace RTC
 		packet->frameMarkingExtensionId      = this->frameMarkingExtensionId;
 		packet->ssrcAudioLevelExtensionId    = this->ssrcAudioLevelExtensionId;
 		packet->videoOrientationExtensionId  = this->videoOrientationExtensionId;
-		// Assign the payload descriptor handler.
-		packet->payloadDescriptorHandler = this->payloadDescriptorHandler;
+		// Copy the payload descriptor handler.
+		if (this->payloadDescriptorHandler)
+		{
+			packet->payloadDescriptorHandler = this->copyPayloadDescriptorHandler(
+			  this->payloadDescriptorHandler, packet->payloadDescriptorHandlerStorage);
+			packet->copyPayloadDescriptorHandler = this->copyPayloadDescriptorHandler;
+		}
 		// Store allocated buffer.
 		packet->buffer = buffer;
 
 		return packet;
 	}
 
+	void* RtpPacket::operator new(size_t size)
+	{
+		return RtpPacketPool::AllocatePacket(size);
+	}
+
+	void RtpPacket::operator delete(void* ptr, size_t size)
+	{
+		RtpPacketPool::FreePacket(ptr, size);
+	}
+
 	// NOTE: The caller must ensure that the buffer/memmory of the packet has
 	// space enough for adding 2 extra bytes.
 	void RtpPacket::RtxEncode(uint8_t payloadType, uint32_t ssrc, uint16_t seq)
@@ -863,13 +925,13 @@ namespace RTC
 	{
 		MS_TRACE();
 
+		// Clear the extensions table.
+		this->extensions.fill({});
+
 		// Parse One-Byte header extension.
 		if (HasOneByteExtensions())
 		{
-			// Clear the One-Byte extension elements map.
-			std::fill(std::begin(this->oneByteExtensions), std::end(this->oneByteExtensions), nullptr);
-
-			uint8_t* extensionStart = reinterpret_cast<uint8_t*>(this->headerExtension) + 4;
+			uint8_t* extensionStart = this->headerExtension->value;
 			uint8_t* extensionEnd   = extensionStart + GetHeaderExtensionLength();
 			uint8_t* ptr            = extensionStart;
 
@@ -883,6 +945,8 @@ namespace RTC
 				if (id == 15u)
 					break;
 
+				ExtensionEntry* entry{ nullptr };
+
 				// Valid extension id.
 				if (id != 0u)
 				{
@@ -894,9 +958,12 @@ namespace RTC
 						break;
 					}
 
-					// Store the One-Byte extension element in an array.
+					// Index the One-Byte extension element.
 					// `-1` because we have 14 elements total 0..13 and `id` is in the range 1..14.
-					this->oneByteExtensions[id - 1] = reinterpret_cast<OneByteExtension*>(ptr);
+					entry         = &this->extensions[id - 1];
+					entry->offset = static_cast<uint16_t>(ptr + 1 - extensionStart);
+					entry->len    = static_cast<uint8_t>(len);
+					entry->room   = static_cast<uint8_t>(len);
 
 					ptr += (1 + len);
 				}
@@ -909,6 +976,9 @@ namespace RTC
 				// Counting padding bytes.
 				while ((ptr < extensionEnd) && (*ptr == 0))
 				{
+					if (entry && entry->room < 16u)
+						++entry->room;
+
 					++ptr;
 				}
 			}
@@ -916,10 +986,7 @@ namespace RTC
 		// Parse Two-Bytes header extension.
 		else if (HasTwoBytesExtensions())
 		{
-			// Clear the Two-Bytes extension elements map.
-			this->mapTwoBytesExtensions.clear();
-
-			uint8_t* extensionStart = reinterpret_cast<uint8_t*>(this->headerExtension) + 4;
+			uint8_t* extensionStart = this->headerExtension->value;
 			uint8_t* extensionEnd   = extensionStart + GetHeaderExtensionLength();
 			uint8_t* ptr            = extensionStart;
 
@@ -932,6 +999,8 @@ namespace RTC
 				const uint8_t id  = *ptr;
 				const uint8_t len = *(ptr + 1);
 
+				ExtensionEntry* entry{ nullptr };
+
 				// Valid extension id.
 				if (id != 0u)
 				{
@@ -943,8 +1012,15 @@ namespace RTC
 						break;
 					}
 
-					// Store the Two-Bytes extension element in the map.
-					this->mapTwoBytesExtensions[id] = reinterpret_cast<TwoBytesExtension*>(ptr);
+					// Index the Two-Bytes extension element. Higher ids are looked up
+					// on demand.
+					if (id <= MaxIndexedExtensionId)
+					{
+						entry         = &this->extensions[id - 1];
+						entry->offset = static_cast<uint16_t>(ptr + 2 - extensionStart);
+						entry->len    = len;
+						entry->room   = len;
+					}
 
 					ptr += (2 + len);
 				}
@@ -957,9 +1033,82 @@ namespace RTC
 				// Counting padding bytes.
 				while ((ptr < extensionEnd) && (*ptr == 0))
 				{
+					if (entry && entry->room < 255u)
+						++entry->room;
+
 					++ptr;
 				}
 			}
 		}
 	}
+
+	RtpPacket::ExtensionEntry RtpPacket::FindTwoBytesExtension(uint8_t id) const
+	{
+		MS_TRACE();
+
+		ExtensionEntry entry;
+
+		if (!HasTwoBytesExtensions())
+			return entry;
+
+		uint8_t* extensionStart = this->headerExtension->value;
+		uint8_t* extensionEnd   = extensionStart + GetHeaderExtensionLength();
+		uint8_t* ptr            = extensionStart;
+
+		// Same walk as in ParseExtensions(), which already validated the elements.
+		while (ptr + 1 < extensionEnd)
+		{
+			const uint8_t elementId = *ptr;
+			const uint8_t len       = *(ptr + 1);
+
+			if (elementId != 0u)
+			{
+				if (ptr + 2 + len > extensionEnd)
+					break;
+
+				if (elementId == id)
+				{
+					entry.offset = static_cast<uint16_t>(ptr + 2 - extensionStart);
+					entry.len    = len;
+					entry.room   = len;
+				}
+
+				ptr += (2 + len);
+			}
+			else
+			{
+				++ptr;
+			}
+
+			while ((ptr < extensionEnd) && (*ptr == 0))
+			{
+				if (entry.offset != 0u && entry.room < 255u)
+					++entry.room;
+
+				++ptr;
+			}
+
+			if (entry.offset != 0u)
+				break;
+		}
+
+		return entry;
+	}
+
+	void RtpPacket::WriteExtensionLength(uint8_t id, const ExtensionEntry& entry, uint8_t len)
+	{
+		MS_TRACE();
+
+		// The length field is the byte before the value.
+		uint8_t* lengthByte = this->headerExtension->value + entry.offset - 1;
+
+		// In One-Byte extensions value length 0 means 1.
+		if (HasOneByteExtensions())
+			*lengthByte = (*lengthByte & 0xF0) | ((len - 1) & 0x0F);
+		else
+			*lengthByte = len;
+
+		if (id <= MaxIndexedExtensionId)
+			this->extensions[id - 1].len = len;
+	}
 } // namespace RTC
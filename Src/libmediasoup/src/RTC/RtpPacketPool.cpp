@@ -0,0 +1,108 @@
+#define MS_CLASS "RTC::RtpPacketPool"
+// #define MS_LOG_DEV_LEVEL 3
+
+#include "RTC/RtpPacketPool.hpp"
+#include "Logger.hpp"
+#include "RTC/RtpPacket.hpp"
+#include <new> // ::operator new(), ::operator delete()
+
+namespace RTC
+{
+	/* Static. */
+
+	// Max number of items kept in each free list. Beyond this they are
+	// returned to the system so a traffic peak does not pin memory forever.
+	static constexpr size_t MaxFreeItems{ 8192u };
+
+	/* Class variables. */
+
+	const size_t RtpPacketPool::BufferSize{ MtuSize + 100 };
+	thread_local RtpPacketPool::FreeList RtpPacketPool::buffers;
+	thread_local RtpPacketPool::FreeList RtpPacketPool::packets;
+
+	/* Class methods. */
+
+	uint8_t* RtpPacketPool::AllocateBuffer()
+	{
+		MS_TRACE();
+
+		if (!RtpPacketPool::buffers.items.empty())
+		{
+			auto* buffer = static_cast<uint8_t*>(RtpPacketPool::buffers.items.back());
+
+			RtpPacketPool::buffers.items.pop_back();
+			++RtpPacketPool::buffers.hits;
+
+			return buffer;
+		}
+
+		++RtpPacketPool::buffers.misses;
+
+		return static_cast<uint8_t*>(::operator new(RtpPacketPool::BufferSize));
+	}
+
+	void RtpPacketPool::FreeBuffer(uint8_t* buffer)
+	{
+		MS_TRACE();
+
+		if (RtpPacketPool::buffers.items.size() < MaxFreeItems)
+			RtpPacketPool::buffers.items.push_back(buffer);
+		else
+			::operator delete(buffer);
+	}
+
+	void* RtpPacketPool::AllocatePacket(size_t size)
+	{
+		MS_TRACE();
+
+		// Only RtpPacket itself is pooled.
+		if (size != sizeof(RtpPacket))
+			return ::operator new(size);
+
+		if (!RtpPacketPool::packets.items.empty())
+		{
+			void* ptr = RtpPacketPool::packets.items.back();
+
+			RtpPacketPool::packets.items.pop_back();
+			++RtpPacketPool::packets.hits;
+
+			return ptr;
+		}
+
+		++RtpPacketPool::packets.misses;
+
+		return ::operator new(size);
+	}
+
+	void RtpPacketPool::FreePacket(void* ptr, size_t size)
+	{
+		MS_TRACE();
+
+		if (size == sizeof(RtpPacket) && RtpPacketPool::packets.items.size() < MaxFreeItems)
+			RtpPacketPool::packets.items.push_back(ptr);
+		else
+			::operator delete(ptr);
+	}
+
+	void RtpPacketPool::FillJson(json& jsonObject)
+	{
+		MS_TRACE();
+
+		jsonObject["bufferHits"]    = RtpPacketPool::buffers.hits;
+		jsonObject["bufferMisses"]  = RtpPacketPool::buffers.misses;
+		jsonObject["freeBuffers"]   = RtpPacketPool::buffers.items.size();
+		jsonObject["packetHits"]    = RtpPacketPool::packets.hits;
+		jsonObject["packetMisses"]  = RtpPacketPool::packets.misses;
+		jsonObject["freePackets"]   = RtpPacketPool::packets.items.size();
+	}
+
+	/* Instance methods. */
+
+	RtpPacketPool::FreeList::~FreeList()
+	{
+		for (auto* item : this->items)
+		{
+			::operator delete(item);
+		}
+	}
+} // namespace RTC
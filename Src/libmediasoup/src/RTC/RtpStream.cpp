@@ -79,6 +79,27 @@ namespace RTC
 			jsonObject["roundTripTime"] = this->rtt;
 	}
 
+	size_t RtpStream::FillStatsCounters(RTC::StatsPublisher::Counters& counters)
+	{
+		MS_TRACE();
+
+		// NOTE: Keep the order in sync with the SDK WorkerStats counter names.
+		counters[0]  = this->packetsLost;
+		counters[1]  = this->fractionLost;
+		counters[2]  = this->packetsDiscarded;
+		counters[3]  = this->packetsRetransmitted;
+		counters[4]  = this->packetsRepaired;
+		counters[5]  = this->nackCount;
+		counters[6]  = this->nackPacketCount;
+		counters[7]  = this->pliCount;
+		counters[8]  = this->firCount;
+		counters[9]  = this->score;
+		// In microseconds.
+		counters[10] = this->hasRtt ? static_cast<uint64_t>(this->rtt * 1000) : 0u;
+
+		return 11u;
+	}
+
 	void RtpStream::SetRtx(uint8_t payloadType, uint32_t ssrc)
 	{
 		MS_TRACE();
@@ -186,7 +186,8 @@ namespace RTC
 	  RTC::RtpStreamRecv::Listener* listener, RTC::RtpStream::Params& params, unsigned int sendNackDelayMs)
 	  : RTC::RtpStream::RtpStream(listener, params, 10), sendNackDelayMs(sendNackDelayMs),
 	    transmissionCounter(
-	      params.spatialLayers, params.temporalLayers, this->params.useDtx ? 6000 : 2500)
+	      params.spatialLayers, params.temporalLayers, this->params.useDtx ? 6000 : 2500),
+	    nackPacket(0u, params.ssrc)
 	{
 		MS_TRACE();
 
@@ -242,6 +243,21 @@ namespace RTC
 		}
 	}
 
+	size_t RtpStreamRecv::FillStatsCounters(RTC::StatsPublisher::Counters& counters)
+	{
+		MS_TRACE();
+
+		const uint64_t nowMs = DepLibUV::GetTimeMs();
+		size_t idx           = RTC::RtpStream::FillStatsCounters(counters);
+
+		counters[idx++] = this->transmissionCounter.GetPacketCount();
+		counters[idx++] = this->transmissionCounter.GetBytes();
+		counters[idx++] = this->transmissionCounter.GetBitrate(nowMs);
+		counters[idx++] = this->jitter;
+
+		return idx;
+	}
+
 	bool RtpStreamRecv::ReceivePacket(RTC::RtpPacket* packet)
 	{
 		MS_TRACE();
@@ -807,7 +823,11 @@ namespace RTC
 		  seqNumbers[0],
 		  seqNumbers.size());
 
-		RTC::RTCP::FeedbackRtpNackPacket packet(0, GetSsrc());
+		auto& packet = this->nackPacket;
+
+		// Items of the previous NACK go back to the pool and are taken again
+		// below.
+		packet.DeleteItems();
 
 		auto it        = seqNumbers.begin();
 		const auto end = seqNumbers.end();
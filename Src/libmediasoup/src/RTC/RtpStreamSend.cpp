@@ -223,6 +223,20 @@ namespace RTC
 		jsonObject["bitrate"]     = this->transmissionCounter.GetBitrate(nowMs);
 	}
 
+	size_t RtpStreamSend::FillStatsCounters(RTC::StatsPublisher::Counters& counters)
+	{
+		MS_TRACE();
+
+		const uint64_t nowMs = DepLibUV::GetTimeMs();
+		size_t idx           = RTC::RtpStream::FillStatsCounters(counters);
+
+		counters[idx++] = this->transmissionCounter.GetPacketCount();
+		counters[idx++] = this->transmissionCounter.GetBytes();
+		counters[idx++] = this->transmissionCounter.GetBitrate(nowMs);
+
+		return idx;
+	}
+
 	void RtpStreamSend::SetRtx(uint8_t payloadType, uint32_t ssrc)
 	{
 		MS_TRACE();
@@ -276,20 +290,21 @@ namespace RTC
 				}
 
 				// Note that this is an already RTX encoded packet if RTX is used
-				// (FillRetransmissionContainer() did it).
-				auto packet = storageItem->packet;
+				// (FillRetransmissionContainer() did it). The storage item keeps it
+				// alive, so no need to copy its shared pointer.
+				auto* packet = storageItem->packet.get();
 
 				// Retransmit the packet.
 				static_cast<RTC::RtpStreamSend::Listener*>(this->listener)
-				  ->OnRtpStreamRetransmitRtpPacket(this, packet.get());
+				  ->OnRtpStreamRetransmitRtpPacket(this, packet);
 
 				// Mark the packet as retransmitted.
-				RTC::RtpStream::PacketRetransmitted(packet.get());
+				RTC::RtpStream::PacketRetransmitted(packet);
 
 				// Mark the packet as repaired (only if this is the first retransmission).
 				if (storageItem->sentTimes == 1)
 				{
-					RTC::RtpStream::PacketRepaired(packet.get());
+					RTC::RtpStream::PacketRepaired(packet);
 				}
 
 				if (HasRtx())
@@ -649,14 +664,14 @@ namespace RTC
 			if (requested)
 			{
 				auto* storageItem = this->storageItemBuffer.Get(currentSeq);
-				std::shared_ptr<RTC::RtpPacket> packet{ nullptr };
+				RTC::RtpPacket* packet{ nullptr };
 				uint32_t diffMs;
 
 				// Calculate the elapsed time between the max timestamp seen and the
 				// requested packet's timestamp (in ms).
 				if (storageItem)
 				{
-					packet = storageItem->packet;
+					packet = storageItem->packet.get();
 					// Put correct info into the packet.
 					packet->SetSsrc(storageItem->ssrc);
 					packet->SetSequenceNumber(storageItem->sequenceNumber);
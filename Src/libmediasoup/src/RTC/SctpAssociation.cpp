@@ -31,26 +31,9 @@ const uint16_t EventTypes[] =
 
 /* Static methods for usrsctp callbacks. */
 
-inline static int onRecvSctpData(
-  struct socket* /*sock*/,
-  union sctp_sockstore /*addr*/,
-  void* data,
-  size_t len,
-  struct sctp_rcvinfo rcv,
-  int flags,
-  void* ulpInfo)
+inline static void handleRecvSctpData(
+  RTC::SctpAssociation* sctpAssociation, void* data, size_t len, struct sctp_rcvinfo rcv, int flags)
 {
-	auto* sctpAssociation = DepUsrSCTP::RetrieveSctpAssociation(reinterpret_cast<uintptr_t>(ulpInfo));
-
-	if (!sctpAssociation)
-	{
-		MS_WARN_TAG(sctp, "no SctpAssociation found");
-
-		std::free(data);
-
-		return 0;
-	}
-
 	if (flags & MSG_NOTIFICATION)
 	{
 		sctpAssociation->OnUsrSctpReceiveSctpNotification(
@@ -74,28 +57,87 @@ inline static int onRecvSctpData(
 		  rcv.rcv_context,
 		  flags);
 
+		// NOTE: The SctpAssociation takes ownership of the data.
 		sctpAssociation->OnUsrSctpReceiveSctpData(
 		  streamId, ssn, ppid, flags, static_cast<uint8_t*>(data), len);
+
+		return;
 	}
 
 	std::free(data);
+}
+
+inline static int onRecvSctpData(
+  struct socket* /*sock*/,
+  union sctp_sockstore /*addr*/,
+  void* data,
+  size_t len,
+  struct sctp_rcvinfo rcv,
+  int flags,
+  void* ulpInfo)
+{
+	auto id               = reinterpret_cast<uintptr_t>(ulpInfo);
+	auto* sctpAssociation = DepUsrSCTP::RetrieveSctpAssociation(id);
+
+	if (sctpAssociation)
+	{
+		handleRecvSctpData(sctpAssociation, data, len, rcv, flags);
+
+		return 1;
+	}
+
+	// usrsctp timers run in the DepUsrSCTP Checker thread, so the
+	// SctpAssociation may belong to another Worker. Handle it in its thread.
+	auto posted = DepUsrSCTP::PostTask(
+	  id,
+	  [data, len, rcv, flags](RTC::SctpAssociation* sctpAssociation)
+	  {
+		  if (sctpAssociation)
+			  handleRecvSctpData(sctpAssociation, data, len, rcv, flags);
+		  else
+			  std::free(data);
+	  });
+
+	if (!posted)
+	{
+		MS_WARN_TAG(sctp, "no SctpAssociation found");
+
+		std::free(data);
+
+		return 0;
+	}
 
 	return 1;
 }
 
 inline static int onSendSctpData(struct socket* /*sock*/, uint32_t freeBuffer, void* ulpInfo)
 {
-	auto* sctpAssociation = DepUsrSCTP::RetrieveSctpAssociation(reinterpret_cast<uintptr_t>(ulpInfo));
+	auto id               = reinterpret_cast<uintptr_t>(ulpInfo);
+	auto* sctpAssociation = DepUsrSCTP::RetrieveSctpAssociation(id);
 
-	if (!sctpAssociation)
+	if (sctpAssociation)
+	{
+		sctpAssociation->OnUsrSctpSentData(freeBuffer);
+
+		return 1;
+	}
+
+	// Same as in onRecvSctpData().
+	auto posted = DepUsrSCTP::PostTask(
+	  id,
+	  [freeBuffer](RTC::SctpAssociation* sctpAssociation)
+	  {
+		  if (sctpAssociation)
+			  sctpAssociation->OnUsrSctpSentData(freeBuffer);
+	  });
+
+	if (!posted)
 	{
 		MS_WARN_TAG(sctp, "no SctpAssociation found");
 
 		return 0;
 	}
 
-	sctpAssociation->OnUsrSctpSentData(freeBuffer);
-
 	return 1;
 }
 
@@ -284,7 +326,8 @@ namespace RTC
 		// Register the SctpAssociation from the global map.
 		DepUsrSCTP::DeregisterSctpAssociation(this);
 
-		delete[] this->messageBuffer;
+		if (this->messageBuffer)
+			this->messageBuffer->Unref();
 	}
 
 	void SctpAssociation::TransportConnected()
@@ -645,17 +688,19 @@ namespace RTC
 	}
 
 	void SctpAssociation::OnUsrSctpReceiveSctpData(
-	  uint16_t streamId, uint16_t ssn, uint32_t ppid, int flags, const uint8_t* data, size_t len)
+	  uint16_t streamId, uint16_t ssn, uint32_t ppid, int flags, uint8_t* data, size_t len)
 	{
 		// Ignore WebRTC DataChannel Control DATA chunks.
 		if (ppid == 50)
 		{
 			MS_WARN_TAG(sctp, "ignoring SCTP data with ppid:50 (WebRTC DataChannel Control)");
 
+			std::free(data);
+
 			return;
 		}
 
-		if (this->messageBufferLen != 0 && ssn != this->lastSsnReceived)
+		if (this->messageBuffer && ssn != this->lastSsnReceived)
 		{
 			MS_WARN_TAG(
 			  sctp,
@@ -664,59 +709,72 @@ namespace RTC
 			  ssn,
 			  this->lastSsnReceived);
 
-			this->messageBufferLen = 0;
+			this->messageBuffer->Unref();
+			this->messageBuffer = nullptr;
 		}
 
 		// Update last SSN received.
 		this->lastSsnReceived = ssn;
 
-		auto eor = static_cast<bool>(flags & MSG_EOR);
+		auto eor               = static_cast<bool>(flags & MSG_EOR);
+		const size_t bufferLen = this->messageBuffer ? this->messageBuffer->GetSize() : 0u;
 
-		if (this->messageBufferLen + len > this->maxSctpMessageSize)
+		if (bufferLen + len > this->maxSctpMessageSize)
 		{
 			MS_WARN_TAG(
 			  sctp,
 			  "ongoing received message exceeds max allowed message size [message size:%zu, max message size:%zu, eor:%u]",
-			  this->messageBufferLen + len,
+			  bufferLen + len,
 			  this->maxSctpMessageSize,
 			  eor ? 1 : 0);
 
 			this->lastSsnReceived = 0;
 
+			std::free(data);
+
 			return;
 		}
 
 		// If end of message and there is no buffered data, notify it directly.
-		if (eor && this->messageBufferLen == 0)
+		// The message takes the usrsctp buffer, so it is never copied.
+		if (eor && !this->messageBuffer)
 		{
 			MS_DEBUG_DEV("directly notifying listener [eor:1, buffer len:0]");
 
-			this->listener->OnSctpAssociationMessageReceived(this, streamId, ppid, data, len);
+			auto* message = RTC::MessageBuffer::Adopt(data, len);
+
+			this->listener->OnSctpAssociationMessageReceived(this, streamId, ppid, message);
+
+			message->Unref();
 		}
 		// If end of message and there is buffered data, append data and notify buffer.
-		else if (eor && this->messageBufferLen != 0)
+		else if (eor && this->messageBuffer)
 		{
-			std::memcpy(this->messageBuffer + this->messageBufferLen, data, len);
-			this->messageBufferLen += len;
+			auto* message = this->messageBuffer;
+
+			// The next message needs a new buffer since the listener may keep this one.
+			this->messageBuffer = nullptr;
+
+			message->Append(data, len);
+			std::free(data);
 
-			MS_DEBUG_DEV("notifying listener [eor:1, buffer len:%zu]", this->messageBufferLen);
+			MS_DEBUG_DEV("notifying listener [eor:1, buffer len:%zu]", message->GetSize());
 
-			this->listener->OnSctpAssociationMessageReceived(
-			  this, streamId, ppid, this->messageBuffer, this->messageBufferLen);
+			this->listener->OnSctpAssociationMessageReceived(this, streamId, ppid, message);
 
-			this->messageBufferLen = 0;
+			message->Unref();
 		}
 		// If non end of message, append data to the buffer.
 		else if (!eor)
 		{
-			// Allocate the buffer if not already done.
+			// Allocate the buffer if not already done. It grows as chunks arrive.
 			if (!this->messageBuffer)
-				this->messageBuffer = new uint8_t[this->maxSctpMessageSize];
+				this->messageBuffer = RTC::MessageBuffer::Create(len * 2);
 
-			std::memcpy(this->messageBuffer + this->messageBufferLen, data, len);
-			this->messageBufferLen += len;
+			this->messageBuffer->Append(data, len);
+			std::free(data);
 
-			MS_DEBUG_DEV("data buffered [eor:0, buffer len:%zu]", this->messageBufferLen);
+			MS_DEBUG_DEV("data buffered [eor:0, buffer len:%zu]", this->messageBuffer->GetSize());
 		}
 	}
 
@@ -659,6 +659,26 @@ namespace RTC
 		return desiredBitrate;
 	}
 
+	bool SimulcastConsumer::GetForwardedMappedSsrcs(std::array<uint32_t, 2>& mappedSsrcs) const
+	{
+		MS_TRACE();
+
+		mappedSsrcs.fill(0u);
+
+		// No packet is forwarded until there are target layers.
+		if (this->targetTemporalLayer == -1)
+			return true;
+
+		// Packets of the current spatial layer and key frames of the target one.
+		if (this->currentSpatialLayer != -1)
+			mappedSsrcs[0] = this->consumableRtpEncodings[this->currentSpatialLayer].ssrc;
+
+		if (this->targetSpatialLayer != -1)
+			mappedSsrcs[1] = this->consumableRtpEncodings[this->targetSpatialLayer].ssrc;
+
+		return true;
+	}
+
 	void SimulcastConsumer::SendRtpPacket(
 	  RTC::RtpPacket* packet, std::shared_ptr<RTC::RtpPacket>& sharedPacket)
 	{
@@ -877,6 +897,9 @@ namespace RTC
 			this->encodingContext->SetTargetTemporalLayer(this->targetTemporalLayer);
 			this->encodingContext->SetCurrentTemporalLayer(packet->GetTemporalLayer());
 
+			// Packets of the previous spatial layer are dropped from now on.
+			this->listener->OnConsumerForwardingChanged(this);
+
 			// Reset the score of our RtpStream to 10.
 			this->rtpStream->ResetScore(10u, /*notify*/ false);
 
@@ -1410,6 +1433,8 @@ namespace RTC
 
 			EmitLayersChange();
 
+			this->listener->OnConsumerForwardingChanged(this);
+
 			return;
 		}
 
@@ -1432,6 +1457,8 @@ namespace RTC
 		// a key frame.
 		if (this->targetSpatialLayer != this->currentSpatialLayer)
 			RequestKeyFrameForTargetSpatialLayer();
+
+		this->listener->OnConsumerForwardingChanged(this);
 	}
 
 	inline bool SimulcastConsumer::CanSwitchToSpatialLayer(int16_t spatialLayer) const
@@ -3,6 +3,7 @@
 
 #include "RTC/SrtpSession.hpp"
 #include "DepLibSRTP.hpp"
+#include "ForwardingMetrics.hpp"
 #include "Logger.hpp"
 #include "MediaSoupErrors.hpp"
 #include <cstring> // std::memset(), std::memcpy()
@@ -158,6 +159,8 @@ namespace RTC
 			return false;
 		}
 
+		ForwardingMetrics::ScopedStage scopedStage(ForwardingMetrics::Stage::SRTP_ENCRYPT);
+
 		std::memcpy(EncryptBuffer, *data, *len);
 
 		const srtp_err_status_t err = srtp_protect(this->session, static_cast<void*>(EncryptBuffer), len);
@@ -179,6 +182,8 @@ namespace RTC
 	{
 		MS_TRACE();
 
+		ForwardingMetrics::ScopedStage scopedStage(ForwardingMetrics::Stage::SRTP_DECRYPT);
+
 		const srtp_err_status_t err = srtp_unprotect(this->session, static_cast<void*>(data), len);
 
 		if (DepLibSRTP::IsError(err))
@@ -0,0 +1,166 @@
+#define MS_CLASS "RTC::StatsPublisher"
+// #define MS_LOG_DEV_LEVEL 3
+
+#include "RTC/StatsPublisher.hpp"
+#include "DepLibUV.hpp"
+#include "Logger.hpp"
+
+namespace RTC
+{
+	/* Instance methods. */
+
+	StatsPublisher::StatsPublisher(
+	  Listener* listener,
+	  PayloadChannel::PayloadChannelNotifier* payloadChannelNotifier,
+	  const std::string& targetId,
+	  uint64_t intervalMs)
+	  : listener(listener), payloadChannelNotifier(payloadChannelNotifier), targetId(targetId)
+	{
+		MS_TRACE();
+
+		this->timer = new Timer(this);
+
+		this->timer->Start(intervalMs, intervalMs);
+	}
+
+	StatsPublisher::~StatsPublisher()
+	{
+		MS_TRACE();
+
+		delete this->timer;
+	}
+
+	void StatsPublisher::AddEntry(
+	  const void* owner,
+	  EntryType type,
+	  const std::string& id,
+	  uint32_t ssrc,
+	  const Counters& counters,
+	  size_t numCounters)
+	{
+		MS_TRACE();
+
+		MS_ASSERT(numCounters <= MaxCounters, "too many counters");
+
+		auto it = this->mapOwnerEntry.find(owner);
+
+		// The owner was deleted and its memory reused by a new entity.
+		if (it != this->mapOwnerEntry.end())
+		{
+			auto& entry = it->second;
+
+			if (entry.type != type || entry.ssrc != ssrc || entry.id != id)
+			{
+				WriteByte(static_cast<uint8_t>(RecordType::REMOVED));
+				WriteVarint(entry.key);
+				++this->numRecords;
+
+				this->mapOwnerEntry.erase(it);
+				it = this->mapOwnerEntry.end();
+			}
+		}
+
+		if (it == this->mapOwnerEntry.end())
+		{
+			Entry entry;
+
+			entry.key         = this->nextKey++;
+			entry.type        = type;
+			entry.ssrc        = ssrc;
+			entry.id          = id;
+			entry.numCounters = static_cast<uint8_t>(numCounters);
+
+			WriteByte(static_cast<uint8_t>(RecordType::ENTITY));
+			WriteVarint(entry.key);
+			WriteByte(static_cast<uint8_t>(type));
+			WriteVarint(ssrc);
+			WriteVarint(id.size());
+			this->buffer.insert(this->buffer.end(), id.begin(), id.end());
+			WriteByte(entry.numCounters);
+			++this->numRecords;
+
+			it = this->mapOwnerEntry.emplace(owner, std::move(entry)).first;
+		}
+
+		auto& entry = it->second;
+		uint64_t changedMask{ 0u };
+
+		entry.lastSeq = this->seq;
+
+		for (size_t idx{ 0u }; idx < entry.numCounters; ++idx)
+		{
+			if (counters[idx] != entry.counters[idx])
+				changedMask |= uint64_t{ 1u } << idx;
+		}
+
+		if (changedMask == 0u)
+			return;
+
+		WriteByte(static_cast<uint8_t>(RecordType::COUNTERS));
+		WriteVarint(entry.key);
+		WriteVarint(changedMask);
+
+		for (size_t idx{ 0u }; idx < entry.numCounters; ++idx)
+		{
+			if ((changedMask & (uint64_t{ 1u } << idx)) == 0u)
+				continue;
+
+			WriteDelta(counters[idx], entry.counters[idx]);
+
+			entry.counters[idx] = counters[idx];
+		}
+
+		++this->numRecords;
+	}
+
+	void StatsPublisher::Publish()
+	{
+		MS_TRACE();
+
+		++this->seq;
+
+		this->buffer.clear();
+		this->numRecords = 0u;
+
+		WriteByte(Version);
+		WriteByte(this->seq == 1u ? FlagFull : 0u);
+		WriteVarint(this->seq);
+		WriteVarint(DepLibUV::GetTimeMs());
+
+		this->listener->OnStatsPublisherCollect(this);
+
+		// Entries not collected this time belong to closed entities.
+		for (auto it = this->mapOwnerEntry.begin(); it != this->mapOwnerEntry.end();)
+		{
+			auto& entry = it->second;
+
+			if (entry.lastSeq == this->seq)
+			{
+				++it;
+
+				continue;
+			}
+
+			WriteByte(static_cast<uint8_t>(RecordType::REMOVED));
+			WriteVarint(entry.key);
+			++this->numRecords;
+
+			this->mapOwnerEntry.erase(it++);
+		}
+
+		// Nothing changed, so do not bother the receiver. The first snapshot is
+		// always sent so that it can reset its state.
+		if (this->numRecords == 0u && this->seq != 1u)
+			return;
+
+		this->payloadChannelNotifier->Emit(
+		  this->targetId, "stats", this->buffer.data(), this->buffer.size());
+	}
+
+	void StatsPublisher::OnTimer(Timer* /*timer*/)
+	{
+		MS_TRACE();
+
+		Publish();
+	}
+} // namespace RTC
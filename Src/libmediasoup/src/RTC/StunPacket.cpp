@@ -12,6 +12,38 @@ namespace RTC
 	/* Class variables. */
 
 	const uint8_t StunPacket::magicCookie[] = { 0x21, 0x12, 0xA4, 0x42 };
+	// clang-format off
+	const uint8_t StunPacket::successResponseTemplateIPv4[64] =
+	{
+		0x01, 0x01, 0x00, 0x2C,                         // Binding success response, length 44.
+		0x21, 0x12, 0xA4, 0x42,                         // Magic cookie.
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00,             // Transaction ID.
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+		0x00, 0x20, 0x00, 0x08,                         // XOR-MAPPED-ADDRESS.
+		0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+		0x00, 0x08, 0x00, 0x14,                         // MESSAGE-INTEGRITY.
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+		0x80, 0x28, 0x00, 0x04,                         // FINGERPRINT.
+		0x00, 0x00, 0x00, 0x00
+	};
+	const uint8_t StunPacket::successResponseTemplateIPv6[76] =
+	{
+		0x01, 0x01, 0x00, 0x38,                         // Binding success response, length 56.
+		0x21, 0x12, 0xA4, 0x42,                         // Magic cookie.
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00,             // Transaction ID.
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+		0x00, 0x20, 0x00, 0x14,                         // XOR-MAPPED-ADDRESS.
+		0x00, 0x02, 0x00, 0x00,
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+		0x00, 0x08, 0x00, 0x14,                         // MESSAGE-INTEGRITY.
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+		0x80, 0x28, 0x00, 0x04,                         // FINGERPRINT.
+		0x00, 0x00, 0x00, 0x00
+	};
+	// clang-format on
 
 	/* Class methods. */
 
@@ -424,6 +456,24 @@ namespace RTC
 	{
 		MS_TRACE();
 
+		return CheckAuthentication(localUsername, &localPassword, nullptr);
+	}
+
+	StunPacket::Authentication StunPacket::CheckAuthentication(
+	  const std::string& localUsername, Utils::Crypto::HmacSha1& localHmacSha1)
+	{
+		MS_TRACE();
+
+		return CheckAuthentication(localUsername, nullptr, &localHmacSha1);
+	}
+
+	StunPacket::Authentication StunPacket::CheckAuthentication(
+	  const std::string& localUsername,
+	  const std::string* localPassword,
+	  Utils::Crypto::HmacSha1* localHmacSha1)
+	{
+		MS_TRACE();
+
 		switch (this->klass)
 		{
 			case Class::REQUEST:
@@ -463,8 +513,10 @@ namespace RTC
 			Utils::Byte::Set2Bytes(this->data, 2, static_cast<uint16_t>(this->size - 20 - 8));
 
 		// Calculate the HMAC-SHA1 of the message according to MESSAGE-INTEGRITY rules.
-		const uint8_t* computedMessageIntegrity = Utils::Crypto::GetHmacSha1(
-		  localPassword, this->data, (this->messageIntegrity - 4) - this->data);
+		const size_t messageIntegrityPos = (this->messageIntegrity - 4) - this->data;
+		const uint8_t* computedMessageIntegrity =
+		  localHmacSha1 ? localHmacSha1->GetHmac(this->data, messageIntegrityPos)
+		                : Utils::Crypto::GetHmacSha1(*localPassword, this->data, messageIntegrityPos);
 
 		Authentication result;
 
@@ -492,6 +544,101 @@ namespace RTC
 		return new StunPacket(Class::SUCCESS_RESPONSE, this->method, this->transactionId, nullptr, 0);
 	}
 
+	size_t StunPacket::SerializeSuccessResponse(
+	  uint8_t* buffer, const struct sockaddr* xorMappedAddress, Utils::Crypto::HmacSha1& hmacSha1) const
+	{
+		MS_TRACE();
+
+		MS_ASSERT(
+		  this->klass == Class::REQUEST && this->method == Method::BINDING,
+		  "attempt to create a success response for a non Binding Request STUN packet");
+
+		size_t size;
+		uint8_t* attrValue = buffer + 20 + 4;
+
+		switch (xorMappedAddress->sa_family)
+		{
+			case AF_INET:
+			{
+				size = sizeof(StunPacket::successResponseTemplateIPv4);
+
+				std::memcpy(buffer, StunPacket::successResponseTemplateIPv4, size);
+
+				// Set port and address and XOR them.
+				std::memcpy(
+				  attrValue + 2, &(reinterpret_cast<const sockaddr_in*>(xorMappedAddress))->sin_port, 2);
+				std::memcpy(
+				  attrValue + 4,
+				  &(reinterpret_cast<const sockaddr_in*>(xorMappedAddress))->sin_addr.s_addr,
+				  4);
+
+				break;
+			}
+
+			case AF_INET6:
+			{
+				size = sizeof(StunPacket::successResponseTemplateIPv6);
+
+				std::memcpy(buffer, StunPacket::successResponseTemplateIPv6, size);
+
+				// Set port and address and XOR them.
+				std::memcpy(
+				  attrValue + 2, &(reinterpret_cast<const sockaddr_in6*>(xorMappedAddress))->sin6_port, 2);
+				std::memcpy(
+				  attrValue + 4,
+				  &(reinterpret_cast<const sockaddr_in6*>(xorMappedAddress))->sin6_addr.s6_addr,
+				  16);
+
+				for (size_t i{ 0 }; i < 12; ++i)
+				{
+					attrValue[8 + i] ^= this->transactionId[i];
+				}
+
+				break;
+			}
+
+			default:
+			{
+				MS_ERROR("invalid inet family in XOR-MAPPED-ADDRESS attribute");
+
+				return 0u;
+			}
+		}
+
+		attrValue[2] ^= StunPacket::magicCookie[0];
+		attrValue[3] ^= StunPacket::magicCookie[1];
+		attrValue[4] ^= StunPacket::magicCookie[0];
+		attrValue[5] ^= StunPacket::magicCookie[1];
+		attrValue[6] ^= StunPacket::magicCookie[2];
+		attrValue[7] ^= StunPacket::magicCookie[3];
+
+		// Set TransactionId field.
+		std::memcpy(buffer + 8, this->transactionId, 12);
+
+		// MESSAGE-INTEGRITY and FINGERPRINT are the last two attributes.
+		const size_t messageIntegrityPos = size - (4 + 20) - (4 + 4);
+		const size_t fingerprintPos      = size - (4 + 4);
+
+		// The header length field must not include FINGERPRINT while computing
+		// MESSAGE-INTEGRITY.
+		Utils::Byte::Set2Bytes(buffer, 2, static_cast<uint16_t>(size - 20 - 8));
+
+		std::memcpy(
+		  buffer + messageIntegrityPos + 4, hmacSha1.GetHmac(buffer, messageIntegrityPos), 20);
+
+		// Restore the header length field.
+		Utils::Byte::Set2Bytes(buffer, 2, static_cast<uint16_t>(size - 20));
+
+		// Compute the CRC32 of the response up to (but excluding) the FINGERPRINT
+		// attribute and XOR it with 0x5354554e.
+		const uint32_t computedFingerprint =
+		  Utils::Crypto::GetCRC32(buffer, fingerprintPos) ^ 0x5354554e;
+
+		Utils::Byte::Set4Bytes(buffer, fingerprintPos + 4, computedFingerprint);
+
+		return size;
+	}
+
 	StunPacket* StunPacket::CreateErrorResponse(uint16_t errorCode)
 	{
 		MS_TRACE();
@@ -154,7 +154,8 @@ namespace RTC
 		}
 	}
 
-	void TcpConnection::Send(const uint8_t* data, size_t len, ::TcpConnectionHandler::onSendCallback* cb)
+	void TcpConnection::Send(
+	  const uint8_t* data, size_t len, const ::TcpConnectionHandler::onSendCallback& cb)
 	{
 		MS_TRACE();
 
@@ -2,6 +2,7 @@
 // #define MS_LOG_DEV_LEVEL 3
 
 #include "RTC/Transport.hpp"
+#include "ForwardingMetrics.hpp"
 #include "Logger.hpp"
 #include "MediaSoupErrors.hpp"
 #include "Utils.hpp"
@@ -27,6 +28,40 @@ namespace RTC
 {
 	static const size_t DefaultSctpSendBufferSize{ 262144 }; // 2^18.
 	static const size_t MaxSctpSendBufferSize{ 268435456 };  // 2^28.
+	static constexpr size_t InitialSentRtpPacketRecords{ 64u };
+	// Beyond this, the oldest pending record is overwritten and its send
+	// callback ignored.
+	static constexpr size_t MaxSentRtpPacketRecords{ 8192u };
+	// Send callback id: slot (20 bits), slot generation (12 bits), record seq
+	// (32 bits).
+	static constexpr uint64_t SendCallbackGenerationMask{ 0xFFF };
+
+	/* Class variables. */
+
+	thread_local std::vector<std::pair<Transport*, uint16_t>> Transport::sendCallbackSlots;
+	thread_local std::vector<uint32_t> Transport::freeSendCallbackSlots;
+
+	/* Class methods. */
+
+	void Transport::OnSendCallback(uint64_t id, bool sent)
+	{
+		MS_TRACE();
+
+		const auto slot       = static_cast<uint32_t>(id >> 44);
+		const auto generation = static_cast<uint16_t>((id >> 32) & SendCallbackGenerationMask);
+		const auto seq        = static_cast<uint32_t>(id);
+
+		if (slot >= Transport::sendCallbackSlots.size())
+			return;
+
+		auto& transportAndGeneration = Transport::sendCallbackSlots[slot];
+
+		// The Transport has been closed.
+		if (!transportAndGeneration.first || transportAndGeneration.second != generation)
+			return;
+
+		transportAndGeneration.first->OnRtpPacketSent(seq, sent);
+	}
 
 	/* Instance methods. */
 
@@ -36,6 +71,22 @@ namespace RTC
 	{
 		MS_TRACE();
 
+		// Get a slot so send callbacks can refer to this Transport.
+		if (!Transport::freeSendCallbackSlots.empty())
+		{
+			this->sendCallbackSlot = Transport::freeSendCallbackSlots.back();
+			Transport::freeSendCallbackSlots.pop_back();
+
+			Transport::sendCallbackSlots[this->sendCallbackSlot].first = this;
+		}
+		else
+		{
+			this->sendCallbackSlot = static_cast<uint32_t>(Transport::sendCallbackSlots.size());
+			Transport::sendCallbackSlots.emplace_back(this, 0u);
+		}
+
+		this->sentRtpPacketRecords.resize(InitialSentRtpPacketRecords);
+
 		auto jsonDirectIt = data.find("direct");
 
 		// clang-format off
@@ -181,8 +232,22 @@ namespace RTC
 		// Set the destroying flag.
 		this->destroying = true;
 
+		// Release the slot so pending send callbacks are ignored.
+		{
+			auto& transportAndGeneration = Transport::sendCallbackSlots[this->sendCallbackSlot];
+
+			transportAndGeneration.first  = nullptr;
+			transportAndGeneration.second = (transportAndGeneration.second + 1) & SendCallbackGenerationMask;
+
+			Transport::freeSendCallbackSlots.push_back(this->sendCallbackSlot);
+		}
+
 		// The destructor must delete and clear everything silently.
 
+		// Delete the RtpPacer before the Consumers its queued packets refer to.
+		delete this->rtpPacer;
+		this->rtpPacer = nullptr;
+
 		// Delete all Producers.
 		for (auto& kv : this->mapProducers)
 		{
@@ -240,6 +305,10 @@ namespace RTC
 		// The caller is supposed to delete this Transport instance after calling
 		// this method.
 
+		// Drop the packets queued for the Consumers that we are gonna close.
+		if (this->rtpPacer)
+			this->rtpPacer->Clear();
+
 		// Close all Producers.
 		for (auto& kv : this->mapProducers)
 		{
@@ -552,6 +621,74 @@ namespace RTC
 		// Add packetLossSent.
 		if (this->tccClient)
 			jsonObject["rtpPacketLossSent"] = this->tccClient->GetPacketLoss();
+
+		// Add pacerQueueSize.
+		if (this->rtpPacer)
+			jsonObject["pacerQueueSize"] = this->rtpPacer->GetQueueSize();
+
+		// Add rtcpTicks.
+		jsonObject["rtcpTicks"] = this->rtcpTicks;
+
+		// Add rtcpTickTime (average, in microseconds).
+		if (this->rtcpTicks > 0u)
+			jsonObject["rtcpTickTime"] = this->rtcpTickTimeNs / this->rtcpTicks / 1000u;
+
+		// Add maxRtcpTickTime (in microseconds).
+		jsonObject["maxRtcpTickTime"] = this->maxRtcpTickTimeNs / 1000u;
+	}
+
+	void Transport::FillBinaryStats(RTC::StatsPublisher* statsPublisher)
+	{
+		MS_TRACE();
+
+		auto nowMs = DepLibUV::GetTimeMs();
+		RTC::StatsPublisher::Counters counters;
+
+		// NOTE: Keep the order in sync with the SDK WorkerStats counter names.
+		counters[0]  = this->recvTransmission.GetBytes();
+		counters[1]  = this->recvTransmission.GetRate(nowMs);
+		counters[2]  = this->sendTransmission.GetBytes();
+		counters[3]  = this->sendTransmission.GetRate(nowMs);
+		counters[4]  = this->recvRtpTransmission.GetBytes();
+		counters[5]  = this->recvRtpTransmission.GetBitrate(nowMs);
+		counters[6]  = this->sendRtpTransmission.GetBytes();
+		counters[7]  = this->sendRtpTransmission.GetBitrate(nowMs);
+		counters[8]  = this->recvRtxTransmission.GetBytes();
+		counters[9]  = this->recvRtxTransmission.GetBitrate(nowMs);
+		counters[10] = this->sendRtxTransmission.GetBytes();
+		counters[11] = this->sendRtxTransmission.GetBitrate(nowMs);
+		counters[12] = this->sendProbationTransmission.GetBytes();
+
+		statsPublisher->AddEntry(
+		  this, RTC::StatsPublisher::EntryType::TRANSPORT, this->id, 0u, counters, 13u);
+
+		for (auto& kv : this->mapProducers)
+		{
+			auto* producer = kv.second;
+
+			producer->FillBinaryStats(statsPublisher);
+		}
+
+		for (auto& kv : this->mapConsumers)
+		{
+			auto* consumer = kv.second;
+
+			consumer->FillBinaryStats(statsPublisher);
+		}
+
+		for (auto& kv : this->mapDataProducers)
+		{
+			auto* dataProducer = kv.second;
+
+			dataProducer->FillBinaryStats(statsPublisher);
+		}
+
+		for (auto& kv : this->mapDataConsumers)
+		{
+			auto* dataConsumer = kv.second;
+
+			dataConsumer->FillBinaryStats(statsPublisher);
+		}
 	}
 
 	void Transport::HandleRequest(Channel::ChannelRequest* request)
@@ -1006,6 +1143,8 @@ namespace RTC
 
 						if (IsConnected())
 							this->tccClient->TransportConnected();
+
+						this->rtpPacer = new RTC::RtpPacer(this, this->initialAvailableOutgoingBitrate);
 					}
 				}
 
@@ -1345,6 +1484,10 @@ namespace RTC
 				// Remove it from the maps.
 				this->mapConsumers.erase(consumer->id);
 
+				// Drop its packets queued in the RtpPacer.
+				if (this->rtpPacer)
+					this->rtpPacer->RemoveConsumer(consumer);
+
 				for (auto ssrc : consumer->GetMediaSsrcs())
 				{
 					this->mapSsrcConsumer.erase(ssrc);
@@ -1495,8 +1638,11 @@ namespace RTC
 		if (this->sctpAssociation)
 			this->sctpAssociation->TransportConnected();
 
-		// Start the RTCP timer.
-		this->rtcpTimer->Start(static_cast<uint64_t>(RTC::RTCP::MaxVideoIntervalMs / 2));
+		// Start the RTCP timer at a random point of the first half interval so
+		// Transports connected at once (such as the PipeTransports between
+		// Routers) do not send their RTCP in the same loop iteration.
+		this->rtcpTimer->Start(static_cast<uint64_t>(Utils::Crypto::GetRandomUInt(
+		  RTC::RTCP::MaxVideoIntervalMs / 4, RTC::RTCP::MaxVideoIntervalMs * 3 / 4)));
 
 		// Tell the TransportCongestionControlClient.
 		if (this->tccClient)
@@ -1540,6 +1686,10 @@ namespace RTC
 		if (this->tccClient)
 			this->tccClient->TransportDisconnected();
 
+		// Drop the packets queued in the RtpPacer.
+		if (this->rtpPacer)
+			this->rtpPacer->Clear();
+
 		// Tell the TransportCongestionControlServer.
 		if (this->tccServer)
 			this->tccServer->TransportDisconnected();
@@ -1555,6 +1705,9 @@ namespace RTC
 	{
 		MS_TRACE();
 
+		ForwardingMetrics::ScopedStage scopedStage(
+		  ForwardingMetrics::Stage::TRANSPORT_RECEIVE_RTP_PACKET);
+
 		// Apply the Transport RTP header extension ids so the RTP listener can use them.
 		packet->SetMidExtensionId(this->recvRtpHeaderExtensionIds.mid);
 		packet->SetRidExtensionId(this->recvRtpHeaderExtensionIds.rid);
@@ -1834,6 +1987,140 @@ namespace RTC
 		return dataConsumer;
 	}
 
+	Transport::onSendCallback Transport::CreateSendCallback(
+	  const webrtc::RtpPacketSendInfo& packetInfo, RTC::RtpPacket* packet, bool isProbation)
+	{
+		MS_TRACE();
+
+		// When using WebRtcServer, the lifecycle of a RTC::UdpSocket maybe longer
+		// than WebRtcTransport so there is a chance for the send callback to be
+		// invoked *after* the WebRtcTransport has been closed (freed). Hence the
+		// callback just carries an id which is validated when invoked, and the
+		// send info is kept here until then.
+		const uint32_t seq = this->sentRtpPacketRecordSeq++;
+		auto mask          = this->sentRtpPacketRecords.size() - 1;
+
+		// Too many packets pending to be notified (UDP sends may be batched until
+		// the end of the loop iteration and TCP writes may be queued), so grow the
+		// ring. Pending records have consecutive seqs, so they don't collide in
+		// the new one either.
+		// clang-format off
+		if (
+			this->sentRtpPacketRecords[seq & mask].pending &&
+			this->sentRtpPacketRecords.size() < MaxSentRtpPacketRecords
+		)
+		// clang-format on
+		{
+			std::vector<SentRtpPacketRecord> records(this->sentRtpPacketRecords.size() * 2);
+
+			mask = records.size() - 1;
+
+			for (auto& record : this->sentRtpPacketRecords)
+			{
+				if (record.pending)
+					records[record.seq & mask] = record;
+			}
+
+			this->sentRtpPacketRecords.swap(records);
+		}
+
+		auto& record = this->sentRtpPacketRecords[seq & mask];
+
+		record.seq        = seq;
+		record.pending    = true;
+		record.packetInfo = packetInfo;
+
+#ifdef ENABLE_RTC_SENDER_BANDWIDTH_ESTIMATOR
+		record.sentInfo             = RTC::SenderBandwidthEstimator::SentInfo();
+		record.sentInfo.wideSeq     = this->transportWideCcSeq;
+		record.sentInfo.size        = packet->GetSize();
+		record.sentInfo.isProbation = isProbation;
+		record.sentInfo.sendingAtMs = DepLibUV::GetTimeMs();
+#else
+		static_cast<void>(packet);
+		static_cast<void>(isProbation);
+#endif
+
+		const uint64_t id = (static_cast<uint64_t>(this->sendCallbackSlot) << 44) |
+		                    (static_cast<uint64_t>(
+		                       Transport::sendCallbackSlots[this->sendCallbackSlot].second)
+		                     << 32) |
+		                    seq;
+
+		return { &Transport::OnSendCallback, id };
+	}
+
+	void Transport::OnRtpPacketSent(uint32_t seq, bool sent)
+	{
+		MS_TRACE();
+
+		auto& record = this->sentRtpPacketRecords[seq & (this->sentRtpPacketRecords.size() - 1)];
+
+		// Overwritten record.
+		if (!record.pending || record.seq != seq)
+			return;
+
+		record.pending = false;
+
+		if (!sent)
+			return;
+
+		if (this->tccClient)
+			this->tccClient->PacketSent(record.packetInfo, DepLibUV::GetTimeMsInt64());
+
+#ifdef ENABLE_RTC_SENDER_BANDWIDTH_ESTIMATOR
+		if (this->senderBwe)
+		{
+			record.sentInfo.sentAtMs = DepLibUV::GetTimeMs();
+			this->senderBwe->RtpPacketSent(record.sentInfo);
+		}
+#endif
+	}
+
+	void Transport::SendConsumerRtpPacket(
+	  RTC::Consumer* consumer, RTC::RtpPacket* packet, bool retransmission)
+	{
+		MS_TRACE();
+
+		// Update abs-send-time if present.
+		packet->UpdateAbsSendTime(DepLibUV::GetTimeMs());
+
+		// Update transport wide sequence number if present.
+		// clang-format off
+		if (
+			this->tccClient &&
+			this->tccClient->GetBweType() == RTC::BweType::TRANSPORT_CC &&
+			packet->UpdateTransportWideCc01(this->transportWideCcSeq + 1)
+		)
+		// clang-format on
+		{
+			this->transportWideCcSeq++;
+
+			webrtc::RtpPacketSendInfo packetInfo;
+
+			packetInfo.ssrc                      = packet->GetSsrc();
+			packetInfo.transport_sequence_number = this->transportWideCcSeq;
+			packetInfo.has_rtp_sequence_number   = true;
+			packetInfo.rtp_sequence_number       = packet->GetSequenceNumber();
+			packetInfo.length                    = packet->GetSize();
+			packetInfo.pacing_info               = this->tccClient->GetPacingInfo();
+
+			// Indicate the pacer (and prober) that a packet is to be sent.
+			this->tccClient->InsertPacket(packetInfo);
+
+			SendRtpPacket(consumer, packet, CreateSendCallback(packetInfo, packet, false));
+		}
+		else
+		{
+			SendRtpPacket(consumer, packet);
+		}
+
+		if (!retransmission)
+			this->sendRtpTransmission.Update(packet);
+		else
+			this->sendRtxTransmission.Update(packet);
+	}
+
 	void Transport::HandleRtcpPacket(RTC::RTCP::Packet* packet)
 	{
 		MS_TRACE();
@@ -2231,51 +2518,55 @@ namespace RTC
 	{
 		MS_TRACE();
 
-		std::unique_ptr<RTC::RTCP::CompoundPacket> packet{ new RTC::RTCP::CompoundPacket() };
+		// Reused on every tick, so its report lists keep their storage and its
+		// reports go back to the RTCP ReportPool.
+		auto* packet = &this->rtcpCompoundPacket;
 
 		for (auto& kv : this->mapConsumers)
 		{
 			auto* consumer = kv.second;
-			auto rtcpAdded = consumer->GetRtcp(packet.get(), nowMs);
+			auto rtcpAdded = consumer->GetRtcp(packet, nowMs);
 
 			// RTCP data couldn't be added because the Compound packet is full.
 			// Send the RTCP compound packet and request for RTCP again.
 			if (!rtcpAdded)
 			{
-				SendRtcpCompoundPacket(packet.get());
+				SendRtcpCompoundPacket(packet);
 
-				// Create a new compount packet.
-				packet.reset(new RTC::RTCP::CompoundPacket());
+				// Start a new compound packet.
+				packet->Reset();
 
 				// Retrieve the RTCP again.
-				consumer->GetRtcp(packet.get(), nowMs);
+				consumer->GetRtcp(packet, nowMs);
 			}
 		}
 
 		for (auto& kv : this->mapProducers)
 		{
 			auto* producer = kv.second;
-			auto rtcpAdded = producer->GetRtcp(packet.get(), nowMs);
+			auto rtcpAdded = producer->GetRtcp(packet, nowMs);
 
 			// RTCP data couldn't be added because the Compound packet is full.
 			// Send the RTCP compound packet and request for RTCP again.
 			if (!rtcpAdded)
 			{
-				SendRtcpCompoundPacket(packet.get());
+				SendRtcpCompoundPacket(packet);
 
-				// Create a new compount packet.
-				packet.reset(new RTC::RTCP::CompoundPacket());
+				// Start a new compound packet.
+				packet->Reset();
 
 				// Retrieve the RTCP again.
-				producer->GetRtcp(packet.get(), nowMs);
+				producer->GetRtcp(packet, nowMs);
 			}
 		}
 
 		// Send the RTCP compound packet if there is any sender or receiver report.
 		if (packet->GetReceiverReportCount() > 0u || packet->GetSenderReportCount() > 0u)
 		{
-			SendRtcpCompoundPacket(packet.get());
+			SendRtcpCompoundPacket(packet);
 		}
+
+		packet->Reset();
 	}
 
 	void Transport::DistributeAvailableOutgoingBitrate()
@@ -2494,183 +2785,32 @@ namespace RTC
 	{
 		MS_TRACE();
 
-		// Update abs-send-time if present.
-		packet->UpdateAbsSendTime(DepLibUV::GetTimeMs());
-
-		// Update transport wide sequence number if present.
-		// clang-format off
-		if (
-			this->tccClient &&
-			this->tccClient->GetBweType() == RTC::BweType::TRANSPORT_CC &&
-			packet->UpdateTransportWideCc01(this->transportWideCcSeq + 1)
-		)
-		// clang-format on
-		{
-			this->transportWideCcSeq++;
-
-			webrtc::RtpPacketSendInfo packetInfo;
-
-			packetInfo.ssrc                      = packet->GetSsrc();
-			packetInfo.transport_sequence_number = this->transportWideCcSeq;
-			packetInfo.has_rtp_sequence_number   = true;
-			packetInfo.rtp_sequence_number       = packet->GetSequenceNumber();
-			packetInfo.length                    = packet->GetSize();
-			packetInfo.pacing_info               = this->tccClient->GetPacingInfo();
-
-			// Indicate the pacer (and prober) that a packet is to be sent.
-			this->tccClient->InsertPacket(packetInfo);
-
-			// When using WebRtcServer, the lifecycle of a RTC::UdpSocket maybe longer
-			// than WebRtcTransport so there is a chance for the send callback to be
-			// invoked *after* the WebRtcTransport has been closed (freed). To avoid
-			// invalid memory access we need to use weak_ptr. Same applies in other
-			// send callbacks.
-			const std::weak_ptr<RTC::TransportCongestionControlClient> tccClientWeakPtr(this->tccClient);
+		const auto priority = consumer->GetKind() == RTC::Media::Kind::AUDIO
+		                        ? RTC::RtpPacer::Priority::AUDIO
+		                        : RTC::RtpPacer::Priority::VIDEO;
 
-#ifdef ENABLE_RTC_SENDER_BANDWIDTH_ESTIMATOR
-			std::weak_ptr<RTC::SenderBandwidthEstimator> senderBweWeakPtr(this->senderBwe);
-			RTC::SenderBandwidthEstimator::SentInfo sentInfo;
-
-			sentInfo.wideSeq     = this->transportWideCcSeq;
-			sentInfo.size        = packet->GetSize();
-			sentInfo.sendingAtMs = DepLibUV::GetTimeMs();
-
-			auto* cb = new onSendCallback(
-			  [tccClientWeakPtr, &packetInfo, senderBweWeakPtr, &sentInfo](bool sent)
-			  {
-				  if (sent)
-				  {
-					  auto tccClient = tccClientWeakPtr.lock();
-
-					  if (tccClient)
-					  {
-						  tccClient->PacketSent(packetInfo, DepLibUV::GetTimeMsInt64());
-					  }
-
-					  auto senderBwe = senderBweWeakPtr.lock();
-
-					  if (senderBwe)
-					  {
-						  sentInfo.sentAtMs = DepLibUV::GetTimeMs();
-						  senderBwe->RtpPacketSent(sentInfo);
-					  }
-				  }
-			  });
-
-			SendRtpPacket(consumer, packet, cb);
-#else
-			const auto* cb = new onSendCallback(
-			  [tccClientWeakPtr, &packetInfo](bool sent)
-			  {
-				  if (sent)
-				  {
-					  auto tccClient = tccClientWeakPtr.lock();
-
-					  if (tccClient)
-					  {
-						  tccClient->PacketSent(packetInfo, DepLibUV::GetTimeMsInt64());
-					  }
-				  }
-			  });
-
-			SendRtpPacket(consumer, packet, cb);
-#endif
-		}
-		else
-		{
-			SendRtpPacket(consumer, packet);
-		}
+		// The packet may be queued to be sent later.
+		if (this->rtpPacer && this->rtpPacer->Enqueue(consumer, packet, priority))
+			return;
 
-		this->sendRtpTransmission.Update(packet);
+		SendConsumerRtpPacket(consumer, packet, /*retransmission*/ false);
 	}
 
 	inline void Transport::OnConsumerRetransmitRtpPacket(RTC::Consumer* consumer, RTC::RtpPacket* packet)
 	{
 		MS_TRACE();
 
-		// Update abs-send-time if present.
-		packet->UpdateAbsSendTime(DepLibUV::GetTimeMs());
-
-		// Update transport wide sequence number if present.
 		// clang-format off
 		if (
-			this->tccClient &&
-			this->tccClient->GetBweType() == RTC::BweType::TRANSPORT_CC &&
-			packet->UpdateTransportWideCc01(this->transportWideCcSeq + 1)
+			this->rtpPacer &&
+			this->rtpPacer->Enqueue(consumer, packet, RTC::RtpPacer::Priority::RETRANSMISSION)
 		)
 		// clang-format on
 		{
-			this->transportWideCcSeq++;
-
-			webrtc::RtpPacketSendInfo packetInfo;
-
-			packetInfo.ssrc                      = packet->GetSsrc();
-			packetInfo.transport_sequence_number = this->transportWideCcSeq;
-			packetInfo.has_rtp_sequence_number   = true;
-			packetInfo.rtp_sequence_number       = packet->GetSequenceNumber();
-			packetInfo.length                    = packet->GetSize();
-			packetInfo.pacing_info               = this->tccClient->GetPacingInfo();
-
-			// Indicate the pacer (and prober) that a packet is to be sent.
-			this->tccClient->InsertPacket(packetInfo);
-
-			const std::weak_ptr<RTC::TransportCongestionControlClient> tccClientWeakPtr(this->tccClient);
-
-#ifdef ENABLE_RTC_SENDER_BANDWIDTH_ESTIMATOR
-			std::weak_ptr<RTC::SenderBandwidthEstimator> senderBweWeakPtr = this->senderBwe;
-			RTC::SenderBandwidthEstimator::SentInfo sentInfo;
-
-			sentInfo.wideSeq     = this->transportWideCcSeq;
-			sentInfo.size        = packet->GetSize();
-			sentInfo.sendingAtMs = DepLibUV::GetTimeMs();
-
-			auto* cb = new onSendCallback(
-			  [tccClientWeakPtr, &packetInfo, senderBweWeakPtr, &sentInfo](bool sent)
-			  {
-				  if (sent)
-				  {
-					  auto tccClient = tccClientWeakPtr.lock();
-
-					  if (tccClient)
-					  {
-						  tccClient->PacketSent(packetInfo, DepLibUV::GetTimeMsInt64());
-					  }
-
-					  auto senderBwe = senderBweWeakPtr.lock();
-
-					  if (senderBwe)
-					  {
-						  sentInfo.sentAtMs = DepLibUV::GetTimeMs();
-						  senderBwe->RtpPacketSent(sentInfo);
-					  }
-				  }
-			  });
-
-			SendRtpPacket(consumer, packet, cb);
-#else
-			const auto* cb = new onSendCallback(
-			  [tccClientWeakPtr, &packetInfo](bool sent)
-			  {
-				  if (sent)
-				  {
-					  auto tccClient = tccClientWeakPtr.lock();
-
-					  if (tccClient)
-					  {
-						  tccClient->PacketSent(packetInfo, DepLibUV::GetTimeMsInt64());
-					  }
-				  }
-			  });
-
-			SendRtpPacket(consumer, packet, cb);
-#endif
-		}
-		else
-		{
-			SendRtpPacket(consumer, packet);
+			return;
 		}
 
-		this->sendRtxTransmission.Update(packet);
+		SendConsumerRtpPacket(consumer, packet, /*retransmission*/ true);
 	}
 
 	inline void Transport::OnConsumerKeyFrameRequested(RTC::Consumer* consumer, uint32_t mappedSsrc)
@@ -2716,6 +2856,10 @@ namespace RTC
 		// Remove it from the maps.
 		this->mapConsumers.erase(consumer->id);
 
+		// Drop its packets queued in the RtpPacer.
+		if (this->rtpPacer)
+			this->rtpPacer->RemoveConsumer(consumer);
+
 		for (auto ssrc : consumer->GetMediaSsrcs())
 		{
 			this->mapSsrcConsumer.erase(ssrc);
@@ -2743,20 +2887,27 @@ namespace RTC
 			ComputeOutgoingDesiredBitrate(/*forceBitrate*/ true);
 	}
 
+	inline void Transport::OnConsumerForwardingChanged(RTC::Consumer* consumer)
+	{
+		MS_TRACE();
+
+		this->listener->OnTransportConsumerForwardingChanged(this, consumer);
+	}
+
 	inline void Transport::OnDataProducerMessageReceived(
-	  RTC::DataProducer* dataProducer, uint32_t ppid, const uint8_t* msg, size_t len)
+	  RTC::DataProducer* dataProducer, uint32_t ppid, RTC::MessageBuffer* message)
 	{
 		MS_TRACE();
 
-		this->listener->OnTransportDataProducerMessageReceived(this, dataProducer, ppid, msg, len);
+		this->listener->OnTransportDataProducerMessageReceived(this, dataProducer, ppid, message);
 	}
 
 	inline void Transport::OnDataConsumerSendMessage(
-	  RTC::DataConsumer* dataConsumer, uint32_t ppid, const uint8_t* msg, size_t len, onQueuedCallback* cb)
+	  RTC::DataConsumer* dataConsumer, uint32_t ppid, RTC::MessageBuffer* message, onQueuedCallback* cb)
 	{
 		MS_TRACE();
 
-		SendMessage(dataConsumer, ppid, msg, len, cb);
+		SendMessage(dataConsumer, ppid, message, cb);
 	}
 
 	inline void Transport::OnDataConsumerDataProducerClosed(RTC::DataConsumer* dataConsumer)
@@ -2880,8 +3031,7 @@ namespace RTC
 	  RTC::SctpAssociation* /*sctpAssociation*/,
 	  uint16_t streamId,
 	  uint32_t ppid,
-	  const uint8_t* msg,
-	  size_t len)
+	  RTC::MessageBuffer* message)
 	{
 		MS_TRACE();
 
@@ -2898,7 +3048,7 @@ namespace RTC
 		// Pass the SCTP message to the corresponding DataProducer.
 		try
 		{
-			dataProducer->ReceiveMessage(ppid, msg, len);
+			dataProducer->ReceiveMessage(ppid, message);
 		}
 		catch (std::exception& error)
 		{
@@ -2928,6 +3078,9 @@ namespace RTC
 
 		MS_DEBUG_DEV("outgoing available bitrate:%" PRIu32, bitrates.availableBitrate);
 
+		if (this->rtpPacer)
+			this->rtpPacer->SetBitrate(bitrates.availableBitrate);
+
 		DistributeAvailableOutgoingBitrate();
 		ComputeOutgoingDesiredBitrate();
 
@@ -2970,57 +3123,7 @@ namespace RTC
 			// Indicate the pacer (and prober) that a packet is to be sent.
 			this->tccClient->InsertPacket(packetInfo);
 
-			const std::weak_ptr<RTC::TransportCongestionControlClient> tccClientWeakPtr(this->tccClient);
-
-#ifdef ENABLE_RTC_SENDER_BANDWIDTH_ESTIMATOR
-			std::weak_ptr<RTC::SenderBandwidthEstimator> senderBweWeakPtr = this->senderBwe;
-			RTC::SenderBandwidthEstimator::SentInfo sentInfo;
-
-			sentInfo.wideSeq     = this->transportWideCcSeq;
-			sentInfo.size        = packet->GetSize();
-			sentInfo.isProbation = true;
-			sentInfo.sendingAtMs = DepLibUV::GetTimeMs();
-
-			auto* cb = new onSendCallback(
-			  [tccClientWeakPtr, &packetInfo, senderBweWeakPtr, &sentInfo](bool sent)
-			  {
-				  if (sent)
-				  {
-					  auto tccClient = tccClientWeakPtr.lock();
-
-					  if (tccClient)
-					  {
-						  tccClient->PacketSent(packetInfo, DepLibUV::GetTimeMsInt64());
-					  }
-
-					  auto senderBwe = senderBweWeakPtr.lock();
-
-					  if (senderBwe)
-					  {
-						  sentInfo.sentAtMs = DepLibUV::GetTimeMs();
-						  senderBwe->RtpPacketSent(sentInfo);
-					  }
-				  }
-			  });
-
-			SendRtpPacket(nullptr, packet, cb);
-#else
-			const auto* cb = new onSendCallback(
-			  [tccClientWeakPtr, &packetInfo](bool sent)
-			  {
-				  if (sent)
-				  {
-					  auto tccClient = tccClientWeakPtr.lock();
-
-					  if (tccClient)
-					  {
-						  tccClient->PacketSent(packetInfo, DepLibUV::GetTimeMsInt64());
-					  }
-				  }
-			  });
-
-			SendRtpPacket(nullptr, packet, cb);
-#endif
+			SendRtpPacket(nullptr, packet, CreateSendCallback(packetInfo, packet, true));
 		}
 		else
 		{
@@ -3050,6 +3153,18 @@ namespace RTC
 		SendRtcpPacket(packet);
 	}
 
+	inline void Transport::OnRtpPacerSendRtpPacket(
+	  RTC::RtpPacer* /*rtpPacer*/,
+	  RTC::Consumer* consumer,
+	  RTC::RtpPacket* packet,
+	  RTC::RtpPacer::Priority priority)
+	{
+		MS_TRACE();
+
+		SendConsumerRtpPacket(
+		  consumer, packet, /*retransmission*/ priority == RTC::RtpPacer::Priority::RETRANSMISSION);
+	}
+
 #ifdef ENABLE_RTC_SENDER_BANDWIDTH_ESTIMATOR
 	inline void Transport::OnSenderBandwidthEstimatorAvailableBitrate(
 	  RTC::SenderBandwidthEstimator* /*senderBwe*/,
@@ -3076,19 +3191,27 @@ namespace RTC
 		// RTCP timer.
 		if (timer == this->rtcpTimer)
 		{
-			auto interval        = static_cast<uint64_t>(RTC::RTCP::MaxVideoIntervalMs);
+			auto interval        = static_cast<uint32_t>(RTC::RTCP::MaxVideoIntervalMs);
 			const uint64_t nowMs = DepLibUV::GetTimeMs();
+			const uint64_t nowNs = DepLibUV::GetTimeNs();
 
 			SendRtcp(nowMs);
 
+			const uint64_t elapsedNs = DepLibUV::GetTimeNs() - nowNs;
+
+			++this->rtcpTicks;
+			this->rtcpTickTimeNs += elapsedNs;
+			this->maxRtcpTickTimeNs = std::max(this->maxRtcpTickTimeNs, elapsedNs);
+
 			/*
 			 * The interval between RTCP packets is varied randomly over the range
 			 * [1.0,1.5] times the calculated interval to avoid unintended synchronization
-			 * of all participants.
+			 * of all participants. With millisecond granularity, as a few discrete
+			 * steps would keep Transports started at once ticking together.
 			 */
-			interval *= static_cast<float>(Utils::Crypto::GetRandomUInt(10, 15)) / 10;
+			interval = Utils::Crypto::GetRandomUInt(interval, interval * 3 / 2);
 
-			this->rtcpTimer->Start(interval);
+			this->rtcpTimer->Start(static_cast<uint64_t>(interval));
 		}
 	}
 } // namespace RTC
@@ -25,6 +25,24 @@ namespace RTC
 		MS_TRACE();
 	}
 
+	UdpSocket::UdpSocket(Listener* listener, std::string& ip, uint16_t port, bool reusePort)
+	  : // This may throw.
+	    ::UdpSocketHandler::UdpSocketHandler(
+	      reusePort ? PortManager::BindUdpReusePort(ip, port) : PortManager::BindUdp(ip, port)),
+	    listener(listener), fixedPort(true)
+	{
+		MS_TRACE();
+	}
+
+	UdpSocket::UdpSocket(
+	  Listener* listener, std::string& ip, uint16_t port, const struct sockaddr* remoteAddr)
+	  : // This may throw.
+	    ::UdpSocketHandler::UdpSocketHandler(PortManager::BindUdpReusePort(ip, port, remoteAddr)),
+	    listener(listener), fixedPort(true)
+	{
+		MS_TRACE();
+	}
+
 	UdpSocket::~UdpSocket()
 	{
 		MS_TRACE();
@@ -5,7 +5,9 @@
 #include "Logger.hpp"
 #include "MediaSoupErrors.hpp"
 #include "Utils.hpp"
-#include <cmath> // std::pow()
+#include <algorithm> // std::any_of()
+#include <cmath>     // std::pow()
+#include <cstdio>    // std::snprintf()
 
 namespace RTC
 {
@@ -105,6 +107,59 @@ namespace RTC
 			}
 
 			listenInfo.port = port;
+
+			auto jsonReusePortIt = jsonListenInfo.find("reusePort");
+
+			if (jsonReusePortIt != jsonListenInfo.end())
+			{
+				if (!jsonReusePortIt->is_boolean())
+					MS_THROW_TYPE_ERROR("wrong listenInfo.reusePort (not a boolean)");
+
+				listenInfo.reusePort = jsonReusePortIt->get<bool>();
+			}
+
+			if (listenInfo.reusePort)
+			{
+				// TCP connections cannot be steered by ICE usernameFragment since the
+				// kernel picks the listener on SYN.
+				if (listenInfo.protocol != RTC::TransportTuple::Protocol::UDP)
+					MS_THROW_TYPE_ERROR("wrong listenInfo.reusePort (only valid for udp)");
+				else if (listenInfo.port == 0)
+					MS_THROW_TYPE_ERROR("wrong listenInfo.reusePort (requires a port)");
+			}
+		}
+
+		// Workers sharing UDP ports encode their index in the reuseport group into
+		// the local ICE usernameFragments, so the group steering program hands
+		// their STUN requests to them.
+		// clang-format off
+		if (std::any_of(
+			listenInfos.begin(),
+			listenInfos.end(),
+			[](const ListenInfo& listenInfo) { return listenInfo.reusePort; }
+		))
+		// clang-format on
+		{
+			auto jsonReusePortIndexIt = data.find("reusePortIndex");
+
+			if (jsonReusePortIndexIt == data.end())
+				MS_THROW_TYPE_ERROR("missing reusePortIndex");
+			// clang-format off
+			else if (
+				!jsonReusePortIndexIt->is_number() ||
+				!Utils::Json::IsPositiveInteger(*jsonReusePortIndexIt) ||
+				jsonReusePortIndexIt->get<uint32_t>() > 255
+			)
+			// clang-format on
+			{
+				MS_THROW_TYPE_ERROR("wrong reusePortIndex (not a number between 0 and 255)");
+			}
+
+			char prefix[3];
+
+			std::snprintf(prefix, sizeof(prefix), "%02x", jsonReusePortIndexIt->get<uint32_t>());
+
+			this->localIceUsernameFragmentPrefix.assign(prefix);
 		}
 
 		try
@@ -116,12 +171,15 @@ namespace RTC
 					// This may throw.
 					RTC::UdpSocket* udpSocket;
 
-					if (listenInfo.port != 0)
+					if (listenInfo.reusePort)
+						udpSocket = new RTC::UdpSocket(this, listenInfo.ip, listenInfo.port, true);
+					else if (listenInfo.port != 0)
 						udpSocket = new RTC::UdpSocket(this, listenInfo.ip, listenInfo.port);
 					else
 						udpSocket = new RTC::UdpSocket(this, listenInfo.ip);
 
-					this->udpSocketOrTcpServers.emplace_back(udpSocket, nullptr, listenInfo.announcedIp);
+					this->udpSocketOrTcpServers.emplace_back(
+					  udpSocket, nullptr, listenInfo.announcedIp, listenInfo.reusePort);
 				}
 				else if (listenInfo.protocol == RTC::TransportTuple::Protocol::TCP)
 				{
@@ -168,6 +226,15 @@ namespace RTC
 
 		this->shared->channelMessageRegistrator->UnregisterHandler(this->id);
 
+		for (auto& kv : this->mapTupleConnectedUdpSocket)
+		{
+			auto* connectedUdpSocket = kv.second;
+
+			delete connectedUdpSocket;
+		}
+		this->mapTupleConnectedUdpSocket.clear();
+		this->mapConnectedUdpSocketUdpSocket.clear();
+
 		for (auto& item : this->udpSocketOrTcpServers)
 		{
 			delete item.udpSocket;
@@ -209,8 +276,9 @@ namespace RTC
 
 				auto& jsonEntry = (*jsonUdpSocketsIt)[udpSocketIdx];
 
-				jsonEntry["ip"]   = item.udpSocket->GetLocalIp();
-				jsonEntry["port"] = item.udpSocket->GetLocalPort();
+				jsonEntry["ip"]        = item.udpSocket->GetLocalIp();
+				jsonEntry["port"]      = item.udpSocket->GetLocalPort();
+				jsonEntry["reusePort"] = item.reusePort;
 
 				++udpSocketIdx;
 			}
@@ -227,6 +295,13 @@ namespace RTC
 			}
 		}
 
+		// Add reusePortIndex and connectedUdpSocketsCount.
+		if (!this->localIceUsernameFragmentPrefix.empty())
+		{
+			jsonObject["reusePortIndex"] = std::stoul(this->localIceUsernameFragmentPrefix, nullptr, 16);
+			jsonObject["connectedUdpSocketsCount"] = this->mapTupleConnectedUdpSocket.size();
+		}
+
 		// Add webRtcTransportIds.
 		jsonObject["webRtcTransportIds"] = json::array();
 		auto jsonWebRtcTransportIdsIt    = jsonObject.find("webRtcTransportIds");
@@ -449,6 +524,61 @@ namespace RTC
 		webRtcTransport->ProcessNonStunPacketFromWebRtcServer(tuple, data, len);
 	}
 
+	void WebRtcServer::ConnectUdpSocket(RTC::TransportTuple* tuple)
+	{
+		MS_TRACE();
+
+		if (this->localIceUsernameFragmentPrefix.empty())
+			return;
+
+		// The reuseport group only steers STUN requests. Once ICE validates a
+		// tuple of a shared port, a socket connected to its remote makes the
+		// kernel deliver the rest of its datagrams (DTLS, RTP, RTCP) to this
+		// worker, since connected sockets win the lookup over the group.
+		for (auto& item : this->udpSocketOrTcpServers)
+		{
+			// The tuple points to the local address of its own socket.
+			if (!item.reusePort || item.udpSocket->GetLocalAddress() != tuple->GetLocalAddress())
+				continue;
+
+			std::string ip = item.udpSocket->GetLocalIp();
+
+			try
+			{
+				// This may throw.
+				auto* connectedUdpSocket =
+				  new RTC::UdpSocket(this, ip, item.udpSocket->GetLocalPort(), tuple->GetRemoteAddress());
+
+				this->mapTupleConnectedUdpSocket[tuple->hash]          = connectedUdpSocket;
+				this->mapConnectedUdpSocketUdpSocket[connectedUdpSocket] = item.udpSocket;
+			}
+			catch (const MediaSoupError& error)
+			{
+				// Datagrams keep arriving through the group, just not always here.
+				MS_WARN_TAG(ice, "failed to connect UDP socket to tuple: %s", error.what());
+			}
+
+			break;
+		}
+	}
+
+	void WebRtcServer::DisconnectUdpSocket(RTC::TransportTuple* tuple)
+	{
+		MS_TRACE();
+
+		auto it = this->mapTupleConnectedUdpSocket.find(tuple->hash);
+
+		if (it == this->mapTupleConnectedUdpSocket.end())
+			return;
+
+		auto* connectedUdpSocket = it->second;
+
+		this->mapConnectedUdpSocketUdpSocket.erase(connectedUdpSocket);
+		this->mapTupleConnectedUdpSocket.erase(it);
+
+		delete connectedUdpSocket;
+	}
+
 	inline void WebRtcServer::OnWebRtcTransportCreated(RTC::WebRtcTransport* webRtcTransport)
 	{
 		MS_TRACE();
@@ -510,6 +640,9 @@ namespace RTC
 		}
 
 		this->mapTupleWebRtcTransport[tuple->hash] = webRtcTransport;
+
+		if (tuple->GetProtocol() == RTC::TransportTuple::Protocol::UDP)
+			ConnectUdpSocket(tuple);
 	}
 
 	inline void WebRtcServer::OnWebRtcTransportTransportTupleRemoved(
@@ -525,6 +658,16 @@ namespace RTC
 		}
 
 		this->mapTupleWebRtcTransport.erase(tuple->hash);
+
+		DisconnectUdpSocket(tuple);
+	}
+
+	inline const std::string& WebRtcServer::OnWebRtcTransportNeedLocalIceUsernameFragmentPrefix(
+	  RTC::WebRtcTransport* /*webRtcTransport*/)
+	{
+		MS_TRACE();
+
+		return this->localIceUsernameFragmentPrefix;
 	}
 
 	inline void WebRtcServer::OnUdpSocketPacketReceived(
@@ -532,6 +675,16 @@ namespace RTC
 	{
 		MS_TRACE();
 
+		// Datagrams received by a connected socket belong to the tuple of the
+		// shared socket, which is also the one used to send.
+		if (!this->mapConnectedUdpSocketUdpSocket.empty())
+		{
+			auto it = this->mapConnectedUdpSocketUdpSocket.find(socket);
+
+			if (it != this->mapConnectedUdpSocketUdpSocket.end())
+				socket = it->second;
+		}
+
 		RTC::TransportTuple tuple(socket, remoteAddr);
 
 		OnPacketReceived(&tuple, data, len);
@@ -265,7 +265,7 @@ namespace RTC
 
 			// Create a ICE server.
 			this->iceServer = new RTC::IceServer(
-			  this, Utils::Crypto::GetRandomString(32), Utils::Crypto::GetRandomString(32));
+			  this, GenerateLocalIceUsernameFragment(), Utils::Crypto::GetRandomString(32));
 
 			// Create a DTLS transport.
 			this->dtlsTransport = new RTC::DtlsTransport(this);
@@ -648,7 +648,7 @@ namespace RTC
 
 			case Channel::ChannelRequest::MethodId::TRANSPORT_RESTART_ICE:
 			{
-				const std::string usernameFragment = Utils::Crypto::GetRandomString(32);
+				const std::string usernameFragment = GenerateLocalIceUsernameFragment();
 				const std::string password         = Utils::Crypto::GetRandomString(32);
 
 				this->iceServer->RestartIce(usernameFragment, password);
@@ -732,6 +732,23 @@ namespace RTC
 		this->iceServer->RemoveTuple(tuple);
 	}
 
+	std::string WebRtcTransport::GenerateLocalIceUsernameFragment()
+	{
+		MS_TRACE();
+
+		if (!this->webRtcTransportListener)
+			return Utils::Crypto::GetRandomString(32);
+
+		// A WebRtcServer sharing its port with other workers needs its own prefix
+		// in the usernameFragment so ICE requests reach this worker.
+		std::string usernameFragment =
+		  this->webRtcTransportListener->OnWebRtcTransportNeedLocalIceUsernameFragmentPrefix(this);
+
+		usernameFragment.append(Utils::Crypto::GetRandomString(32 - usernameFragment.size()));
+
+		return usernameFragment;
+	}
+
 	inline bool WebRtcTransport::IsConnected() const
 	{
 		MS_TRACE();
@@ -831,7 +848,7 @@ namespace RTC
 	}
 
 	void WebRtcTransport::SendRtpPacket(
-	  RTC::Consumer* /*consumer*/, RTC::RtpPacket* packet, RTC::Transport::onSendCallback* cb)
+	  RTC::Consumer* /*consumer*/, RTC::RtpPacket* packet, const RTC::Transport::onSendCallback& cb)
 	{
 		MS_TRACE();
 
@@ -839,8 +856,7 @@ namespace RTC
 		{
 			if (cb)
 			{
-				(*cb)(false);
-				delete cb;
+				cb(false);
 			}
 
 			return;
@@ -853,8 +869,7 @@ namespace RTC
 
 			if (cb)
 			{
-				(*cb)(false);
-				delete cb;
+				cb(false);
 			}
 
 			return;
@@ -867,8 +882,7 @@ namespace RTC
 		{
 			if (cb)
 			{
-				(*cb)(false);
-				delete cb;
+				cb(false);
 			}
 
 			return;
@@ -943,11 +957,12 @@ namespace RTC
 	}
 
 	void WebRtcTransport::SendMessage(
-	  RTC::DataConsumer* dataConsumer, uint32_t ppid, const uint8_t* msg, size_t len, onQueuedCallback* cb)
+	  RTC::DataConsumer* dataConsumer, uint32_t ppid, RTC::MessageBuffer* message, onQueuedCallback* cb)
 	{
 		MS_TRACE();
 
-		this->sctpAssociation->SendSctpMessage(dataConsumer, ppid, msg, len, cb);
+		this->sctpAssociation->SendSctpMessage(
+		  dataConsumer, ppid, message->GetData(), message->GetSize(), cb);
 	}
 
 	void WebRtcTransport::SendSctpData(const uint8_t* data, size_t len)
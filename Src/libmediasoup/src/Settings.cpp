@@ -60,6 +60,7 @@ void Settings::SetConfiguration(int argc, char* argv[])
 		{ "dtlsCertificateFile",  optional_argument, nullptr, 'c' },
 		{ "dtlsPrivateKeyFile",   optional_argument, nullptr, 'p' },
 		{ "libwebrtcFieldTrials", optional_argument, nullptr, 'W' },
+		{ "channelFormat",        optional_argument, nullptr, 'f' },
 		{ nullptr, 0, nullptr, 0 }
 	};
 	// clang-format on
@@ -156,6 +157,14 @@ void Settings::SetConfiguration(int argc, char* argv[])
 				break;
 			}
 
+			case 'f':
+			{
+				stringValue = std::string(optarg);
+				SetChannelFormat(stringValue);
+
+				break;
+			}
+
 			// Invalid option.
 			case '?':
 			{
@@ -255,6 +264,8 @@ void Settings::PrintConfiguration()
 		MS_DEBUG_TAG(
 		  info, "  libwebrtcFieldTrials : %s", Settings::configuration.libwebrtcFieldTrials.c_str());
 	}
+	MS_DEBUG_TAG(
+	  info, "  channelFormat        : %s", Settings::configuration.binaryChannel ? "binary" : "json");
 
 	MS_DEBUG_TAG(info, "</configuration>");
 }
@@ -361,6 +372,18 @@ void Settings::SetLogTags(const std::vector<std::string>& tags)
 	Settings::configuration.logTags = newLogTags;
 }
 
+void Settings::SetChannelFormat(const std::string& format)
+{
+	MS_TRACE();
+
+	if (format == "json")
+		Settings::configuration.binaryChannel = false;
+	else if (format == "binary")
+		Settings::configuration.binaryChannel = true;
+	else
+		MS_THROW_TYPE_ERROR("invalid value '%s' for channelFormat", format.c_str());
+}
+
 void Settings::SetDtlsCertificateAndPrivateKeyFiles()
 {
 	MS_TRACE();
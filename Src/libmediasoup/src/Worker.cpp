@@ -5,11 +5,15 @@
 #include "ChannelMessageRegistrator.hpp"
 #include "DepLibUV.hpp"
 #include "DepUsrSCTP.hpp"
+#include "ForwardingMetrics.hpp"
 #include "Logger.hpp"
 #include "MediaSoupErrors.hpp"
 #include "Settings.hpp"
 #include "Channel/ChannelNotifier.hpp"
 #include "PayloadChannel/PayloadChannelNotifier.hpp"
+#include "RTC/RTCP/ReportPool.hpp"
+#include "RTC/RtpPacketPool.hpp"
+#include "handles/UdpSocketHandler.hpp"
 
 /* Instance methods. */
 
@@ -41,8 +45,15 @@ Worker::Worker(::Channel::ChannelSocket* channel, PayloadChannel::PayloadChannel
 	}
 #endif
 
-	// Create the Checker instance in DepUsrSCTP.
-	DepUsrSCTP::CreateChecker();
+	// Let usrsctp callbacks of other threads reach the SctpAssociations of this
+	// Worker.
+	DepUsrSCTP::CreateInbox();
+
+	// Start flushing the batched UDP sends on every loop iteration.
+	UdpSocketHandler::ClassInit();
+
+	// Start the forwarding metrics period.
+	ForwardingMetrics::ClassInit();
 
 	// Tell the Node process that we are running.
 	this->shared->channelNotifier->Emit(Logger::pid, "running");
@@ -72,6 +83,10 @@ void Worker::Close()
 	// Delete the SignalsHandler.
 	delete this->signalsHandler;
 
+	// Stop publishing stats.
+	delete this->statsPublisher;
+	this->statsPublisher = nullptr;
+
 	// Delete all Routers.
 	for (auto& kv : this->mapRouters)
 	{
@@ -90,11 +105,17 @@ void Worker::Close()
 	}
 	this->mapWebRtcServers.clear();
 
+	// Stop flushing the batched UDP sends.
+	UdpSocketHandler::ClassDestroy();
+
 	// Delete the RTC::Shared singleton.
 	delete this->shared;
 
-	// Close the Checker instance in DepUsrSCTP.
-	DepUsrSCTP::CloseChecker();
+	// Close the Inbox of this Worker in DepUsrSCTP.
+	DepUsrSCTP::CloseInbox();
+
+	// Send the deferred logs while the Channel is open.
+	Logger::ClassDestroy();
 
 	// Close the Channel.
 	this->channel->Close();
@@ -137,6 +158,24 @@ void Worker::FillJson(json& jsonObject) const
 	auto jsonChannelMessageHandlersIt    = jsonObject.find("channelMessageHandlers");
 
 	this->shared->channelMessageRegistrator->FillJson(*jsonChannelMessageHandlersIt);
+
+	// Add rtpPacketPool.
+	jsonObject["rtpPacketPool"] = json::object();
+	auto jsonRtpPacketPoolIt    = jsonObject.find("rtpPacketPool");
+
+	RTC::RtpPacketPool::FillJson(*jsonRtpPacketPoolIt);
+
+	// Add rtcpReportPool.
+	jsonObject["rtcpReportPool"] = json::object();
+	auto jsonRtcpReportPoolIt    = jsonObject.find("rtcpReportPool");
+
+	RTC::RTCP::ReportPool::FillJson(*jsonRtcpReportPoolIt);
+
+	// Add udpSendBatching.
+	jsonObject["udpSendBatching"] = json::object();
+	auto jsonUdpSendBatchingIt    = jsonObject.find("udpSendBatching");
+
+	UdpSocketHandler::FillJsonSendStats(*jsonUdpSendBatchingIt);
 }
 
 void Worker::FillJsonResourceUsage(json& jsonObject) const
@@ -313,6 +352,72 @@ inline void Worker::HandleRequest(Channel::ChannelRequest* request)
 			break;
 		}
 
+		case Channel::ChannelRequest::MethodId::WORKER_GET_METRICS:
+		{
+			json data = json::object();
+
+			ForwardingMetrics::FillJson(data);
+
+			// Add logger.
+			data["logger"] = json::object();
+			Logger::FillJson(data["logger"]);
+
+			// Optionally start a new period.
+			auto jsonResetIt = request->data.find("reset");
+
+			if (jsonResetIt != request->data.end() && jsonResetIt->is_boolean() && jsonResetIt->get<bool>())
+				ForwardingMetrics::Reset();
+
+			request->Accept(data);
+
+			break;
+		}
+
+		case Channel::ChannelRequest::MethodId::WORKER_SUBSCRIBE_STATS:
+		{
+			auto jsonIntervalMsIt = request->data.find("intervalMs");
+
+			if (jsonIntervalMsIt == request->data.end() || !jsonIntervalMsIt->is_number_unsigned())
+				MS_THROW_TYPE_ERROR("missing intervalMs");
+
+			auto intervalMs = jsonIntervalMsIt->get<uint64_t>();
+			auto jsonSubscriptionIdIt = request->data.find("subscriptionId");
+
+			// Zero means unsubscribe.
+			if (intervalMs != 0u)
+			{
+				if (intervalMs < RTC::StatsPublisher::MinIntervalMs)
+				{
+					MS_THROW_TYPE_ERROR(
+					  "intervalMs must be at least %" PRIu64, RTC::StatsPublisher::MinIntervalMs);
+				}
+
+				if (jsonSubscriptionIdIt == request->data.end() || !jsonSubscriptionIdIt->is_string())
+					MS_THROW_TYPE_ERROR("missing subscriptionId");
+			}
+
+			// A new subscription starts with a full snapshot.
+			delete this->statsPublisher;
+			this->statsPublisher = nullptr;
+
+			if (intervalMs == 0u)
+			{
+				request->Accept();
+
+				break;
+			}
+
+			this->statsPublisher = new RTC::StatsPublisher(
+			  this,
+			  this->shared->payloadChannelNotifier,
+			  jsonSubscriptionIdIt->get<std::string>(),
+			  intervalMs);
+
+			request->Accept();
+
+			break;
+		}
+
 		case Channel::ChannelRequest::MethodId::WORKER_UPDATE_SETTINGS:
 		{
 			Settings::HandleRequest(request);
@@ -596,3 +701,15 @@ inline RTC::WebRtcServer* Worker::OnRouterNeedWebRtcServer(
 
 	return webRtcServer;
 }
+
+inline void Worker::OnStatsPublisherCollect(RTC::StatsPublisher* statsPublisher)
+{
+	MS_TRACE();
+
+	for (auto& kv : this->mapRouters)
+	{
+		auto* router = kv.second;
+
+		router->FillBinaryStats(statsPublisher);
+	}
+}
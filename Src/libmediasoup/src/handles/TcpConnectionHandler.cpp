@@ -31,12 +31,12 @@ inline static void onWrite(uv_write_t* req, int status)
 	auto* writeData  = static_cast<TcpConnectionHandler::UvWriteData*>(req->data);
 	auto* handle     = req->handle;
 	auto* connection = static_cast<TcpConnectionHandler*>(handle->data);
-	auto* cb         = writeData->cb;
+	auto cb          = writeData->cb;
 
 	if (connection)
 		connection->OnUvWrite(status, cb);
 
-	// Delete the UvWriteData struct and the cb.
+	// Delete the UvWriteData struct.
 	delete writeData;
 }
 
@@ -179,7 +179,7 @@ void TcpConnectionHandler::Write(
   size_t len1,
   const uint8_t* data2,
   size_t len2,
-  TcpConnectionHandler::onSendCallback* cb)
+  const TcpConnectionHandler::onSendCallback& cb)
 {
 	MS_TRACE();
 
@@ -187,8 +187,7 @@ void TcpConnectionHandler::Write(
 	{
 		if (cb)
 		{
-			(*cb)(false);
-			delete cb;
+			cb(false);
 		}
 
 		return;
@@ -198,8 +197,7 @@ void TcpConnectionHandler::Write(
 	{
 		if (cb)
 		{
-			(*cb)(false);
-			delete cb;
+			cb(false);
 		}
 
 		return;
@@ -225,8 +223,7 @@ void TcpConnectionHandler::Write(
 
 		if (cb)
 		{
-			(*cb)(true);
-			delete cb;
+			cb(true);
 		}
 
 		return;
@@ -283,9 +280,9 @@ void TcpConnectionHandler::Write(
 		MS_WARN_DEV("uv_write() failed: %s", uv_strerror(err));
 
 		if (cb)
-			(*cb)(false);
+			cb(false);
 
-		// Delete the UvWriteData struct (it will delete the store and cb too).
+		// Delete the UvWriteData struct (it will delete the store too).
 		delete writeData;
 	}
 	else
@@ -399,16 +396,14 @@ inline void TcpConnectionHandler::OnUvRead(ssize_t nread, const uv_buf_t* /*buf*
 	}
 }
 
-inline void TcpConnectionHandler::OnUvWrite(int status, TcpConnectionHandler::onSendCallback* cb)
+inline void TcpConnectionHandler::OnUvWrite(int status, const TcpConnectionHandler::onSendCallback& cb)
 {
 	MS_TRACE();
 
-	// NOTE: Do not delete cb here since it will be delete in onWrite() above.
-
 	if (status == 0)
 	{
 		if (cb)
-			(*cb)(true);
+			cb(true);
 	}
 	else
 	{
@@ -418,7 +413,7 @@ inline void TcpConnectionHandler::OnUvWrite(int status, TcpConnectionHandler::on
 		MS_WARN_DEV("write error, closing the connection: %s", uv_strerror(status));
 
 		if (cb)
-			(*cb)(false);
+			cb(false);
 
 		Close();
 
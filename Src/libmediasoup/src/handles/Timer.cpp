@@ -2,40 +2,16 @@
 // #define MS_LOG_DEV_LEVEL 3
 
 #include "handles/Timer.hpp"
-#include "DepLibUV.hpp"
 #include "Logger.hpp"
 #include "MediaSoupErrors.hpp"
 
-/* Static methods for UV callbacks. */
-
-inline static void onTimer(uv_timer_t* handle)
-{
-	static_cast<Timer*>(handle->data)->OnUvTimer();
-}
-
-inline static void onClose(uv_handle_t* handle)
-{
-	delete handle;
-}
-
 /* Instance methods. */
 
 Timer::Timer(Listener* listener) : listener(listener)
 {
 	MS_TRACE();
 
-	this->uvHandle       = new uv_timer_t;
-	this->uvHandle->data = static_cast<void*>(this);
-
-	const int err = uv_timer_init(DepLibUV::GetLoop(), this->uvHandle);
-
-	if (err != 0)
-	{
-		delete this->uvHandle;
-		this->uvHandle = nullptr;
-
-		MS_THROW_ERROR("uv_timer_init() failed: %s", uv_strerror(err));
-	}
+	this->wheel = TimerWheel::Acquire();
 }
 
 Timer::~Timer()
@@ -44,6 +20,8 @@ Timer::~Timer()
 
 	if (!this->closed)
 		Close();
+
+	TimerWheel::Release();
 }
 
 void Timer::Close()
@@ -55,7 +33,8 @@ void Timer::Close()
 
 	this->closed = true;
 
-	uv_close(reinterpret_cast<uv_handle_t*>(this->uvHandle), static_cast<uv_close_cb>(onClose));
+	if (IsActive())
+		this->wheel->Remove(this);
 }
 
 void Timer::Start(uint64_t timeout, uint64_t repeat)
@@ -68,13 +47,10 @@ void Timer::Start(uint64_t timeout, uint64_t repeat)
 	this->timeout = timeout;
 	this->repeat  = repeat;
 
-	if (uv_is_active(reinterpret_cast<uv_handle_t*>(this->uvHandle)) != 0)
+	if (IsActive())
 		Stop();
 
-	const int err = uv_timer_start(this->uvHandle, static_cast<uv_timer_cb>(onTimer), timeout, repeat);
-
-	if (err != 0)
-		MS_THROW_ERROR("uv_timer_start() failed: %s", uv_strerror(err));
+	this->wheel->Add(this, timeout);
 }
 
 void Timer::Stop()
@@ -84,10 +60,8 @@ void Timer::Stop()
 	if (this->closed)
 		MS_THROW_ERROR("closed");
 
-	const int err = uv_timer_stop(this->uvHandle);
-
-	if (err != 0)
-		MS_THROW_ERROR("uv_timer_stop() failed: %s", uv_strerror(err));
+	if (IsActive())
+		this->wheel->Remove(this);
 }
 
 void Timer::Reset()
@@ -97,17 +71,14 @@ void Timer::Reset()
 	if (this->closed)
 		MS_THROW_ERROR("closed");
 
-	if (uv_is_active(reinterpret_cast<uv_handle_t*>(this->uvHandle)) == 0)
+	if (!IsActive())
 		return;
 
 	if (this->repeat == 0u)
 		return;
 
-	const int err =
-	  uv_timer_start(this->uvHandle, static_cast<uv_timer_cb>(onTimer), this->repeat, this->repeat);
-
-	if (err != 0)
-		MS_THROW_ERROR("uv_timer_start() failed: %s", uv_strerror(err));
+	this->wheel->Remove(this);
+	this->wheel->Add(this, this->repeat);
 }
 
 void Timer::Restart()
@@ -117,17 +88,13 @@ void Timer::Restart()
 	if (this->closed)
 		MS_THROW_ERROR("closed");
 
-	if (uv_is_active(reinterpret_cast<uv_handle_t*>(this->uvHandle)) != 0)
+	if (IsActive())
 		Stop();
 
-	const int err =
-	  uv_timer_start(this->uvHandle, static_cast<uv_timer_cb>(onTimer), this->timeout, this->repeat);
-
-	if (err != 0)
-		MS_THROW_ERROR("uv_timer_start() failed: %s", uv_strerror(err));
+	this->wheel->Add(this, this->timeout);
 }
 
-inline void Timer::OnUvTimer()
+void Timer::OnTimer()
 {
 	MS_TRACE();
 
@@ -0,0 +1,331 @@
+#define MS_CLASS "TimerWheel"
+// #define MS_LOG_DEV_LEVEL 3
+
+#include "handles/TimerWheel.hpp"
+#include "DepLibUV.hpp"
+#include "Logger.hpp"
+#include "MediaSoupErrors.hpp"
+#include "handles/Timer.hpp"
+#include <algorithm> // std::max()
+
+/* Static methods for UV callbacks. */
+
+inline static void onTimer(uv_timer_t* handle)
+{
+	static_cast<TimerWheel*>(handle->data)->OnUvTimer();
+}
+
+inline static void onClose(uv_handle_t* handle)
+{
+	delete handle;
+}
+
+/* Static. */
+
+static constexpr uint64_t MaxTimeout{ 0xFFFFFFFF };
+
+/* Class variables. */
+
+thread_local TimerWheel* TimerWheel::wheel{ nullptr };
+thread_local size_t TimerWheel::numTimers{ 0u };
+
+/* Class methods. */
+
+TimerWheel* TimerWheel::Acquire()
+{
+	MS_TRACE();
+
+	if (!TimerWheel::wheel)
+		TimerWheel::wheel = new TimerWheel();
+
+	++TimerWheel::numTimers;
+
+	return TimerWheel::wheel;
+}
+
+void TimerWheel::Release()
+{
+	MS_TRACE();
+
+	MS_ASSERT(TimerWheel::numTimers > 0u, "no Timers");
+
+	// If the last Timer is deleted within its callback, the wheel is deleted
+	// once all the expired Timers have been processed.
+	if (--TimerWheel::numTimers == 0u && !TimerWheel::wheel->processing)
+	{
+		delete TimerWheel::wheel;
+		TimerWheel::wheel = nullptr;
+	}
+}
+
+inline void TimerWheel::Unlink(Timer* timer, Slot* slot)
+{
+	if (timer->prev)
+		timer->prev->next = timer->next;
+	else
+		slot->head = timer->next;
+
+	if (timer->next)
+		timer->next->prev = timer->prev;
+
+	timer->prev = nullptr;
+	timer->next = nullptr;
+	timer->slot = nullptr;
+}
+
+/* Instance methods. */
+
+TimerWheel::TimerWheel()
+{
+	MS_TRACE();
+
+	this->uvHandle       = new uv_timer_t;
+	this->uvHandle->data = static_cast<void*>(this);
+
+	const int err = uv_timer_init(DepLibUV::GetLoop(), this->uvHandle);
+
+	if (err != 0)
+	{
+		delete this->uvHandle;
+		this->uvHandle = nullptr;
+
+		MS_THROW_ERROR("uv_timer_init() failed: %s", uv_strerror(err));
+	}
+
+	this->nextTick = uv_now(DepLibUV::GetLoop());
+}
+
+TimerWheel::~TimerWheel()
+{
+	MS_TRACE();
+
+	uv_close(reinterpret_cast<uv_handle_t*>(this->uvHandle), static_cast<uv_close_cb>(onClose));
+}
+
+void TimerWheel::Add(Timer* timer, uint64_t timeout)
+{
+	MS_TRACE();
+
+	const uint64_t nowMs = uv_now(DepLibUV::GetLoop());
+
+	// Nothing to catch up with.
+	if (this->numActiveTimers == 0u && !this->processing)
+		this->nextTick = nowMs;
+
+	timer->expiresAt = nowMs + timeout;
+
+	Insert(timer);
+
+	++this->numActiveTimers;
+
+	// While processing, the uv_timer_t is armed once done.
+	if (this->processing)
+		return;
+
+	if (this->armedAt == 0u || timer->expiresAt < this->armedAt)
+		Arm(timer->expiresAt);
+}
+
+void TimerWheel::Remove(Timer* timer)
+{
+	MS_TRACE();
+
+	Unlink(timer, timer->slot);
+
+	--this->numActiveTimers;
+
+	// Don't wake up for nothing. Otherwise the uv_timer_t is left armed and
+	// may just fire earlier than needed.
+	if (this->numActiveTimers == 0u && !this->processing && this->armedAt != 0u)
+	{
+		uv_timer_stop(this->uvHandle);
+
+		this->armedAt = 0u;
+	}
+}
+
+void TimerWheel::Insert(Timer* timer)
+{
+	MS_TRACE();
+
+	// Expired Timers fire in the next tick.
+	timer->expiresAt = std::max(timer->expiresAt, this->nextTick);
+
+	uint64_t delta = timer->expiresAt - this->nextTick;
+
+	if (delta > MaxTimeout)
+	{
+		delta            = MaxTimeout;
+		timer->expiresAt = this->nextTick + MaxTimeout;
+	}
+
+	size_t level{ 0u };
+
+	while (level < NumLevels - 1 && delta >= (uint64_t{ 1 } << (SlotBits * (level + 1))))
+	{
+		++level;
+	}
+
+	auto& slot = this->levels[level][(timer->expiresAt >> (SlotBits * level)) & SlotMask];
+
+	timer->slot = &slot;
+	timer->prev = nullptr;
+	timer->next = slot.head;
+
+	if (slot.head)
+		slot.head->prev = timer;
+
+	slot.head = timer;
+}
+
+void TimerWheel::Cascade(size_t level, size_t index)
+{
+	MS_TRACE();
+
+	auto& slot  = this->levels[level][index];
+	auto* timer = slot.head;
+
+	slot.head = nullptr;
+
+	while (timer)
+	{
+		auto* next = timer->next;
+
+		Insert(timer);
+
+		timer = next;
+	}
+}
+
+void TimerWheel::Arm(uint64_t wakeAt)
+{
+	MS_TRACE();
+
+	const uint64_t nowMs   = uv_now(DepLibUV::GetLoop());
+	const uint64_t timeout = wakeAt > nowMs ? wakeAt - nowMs : 0u;
+
+	const int err = uv_timer_start(this->uvHandle, static_cast<uv_timer_cb>(onTimer), timeout, 0u);
+
+	if (err != 0)
+		MS_THROW_ERROR("uv_timer_start() failed: %s", uv_strerror(err));
+
+	this->armedAt = std::max(wakeAt, nowMs);
+}
+
+void TimerWheel::ArmNext()
+{
+	MS_TRACE();
+
+	if (this->numActiveTimers == 0u)
+	{
+		uv_timer_stop(this->uvHandle);
+
+		this->armedAt = 0u;
+
+		return;
+	}
+
+	// Wake up in the next non empty slot of the first level or, if none, at
+	// the end of its rotation so upper levels are cascaded.
+	uint64_t wakeAt = (this->nextTick | SlotMask) + 1;
+
+	// Upper levels are cascaded when the first level rotation begins.
+	if ((this->nextTick & SlotMask) == 0u)
+	{
+		wakeAt = this->nextTick;
+	}
+	else
+	{
+		for (uint64_t tick = this->nextTick; tick < wakeAt; ++tick)
+		{
+			if (this->levels[0][tick & SlotMask].head)
+			{
+				wakeAt = tick;
+
+				break;
+			}
+		}
+	}
+
+	Arm(wakeAt);
+}
+
+inline void TimerWheel::OnUvTimer()
+{
+	MS_TRACE();
+
+	const uint64_t nowMs = uv_now(DepLibUV::GetLoop());
+
+	this->armedAt    = 0u;
+	this->processing = true;
+
+	while (this->nextTick <= nowMs)
+	{
+		const auto index = static_cast<size_t>(this->nextTick & SlotMask);
+
+		// Move the Timers of upper levels down once their range is reached.
+		if (index == 0u)
+		{
+			for (size_t level{ 1u }; level < NumLevels; ++level)
+			{
+				const auto levelIndex =
+				  static_cast<size_t>((this->nextTick >> (SlotBits * level)) & SlotMask);
+
+				Cascade(level, levelIndex);
+
+				if (levelIndex != 0u)
+					break;
+			}
+		}
+
+		// Detach the expired Timers so the ones (re)started by their listeners
+		// don't fire in this same tick.
+		Slot expired;
+
+		expired.head                = this->levels[0][index].head;
+		this->levels[0][index].head = nullptr;
+
+		for (auto* timer = expired.head; timer; timer = timer->next)
+		{
+			timer->slot = &expired;
+		}
+
+		++this->nextTick;
+
+		// Listeners may stop or delete any Timer, so always take the first one.
+		while (expired.head)
+		{
+			auto* timer = expired.head;
+
+			Unlink(timer, &expired);
+
+			--this->numActiveTimers;
+
+			// As libuv does, restart repeating Timers before notifying them.
+			if (timer->repeat != 0u)
+			{
+				timer->expiresAt = nowMs + timer->repeat;
+
+				Insert(timer);
+
+				++this->numActiveTimers;
+			}
+
+			timer->OnTimer();
+		}
+	}
+
+	this->processing = false;
+
+	// All the Timers have been deleted.
+	if (TimerWheel::numTimers == 0u)
+	{
+		TimerWheel::wheel = nullptr;
+
+		delete this;
+
+		return;
+	}
+
+	ArmNext();
+}
@@ -2,15 +2,65 @@
 // #define MS_LOG_DEV_LEVEL 3
 
 #include "handles/UdpSocketHandler.hpp"
+#include "DepLibUV.hpp"
+#include "ForwardingMetrics.hpp"
 #include "Logger.hpp"
 #include "MediaSoupErrors.hpp"
 #include "Utils.hpp"
-#include <cstring> // std::memcpy()
+#include <algorithm> // std::find(), std::min()
+#include <cstring>   // std::memcpy(), std::memcmp()
+#ifdef __linux__
+#include <netinet/udp.h> // SOL_UDP
+#include <sys/socket.h>  // sendmmsg(), sendmsg()
+#endif
+
+#if defined(__linux__) && !defined(UDP_SEGMENT)
+#define UDP_SEGMENT 103
+#endif
 
 /* Static. */
 
 static constexpr size_t ReadBufferSize{ 65536 };
 thread_local static uint8_t ReadBuffer[ReadBufferSize];
+// Max datagrams libuv reads with a single recvmmsg() (UV__MMSG_MAXWIDTH). Each
+// one gets a ReadBufferSize chunk of the buffer given to libuv.
+static constexpr size_t RecvMmsgMaxDatagrams{ 20u };
+static constexpr size_t RecvMmsgBufferSize{ RecvMmsgMaxDatagrams * ReadBufferSize };
+thread_local static uint8_t* RecvMmsgBuffer{ nullptr };
+// Max number of datagrams queued in a socket before it is flushed. It is
+// also the max number of segments of a GSO send.
+static constexpr size_t MaxBatchDatagrams{ 64u };
+// Bigger datagrams are sent right away.
+static constexpr size_t MaxBatchDatagramSize{ 4096u };
+// Max total size of a GSO send.
+static constexpr size_t MaxGsoSize{ 65000u };
+// Storage for the datagrams queued by every socket in this thread.
+static constexpr size_t BatchBufferSize{ 262144u };
+thread_local static uint8_t BatchBuffer[BatchBufferSize];
+thread_local static size_t BatchBufferUsed{ 0u };
+// Buffers referenced by queued datagrams until the next FlushAll().
+struct BorrowedBuffer
+{
+	const uint8_t* data{ nullptr };
+	size_t len{ 0u };
+};
+
+thread_local static std::vector<BorrowedBuffer> BorrowedBuffers;
+// Sockets with queued datagrams.
+thread_local static std::vector<UdpSocketHandler*> PendingFlushSockets;
+// Send callbacks of flushed datagrams, invoked once no flush is in progress.
+thread_local static std::vector<std::pair<SendCallback, bool>> PendingCallbacks;
+thread_local static uv_prepare_t* UvPrepareHandle{ nullptr };
+
+struct BatchSendStats
+{
+	uint64_t datagrams{ 0u };
+	uint64_t syscalls{ 0u };
+	uint64_t gsoSends{ 0u };
+	uint64_t borrowedBytes{ 0u };
+};
+
+thread_local static BatchSendStats SendStats;
 
 /* Static methods for UV callbacks. */
 
@@ -36,12 +86,12 @@ inline static void onSend(uv_udp_send_t* req, int status)
 	auto* sendData = static_cast<UdpSocketHandler::UvSendData*>(req->data);
 	auto* handle   = req->handle;
 	auto* socket   = static_cast<UdpSocketHandler*>(handle->data);
-	auto* cb       = sendData->cb;
+	auto cb        = sendData->cb;
 
 	if (socket)
 		socket->OnUvSend(status, cb);
 
-	// Delete the UvSendData struct (it will delete the store and cb too).
+	// Delete the UvSendData struct (it will delete the store too).
 	delete sendData;
 }
 
@@ -50,6 +100,153 @@ inline static void onClose(uv_handle_t* handle)
 	delete handle;
 }
 
+inline static void onPrepare(uv_prepare_t* /*handle*/)
+{
+	// Send everything queued during this loop iteration before polling.
+	UdpSocketHandler::FlushAll();
+}
+
+inline static socklen_t getAddressLen(const struct sockaddr* addr)
+{
+	return addr->sa_family == AF_INET6 ? sizeof(struct sockaddr_in6) : sizeof(struct sockaddr_in);
+}
+
+// Returns the number of bytes at the end of the datagram that lie within a
+// borrowed buffer.
+inline static size_t getBorrowedLen(const uint8_t* data, size_t len)
+{
+	for (const auto& buffer : BorrowedBuffers)
+	{
+		const uint8_t* end = data + len;
+
+		if (end > buffer.data && end <= buffer.data + buffer.len)
+			return static_cast<size_t>(end - std::max(data, buffer.data));
+	}
+
+	return 0u;
+}
+
+inline static void invokePendingCallbacks()
+{
+	thread_local static bool invoking{ false };
+
+	// Callbacks may send (so queue) more datagrams. The outer call handles
+	// callbacks added meanwhile.
+	if (invoking)
+		return;
+
+	invoking = true;
+
+	for (size_t idx{ 0u }; idx < PendingCallbacks.size(); ++idx)
+	{
+		auto cbAndSent = PendingCallbacks[idx];
+
+		cbAndSent.first(cbAndSent.second);
+	}
+
+	PendingCallbacks.clear();
+
+	invoking = false;
+}
+
+/* Class methods. */
+
+void UdpSocketHandler::ClassInit()
+{
+	MS_TRACE();
+
+#ifdef __linux__
+	int err;
+
+	UvPrepareHandle = new uv_prepare_t;
+
+	err = uv_prepare_init(DepLibUV::GetLoop(), UvPrepareHandle);
+
+	if (err != 0)
+	{
+		delete UvPrepareHandle;
+		UvPrepareHandle = nullptr;
+
+		MS_THROW_ERROR("uv_prepare_init() failed: %s", uv_strerror(err));
+	}
+
+	err = uv_prepare_start(UvPrepareHandle, static_cast<uv_prepare_cb>(onPrepare));
+
+	if (err != 0)
+	{
+		uv_close(reinterpret_cast<uv_handle_t*>(UvPrepareHandle), static_cast<uv_close_cb>(onClose));
+		UvPrepareHandle = nullptr;
+
+		MS_THROW_ERROR("uv_prepare_start() failed: %s", uv_strerror(err));
+	}
+
+	// The flush handle must not keep the loop alive by itself.
+	uv_unref(reinterpret_cast<uv_handle_t*>(UvPrepareHandle));
+
+	// Allocated once per worker rather than as a thread_local array, which
+	// would reserve it in every thread of the process.
+	RecvMmsgBuffer = new uint8_t[RecvMmsgBufferSize];
+#endif
+}
+
+void UdpSocketHandler::ClassDestroy()
+{
+	MS_TRACE();
+
+	UdpSocketHandler::FlushAll();
+
+	if (UvPrepareHandle)
+	{
+		uv_close(reinterpret_cast<uv_handle_t*>(UvPrepareHandle), static_cast<uv_close_cb>(onClose));
+		UvPrepareHandle = nullptr;
+	}
+
+	delete[] RecvMmsgBuffer;
+	RecvMmsgBuffer = nullptr;
+}
+
+void UdpSocketHandler::FlushAll()
+{
+	MS_TRACE();
+
+	while (!PendingFlushSockets.empty())
+	{
+		auto* socket = PendingFlushSockets.back();
+
+		PendingFlushSockets.pop_back();
+		socket->pendingFlush = false;
+		socket->FlushPending();
+	}
+
+	// Nothing queued points into the batch buffer or borrowed ones anymore.
+	BatchBufferUsed = 0u;
+	BorrowedBuffers.clear();
+
+	invokePendingCallbacks();
+}
+
+void UdpSocketHandler::BorrowBuffer(const uint8_t* data, size_t len)
+{
+	MS_TRACE();
+
+	// Only relevant if datagrams are queued.
+	if (!UvPrepareHandle || !data || len == 0u)
+		return;
+
+	BorrowedBuffers.push_back({ data, len });
+}
+
+void UdpSocketHandler::FillJsonSendStats(json& jsonObject)
+{
+	MS_TRACE();
+
+	jsonObject["batchedDatagrams"] = SendStats.datagrams;
+	jsonObject["batchSyscalls"]    = SendStats.syscalls;
+	jsonObject["syscallsSaved"]    = SendStats.datagrams - SendStats.syscalls;
+	jsonObject["gsoSends"]         = SendStats.gsoSends;
+	jsonObject["borrowedBytes"]    = SendStats.borrowedBytes;
+}
+
 /* Instance methods. */
 
 // NOLINTNEXTLINE(cppcoreguidelines-pro-type-member-init)
@@ -97,6 +294,19 @@ void UdpSocketHandler::Close()
 
 	this->closed = true;
 
+	// Send what is queued while the UV handle is still open. Datagrams sent
+	// from the callbacks fail since the socket is already closed.
+	FlushPending();
+
+	if (this->pendingFlush)
+	{
+		PendingFlushSockets.erase(
+		  std::find(PendingFlushSockets.begin(), PendingFlushSockets.end(), this));
+		this->pendingFlush = false;
+	}
+
+	invokePendingCallbacks();
+
 	// Tell the UV handle that the UdpSocketHandler has been closed.
 	this->uvHandle->data = nullptr;
 
@@ -119,7 +329,10 @@ void UdpSocketHandler::Dump() const
 }
 
 void UdpSocketHandler::Send(
-  const uint8_t* data, size_t len, const struct sockaddr* addr, UdpSocketHandler::onSendCallback* cb)
+  const uint8_t* data,
+  size_t len,
+  const struct sockaddr* addr,
+  const UdpSocketHandler::onSendCallback& cb)
 {
 	MS_TRACE();
 
@@ -127,8 +340,7 @@ void UdpSocketHandler::Send(
 	{
 		if (cb)
 		{
-			(*cb)(false);
-			delete cb;
+			cb(false);
 		}
 
 		return;
@@ -138,18 +350,329 @@ void UdpSocketHandler::Send(
 	{
 		if (cb)
 		{
-			(*cb)(false);
-			delete cb;
+			cb(false);
 		}
 
 		return;
 	}
 
+	// Queue the datagram. It is sent with the rest of the batch once the
+	// fan-out ends or, at the latest, before the loop polls again.
+	if (UvPrepareHandle && len <= MaxBatchDatagramSize)
+	{
+		// Just the head of the datagram out of borrowed buffers is copied.
+		size_t borrowedLen = getBorrowedLen(data, len);
+		size_t copyLen     = len - borrowedLen;
+
+		if (BatchBufferUsed + copyLen > BatchBufferSize)
+		{
+			// This also returns the borrowed buffers.
+			UdpSocketHandler::FlushAll();
+
+			borrowedLen = 0u;
+			copyLen     = len;
+		}
+
+		uint8_t* store = BatchBuffer + BatchBufferUsed;
+
+		std::memcpy(store, data, copyLen);
+		BatchBufferUsed += copyLen;
+
+		this->pendingDatagrams.emplace_back();
+
+		auto& datagram = this->pendingDatagrams.back();
+
+		datagram.data         = store;
+		datagram.len          = copyLen;
+		datagram.borrowedData = data + copyLen;
+		datagram.borrowedLen  = borrowedLen;
+		datagram.cb           = cb;
+		std::memcpy(std::addressof(datagram.addr), addr, getAddressLen(addr));
+
+		if (!this->pendingFlush)
+		{
+			this->pendingFlush = true;
+			PendingFlushSockets.push_back(this);
+		}
+
+		if (this->pendingDatagrams.size() >= MaxBatchDatagrams)
+			Flush();
+
+		return;
+	}
+
+	// Keep the order with queued datagrams.
+	Flush();
+
+	int result;
+
+	{
+		ForwardingMetrics::ScopedStage scopedStage(ForwardingMetrics::Stage::UDP_SEND);
+
+		result = SendDatagram(data, len, nullptr, 0u, addr, cb);
+	}
+
+	if (result != SendResult::PENDING && cb)
+	{
+		cb(result == SendResult::SENT);
+	}
+}
+
+void UdpSocketHandler::Flush()
+{
+	MS_TRACE();
+
+	FlushPending();
+	invokePendingCallbacks();
+}
+
+void UdpSocketHandler::FlushPending()
+{
+	MS_TRACE();
+
+	if (this->pendingDatagrams.empty())
+		return;
+
+	ForwardingMetrics::ScopedStage scopedStage(ForwardingMetrics::Stage::UDP_SEND);
+
+	const size_t count = this->pendingDatagrams.size();
+	const size_t sent  = SendBatch(this->pendingDatagrams);
+
+	// Whatever the batch could not send goes through the regular path.
+	for (size_t idx{ sent }; idx < count; ++idx)
+	{
+		auto& datagram = this->pendingDatagrams[idx];
+
+		const int result = SendDatagram(
+		  datagram.data,
+		  datagram.len,
+		  datagram.borrowedData,
+		  datagram.borrowedLen,
+		  reinterpret_cast<const struct sockaddr*>(std::addressof(datagram.addr)),
+		  datagram.cb);
+
+		if (result != SendResult::PENDING && datagram.cb)
+			PendingCallbacks.emplace_back(datagram.cb, result == SendResult::SENT);
+	}
+
+	this->pendingDatagrams.clear();
+}
+
+size_t UdpSocketHandler::SendBatch(std::vector<PendingDatagram>& datagrams)
+{
+	MS_TRACE();
+
+#ifdef __linux__
+	uv_os_fd_t fd;
+
+	if (uv_fileno(reinterpret_cast<uv_handle_t*>(this->uvHandle), &fd) != 0)
+		return 0u;
+
+	const size_t count = datagrams.size();
+	const auto* firstAddr = reinterpret_cast<const struct sockaddr*>(std::addressof(datagrams[0].addr));
+	const socklen_t firstAddrLen = getAddressLen(firstAddr);
+
+	auto onDatagramSent = [this](PendingDatagram& datagram, size_t sentLen)
+	{
+		this->sentBytes += sentLen;
+		++SendStats.datagrams;
+		SendStats.borrowedBytes += datagram.borrowedLen;
+
+		if (datagram.cb)
+			PendingCallbacks.emplace_back(datagram.cb, sentLen == datagram.GetSize());
+	};
+
+	// A single GSO send works if every datagram goes to the same destination
+	// and all but the last one have the same size.
+	bool useGso = !this->gsoDisabled && count > 1 && count <= MaxBatchDatagrams;
+	size_t totalLen{ 0u };
+
+	for (size_t idx{ 0u }; useGso && idx < count; ++idx)
+	{
+		auto& datagram = datagrams[idx];
+
+		totalLen += datagram.GetSize();
+
+		// clang-format off
+		if (
+			(idx < count - 1 && datagram.GetSize() != datagrams[0].GetSize()) ||
+			datagram.GetSize() > datagrams[0].GetSize() ||
+			totalLen > MaxGsoSize ||
+			std::memcmp(std::addressof(datagram.addr), firstAddr, firstAddrLen) != 0
+		)
+		// clang-format on
+		{
+			useGso = false;
+		}
+	}
+
+	// Up to two iovecs per datagram, the copied head and the borrowed rest.
+	struct iovec iovs[MaxBatchDatagrams * 2];
+
+	auto fillIovs = [](const PendingDatagram& datagram, struct iovec* iov)
+	{
+		size_t iovLen{ 0u };
+
+		if (datagram.len != 0u)
+		{
+			iov[iovLen].iov_base = const_cast<uint8_t*>(datagram.data);
+			iov[iovLen].iov_len  = datagram.len;
+			++iovLen;
+		}
+
+		if (datagram.borrowedLen != 0u)
+		{
+			iov[iovLen].iov_base = const_cast<uint8_t*>(datagram.borrowedData);
+			iov[iovLen].iov_len  = datagram.borrowedLen;
+			++iovLen;
+		}
+
+		return iovLen;
+	};
+
+	if (useGso)
+	{
+		struct msghdr msg; // NOLINT(cppcoreguidelines-pro-type-member-init)
+		char control[CMSG_SPACE(sizeof(uint16_t))];
+		const auto segmentSize = static_cast<uint16_t>(datagrams[0].GetSize());
+		size_t iovLen{ 0u };
+
+		std::memset(std::addressof(msg), 0, sizeof(msg));
+		std::memset(control, 0, sizeof(control));
+
+		// The kernel splits the concatenation of all the iovecs into segments.
+		for (size_t idx{ 0u }; idx < count; ++idx)
+		{
+			iovLen += fillIovs(datagrams[idx], iovs + iovLen);
+		}
+
+		msg.msg_name       = const_cast<struct sockaddr*>(firstAddr);
+		msg.msg_namelen    = firstAddrLen;
+		msg.msg_iov        = iovs;
+		msg.msg_iovlen     = iovLen;
+		msg.msg_control    = control;
+		msg.msg_controllen = sizeof(control);
+
+		struct cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+
+		cmsg->cmsg_level = SOL_UDP;
+		cmsg->cmsg_type  = UDP_SEGMENT;
+		cmsg->cmsg_len   = CMSG_LEN(sizeof(uint16_t));
+		std::memcpy(CMSG_DATA(cmsg), &segmentSize, sizeof(uint16_t));
+
+		const ssize_t ret = sendmsg(fd, &msg, 0);
+
+		++SendStats.syscalls;
+
+		if (ret >= 0)
+		{
+			++SendStats.gsoSends;
+
+			for (size_t idx{ 0u }; idx < count; ++idx)
+			{
+				onDatagramSent(datagrams[idx], datagrams[idx].GetSize());
+			}
+
+			return count;
+		}
+		else if (errno == EAGAIN || errno == EWOULDBLOCK)
+		{
+			return 0u;
+		}
+
+		// Kernel or NIC without UDP GSO support. Stick to sendmmsg().
+		// clang-format off
+		if (
+			errno == EIO ||
+			errno == EINVAL ||
+			errno == ENOPROTOOPT ||
+			errno == EOPNOTSUPP
+		)
+		// clang-format on
+		{
+			MS_DEBUG_DEV("UDP GSO send failed, disabling it: %s", std::strerror(errno));
+
+			this->gsoDisabled = true;
+		}
+		// Otherwise the error may come from the destination (unreachable,
+		// refused, filtered...), which says nothing about GSO support. Just send
+		// this batch with sendmmsg().
+		else
+		{
+			MS_DEBUG_DEV("UDP GSO send failed: %s", std::strerror(errno));
+		}
+	}
+
+	struct mmsghdr msgs[MaxBatchDatagrams];
+	size_t sent{ 0u };
+
+	while (sent < count)
+	{
+		const size_t batchLen = std::min(count - sent, MaxBatchDatagrams);
+
+		size_t iovLen{ 0u };
+
+		std::memset(msgs, 0, sizeof(struct mmsghdr) * batchLen);
+
+		for (size_t idx{ 0u }; idx < batchLen; ++idx)
+		{
+			auto& datagram = datagrams[sent + idx];
+
+			msgs[idx].msg_hdr.msg_name = std::addressof(datagram.addr);
+			msgs[idx].msg_hdr.msg_namelen =
+			  getAddressLen(reinterpret_cast<const struct sockaddr*>(std::addressof(datagram.addr)));
+			msgs[idx].msg_hdr.msg_iov    = iovs + iovLen;
+			msgs[idx].msg_hdr.msg_iovlen = fillIovs(datagram, iovs + iovLen);
+
+			iovLen += msgs[idx].msg_hdr.msg_iovlen;
+		}
+
+		const int ret = sendmmsg(fd, msgs, batchLen, 0);
+
+		++SendStats.syscalls;
+
+		if (ret <= 0)
+			break;
+
+		for (size_t idx{ 0u }; idx < static_cast<size_t>(ret); ++idx)
+		{
+			onDatagramSent(datagrams[sent + idx], msgs[idx].msg_len);
+		}
+
+		sent += ret;
+
+		if (static_cast<size_t>(ret) < batchLen)
+			break;
+	}
+
+	return sent;
+#else
+	return 0u;
+#endif
+}
+
+int UdpSocketHandler::SendDatagram(
+  const uint8_t* data,
+  size_t len,
+  const uint8_t* borrowedData,
+  size_t borrowedLen,
+  const struct sockaddr* addr,
+  const UdpSocketHandler::onSendCallback& cb)
+{
+	MS_TRACE();
+
 	// First try uv_udp_try_send(). In case it can not directly send the datagram
 	// then build a uv_req_t and use uv_udp_send().
 
-	uv_buf_t buffer = uv_buf_init(reinterpret_cast<char*>(const_cast<uint8_t*>(data)), len);
-	const int sent  = uv_udp_try_send(this->uvHandle, &buffer, 1, addr);
+	uv_buf_t buffers[2];
+	const unsigned int numBuffers = borrowedLen != 0u ? 2u : 1u;
+
+	buffers[0] = uv_buf_init(reinterpret_cast<char*>(const_cast<uint8_t*>(data)), len);
+	buffers[1] = uv_buf_init(reinterpret_cast<char*>(const_cast<uint8_t*>(borrowedData)), borrowedLen);
+
+	const int sent = uv_udp_try_send(this->uvHandle, buffers, numBuffers, addr);
+
+	len += borrowedLen;
 
 	// Entire datagram was sent. Done.
 	if (sent == static_cast<int>(len))
@@ -157,13 +680,7 @@ void UdpSocketHandler::Send(
 		// Update sent bytes.
 		this->sentBytes += sent;
 
-		if (cb)
-		{
-			(*cb)(true);
-			delete cb;
-		}
-
-		return;
+		return SendResult::SENT;
 	}
 	else if (sent >= 0)
 	{
@@ -172,13 +689,7 @@ void UdpSocketHandler::Send(
 		// Update sent bytes.
 		this->sentBytes += sent;
 
-		if (cb)
-		{
-			(*cb)(false);
-			delete cb;
-		}
-
-		return;
+		return SendResult::FAILED;
 	}
 	// Any error but legit EAGAIN. Use uv_udp_send().
 	else if (sent != UV_EAGAIN)
@@ -189,10 +700,12 @@ void UdpSocketHandler::Send(
 	auto* sendData = new UvSendData(len);
 
 	sendData->req.data = static_cast<void*>(sendData);
-	std::memcpy(sendData->store, data, len);
-	sendData->cb = cb;
+	std::memcpy(sendData->store, data, len - borrowedLen);
+
+	if (borrowedLen != 0u)
+		std::memcpy(sendData->store + len - borrowedLen, borrowedData, borrowedLen);
 
-	buffer = uv_buf_init(reinterpret_cast<char*>(sendData->store), len);
+	uv_buf_t buffer = uv_buf_init(reinterpret_cast<char*>(sendData->store), len);
 
 	int err = uv_udp_send(
 	  &sendData->req, this->uvHandle, &buffer, 1, addr, static_cast<uv_udp_send_cb>(onSend));
@@ -203,17 +716,19 @@ void UdpSocketHandler::Send(
 		// (IPv6 destination on a IPv4 binded socket), so be ready.
 		MS_WARN_DEV("uv_udp_send() failed: %s", uv_strerror(err));
 
-		if (cb)
-			(*cb)(false);
-
-		// Delete the UvSendData struct (it will delete the store and cb too).
+		// Delete the UvSendData struct (it will delete the store).
 		delete sendData;
+
+		return SendResult::FAILED;
 	}
-	else
-	{
-		// Update sent bytes.
-		this->sentBytes += len;
-	}
+
+	// The callback is now owned by the send request.
+	sendData->cb = cb;
+
+	// Update sent bytes.
+	this->sentBytes += len;
+
+	return SendResult::PENDING;
 }
 
 bool UdpSocketHandler::SetLocalAddress()
@@ -245,6 +760,20 @@ inline void UdpSocketHandler::OnUvRecvAlloc(size_t /*suggestedSize*/, uv_buf_t*
 {
 	MS_TRACE();
 
+#if UV_VERSION_HEX >= 0x012800
+	// Sockets created with UV_UDP_RECVMMSG read a batch of datagrams per
+	// syscall as long as the buffer has room for more than one of them. Each
+	// one is then notified separately (UV_UDP_MMSG_CHUNK) and a last callback
+	// with UV_UDP_MMSG_FREE and no data ends the batch.
+	if (RecvMmsgBuffer && uv_udp_using_recvmmsg(this->uvHandle))
+	{
+		buf->base = reinterpret_cast<char*>(RecvMmsgBuffer);
+		buf->len  = RecvMmsgBufferSize;
+
+		return;
+	}
+#endif
+
 	// Tell UV to write into the static buffer.
 	buf->base = reinterpret_cast<char*>(ReadBuffer);
 	// Give UV all the buffer space.
@@ -274,8 +803,12 @@ inline void UdpSocketHandler::OnUvRecv(
 		// Update received bytes.
 		this->recvBytes += nread;
 
+		ForwardingMetrics::SetPacketReceived();
+
 		// Notify the subclass.
 		UserOnUdpDatagramReceived(reinterpret_cast<uint8_t*>(buf->base), nread, addr);
+
+		ForwardingMetrics::ClearPacketReceived();
 	}
 	// Some error.
 	else
@@ -284,16 +817,14 @@ inline void UdpSocketHandler::OnUvRecv(
 	}
 }
 
-inline void UdpSocketHandler::OnUvSend(int status, UdpSocketHandler::onSendCallback* cb)
+inline void UdpSocketHandler::OnUvSend(int status, const UdpSocketHandler::onSendCallback& cb)
 {
 	MS_TRACE();
 
-	// NOTE: Do not delete cb here since it will be delete in onSend() above.
-
 	if (status == 0)
 	{
 		if (cb)
-			(*cb)(true);
+			cb(true);
 	}
 	else
 	{
@@ -302,6 +833,6 @@ inline void UdpSocketHandler::OnUvSend(int status, UdpSocketHandler::onSendCallb
 #endif
 
 		if (cb)
-			(*cb)(false);
+			cb(false);
 	}
 }
@@ -15,6 +15,7 @@
 #include "Channel/ChannelSocket.hpp"
 #include "PayloadChannel/PayloadChannelSocket.hpp"
 #include "RTC/DtlsTransport.hpp"
+#include "RTC/MessageBuffer.hpp"
 #include "RTC/SrtpSession.hpp"
 #include <uv.h>
 #include <absl/container/flat_hash_map.h>
@@ -113,6 +114,7 @@ extern "C" int mediasoup_worker_run(
 	{
 		MS_ERROR_STD("settings error: %s", error.what());
 
+		Logger::ClassDestroy();
 		channel->Close();
 		payloadChannel->Close();
 		DepLibUV::RunLoop();
@@ -125,6 +127,7 @@ extern "C" int mediasoup_worker_run(
 	{
 		MS_ERROR_STD("unexpected settings error: %s", error.what());
 
+		Logger::ClassDestroy();
 		channel->Close();
 		payloadChannel->Close();
 		DepLibUV::RunLoop();
@@ -154,6 +157,9 @@ extern "C" int mediasoup_worker_run(
 	Settings::PrintConfiguration();
 	DepLibUV::PrintVersion();
 
+	// Requests are read once the loop runs, so this applies to every message.
+	channel->SetBinary(Settings::configuration.binaryChannel);
+
 	try
 	{
 		// Initialize static stuff.
@@ -193,10 +199,22 @@ extern "C" int mediasoup_worker_run(
 	{
 		MS_ERROR_STD("failure exit: %s", error.what());
 
+		Logger::ClassDestroy();
+
 		return 1;
 	}
 }
 
+extern "C" void mediasoup_payload_ref(PayloadChannelPayloadRef payloadRef)
+{
+	static_cast<RTC::MessageBuffer*>(payloadRef)->Ref();
+}
+
+extern "C" void mediasoup_payload_unref(PayloadChannelPayloadRef payloadRef)
+{
+	static_cast<RTC::MessageBuffer*>(payloadRef)->Unref();
+}
+
 void IgnoreSignals()
 {
 #ifndef _WIN32
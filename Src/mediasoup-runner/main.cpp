@@ -92,6 +92,7 @@ public:
 		uint32_t messageLen,
 		const uint8_t* payload,
 		uint32_t payloadLen,
+		PayloadChannelPayloadRef payloadRef,
 		ChannelWriteCtx ctx)
 	{
 		std::string strMsg((const char*)message, messageLen);
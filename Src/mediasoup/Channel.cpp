@@ -5,10 +5,29 @@
 #include "Logger.h"
 #include "utils.h"
 #include "errors.h"
-
+#include "Channel/ChannelMethods.hpp"
+#include <cstring> // std::memcpy()
 
 namespace mediasoup {
 
+// Binary message kinds sent by the worker. They are below any printable
+// character so they never collide with log lines.
+enum class MessageKind : uint8_t
+{
+	RESPONSE_ACCEPTED = 1,
+	RESPONSE_ERROR,
+	RESPONSE_TYPE_ERROR,
+	NOTIFICATION
+};
+
+// Numeric method ids of the binary format, from the list shared with the
+// worker.
+static const std::unordered_map<std::string, uint16_t> method2Id =
+{
+#define MS_CHANNEL_METHOD_ENTRY(name, method, id) { method, id },
+	MS_CHANNEL_METHODS(MS_CHANNEL_METHOD_ENTRY)
+#undef MS_CHANNEL_METHOD_ENTRY
+};
 
 Channel::Channel(int pid)
 	: _pid(pid)
@@ -34,6 +53,45 @@ void Channel::close()
 	this->subClose();
 }
 
+void Channel::setBinaryFormat(bool binary)
+{
+	this->_binary = binary;
+}
+
+void Channel::_serializeRequest(std::string& request, uint32_t id, const std::string& method, const std::string& handlerId, const json& data)
+{
+	request.clear();
+
+	if (!this->_binary)
+	{
+		request.append(std::to_string(id));
+		request.push_back(':');
+		request.append(method);
+		request.push_back(':');
+		request.append(handlerId);
+		request.push_back(':');
+		request.append(data.is_null() ? "undefined" : data.dump());
+
+		return;
+	}
+
+	auto it = method2Id.find(method);
+
+	if (it == method2Id.end())
+		MSC_THROW_TYPE_ERROR("unknown method '%s'", method.c_str());
+
+	uint16_t methodId = it->second;
+	uint16_t handlerIdLen = handlerId == "undefined" ? 0 : static_cast<uint16_t>(handlerId.length());
+
+	request.append(reinterpret_cast<const char*>(&id), sizeof(id));
+	request.append(reinterpret_cast<const char*>(&methodId), sizeof(methodId));
+	request.append(reinterpret_cast<const char*>(&handlerIdLen), sizeof(handlerIdLen));
+	request.append(handlerId, 0, handlerIdLen);
+
+	if (!data.is_null())
+		json::to_msgpack(data, request);
+}
+
 void Channel::_receivePayload(const std::string& nsPayload)
 {
 	try
@@ -41,6 +99,14 @@ void Channel::_receivePayload(const std::string& nsPayload)
 		// We can receive JSON messages (Channel messages) or log strings.
 		switch (nsPayload[0])
 		{
+			// Binary Channel messages.
+		case static_cast<char>(MessageKind::RESPONSE_ACCEPTED):
+		case static_cast<char>(MessageKind::RESPONSE_ERROR):
+		case static_cast<char>(MessageKind::RESPONSE_TYPE_ERROR):
+		case static_cast<char>(MessageKind::NOTIFICATION):
+			this->_processBinaryMessage(nsPayload);
+			break;
+
 			// 123 = "{" (a Channel JSON messsage).
 		case 123:
 			this->_processMessage(json::parse(nsPayload));
@@ -83,36 +149,13 @@ void Channel::_processMessage(const json& msg)
 	{
 		uint32_t id = msg["id"].get<uint32_t>();
 
-		if (!this->_sents.count(id))
-		{
-			MSC_ERROR("received response does not match any sent request [id:%d]", id);
-			return;
-		}
-
-		async_simple::Promise<json> sent = std::move(this->_sents[id]);
-		this->_sents.erase(id);
-
 		if (msg.count("accepted") && msg["accepted"].get<bool>())
 		{
-			json data = msg.value("data", json::object());
-			MSC_DEBUG("request succeeded [id:%d]", id);
-			sent.setValue(std::move(data));
+			this->_resolveSent(id, msg.value("data", json::object()));
 		}
 		else if (msg.count("error"))
 		{
-			std::string error = msg["error"];
-			std::string reason = msg["reason"];
-
-			MSC_WARN("request failed [id:\"%d\"] reason:%s]", id, reason.c_str());
-
-			if (error == "TypeError")
-			{
-				sent.setException(std::make_exception_ptr(TypeError(reason)));
-			}
-			else
-			{
-				sent.setException(std::make_exception_ptr(Error(reason)));
-			}
+			this->_rejectSent(id, msg["error"], msg["reason"]);
 		}
 		else
 		{
@@ -132,9 +175,7 @@ void Channel::_processMessage(const json& msg)
 			targetId = msg["targetId"].get<std::string>();
 		}
 
-		setImmediate([=]() {
-			this->emit(targetId, msg["event"].get<std::string>(), msg.value("data", json()));
-		});
+		this->_emitNotification(targetId, msg["event"].get<std::string>(), msg.value("data", json()));
 	}
 	// Otherwise unexpected message.
 	else
@@ -143,4 +184,114 @@ void Channel::_processMessage(const json& msg)
 	}
 }
 
+void Channel::_processBinaryMessage(const std::string& payload)
+{
+	const char* data = payload.data();
+	size_t len = payload.size();
+	size_t offset = 1;
+
+	auto readString = [&](std::string& out) {
+		uint16_t strLen;
+
+		if (len < offset + sizeof(strLen))
+			MSC_THROW_ERROR("truncated binary message");
+
+		std::memcpy(&strLen, data + offset, sizeof(strLen));
+		offset += sizeof(strLen);
+
+		if (len < offset + strLen)
+			MSC_THROW_ERROR("truncated binary message");
+
+		out.assign(data + offset, strLen);
+		offset += strLen;
+	};
+
+	auto readData = [&](json defaultValue) {
+		if (offset == len)
+			return defaultValue;
+
+		return json::from_msgpack(data + offset, data + len);
+	};
+
+	MessageKind kind = static_cast<MessageKind>(data[0]);
+
+	if (kind == MessageKind::NOTIFICATION)
+	{
+		std::string targetId;
+		std::string event;
+
+		readString(targetId);
+		readString(event);
+
+		this->_emitNotification(targetId, event, readData(json()));
+
+		return;
+	}
+
+	uint32_t id;
+
+	if (len < offset + sizeof(id))
+		MSC_THROW_ERROR("truncated binary message");
+
+	std::memcpy(&id, data + offset, sizeof(id));
+	offset += sizeof(id);
+
+	if (kind == MessageKind::RESPONSE_ACCEPTED)
+	{
+		this->_resolveSent(id, readData(json::object()));
+	}
+	else
+	{
+		this->_rejectSent(
+			id,
+			kind == MessageKind::RESPONSE_TYPE_ERROR ? "TypeError" : "Error",
+			std::string(data + offset, len - offset));
+	}
+}
+
+void Channel::_resolveSent(uint32_t id, json data)
+{
+	if (!this->_sents.count(id))
+	{
+		MSC_ERROR("received response does not match any sent request [id:%d]", id);
+		return;
+	}
+
+	async_simple::Promise<json> sent = std::move(this->_sents[id]);
+	this->_sents.erase(id);
+
+	MSC_DEBUG("request succeeded [id:%d]", id);
+	sent.setValue(std::move(data));
+}
+
+void Channel::_rejectSent(uint32_t id, const std::string& error, const std::string& reason)
+{
+	if (!this->_sents.count(id))
+	{
+		MSC_ERROR("received response does not match any sent request [id:%d]", id);
+		return;
+	}
+
+	async_simple::Promise<json> sent = std::move(this->_sents[id]);
+	this->_sents.erase(id);
+
+	MSC_WARN("request failed [id:\"%d\"] reason:%s]", id, reason.c_str());
+
+	if (error == "TypeError")
+	{
+		sent.setException(std::make_exception_ptr(TypeError(reason)));
+	}
+	else
+	{
+		sent.setException(std::make_exception_ptr(Error(reason)));
+	}
+}
+
+void Channel::_emitNotification(const std::string& targetId, const std::string& event, json data)
+{
+	setImmediate([this, targetId, event = std::string(event), data = std::move(data)]() mutable {
+		this->emit(targetId, std::move(event), std::move(data));
+	});
+}
+
 }
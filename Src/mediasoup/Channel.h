@@ -12,17 +12,29 @@ public:
 
 	void close();
 
+	/**
+	 * Use the binary message format. Must match the worker --channelFormat.
+	 */
+	void setBinaryFormat(bool binary);
+
 	virtual async_simple::coro::Lazy<json> request(std::string method, std::optional<std::string> handlerId = std::nullopt, const json& data = json()) = 0;
 
 protected:
+	void _serializeRequest(std::string& request, uint32_t id, const std::string& method, const std::string& handlerId, const json& data);
 	void _receivePayload(const std::string& nsPayload);
 	void _processMessage(const json& msg);
+	void _processBinaryMessage(const std::string& payload);
+	void _resolveSent(uint32_t id, json data);
+	void _rejectSent(uint32_t id, const std::string& error, const std::string& reason);
+	void _emitNotification(const std::string& targetId, const std::string& event, json data);
 	virtual void subClose() = 0;
 
 protected:
 	int _pid;
 	// Closed flag.
 	bool _closed = false;
+	// Binary message format flag.
+	bool _binary = false;
 	
 	// Next id for messages sent to the worker process.
 	uint32_t _nextId = 0;
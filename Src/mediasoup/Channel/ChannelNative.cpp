@@ -9,13 +9,13 @@ namespace mediasoup {
 
 const int PayloadMaxLen = 1024 * 1024 * 4;
 const int MessageMaxLen = PayloadMaxLen + sizeof(int);
+// Slot buffers grown beyond this by an unusually big message are freed once
+// the message is consumed, so one dump does not pin megabytes per slot.
+const size_t SlotShrinkThreshold = 64 * 1024;
 
 inline static void onAsync(uv_handle_t* handle)
 {
-	while (static_cast<ChannelNative*>(handle->data)->CallbackWrite())
-	{
-		// Read while there are new messages.
-	}
+	static_cast<ChannelNative*>(handle->data)->OnAsync();
 }
 
 inline static void onClose(uv_handle_t* handle)
@@ -23,6 +23,12 @@ inline static void onClose(uv_handle_t* handle)
 	delete handle;
 }
 
+inline static void releaseSlotBuffer(std::string& buffer)
+{
+	if (buffer.capacity() > SlotShrinkThreshold)
+		std::string().swap(buffer);
+}
+
 ChannelNative::ChannelNative()
 	: Channel(0)
 {
@@ -39,23 +45,21 @@ ChannelNative::ChannelNative()
 
 		MSC_THROW_ERROR("uv_async_init() failed: %s", uv_strerror(err));
 	}
-
-	/*err = uv_async_send(this->_uvWriteHandle);
-
-	if (err != 0)
-	{
-		delete this->_uvWriteHandle;
-		this->_uvWriteHandle = nullptr;
-
-		MSC_THROW_ERROR("uv_async_send() failed: %s", uv_strerror(err));
-	}*/
 }
 
 void ChannelNative::subClose()
 {
+	{
+		std::lock_guard<std::mutex> lock(this->_writeHandleMutex);
+
+		this->_writeClosed.store(true);
+	}
+
 	if (this->_uvWriteHandle)
 	{
 		uv_close(reinterpret_cast<uv_handle_t*>(this->_uvWriteHandle), static_cast<uv_close_cb>(onClose));
+
+		this->_uvWriteHandle = nullptr;
 	}
 }
 
@@ -67,60 +71,87 @@ ChannelReadFreeFn ChannelNative::channelReadFn(uint8_t** message,
 	const void* handle,
 	ChannelReadCtx ctx)
 {
-
 	ChannelNative* pThis = (ChannelNative*)ctx;
 
-	//return channelReadFreeFn;
 	return pThis->ProduceMessage(message, messageLen, messageCtx, handle) ? channelReadFreeFn : nullptr;
 }
 
 void ChannelNative::channelReadFreeFn(uint8_t* message, uint32_t messageLen, size_t messageCtx)
 {
-	RequestMessage* data = reinterpret_cast<RequestMessage*>(messageCtx);
+	ChannelNative* pThis = reinterpret_cast<ChannelNative*>(messageCtx);
 
-	delete data;
+	pThis->ReleaseMessage();
 }
 
 void ChannelNative::channelWriteFn(const uint8_t* message, uint32_t messageLen, ChannelWriteCtx ctx)
 {
 	ChannelNative* pThis = (ChannelNative*)ctx;
 
-	std::string strPayload((const char*)message, messageLen);
-
-	pThis->ReceiveMessage(strPayload);
+	pThis->ReceiveMessage(message, messageLen);
 }
 
+// Called on the worker thread.
 bool ChannelNative::ProduceMessage(uint8_t** message, uint32_t* messageLen, size_t* messageCtx, const void* handle)
 {
-	this->_uvReadHandle = reinterpret_cast<uv_async_t*>(const_cast<void*>(handle));
+	this->_uvReadHandle.store(reinterpret_cast<uv_async_t*>(const_cast<void*>(handle)));
+
+	RequestMessage* data = this->_requestMessageRing.Front();
 
-	if (_requestMessageQueue.empty())
+	if (!data)
 	{
-		return false;
+		// Clear the pending flag before checking again so a request committed
+		// meanwhile either is seen here or triggers a new wakeup.
+		this->_readPending.store(false);
+
+		data = this->_requestMessageRing.Front();
+
+		if (!data)
+			return false;
 	}
-	
-	RequestMessage* data = _requestMessageQueue.front();
 
 	*message = (uint8_t*)data->request.data();
 	*messageLen = data->request.size();
-	*messageCtx = (size_t)data;
+	*messageCtx = (size_t)this;
 
-	_requestMessageQueue.pop();
+	this->_requestMessageRing.Pop();
 
 	return true;
 }
 
+// Called on the worker thread once the request returned by ProduceMessage()
+// has been processed.
+void ChannelNative::ReleaseMessage()
+{
+	// Slots are consumed and released in order, so the first popped one is
+	// the slot being freed.
+	releaseSlotBuffer(this->_requestMessageRing.OldestPopped()->request);
+
+	this->_requestMessageRing.Release();
+}
+
 void ChannelNative::SendRequestMessage(uint32_t id)
 {
-	if (!_uvReadHandle)
+	if (this->_readPending.exchange(true))
+	{
+		return;
+	}
+
+	uv_async_t* uvReadHandle = this->_uvReadHandle.load();
+
+	// The worker has not started reading yet. It drains the ring on its first
+	// read.
+	if (!uvReadHandle)
 	{
 		return;
 	}
 
 	try
 	{
-		if (uv_async_send(_uvReadHandle) != 0)
+		if (uv_async_send(uvReadHandle) != 0)
 		{
+			// Let the next request try again.
+			this->_readPending.store(false);
+
 			this->_sents[id].setException(
 				std::make_exception_ptr(Error(" SendRequestMessage uv_async_send error")));
 		}
@@ -132,40 +163,100 @@ void ChannelNative::SendRequestMessage(uint32_t id)
 	}
 }
 
-void ChannelNative::ReceiveMessage(const std::string& message)
+// Called on the worker thread.
+void ChannelNative::ReceiveMessage(const uint8_t* message, uint32_t messageLen)
 {
-	_receiveMessageQueue.push(message);
+	if (this->_writeClosed.load())
+		return;
 
-	int err = uv_async_send(this->_uvWriteHandle);
+	ResponseMessage* data;
 
-	if (err != 0)
+	// The main loop is behind. Wait for it rather than dropping a response,
+	// unless it is closed and will not drain the ring anymore.
+	while (!(data = this->_receiveMessageRing.Prepare()))
 	{
-		delete this->_uvWriteHandle;
-		this->_uvWriteHandle = nullptr;
+		if (this->_writeClosed.load())
+			return;
+
+		std::this_thread::yield();
+	}
+
+	data->payload.assign(reinterpret_cast<const char*>(message), messageLen);
+
+	this->_receiveMessageRing.Commit();
 
-		MSC_THROW_ERROR("uv_async_send() failed: %s", uv_strerror(err));
+	if (!this->_writePending.exchange(true))
+	{
+		std::lock_guard<std::mutex> lock(this->_writeHandleMutex);
+
+		// Let the next message try again if this wakeup was not sent.
+		if (this->_writeClosed.load() || uv_async_send(this->_uvWriteHandle) != 0)
+			this->_writePending.store(false);
 	}
 }
 
+void ChannelNative::OnAsync()
+{
+	// Clear the flag before draining so messages committed meanwhile are
+	// either read below or trigger a new wakeup.
+	this->_writePending.store(false);
+
+	while (CallbackWrite())
+	{
+		// Read while there are new messages.
+	}
+
+	// Responses mean the worker has freed request slots.
+	FlushPendingRequests();
+}
+
 bool ChannelNative::CallbackWrite()
 {
 	if (this->_closed)
 		return false;
 
-	if (!_receiveMessageQueue.size())
+	ResponseMessage* data = this->_receiveMessageRing.Front();
+
+	if (!data)
 	{
 		return false;
 	}
 
-	std::string strPayload = _receiveMessageQueue.front();
+	this->_receivePayload(data->payload);
 
-	this->_receivePayload(strPayload);
+	releaseSlotBuffer(data->payload);
 
-	_receiveMessageQueue.pop();
+	this->_receiveMessageRing.PopAndRelease();
 
 	return true;
 }
 
+void ChannelNative::FlushPendingRequests()
+{
+	if (this->_pendingRequests.empty())
+		return;
+
+	uint32_t id = 0;
+
+	while (!this->_pendingRequests.empty())
+	{
+		RequestMessage* data = this->_requestMessageRing.Prepare();
+
+		if (!data)
+			break;
+
+		id = this->_pendingRequests.front().id;
+		data->id = id;
+		data->request.swap(this->_pendingRequests.front().request);
+
+		this->_requestMessageRing.Commit();
+		this->_pendingRequests.pop_front();
+	}
+
+	if (id != 0)
+		SendRequestMessage(id);
+}
+
 async_simple::coro::Lazy<json> ChannelNative::request(std::string method, std::optional<std::string> handlerId, const json& data/* = json()*/)
 {
 	constexpr auto max_value = std::numeric_limits<uint32_t>::max(); //4294967295
@@ -181,14 +272,35 @@ async_simple::coro::Lazy<json> ChannelNative::request(std::string method, std::o
 		handlerId = "undefined";
 	}
 
-	std::string payload = data.is_null() ? "undefined" : data.dump();
+	// Keep FIFO order: only use the ring directly when nothing is waiting.
+	RequestMessage* slot = this->_pendingRequests.empty() ? this->_requestMessageRing.Prepare() : nullptr;
 
-	std::string request = Utils::Printf("%u:%s:%s:%s", id, method.c_str(), handlerId.value().c_str(), payload.c_str());
+	if (!slot)
+	{
+		this->_pendingRequests.push_back(RequestMessage{ id });
+		slot = std::addressof(this->_pendingRequests.back());
+	}
+
+	slot->id = id;
+
+	try
+	{
+		this->_serializeRequest(slot->request, id, method, handlerId.value(), data);
 
-	if (request.length() > MessageMaxLen)
-		MSC_THROW_ERROR("Channel request too big");
+		if (slot->request.length() > MessageMaxLen)
+			MSC_THROW_ERROR("Channel request too big");
+	}
+	catch (...)
+	{
+		// Nothing was committed, the slot is reused by the next request.
+		if (!this->_pendingRequests.empty() && slot == std::addressof(this->_pendingRequests.back()))
+			this->_pendingRequests.pop_back();
+
+		throw;
+	}
 
-	_requestMessageQueue.push(new RequestMessage{ id, request });
+	if (this->_pendingRequests.empty())
+		this->_requestMessageRing.Commit();
 
 	async_simple::Promise<json> t_promise;
 
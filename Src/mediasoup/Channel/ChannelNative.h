@@ -3,6 +3,7 @@
 #include <uv.h>
 #include "lib.hpp"
 #include "Channel.h"
+#include "SpscRing.h"
 
 namespace mediasoup {
 
@@ -15,6 +16,11 @@ protected:
 		std::string request;
 	};
 
+	struct ResponseMessage
+	{
+		std::string payload;
+	};
+
 public:
 	ChannelNative();
 
@@ -32,9 +38,13 @@ public:
 
 	bool ProduceMessage(uint8_t** message, uint32_t* messageLen, size_t* messageCtx, const void* handle);
 
+	void ReleaseMessage();
+
 	void SendRequestMessage(uint32_t id);
-	
-	void ReceiveMessage(const std::string& message);
+
+	void ReceiveMessage(const uint8_t* message, uint32_t messageLen);
+
+	void OnAsync();
 
 	bool CallbackWrite();
 
@@ -43,13 +53,30 @@ public:
 protected:
 	virtual void subClose() override;
 
+private:
+	void FlushPendingRequests();
+
 protected:
-	uv_async_t* _uvReadHandle{ nullptr };
+	// Worker side async handle, set by the worker thread on its first read.
+	std::atomic<uv_async_t*> _uvReadHandle{ nullptr };
 	uv_async_t* _uvWriteHandle{ nullptr };
 
-	std::queue<std::string> _receiveMessageQueue;
-	std::queue<RequestMessage*> _requestMessageQueue;
-
+	// Worker thread -> main loop (responses, notifications and logs).
+	SpscRing<ResponseMessage, 4096> _receiveMessageRing;
+	// Main loop -> worker thread (requests).
+	SpscRing<RequestMessage, 1024> _requestMessageRing;
+	// Requests that did not fit in the ring while it was full (main loop only).
+	std::deque<RequestMessage> _pendingRequests;
+
+	// Set while a wakeup is in flight so bursts cost a single uv_async_send().
+	std::atomic<bool> _readPending{ false };
+	std::atomic<bool> _writePending{ false };
+
+	// Set on close, after which the worker thread drops its messages since
+	// nothing drains the ring anymore. The mutex keeps the worker thread from
+	// using _uvWriteHandle while it is being closed.
+	std::atomic<bool> _writeClosed{ false };
+	std::mutex _writeHandleMutex;
 };
 
 }
@@ -82,9 +82,9 @@ async_simple::coro::Lazy<json> ChannelOrigin::request(std::string method, std::o
 		handlerId = "undefined";
 	}
 
-	std::string payload = data.is_null() ? "undefined" : data.dump();
+	std::string request;
 
-	std::string request = Utils::Printf("%u:%s:%s:%s", id, method.c_str(), handlerId.value().c_str(), payload.c_str());
+	this->_serializeRequest(request, id, method, handlerId.value(), data);
 
 	if (request.length() > NS_MESSAGE_MAX_LEN)
 		MSC_THROW_ERROR("Channel request too big");
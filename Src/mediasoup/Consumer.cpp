@@ -366,7 +366,7 @@ void Consumer::_handleWorkerNotifications()
 		}
 	});
 
-	this->_payloadChannel->on(this->_internal["consumerId"], [=](std::string event, const json& data, std::string payload) {
+	this->_payloadChannel->on(this->_internal["consumerId"], [=](std::string event, json data, const uint8_t* payload, size_t payloadLen) {
 		if (event == "rtp")
 		{
 			if (this->_closed)
@@ -40,9 +40,10 @@ void PayloadChannel::close()
  */
 void PayloadChannel::notify(
 	std::string event,
-	json internal,
-	json data/* = json()*/,
-	std::string payload/* = std::string()*/
+	std::optional<std::string> handlerId/* = std::nullopt*/,
+	std::optional<std::string> data/* = std::nullopt*/,
+	const uint8_t* payload/* = nullptr*/,
+	size_t payloadLen/* = 0*/
 )
 {
 	MSC_DEBUG("notify() [event:%s]", event.c_str());
@@ -50,87 +51,37 @@ void PayloadChannel::notify(
 	if (this->_closed)
 		MSC_THROW_INVALID_STATE_ERROR("PayloadChannel closed");
 
-// 	const notification = { event, internal, data };
-// 	const ns1 = netstring.nsWrite(JSON.stringify(notification));
-// 	const ns2 = netstring.nsWrite(payload);
-// 
-// 	if (Buffer.byteLength(ns1) > NS_MESSAGE_MAX_LEN)
-// 		MSC_THROW_ERROR("PayloadChannel notification too big");
-// 	else if (Buffer.byteLength(ns2) > NS_MESSAGE_MAX_LEN)
-// 		MSC_THROW_ERROR("PayloadChannel payload too big");
-// 
-// 	try
-// 	{
-// 		// This may throw if closed or remote side ended.
-// 		this->_producerSocket->write(ns1);
-// 	}
-// 	catch (error)
-// 	{
-// 		MSC_WARN("notify() | sending notification failed: %s", String(error));
-// 
-// 		return;
-// 	}
-// 
-// 	try
-// 	{
-// 		// This may throw if closed or remote side ended.
-// 		this->_producerSocket->write(ns2);
-// 	}
-// 	catch (error)
-// 	{
-// 		MSC_WARN("notify() | sending payload failed: %s", String(error));
-// 
-// 		return;
-// 	}
+	this->_notification.clear();
+	this->_notification.append("n:");
+	this->_notification.append(event);
+	this->_notification.push_back(':');
+	this->_notification.append(handlerId.value_or("undefined"));
+	this->_notification.push_back(':');
+	this->_notification.append(data.value_or("undefined"));
+
+	if (this->_notification.length() > NS_MESSAGE_MAX_LEN)
+		MSC_THROW_ERROR("PayloadChannel notification too big");
+	else if (payloadLen > NS_PAYLOAD_MAX_LEN)
+		MSC_THROW_ERROR("PayloadChannel payload too big");
+
+	this->subNotify(this->_notification, payload, payloadLen);
 }
 
-void PayloadChannel::_processData(const json& msg)
+void PayloadChannel::_processMessage(const json& msg, const uint8_t* payload, size_t payloadLen)
 {
-// 	if (!this->_ongoingNotification)
-// 	{
-// 		let msg;
-// 
-// 		try
-// 		{
-// 			msg = JSON.parse(data.toString("utf8"));
-// 		}
-// 		catch (error)
-// 		{
-// 			MSC_ERROR(
-// 				"received invalid data from the worker process: %s",
-// 				String(error));
-// 
-// 			return;
-// 		}
-// 
-// 		if (!msg.targetId || !msg.event)
-// 		{
-// 			MSC_ERROR("received message is not a notification");
-// 
-// 			return;
-// 		}
-// 
-// 		this->_ongoingNotification =
-// 		{
-// 			targetId: msg.targetId,
-// 			event : msg.event,
-// 			data : msg.data
-// 		};
-// 	}
-// 	else
-// 	{
-// 		const payload = data as Buffer;
-// 
-// 		// Emit the corresponding event.
-// 		this->emit(
-// 			this->_ongoingNotification.targetId,
-// 			this->_ongoingNotification.event,
-// 			this->_ongoingNotification.data,
-// 			payload);
-// 
-// 		// Unset ongoing notification.
-// 		this->_ongoingNotification = undefined;
-// 	}
+	if (!msg.contains("targetId") || !msg.contains("event"))
+	{
+		MSC_ERROR("received message is not a notification");
+
+		return;
+	}
+
+	std::string targetId = msg["targetId"].get<std::string>();
+	std::string event = msg["event"].get<std::string>();
+	json data = msg.value("data", json());
+
+	// Emit the corresponding event.
+	this->emit(targetId, event, data, payload, payloadLen);
 }
 
 }
@@ -24,19 +24,24 @@ public:
 	*/
 	void notify(
 		std::string event,
-		json internal,
-		json data = json(),
-		std::string payload = std::string()
+		std::optional<std::string> handlerId = std::nullopt,
+		std::optional<std::string> data = std::nullopt,
+		const uint8_t* payload = nullptr,
+		size_t payloadLen = 0
 	);
 
-private:
-	void _processData(const json& msg);
+protected:
+	void _processMessage(const json& msg, const uint8_t* payload, size_t payloadLen);
+	virtual void subNotify(const std::string& notification, const uint8_t* payload, size_t payloadLen) = 0;
 	virtual void subClose() = 0;
 
-private:
+protected:
 	// Closed flag.
 	bool _closed = false;
 
+	// Reused buffer for serializing outgoing notifications.
+	std::string _notification;
+
 	// Buffer for reading messages from the worker.
 //	Buffer _recvBuffer;
 
@@ -1,15 +1,372 @@
 #define MSC_CLASS "PayloadChannelNative"
 
 #include "common.h"
+#include "Logger.h"
+#include "errors.h"
 #include "PayloadChannelNative.h"
 
 namespace mediasoup {
+
+// Slot buffers grown beyond this by an unusually big message are freed once
+// the message is consumed, so one large payload does not pin memory per slot.
+const size_t SlotShrinkThreshold = 64 * 1024;
+
+inline static void onAsync(uv_handle_t* handle)
+{
+	static_cast<PayloadChannelNative*>(handle->data)->OnAsync();
+}
+
+inline static void onClose(uv_handle_t* handle)
+{
+	delete handle;
+}
+
+inline static void releaseSlotBuffer(std::string& buffer)
+{
+	if (buffer.capacity() > SlotShrinkThreshold)
+		std::string().swap(buffer);
+}
+
 PayloadChannelNative::PayloadChannelNative()
 {
+	this->_uvWriteHandle = new uv_async_t;
+	this->_uvWriteHandle->data = static_cast<void*>(this);
+
+	int err =
+		uv_async_init(uv_default_loop(), this->_uvWriteHandle, reinterpret_cast<uv_async_cb>(onAsync));
+
+	if (err != 0)
+	{
+		delete this->_uvWriteHandle;
+		this->_uvWriteHandle = nullptr;
+
+		MSC_THROW_ERROR("uv_async_init() failed: %s", uv_strerror(err));
+	}
+}
+
+PayloadChannelNative::~PayloadChannelNative()
+{
+	// Messages the worker committed while closing.
+	DropReceivedMessages();
 }
 
 void PayloadChannelNative::subClose()
 {
+	{
+		std::lock_guard<std::mutex> lock(this->_writeHandleMutex);
+
+		this->_writeClosed.store(true);
+	}
+
+	if (this->_uvWriteHandle)
+	{
+		uv_close(reinterpret_cast<uv_handle_t*>(this->_uvWriteHandle), static_cast<uv_close_cb>(onClose));
+
+		this->_uvWriteHandle = nullptr;
+	}
+
+	DropReceivedMessages();
+}
+
+PayloadChannelReadFreeFn PayloadChannelNative::payloadChannelReadFreeFn(
+	uint8_t** message,
+	uint32_t* messageLen,
+	size_t* messageCtx,
+	uint8_t** payload,
+	uint32_t* payloadLen,
+	size_t* payloadCapacity,
+	// This is `uv_async_t` handle that can be called later with `uv_async_send()` when there is more
+	// data to read.
+	const void* handle,
+	PayloadChannelReadCtx ctx)
+{
+	PayloadChannelNative* pThis = (PayloadChannelNative*)ctx;
+
+	return pThis->ProduceMessage(message, messageLen, messageCtx, payload, payloadLen, payloadCapacity, handle)
+		? static_cast<PayloadChannelReadFreeFn>(payloadChannelReadFreeFn)
+		: nullptr;
+}
+
+// The worker calls this twice per message: once with the message context and
+// once with the payload capacity. Message and payload share a slot, so the
+// slot is released on the first call and the second one (context 0) is a no-op.
+void PayloadChannelNative::payloadChannelReadFreeFn(uint8_t* message, uint32_t messageLen, size_t messageCtx)
+{
+	if (messageCtx == 0)
+		return;
+
+	PayloadChannelNative* pThis = reinterpret_cast<PayloadChannelNative*>(messageCtx);
+
+	pThis->ReleaseMessage();
+}
+
+void PayloadChannelNative::payloadChannelWriteFn(
+	const uint8_t* message,
+	uint32_t messageLen,
+	const uint8_t* payload,
+	uint32_t payloadLen,
+	PayloadChannelPayloadRef payloadRef,
+	ChannelWriteCtx ctx)
+{
+	PayloadChannelNative* pThis = (PayloadChannelNative*)ctx;
+
+	pThis->ReceiveMessage(message, messageLen, payload, payloadLen, payloadRef);
+}
+
+// Called on the worker thread.
+bool PayloadChannelNative::ProduceMessage(
+	uint8_t** message,
+	uint32_t* messageLen,
+	size_t* messageCtx,
+	uint8_t** payload,
+	uint32_t* payloadLen,
+	size_t* payloadCapacity,
+	const void* handle)
+{
+	this->_uvReadHandle.store(reinterpret_cast<uv_async_t*>(const_cast<void*>(handle)));
+
+	PayloadMessage* data = this->_notificationMessageRing.Front();
+
+	if (!data)
+	{
+		// Clear the pending flag before checking again so a notification
+		// committed meanwhile either is seen here or triggers a new wakeup.
+		this->_readPending.store(false);
+
+		data = this->_notificationMessageRing.Front();
+
+		if (!data)
+			return false;
+	}
+
+	*message = (uint8_t*)data->message.data();
+	*messageLen = data->message.size();
+	*messageCtx = (size_t)this;
+	*payload = data->payload.empty() ? nullptr : (uint8_t*)data->payload.data();
+	*payloadLen = data->payload.size();
+	*payloadCapacity = 0;
+
+	this->_notificationMessageRing.Pop();
+
+	return true;
+}
+
+// Called on the worker thread once the notification returned by
+// ProduceMessage() has been processed.
+void PayloadChannelNative::ReleaseMessage()
+{
+	PayloadMessage* data = this->_notificationMessageRing.OldestPopped();
+
+	releaseSlotBuffer(data->message);
+	releaseSlotBuffer(data->payload);
+
+	this->_notificationMessageRing.Release();
+}
+
+void PayloadChannelNative::SendNotificationMessage()
+{
+	if (this->_readPending.exchange(true))
+		return;
+
+	uv_async_t* uvReadHandle = this->_uvReadHandle.load();
+
+	// The worker has not started reading yet. It drains the ring on its first
+	// read.
+	if (!uvReadHandle)
+		return;
+
+	if (uv_async_send(uvReadHandle) != 0)
+	{
+		// Let the next notification try again.
+		this->_readPending.store(false);
+
+		MSC_WARN("notify() | uv_async_send() failed");
+	}
+}
+
+// Called on the worker thread.
+void PayloadChannelNative::ReceiveMessage(
+	const uint8_t* message,
+	uint32_t messageLen,
+	const uint8_t* payload,
+	uint32_t payloadLen,
+	PayloadChannelPayloadRef payloadRef)
+{
+	if (this->_writeClosed.load())
+		return;
+
+	PayloadMessage* data;
+
+	// The main loop is behind. Wait for it rather than dropping a message,
+	// unless it is closed and will not drain the ring anymore.
+	while (!(data = this->_receiveMessageRing.Prepare()))
+	{
+		if (this->_writeClosed.load())
+			return;
+
+		std::this_thread::yield();
+	}
+
+	data->message.assign(reinterpret_cast<const char*>(message), messageLen);
+
+	// A shared payload (a DataChannel message sent to every DataConsumer) is
+	// kept until processed instead of being copied into each slot.
+	if (payloadRef)
+	{
+		mediasoup_payload_ref(payloadRef);
+
+		data->payloadRef = payloadRef;
+		data->sharedPayload = payload;
+		data->sharedPayloadLen = payloadLen;
+		data->payload.clear();
+	}
+	else if (payload)
+	{
+		data->payload.assign(reinterpret_cast<const char*>(payload), payloadLen);
+	}
+	else
+	{
+		data->payload.clear();
+	}
+
+	this->_receiveMessageRing.Commit();
+
+	if (!this->_writePending.exchange(true))
+	{
+		std::lock_guard<std::mutex> lock(this->_writeHandleMutex);
+
+		// Let the next message try again if this wakeup was not sent.
+		if (this->_writeClosed.load() || uv_async_send(this->_uvWriteHandle) != 0)
+			this->_writePending.store(false);
+	}
+}
+
+void PayloadChannelNative::OnAsync()
+{
+	// Clear the flag before draining so messages committed meanwhile are
+	// either read below or trigger a new wakeup.
+	this->_writePending.store(false);
+
+	while (CallbackWrite())
+	{
+		// Read while there are new messages.
+	}
+
+	FlushPendingNotifications();
+}
+
+bool PayloadChannelNative::CallbackWrite()
+{
+	if (this->_closed)
+		return false;
+
+	PayloadMessage* data = this->_receiveMessageRing.Front();
+
+	if (!data)
+		return false;
+
+	try
+	{
+		json msg = json::parse(data->message);
+
+		// Listeners run synchronously, so they may read the payload straight
+		// from the slot or from the shared payload.
+		if (data->payloadRef)
+			this->_processMessage(msg, data->sharedPayload, data->sharedPayloadLen);
+		else
+			this->_processMessage(
+				msg, reinterpret_cast<const uint8_t*>(data->payload.data()), data->payload.size());
+	}
+	catch (const json::parse_error& error)
+	{
+		MSC_ERROR("received invalid data from the worker process: %s", error.what());
+	}
+
+	if (data->payloadRef)
+	{
+		mediasoup_payload_unref(data->payloadRef);
+
+		data->payloadRef = nullptr;
+		data->sharedPayload = nullptr;
+		data->sharedPayloadLen = 0;
+	}
+
+	releaseSlotBuffer(data->message);
+	releaseSlotBuffer(data->payload);
+
+	this->_receiveMessageRing.PopAndRelease();
+
+	return true;
+}
+
+// Releases the messages that will not be processed, and with them the
+// payloads shared by the worker.
+void PayloadChannelNative::DropReceivedMessages()
+{
+	PayloadMessage* data;
 
+	while ((data = this->_receiveMessageRing.Front()))
+	{
+		if (data->payloadRef)
+		{
+			mediasoup_payload_unref(data->payloadRef);
+
+			data->payloadRef = nullptr;
+			data->sharedPayload = nullptr;
+			data->sharedPayloadLen = 0;
+		}
+
+		this->_receiveMessageRing.PopAndRelease();
+	}
 }
+
+void PayloadChannelNative::subNotify(const std::string& notification, const uint8_t* payload, size_t payloadLen)
+{
+	FlushPendingNotifications();
+
+	// Keep FIFO order: only use the ring directly when nothing is waiting.
+	PayloadMessage* slot =
+		this->_pendingNotifications.empty() ? this->_notificationMessageRing.Prepare() : nullptr;
+
+	if (!slot)
+	{
+		this->_pendingNotifications.emplace_back();
+		slot = std::addressof(this->_pendingNotifications.back());
+	}
+
+	slot->message.assign(notification);
+
+	if (payload)
+		slot->payload.assign(reinterpret_cast<const char*>(payload), payloadLen);
+	else
+		slot->payload.clear();
+
+	if (this->_pendingNotifications.empty())
+		this->_notificationMessageRing.Commit();
+
+	SendNotificationMessage();
+}
+
+void PayloadChannelNative::FlushPendingNotifications()
+{
+	if (this->_pendingNotifications.empty())
+		return;
+
+	while (!this->_pendingNotifications.empty())
+	{
+		PayloadMessage* data = this->_notificationMessageRing.Prepare();
+
+		if (!data)
+			break;
+
+		data->message.swap(this->_pendingNotifications.front().message);
+		data->payload.swap(this->_pendingNotifications.front().payload);
+
+		this->_notificationMessageRing.Commit();
+		this->_pendingNotifications.pop_front();
+	}
+
+	SendNotificationMessage();
+}
+
 }
@@ -1,14 +1,29 @@
 #pragma once
 
+#include <uv.h>
 #include "lib.hpp"
 #include "PayloadChannel.h"
+#include "SpscRing.h"
 
 namespace mediasoup {
 
 class PayloadChannelNative : public PayloadChannel
 {
+protected:
+	struct PayloadMessage
+	{
+		std::string message;
+		std::string payload;
+		// Set instead of `payload` when the worker shares the payload, which is
+		// then kept until processed rather than copied.
+		PayloadChannelPayloadRef payloadRef{ nullptr };
+		const uint8_t* sharedPayload{ nullptr };
+		uint32_t sharedPayloadLen{ 0 };
+	};
+
 public:
 	PayloadChannelNative();
+	virtual ~PayloadChannelNative();
 
 	static PayloadChannelReadFreeFn payloadChannelReadFreeFn(
 		uint8_t** message,
@@ -20,35 +35,70 @@ public:
 		// This is `uv_async_t` handle that can be called later with `uv_async_send()` when there is more
 		// data to read.
 		const void* handle,
-		PayloadChannelReadCtx ctx)
-	{
+		PayloadChannelReadCtx ctx);
 
-		//uv_async_send((uv_async_t*)handle);
-		//return payloadChannelReadFreeFn;
-		return nullptr;
-	}
+	static void payloadChannelReadFreeFn(uint8_t*, uint32_t, size_t);
 
-	static void payloadChannelReadFreeFn(uint8_t*, uint32_t, size_t)
-	{
+	static void payloadChannelWriteFn(
+		const uint8_t* message,
+		uint32_t messageLen,
+		const uint8_t* payload,
+		uint32_t payloadLen,
+		PayloadChannelPayloadRef payloadRef,
+		ChannelWriteCtx ctx);
 
-	}
+	bool ProduceMessage(
+		uint8_t** message,
+		uint32_t* messageLen,
+		size_t* messageCtx,
+		uint8_t** payload,
+		uint32_t* payloadLen,
+		size_t* payloadCapacity,
+		const void* handle);
 
-	static void payloadChannelWriteFn(
+	void ReleaseMessage();
+
+	void ReceiveMessage(
 		const uint8_t* message,
 		uint32_t messageLen,
 		const uint8_t* payload,
 		uint32_t payloadLen,
-		ChannelWriteCtx ctx)
-	{
-		std::string strMsg((const char*)message, messageLen);
-		std::string strPayload((const char*)payload, payloadLen);
+		PayloadChannelPayloadRef payloadRef);
 
-		printf("%s---->%s\n", strMsg.c_str(), strPayload.c_str());
-	}
+	void OnAsync();
+
+	bool CallbackWrite();
 
 protected:
+	virtual void subNotify(const std::string& notification, const uint8_t* payload, size_t payloadLen) override;
 	virtual void subClose() override;
 
+private:
+	void FlushPendingNotifications();
+	void SendNotificationMessage();
+	void DropReceivedMessages();
+
+protected:
+	// Worker side async handle, set by the worker thread on its first read.
+	std::atomic<uv_async_t*> _uvReadHandle{ nullptr };
+	uv_async_t* _uvWriteHandle{ nullptr };
+
+	// Worker thread -> main loop (notifications with payload).
+	SpscRing<PayloadMessage, 1024> _receiveMessageRing;
+	// Main loop -> worker thread (notifications with payload).
+	SpscRing<PayloadMessage, 1024> _notificationMessageRing;
+	// Notifications that did not fit in the ring while it was full (main loop only).
+	std::deque<PayloadMessage> _pendingNotifications;
+
+	// Set while a wakeup is in flight so bursts cost a single uv_async_send().
+	std::atomic<bool> _readPending{ false };
+	std::atomic<bool> _writePending{ false };
+
+	// Set on close, after which the worker thread drops its messages since
+	// nothing drains the ring anymore. The mutex keeps the worker thread from
+	// using _uvWriteHandle while it is being closed.
+	std::atomic<bool> _writeClosed{ false };
+	std::mutex _writeHandleMutex;
 };
 
 }
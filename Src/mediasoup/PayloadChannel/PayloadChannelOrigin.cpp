@@ -1,6 +1,7 @@
 #define MSC_CLASS "PayloadChannelOrigin"
 
 #include "common.h"
+#include "Logger.h"
 #include "PayloadChannelOrigin.h"
 #include "child_process/Socket.h"
 
@@ -34,6 +35,27 @@ PayloadChannelOrigin::PayloadChannelOrigin(Socket* producerSocket, Socket* consu
 	//_producerSocket->Start();
 }
 
+void PayloadChannelOrigin::subNotify(const std::string& notification, const uint8_t* payload, size_t payloadLen)
+{
+	int size = notification.size();
+	int payloadSize = payloadLen;
+
+	// This may raise if closed or remote side ended.
+	try
+	{
+		this->_producerSocket->Write((const uint8_t*)(int*)(&size), sizeof(size));
+		this->_producerSocket->Write((const uint8_t*)notification.data(), size);
+		this->_producerSocket->Write((const uint8_t*)(int*)(&payloadSize), sizeof(payloadSize));
+
+		if (payloadSize > 0)
+			this->_producerSocket->Write(payload, payloadSize);
+	}
+	catch (const std::exception& error)
+	{
+		MSC_WARN("notify() | sending notification failed: %s", error.what());
+	}
+}
+
 void PayloadChannelOrigin::subClose()
 {
 	// Remove event listeners but leave a fake "error" hander to avoid
@@ -12,6 +12,7 @@ public:
 	PayloadChannelOrigin(Socket* producerSocket, Socket* consumerSocket);
 
 protected:
+	virtual void subNotify(const std::string& notification, const uint8_t* payload, size_t payloadLen) override;
 	virtual void subClose() override;
 
 protected:
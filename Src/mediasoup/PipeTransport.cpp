@@ -37,7 +37,8 @@ PipeTransport::PipeTransport(const json& internal,
 		{ "sctpParameters" , data["sctpParameters"] },
 		{ "sctpState"      , data["sctpState"] },
 		{ "rtx"            , data["rtx"] },
-		{ "srtpParameters" , data["srtpParameters"] }
+		{ "srtpParameters" , data["srtpParameters"] },
+		{ "inProcess"      , data.value("inProcess", false) }
 	};
 
 	this->_handleWorkerNotifications();
@@ -75,6 +76,14 @@ SrtpParameters PipeTransport::srtpParameters()
 	return this->_data["srtpParameters"];
 }
 
+/**
+ * Whether packets go through memory to a PipeTransport of this process.
+ */
+bool PipeTransport::inProcess()
+{
+	return this->_data["inProcess"];
+}
+
 std::string PipeTransport::typeName()
 {
 	return "PipeTransport";
@@ -159,10 +168,13 @@ async_simple::coro::Lazy<void> PipeTransport::connect(
 
 	json reqData = {
 		{ "ip", ip },
-		{ "port", port },
-		{ "srtpParameters", srtpParameters }
+		{ "port", port }
 	};
 
+	// The worker rejects srtpParameters when SRTP is not enabled.
+	if (!srtpParameters.cryptoSuite.empty())
+		reqData["srtpParameters"] = srtpParameters;
+
 	json data =
 		co_await this->_channel->request("transport.connect", this->_internal["transportId"], reqData);
 
@@ -170,6 +182,23 @@ async_simple::coro::Lazy<void> PipeTransport::connect(
 	this->_data["tuple"] = data["tuple"];
 }
 
+/**
+ * Connect the in-process PipeTransport with the given one.
+ */
+async_simple::coro::Lazy<void> PipeTransport::connectInProcess(std::string pipeTransportId)
+{
+	MSC_DEBUG("connectInProcess()");
+
+	if (!this->inProcess())
+		MSC_THROW_INVALID_STATE_ERROR("not an in-process PipeTransport");
+
+	json reqData = {
+		{ "pipeTransportId", pipeTransportId }
+	};
+
+	co_await this->_channel->request("transport.connect", this->_internal["transportId"], reqData);
+}
+
 /**
  * Create a pipe Consumer.
  *
@@ -202,7 +231,7 @@ async_simple::coro::Lazy<Consumer*> PipeTransport::consume(ConsumerOptions& opti
 
 	json reqData =
 	{
-		{ "consumerId", uuidv4() },
+		{ "consumerId", internal["consumerId"] },
 		{ "producerId", producerId },
 		{ "kind"                   , producer->kind() },
 		{ "rtpParameters"          , rtpParameters },
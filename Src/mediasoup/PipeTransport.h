@@ -46,6 +46,11 @@ public:
 	 */
 	SrtpParameters srtpParameters();
 
+	/**
+	 * Whether packets go through memory to a PipeTransport of this process.
+	 */
+	bool inProcess();
+
 	virtual std::string typeName();
 
 	/**
@@ -95,6 +100,12 @@ public:
 		SrtpParameters& srtpParameters
 	);
 
+	/**
+	 * Connect the in-process PipeTransport with the given one, created with
+	 * inProcess in a Router of another Worker of this process.
+	 */
+	async_simple::coro::Lazy<void> connectInProcess(std::string pipeTransportId);
+
 	/**
 	 * Create a pipe Consumer.
 	 *
@@ -108,10 +108,13 @@ async_simple::coro::Lazy<void> PlainTransport::connect(
 	json reqData = {
 		{ "ip", ip },
 		{ "port", port },
-		{ "rtcpPort", rtcpPort },
-		{ "srtpParameters", srtpParameters }
+		{ "rtcpPort", rtcpPort }
 	};
 
+	// The worker rejects srtpParameters when SRTP is not enabled.
+	if (!srtpParameters.cryptoSuite.empty())
+		reqData["srtpParameters"] = srtpParameters;
+
 	json data =
 		co_await this->_channel->request("transport.connect", this->_internal["transportId"], reqData);
 
@@ -11,6 +11,7 @@
 #include "Channel.h"
 #include "transport.h"
 #include "DataProducer.h"
+#include "DataConsumer.h"
 #include "WebRtcServer.h"
 #include "WebRtctransport.h"
 #include "Plaintransport.h"
@@ -396,12 +397,13 @@ async_simple::coro::Lazy<PipeTransport*> Router::createPipeTransport(
 	uint32_t maxSctpMessageSize/* = 1073741823*/,
 	bool enableRtx/* = false*/,
 	bool enableSrtp/* = false*/,
-	json appData/* = json()*/
+	json appData/* = json()*/,
+	bool inProcess/* = false*/
 )
 {
 	MSC_DEBUG("createPipeTransport()");
 
-	if (!listenIp)
+	if (!listenIp && !inProcess)
 		MSC_THROW_ERROR("missing listenIp");
 	else if (!appData.is_null() && !appData.is_object())
 		MSC_THROW_ERROR("if given, appData must be an object");
@@ -427,13 +429,15 @@ async_simple::coro::Lazy<PipeTransport*> Router::createPipeTransport(
 	internal["transportId"] = uuidv4();
 
 	json reqData = {
+		{ "transportId", internal["transportId"] },
 		{ "listenIp" , listenIp },
 		{ "enableSctp", enableSctp },
 		{ "numSctpStreams", numSctpStreams },
 		{ "maxSctpMessageSize", maxSctpMessageSize },
 		{ "isDataChannel", false},
 		{ "enableRtx", enableRtx },
-		{ "enableSrtp", enableSrtp}
+		{ "enableSrtp", enableSrtp},
+		{ "inProcess", inProcess }
 	};
 
 
@@ -526,189 +530,285 @@ async_simple::coro::Lazy<DirectTransport*> Router::createDirectTransport(const D
 	this->_observer->safeEmit("newtransport", transport);
 	co_return transport;
 }
-///**
-// * Pipes the given Producer or DataProducer into another Router in same host.
-// */
-//async pipeToRouter({ producerId, dataProducerId, router, listenIp = "127.0.0.1", enableSctp = true, numSctpStreams = { OS: 1024, MIS : 1024 }, enableRtx = false, enableSrtp = false }) {
-//	MSC_DEBUG("pipeToRouter()");
-//	if (!producerId && !dataProducerId)
-//		throw new TypeError("missing producerId or dataProducerId");
-//	else if (producerId && dataProducerId)
-//		throw new TypeError("just producerId or dataProducerId can be given");
-//	else if (!router)
-//		throw new TypeError("Router not found");
-//	else if (router == = this)
-//		throw new TypeError("cannot use this Router as destination");
-//	let producer;
-//	let dataProducer;
-//	if (producerId) {
-//		producer = this->_producers.get(producerId);
-//		if (!producer)
-//			throw new TypeError("Producer not found");
-//	}
-//	else if (dataProducerId) {
-//		dataProducer = this->_dataProducers.get(dataProducerId);
-//		if (!dataProducer)
-//			throw new TypeError("DataProducer not found");
-//	}
-//	const pipeTransportPairKey = router.id;
-//	let pipeTransportPairPromise = this->_mapRouterPairPipeTransportPairPromise.get(pipeTransportPairKey);
-//	let pipeTransportPair;
-//	let localPipeTransport;
-//	let remotePipeTransport;
-//	if (pipeTransportPairPromise) {
-//		pipeTransportPair = co_await pipeTransportPairPromise;
-//		localPipeTransport = pipeTransportPair[this.id];
-//		remotePipeTransport = pipeTransportPair[router.id];
-//	}
-//	else {
-//		pipeTransportPairPromise = new Promise((resolve, reject) = > {
-//			Promise.all([
-//				this.createPipeTransport({ listenIp, enableSctp, numSctpStreams, enableRtx, enableSrtp }),
-//					router.createPipeTransport({ listenIp, enableSctp, numSctpStreams, enableRtx, enableSrtp })
-//			])
-//				.then((pipeTransports) = > {
-//					localPipeTransport = pipeTransports[0];
-//					remotePipeTransport = pipeTransports[1];
-//				})
-//					.then(() = > {
-//					return Promise.all([
-//						localPipetransport->connect({
-//							ip: remotePipetransport->tuple.localIp,
-//							port : remotePipetransport->tuple.localPort,
-//							srtpParameters : remotePipetransport->srtpParameters
-//							}),
-//							remotePipetransport->connect({
-//								ip: localPipetransport->tuple.localIp,
-//								port : localPipetransport->tuple.localPort,
-//								srtpParameters : localPipetransport->srtpParameters
-//								})
-//					]);
-//				})
-//					.then(() = > {
-//					localPipetransport->observer.on("close", () = > {
-//						remotePipetransport->close();
-//						this->_mapRouterPairPipeTransportPairPromise.delete(pipeTransportPairKey);
-//					});
-//					remotePipetransport->observer.on("close", () = > {
-//						localPipetransport->close();
-//						this->_mapRouterPairPipeTransportPairPromise.delete(pipeTransportPairKey);
-//					});
-//					resolve({
-//						[this.id] : localPipeTransport,
-//						[router.id] : remotePipeTransport
-//						});
-//				})
-//					.catch ((error) = > {
-//					logger.error("pipeToRouter() | error creating PipeTransport pair:%o", error);
-//					if (localPipeTransport)
-//						localPipetransport->close();
-//					if (remotePipeTransport)
-//						remotePipetransport->close();
-//					reject(error);
-//				});
-//		});
-//		this->_mapRouterPairPipeTransportPairPromise.set(pipeTransportPairKey, pipeTransportPairPromise);
-//		router.addPipeTransportPair(this.id, pipeTransportPairPromise);
-//		co_await pipeTransportPairPromise;
-//	}
-//	if (producer) {
-//		let pipeConsumer;
-//		let pipeProducer;
-//		try {
-//			pipeConsumer = co_await localPipetransport->consume({
-//				producerId: producerId
-//				});
-//			pipeProducer = co_await remotePipetransport->produce({
-//				id: producer.id,
-//				kind : pipeConsumer.kind,
-//				rtpParameters : pipeConsumer.rtpParameters,
-//				paused : pipeConsumer.producerPaused,
-//				appData : producer.appData
-//				});
-//			// Ensure that the producer has not been closed in the meanwhile.
-//			if (producer.closed)
-//				throw new errors_1.InvalidStateError("original Producer closed");
-//			// Ensure that producer.paused has not changed in the meanwhile and, if
-//			// so, sych the pipeProducer.
-//			if (pipeProducer.paused != = producer.paused) {
-//				if (producer.paused)
-//					co_await pipeProducer.pause();
-//				else
-//					co_await pipeProducer.resume();
-//			}
-//			// Pipe events from the pipe Consumer to the pipe Producer.
-//			pipeConsumer.observer.on("close", () = > pipeProducer.close());
-//			pipeConsumer.observer.on("pause", () = > pipeProducer.pause());
-//			pipeConsumer.observer.on("resume", () = > pipeProducer.resume());
-//			// Pipe events from the pipe Producer to the pipe Consumer.
-//			pipeProducer.observer.on("close", () = > pipeConsumer.close());
-//			return { pipeConsumer, pipeProducer };
-//		}
-//		catch (error) {
-//			logger.error("pipeToRouter() | error creating pipe Consumer/Producer pair:%o", error);
-//			if (pipeConsumer)
-//				pipeConsumer.close();
-//			if (pipeProducer)
-//				pipeProducer.close();
-//			throw error;
-//		}
-//	}
-//	else if (dataProducer) {
-//		let pipeDataConsumer;
-//		let pipeDataProducer;
-//		try {
-//			pipeDataConsumer = co_await localPipetransport->consumeData({
-//				dataProducerId: dataProducerId
-//				});
-//			pipeDataProducer = co_await remotePipetransport->produceData({
-//				id: dataProducer.id,
-//				sctpStreamParameters : pipeDataConsumer.sctpStreamParameters,
-//				label : pipeDataConsumer.label,
-//				protocol : pipeDataConsumer.protocol,
-//				appData : dataProducer.appData
-//				});
-//			// Ensure that the dataProducer has not been closed in the meanwhile.
-//			if (dataProducer.closed)
-//				throw new errors_1.InvalidStateError("original DataProducer closed");
-//			// Pipe events from the pipe DataConsumer to the pipe DataProducer.
-//			pipeDataConsumer.observer.on("close", () = > pipeDataProducer.close());
-//			// Pipe events from the pipe DataProducer to the pipe DataConsumer.
-//			pipeDataProducer.observer.on("close", () = > pipeDataConsumer.close());
-//			return { pipeDataConsumer, pipeDataProducer };
-//		}
-//		catch (error) {
-//			logger.error("pipeToRouter() | error creating pipe DataConsumer/DataProducer pair:%o", error);
-//			if (pipeDataConsumer)
-//				pipeDataConsumer.close();
-//			if (pipeDataProducer)
-//				pipeDataProducer.close();
-//			throw error;
-//		}
-//	}
-//	else {
-//		throw new Error("internal error");
-//	}
-//}
-//
-//addPipeTransportPair(pipeTransportPairKey, pipeTransportPairPromise) {
-//	if (this->_mapRouterPairPipeTransportPairPromise.has(pipeTransportPairKey)) {
-//		throw new Error("given pipeTransportPairKey already exists in this Router");
-//	}
-//	this->_mapRouterPairPipeTransportPairPromise.set(pipeTransportPairKey, pipeTransportPairPromise);
-//	pipeTransportPairPromise
-//		.then((pipeTransportPair) = > {
-//		const localPipeTransport = pipeTransportPair[this.id];
-//		// NOTE: No need to do any other cleanup here since that is done by the
-//		// Router calling this method on us.
-//		localPipetransport->observer.on("close", () = > {
-//			this->_mapRouterPairPipeTransportPairPromise.delete(pipeTransportPairKey);
-//		});
-//	})
-//		.catch (() = > {
-//		this->_mapRouterPairPipeTransportPairPromise.delete(pipeTransportPairKey);
-//	});
-//}
+async_simple::coro::Lazy<PipeToRouterResult> Router::pipeToRouter(const PipeToRouterOptions& options)
+{
+	MSC_DEBUG("pipeToRouter()");
+
+	const std::string& producerId = options.producerId;
+	const std::string& dataProducerId = options.dataProducerId;
+	Router* router = options.router;
+
+	if (producerId.empty() && dataProducerId.empty())
+		MSC_THROW_TYPE_ERROR("missing producerId or dataProducerId");
+	else if (!producerId.empty() && !dataProducerId.empty())
+		MSC_THROW_TYPE_ERROR("just producerId or dataProducerId can be given");
+	else if (!router)
+		MSC_THROW_TYPE_ERROR("Router not found");
+	else if (router == this)
+		MSC_THROW_TYPE_ERROR("cannot use this Router as destination");
+
+	Producer* producer = nullptr;
+	DataProducer* dataProducer = nullptr;
+
+	if (!producerId.empty())
+	{
+		producer = GetMapValue(this->_producers, producerId);
+
+		if (!producer)
+			MSC_THROW_TYPE_ERROR("Producer not found");
+	}
+	else
+	{
+		dataProducer = GetMapValue(this->_dataProducers, dataProducerId);
+
+		if (!dataProducer)
+			MSC_THROW_TYPE_ERROR("DataProducer not found");
+	}
+
+	PipeTransportPair pipeTransportPair = co_await this->_getPipeTransportPair(options);
+	PipeTransport* localPipeTransport = pipeTransportPair[this->id()];
+	PipeTransport* remotePipeTransport = pipeTransportPair[router->id()];
+
+	PipeToRouterResult result;
+
+	if (producer)
+	{
+		Consumer* pipeConsumer = nullptr;
+		Producer* pipeProducer = nullptr;
+
+		try
+		{
+			ConsumerOptions consumerOptions;
+			consumerOptions.producerId = producerId;
+
+			pipeConsumer = co_await localPipeTransport->consume(consumerOptions);
+
+			pipeProducer = co_await remotePipeTransport->produce(
+				producer->id(),
+				pipeConsumer->kind(),
+				pipeConsumer->rtpParameters(),
+				pipeConsumer->producerPaused(),
+				0,
+				producer->appData());
+
+			// Ensure that the producer has not been closed in the meanwhile.
+			if (producer->closed())
+				MSC_THROW_INVALID_STATE_ERROR("original Producer closed");
+
+			// Ensure that producer.paused has not changed in the meanwhile and, if
+			// so, sync the pipeProducer.
+			if (pipeProducer->paused() != producer->paused())
+			{
+				if (producer->paused())
+					co_await pipeProducer->pause();
+				else
+					co_await pipeProducer->resume();
+			}
+
+			// Pipe events from the pipe Consumer to the pipe Producer.
+			pipeConsumer->observer()->on("close", [=]() { pipeProducer->close(); });
+			pipeConsumer->observer()->on("pause", [=]() { pipeProducer->pause().start([](auto&&) {}); });
+			pipeConsumer->observer()->on("resume", [=]() { pipeProducer->resume().start([](auto&&) {}); });
+
+			// Pipe events from the pipe Producer to the pipe Consumer.
+			pipeProducer->observer()->on("close", [=]() { pipeConsumer->close(); });
+		}
+		catch (std::exception& error)
+		{
+			MSC_ERROR("pipeToRouter() | error creating pipe Consumer/Producer pair:%s", error.what());
+
+			if (pipeConsumer)
+				pipeConsumer->close();
+
+			if (pipeProducer)
+				pipeProducer->close();
+
+			throw;
+		}
+
+		result.pipeConsumer = pipeConsumer;
+		result.pipeProducer = pipeProducer;
+	}
+	else
+	{
+		DataConsumer* pipeDataConsumer = nullptr;
+		DataProducer* pipeDataProducer = nullptr;
+
+		try
+		{
+			DataConsumerOptions dataConsumerOptions;
+			dataConsumerOptions.dataProducerId = dataProducerId;
+
+			pipeDataConsumer = co_await localPipeTransport->consumeData(dataConsumerOptions);
+
+			DataProducerOptions dataProducerOptions;
+			dataProducerOptions.id = dataProducer->id();
+			dataProducerOptions.sctpStreamParameters = pipeDataConsumer->sctpStreamParameters();
+			dataProducerOptions.label = pipeDataConsumer->label();
+			dataProducerOptions.protocol = pipeDataConsumer->protocol();
+			dataProducerOptions.appData = dataProducer->appData();
+
+			pipeDataProducer = co_await remotePipeTransport->produceData(dataProducerOptions);
+
+			// Ensure that the dataProducer has not been closed in the meanwhile.
+			if (dataProducer->closed())
+				MSC_THROW_INVALID_STATE_ERROR("original DataProducer closed");
+
+			// Pipe events from the pipe DataConsumer to the pipe DataProducer.
+			pipeDataConsumer->observer()->on("close", [=]() { pipeDataProducer->close(); });
+
+			// Pipe events from the pipe DataProducer to the pipe DataConsumer.
+			pipeDataProducer->observer()->on("close", [=]() { pipeDataConsumer->close(); });
+		}
+		catch (std::exception& error)
+		{
+			MSC_ERROR(
+				"pipeToRouter() | error creating pipe DataConsumer/DataProducer pair:%s", error.what());
+
+			if (pipeDataConsumer)
+				pipeDataConsumer->close();
+
+			if (pipeDataProducer)
+				pipeDataProducer->close();
+
+			throw;
+		}
+
+		result.pipeDataConsumer = pipeDataConsumer;
+		result.pipeDataProducer = pipeDataProducer;
+	}
+
+	co_return result;
+}
+
+async_simple::coro::Lazy<PipeTransportPair> Router::_getPipeTransportPair(const PipeToRouterOptions& options)
+{
+	Router* router = options.router;
+	std::string pipeTransportPairKey = router->id();
+
+	// The pair is being created by another pipeToRouter() call (in this Router
+	// or in the other one), so wait for it.
+	if (this->_mapRouterPairPipeTransportPair.count(pipeTransportPairKey))
+	{
+		std::shared_ptr<PipeTransportPairEntry> entry =
+			this->_mapRouterPairPipeTransportPair.at(pipeTransportPairKey);
+
+		if (!entry->ready)
+		{
+			async_simple::Promise<bool> waiter;
+			auto future = waiter.getFuture();
+
+			entry->waiters.push_back(std::move(waiter));
+
+			// This throws if the pair could not be created.
+			co_await std::move(future);
+		}
+
+		co_return entry->pair;
+	}
+
+	auto entry = std::make_shared<PipeTransportPairEntry>();
+	std::string routerId = this->id();
+
+	this->_mapRouterPairPipeTransportPair[pipeTransportPairKey] = entry;
+	router->_mapRouterPairPipeTransportPair[routerId] = entry;
+
+	PipeTransport* localPipeTransport = nullptr;
+	PipeTransport* remotePipeTransport = nullptr;
+
+	try
+	{
+		localPipeTransport = co_await this->createPipeTransport(
+			options.listenIp,
+			options.enableSctp,
+			options.numSctpStreams,
+			1073741823,
+			options.enableRtx,
+			options.enableSrtp,
+			json(),
+			options.inProcess);
+
+		remotePipeTransport = co_await router->createPipeTransport(
+			options.listenIp,
+			options.enableSctp,
+			options.numSctpStreams,
+			1073741823,
+			options.enableRtx,
+			options.enableSrtp,
+			json(),
+			options.inProcess);
+
+		if (options.inProcess)
+		{
+			co_await localPipeTransport->connectInProcess(remotePipeTransport->id());
+
+			co_await remotePipeTransport->connectInProcess(localPipeTransport->id());
+		}
+		else
+		{
+			TransportTuple localTuple = localPipeTransport->tuple();
+			TransportTuple remoteTuple = remotePipeTransport->tuple();
+			SrtpParameters localSrtpParameters = localPipeTransport->srtpParameters();
+			SrtpParameters remoteSrtpParameters = remotePipeTransport->srtpParameters();
+
+			co_await localPipeTransport->connect(
+				remoteTuple.localIp, remoteTuple.localPort, remoteSrtpParameters);
+
+			co_await remotePipeTransport->connect(
+				localTuple.localIp, localTuple.localPort, localSrtpParameters);
+		}
+	}
+	catch (std::exception& error)
+	{
+		MSC_ERROR("pipeToRouter() | error creating PipeTransport pair:%s", error.what());
+
+		this->_mapRouterPairPipeTransportPair.erase(pipeTransportPairKey);
+		router->_mapRouterPairPipeTransportPair.erase(routerId);
+
+		if (localPipeTransport)
+			localPipeTransport->close();
+
+		if (remotePipeTransport)
+			remotePipeTransport->close();
+
+		for (auto& waiter : entry->waiters)
+		{
+			waiter.setException(std::current_exception());
+		}
+
+		throw;
+	}
+
+	// Closing any of the PipeTransports closes the pair.
+	localPipeTransport->observer()->on("close", [=]()
+	{
+		remotePipeTransport->close();
+		this->_mapRouterPairPipeTransportPair.erase(pipeTransportPairKey);
+		router->_mapRouterPairPipeTransportPair.erase(routerId);
+	});
+
+	remotePipeTransport->observer()->on("close", [=]()
+	{
+		localPipeTransport->close();
+		this->_mapRouterPairPipeTransportPair.erase(pipeTransportPairKey);
+		router->_mapRouterPairPipeTransportPair.erase(routerId);
+	});
+
+	entry->pair = {
+		{ routerId, localPipeTransport },
+		{ pipeTransportPairKey, remotePipeTransport }
+	};
+	entry->ready = true;
+
+	for (auto& waiter : entry->waiters)
+	{
+		waiter.setValue(true);
+	}
+
+	entry->waiters.clear();
+
+	co_return entry->pair;
+}
 
 async_simple::coro::Lazy<ActiveSpeakerObserver*> Router::createActiveSpeakerObserver(const ActiveSpeakerObserverOptions& options)
 {
@@ -24,6 +24,83 @@ struct WebRtcTransportOptions;
 struct AudioLevelObserverOptions;
 struct ActiveSpeakerObserverOptions;
 
+struct PipeToRouterOptions
+{
+	/**
+	 * The id of the Producer to consume.
+	 */
+	std::string producerId;
+
+	/**
+	 * The id of the DataProducer to consume.
+	 */
+	std::string dataProducerId;
+
+	/**
+	 * Target Router instance.
+	 */
+	Router* router{ nullptr };
+
+	/**
+	 * IP used in the PipeTransport pair. Default "127.0.0.1".
+	 */
+	json listenIp = "127.0.0.1";
+
+	/**
+	 * Create a SCTP association. Default true.
+	 */
+	bool enableSctp = true;
+
+	/**
+	 * SCTP streams number.
+	 */
+	json numSctpStreams = { { "OS", 1024 }, { "MIS", 1024 } };
+
+	/**
+	 * Enable RTX and NACK for RTP retransmission.
+	 */
+	bool enableRtx = false;
+
+	/**
+	 * Enable SRTP.
+	 */
+	bool enableSrtp = false;
+
+	/**
+	 * Pass the packets through memory rather than through UDP. Both Routers
+	 * must belong to Workers running in this process. Default false.
+	 */
+	bool inProcess = false;
+};
+
+struct PipeToRouterResult
+{
+	/**
+	 * The Consumer created in the current Router.
+	 */
+	Consumer* pipeConsumer{ nullptr };
+
+	/**
+	 * The Producer created in the target Router.
+	 */
+	Producer* pipeProducer{ nullptr };
+
+	/**
+	 * The DataConsumer created in the current Router.
+	 */
+	DataConsumer* pipeDataConsumer{ nullptr };
+
+	/**
+	 * The DataProducer created in the target Router.
+	 */
+	DataProducer* pipeDataProducer{ nullptr };
+};
+
+/**
+ * PipeTransports connecting two Routers, indexed by Router id.
+ */
+using PipeTransportPair = std::map<std::string, PipeTransport*>;
+
 
 class MS_EXPORT Router : public EnhancedEventEmitter
 {
@@ -111,7 +188,8 @@ public:
 		uint32_t maxSctpMessageSize = 1073741823,
 		bool enableRtx = false,
 		bool enableSrtp = false,
-		json appData = json()
+		json appData = json(),
+		bool inProcess = false
 	);
 	/**
 	 * Create a DirectTransport.
@@ -120,11 +198,7 @@ public:
 	/**
 	 * Pipes the given Producer or DataProducer into another Router in same host.
 	 */
-	//pipeToRouter({ producerId, dataProducerId, router, listenIp, enableSctp, numSctpStreams, enableRtx, enableSrtp }: PipeToRouterOptions) : Promise<PipeToRouterResult>;
-	/**
-	 * @private
-	 */
-	//addPipeTransportPair(pipeTransportPairKey: string, pipeTransportPairPromise : Promise<PipeTransportPair>) : void;
+	async_simple::coro::Lazy<PipeToRouterResult> pipeToRouter(const PipeToRouterOptions& options);
 	/**
 	 * Create an ActiveSpeakerObserver
 	 */
@@ -138,6 +212,13 @@ public:
 	 */
 	bool canConsume(std::string producerId, json& rtpCapabilities);
 
+private:
+	/**
+	 * Get or create the PipeTransport pair connecting this Router with the
+	 * given one.
+	 */
+	async_simple::coro::Lazy<PipeTransportPair> _getPipeTransportPair(const PipeToRouterOptions& options);
+
 private:
 	// Internal data.
 	json _internal;
@@ -159,9 +240,17 @@ private:
 	std::map<std::string, RtpObserver*> _rtpObservers;
 	// DataProducers map.
 	std::map<std::string, DataProducer*> _dataProducers;
-	// Map of PipeTransport pair Promises indexed by the id of the Router in
-	// which pipeToRouter() was called.
-	//std::map<std::string, DataProducer*> _mapRouterPairPipeTransportPairPromise;
+	// PipeTransport pair shared by the two Routers it connects. It's ready once
+	// both PipeTransports are connected.
+	struct PipeTransportPairEntry
+	{
+		PipeTransportPair pair;
+		bool ready = false;
+		// pipeToRouter() calls waiting for the pair to be ready.
+		std::vector<async_simple::Promise<bool>> waiters;
+	};
+	// Map of PipeTransport pairs indexed by the id of the other Router.
+	std::map<std::string, std::shared_ptr<PipeTransportPairEntry>> _mapRouterPairPipeTransportPair;
 	// Observer instance.
 	EnhancedEventEmitter* _observer;
 };
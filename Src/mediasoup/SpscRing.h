@@ -0,0 +1,98 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+
+namespace mediasoup {
+
+/**
+ * Bounded lock-free ring of pre-allocated slots shared by exactly one
+ * producer thread and one consumer thread.
+ *
+ * The producer fills the slot returned by Prepare() and publishes it with
+ * Commit(). The consumer reads the slot returned by Front() and moves past it
+ * with Pop(). A popped slot keeps belonging to the consumer until Release(),
+ * so its storage may be handed out (e.g. to the worker) and given back later.
+ * Slots are released in the same order they were popped.
+ *
+ * Slot objects are never destroyed while the ring lives, so members such as
+ * std::string keep their capacity and are reused by the next message.
+ */
+template<typename T, size_t Capacity>
+class SpscRing
+{
+	static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+public:
+	/* Producer side. */
+
+	// Returns the next free slot or nullptr if the ring is full.
+	T* Prepare()
+	{
+		size_t head = this->_head.load(std::memory_order_relaxed);
+
+		if (head - this->_tail.load(std::memory_order_acquire) == Capacity)
+			return nullptr;
+
+		return std::addressof(this->_slots[head & (Capacity - 1)]);
+	}
+
+	// Publishes the slot returned by the last Prepare().
+	void Commit()
+	{
+		this->_head.store(this->_head.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+	}
+
+	/* Consumer side. */
+
+	// Returns the oldest published and not yet popped slot or nullptr.
+	T* Front()
+	{
+		if (this->_read == this->_head.load(std::memory_order_acquire))
+			return nullptr;
+
+		return std::addressof(this->_slots[this->_read & (Capacity - 1)]);
+	}
+
+	void Pop()
+	{
+		++this->_read;
+	}
+
+	// Returns the oldest popped and not yet released slot.
+	T* OldestPopped()
+	{
+		return std::addressof(this->_slots[this->_tail.load(std::memory_order_relaxed) & (Capacity - 1)]);
+	}
+
+	// Gives the oldest popped slot back to the producer.
+	void Release()
+	{
+		this->_tail.store(this->_tail.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+	}
+
+	// Convenience for consumers that are done with the slot right away.
+	void PopAndRelease()
+	{
+		Pop();
+		Release();
+	}
+
+	bool Empty()
+	{
+		return this->_read == this->_head.load(std::memory_order_acquire);
+	}
+
+private:
+	// Written by the producer only.
+	alignas(64) std::atomic<size_t> _head{ 0 };
+	// Written by the consumer only.
+	alignas(64) std::atomic<size_t> _tail{ 0 };
+	// Consumer local read cursor (_tail <= _read <= _head).
+	alignas(64) size_t _read{ 0 };
+	alignas(64) std::array<T, Capacity> _slots;
+};
+
+}
@@ -31,6 +31,12 @@ struct WebRtcServerListenInfo
 	 */
 	uint16_t port;
 
+	/**
+	 * Share the UDP port with the WebRtcServers of other Workers (SO_REUSEPORT,
+	 * Linux only). Requires a port and WebRtcServerOptions.reusePortIndex.
+	 */
+	bool reusePort{ false };
+
 	WebRtcServerListenInfo(const json& listenInfo)
 	{
 		this->protocol = listenInfo.value("protocol", "");
@@ -40,6 +46,7 @@ struct WebRtcServerListenInfo
 			this->announcedIp = listenInfo.value("announcedIp", "");
 		}
 		this->port = listenInfo.value("port", 0);
+		this->reusePort = listenInfo.value("reusePort", false);
 	}
 
 	operator json() const 
@@ -53,6 +60,9 @@ struct WebRtcServerListenInfo
 		if (announcedIp.has_value())
 			data["announcedIp"] = announcedIp.value();
 
+		if (reusePort)
+			data["reusePort"] = true;
+
 		return data;
 	}
 };
@@ -64,12 +74,24 @@ struct WebRtcServerOptions
 		{
 			this->listenInfos.push_back(WebRtcServerListenInfo(listenInfo));
 		}
+
+		if (options.contains("reusePortIndex"))
+		{
+			this->reusePortIndex = options["reusePortIndex"].get<uint8_t>();
+		}
 	}
 	/**
 	 * Listen infos.
 	 */
 	std::list<WebRtcServerListenInfo> listenInfos;
 
+	/**
+	 * Index of this WebRtcServer among the ones sharing ports (listenInfos with
+	 * reusePort). Servers must be created in index order, starting at 0, since
+	 * the kernel orders the sockets of a shared port by creation.
+	 */
+	std::optional<uint8_t> reusePortIndex;
+
 	/**
 	 * Custom application data.
 	 */
@@ -11,6 +11,7 @@
 #include "ortc.h"
 #include "PayloadChannel.h"
 #include "WebRtcServer.h"
+#include "WorkerStats.h"
 #include "Utils.h"
 #include "Worker/WorkerNative.h"
 #include "Worker/WorkerOrigin.h"
@@ -38,6 +39,7 @@ Worker* Worker::Create(json settings, bool native)
 	uint32_t rtcMaxPort = settings.value("rtcMaxPort", 0);
 	std::string dtlsCertificateFile = settings.value("dtlsCertificateFile", "");
 	std::string dtlsPrivateKeyFile = settings.value("dtlsPrivateKeyFile", "");
+	std::string channelFormat = settings.value("channelFormat", "");
 
 	if (!logLevel.empty())
 		spawnArgs.push_back(Utils::Printf("--logLevel=%s", logLevel.c_str()));
@@ -60,13 +62,19 @@ Worker* Worker::Create(json settings, bool native)
 	if (!dtlsPrivateKeyFile.empty())
 		spawnArgs.push_back(Utils::Printf("--dtlsPrivateKeyFile=%s", dtlsPrivateKeyFile.c_str()));
 
+	if (!channelFormat.empty())
+		spawnArgs.push_back(Utils::Printf("--channelFormat=%s", channelFormat.c_str()));
+
 	worker->init(spawnArgs);
 
+	worker->_channel->setBinaryFormat(channelFormat == "binary");
+
 	return worker;
 }
 
 Worker::Worker(json settings)
 	: _observer(new EnhancedEventEmitter())
+	, _stats(new WorkerStats())
 {
 	MSC_DEBUG("constructor()");
 }
@@ -75,6 +83,9 @@ Worker::~Worker()
 {
 	delete _observer;
 	_observer = nullptr;
+
+	delete _stats;
+	_stats = nullptr;
 }
 
 uint32_t Worker::pid() {
@@ -157,6 +168,70 @@ async_simple::coro::Lazy<json> Worker::getResourceUsage()
 	co_return ret;
 }
 
+async_simple::coro::Lazy<json> Worker::getMetrics(bool reset/* = false*/)
+{
+	MSC_DEBUG("getMetrics()");
+
+	json reqData = { { "reset", reset } };
+
+	json ret = co_await this->_channel->request("worker.getMetrics", undefined, reqData);
+
+	co_return ret;
+}
+
+async_simple::coro::Lazy<void> Worker::subscribeStats(uint32_t intervalMs)
+{
+	MSC_DEBUG("subscribeStats()");
+
+	// Stop listening to the previous subscription.
+	if (!this->_statsSubscriptionId.empty())
+	{
+		this->_payloadChannel->removeAllListeners(this->_statsSubscriptionId);
+		this->_statsSubscriptionId.clear();
+	}
+
+	json reqData = { { "intervalMs", intervalMs } };
+
+	if (intervalMs > 0)
+	{
+		this->_statsSubscriptionId = uuidv4();
+		reqData["subscriptionId"] = this->_statsSubscriptionId;
+
+		this->_payloadChannel->on(
+			this->_statsSubscriptionId,
+			[=](std::string event, json data, const uint8_t* payload, size_t payloadLen)
+			{
+				if (event == "stats")
+				{
+					json changed = json::array();
+					json removed = json::array();
+
+					if (!this->_stats->apply(payload, payloadLen, changed, removed))
+						return;
+
+					json stats = {
+						{ "timestamp", this->_stats->timestamp() },
+						{ "changed", changed },
+						{ "removed", removed }
+					};
+
+					this->safeEmit("stats", stats);
+				}
+				else
+				{
+					MSC_ERROR("ignoring unknown event \"%s\" in payload channel listener", event.c_str());
+				}
+			});
+	}
+
+	co_await this->_channel->request("worker.subscribeStats", undefined, reqData);
+}
+
+json Worker::stats()
+{
+	return this->_stats->dump();
+}
+
 async_simple::coro::Lazy<void> Worker::updateSettings(std::string logLevel, std::vector<std::string> logTags)
 {
 	MSC_DEBUG("updateSettings()");
@@ -182,6 +257,9 @@ async_simple::coro::Lazy<WebRtcServer*> Worker::createWebRtcServer(const WebRtcS
 		{ "listenInfos", options.listenInfos }
 	};
 
+	if (options.reusePortIndex.has_value())
+		reqData["reusePortIndex"] = options.reusePortIndex.value();
+
 	co_await this->_channel->request("worker.createWebRtcServer", undefined, reqData);
 
 	WebRtcServer* webRtcServer = new WebRtcServer(
@@ -10,6 +10,7 @@ class Channel;
 class Request;
 class SubProcess;
 class WebRtcServer;
+class WorkerStats;
 class PayloadChannel;
 
 struct WebRtcServerOptions;
@@ -69,6 +70,22 @@ public:
 	 * Get mediasoup-worker process resource usage.
 	 */
 	async_simple::coro::Lazy<json> getResourceUsage();
+	/**
+	 * Get the forwarding latency histograms of the worker. If reset is given
+	 * a new measuring period starts after this one.
+	 */
+	async_simple::coro::Lazy<json> getMetrics(bool reset = false);
+	/**
+	 * Subscribe to the counters of every Transport, RTP stream, DataProducer
+	 * and DataConsumer of the worker. Every intervalMs the worker sends the
+	 * ones that changed and the "stats" event is emitted with them. Zero
+	 * unsubscribes.
+	 */
+	async_simple::coro::Lazy<void> subscribeStats(uint32_t intervalMs);
+	/**
+	 * Current counters received since subscribeStats() was called.
+	 */
+	json stats();
 	/**
 	 * Update settings.
 	 */
@@ -108,6 +125,10 @@ protected:
 	std::set<Router*> _routers;
 	// Observer instance.
 	EnhancedEventEmitter* _observer{ nullptr };
+	// Stats received from the worker.
+	WorkerStats* _stats{ nullptr };
+	// Id of the current stats subscription.
+	std::string _statsSubscriptionId;
 };
 
 }
@@ -2,19 +2,30 @@
 
 #include "common.h"
 #include "WorkerNative.h"
+#include "Logger.h"
 #include "Channel/ChannelNative.h"
 #include "PayloadChannel/PayloadChannelNative.h"
+#ifndef _WIN32
+#include <pthread.h>
+#endif
 
 namespace mediasoup {
 
 WorkerNative::WorkerNative(json settings)
 	: Worker(settings)
 {
-	
+	this->_cpuAffinity = settings.value("cpuAffinity", -1);
 }
 
 WorkerNative::~WorkerNative()
 {
+	// The worker thread ends the process when mediasoup_worker_run() returns,
+	// so it is never joined.
+	if (_work_thread.joinable())
+	{
+		_work_thread.detach();
+	}
+
 	if (_channel)
 	{
 		delete _channel;
@@ -33,7 +44,9 @@ void WorkerNative::init(AStringVector spawnArgs)
 	_channel = new ChannelNative;
 	_payloadChannel = new PayloadChannelNative;
 
+	// getopt() skips argv[0], so provide a program name as a real process would.
 	std::vector<char*> vecArgs;
+	vecArgs.push_back(strdup("mediasoup-worker"));
 	for (std::string spawnArg : spawnArgs)
 	{
 		vecArgs.push_back(strdup(spawnArg.c_str()));
@@ -67,6 +80,9 @@ void WorkerNative::init(AStringVector spawnArgs)
 			std::_Exit(42);
 		}
 	});
+
+	// Pin from this thread so a failure is logged on the main loop.
+	setThreadAffinity();
 }
 
 void WorkerNative::subClose()
@@ -74,4 +90,33 @@ void WorkerNative::subClose()
 
 }
 
+void WorkerNative::setThreadAffinity()
+{
+	if (this->_cpuAffinity < 0)
+		return;
+
+#ifdef _WIN32
+	DWORD_PTR mask = static_cast<DWORD_PTR>(1) << this->_cpuAffinity;
+
+	if (SetThreadAffinityMask(_work_thread.native_handle(), mask) == 0)
+	{
+		MSC_WARN("SetThreadAffinityMask() failed [cpu:%d, error:%lu]", this->_cpuAffinity, GetLastError());
+	}
+#elif defined(__linux__)
+	cpu_set_t cpuset;
+
+	CPU_ZERO(&cpuset);
+	CPU_SET(this->_cpuAffinity, &cpuset);
+
+	int err = pthread_setaffinity_np(_work_thread.native_handle(), sizeof(cpu_set_t), &cpuset);
+
+	if (err != 0)
+	{
+		MSC_WARN("pthread_setaffinity_np() failed [cpu:%d, error:%d]", this->_cpuAffinity, err);
+	}
+#else
+	MSC_WARN("worker thread CPU affinity not supported on this platform");
+#endif
+}
+
 }
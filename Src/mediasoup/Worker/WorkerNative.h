@@ -17,9 +17,14 @@ protected:
 	virtual void init(AStringVector spawnArgs) override;
 	virtual void subClose() override;
 
+private:
+	void setThreadAffinity();
+
 protected:
 	//
 	std::thread _work_thread;
+	// CPU core the worker thread is pinned to (-1 means no pinning).
+	int _cpuAffinity{ -1 };
 };
 
 }
@@ -0,0 +1,340 @@
+#define MSC_CLASS "WorkerStats"
+
+#include "common.h"
+#include "WorkerStats.h"
+#include "Logger.h"
+
+namespace mediasoup {
+
+// Must match the worker RTC::StatsPublisher.
+static const uint8_t StatsVersion = 1;
+static const uint8_t StatsFlagFull = 0x01;
+static const uint8_t RecordEntity = 1;
+static const uint8_t RecordCounters = 2;
+static const uint8_t RecordRemoved = 3;
+
+// Indexed by entry type, in the order the worker fills the counters.
+static const std::vector<std::string> TransportCounterNames =
+{
+	"bytesReceived", "recvBitrate", "bytesSent", "sendBitrate",
+	"rtpBytesReceived", "rtpRecvBitrate", "rtpBytesSent", "rtpSendBitrate",
+	"rtxBytesReceived", "rtxRecvBitrate", "rtxBytesSent", "rtxSendBitrate",
+	"probationBytesSent"
+};
+static const std::vector<std::string> RtpStreamCounterNames =
+{
+	"packetsLost", "fractionLost", "packetsDiscarded", "packetsRetransmitted",
+	"packetsRepaired", "nackCount", "nackPacketCount", "pliCount", "firCount",
+	"score", "roundTripTime", "packetCount", "byteCount", "bitrate", "jitter"
+};
+static const std::vector<std::string> DataProducerCounterNames =
+{
+	"messagesReceived", "bytesReceived"
+};
+static const std::vector<std::string> DataConsumerCounterNames =
+{
+	"messagesSent", "bytesSent", "bufferedAmount"
+};
+
+struct StatsEntryType
+{
+	const char* name;
+	const std::vector<std::string>* counterNames;
+};
+
+static const std::map<uint8_t, StatsEntryType> StatsEntryTypes =
+{
+	{ 1, { "transport",     &TransportCounterNames    } },
+	{ 2, { "inbound-rtp",   &RtpStreamCounterNames    } },
+	{ 3, { "outbound-rtp",  &RtpStreamCounterNames    } },
+	{ 4, { "data-producer", &DataProducerCounterNames } },
+	{ 5, { "data-consumer", &DataConsumerCounterNames } }
+};
+
+class StatsReader
+{
+public:
+	StatsReader(const uint8_t* data, size_t len)
+		: _data(data), _len(len)
+	{
+	}
+
+	bool readByte(uint8_t& value)
+	{
+		if (this->_pos >= this->_len)
+			return false;
+
+		value = this->_data[this->_pos++];
+
+		return true;
+	}
+
+	bool readVarint(uint64_t& value)
+	{
+		value = 0;
+
+		for (uint32_t shift = 0; shift < 64; shift += 7)
+		{
+			uint8_t byte;
+
+			if (!this->readByte(byte))
+				return false;
+
+			value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+
+			if ((byte & 0x80) == 0)
+				return true;
+		}
+
+		return false;
+	}
+
+	bool readDelta(int64_t& value)
+	{
+		uint64_t zigzag;
+
+		if (!this->readVarint(zigzag))
+			return false;
+
+		value = static_cast<int64_t>(zigzag >> 1) ^ -static_cast<int64_t>(zigzag & 1);
+
+		return true;
+	}
+
+	bool readString(std::string& value, size_t len)
+	{
+		if (this->_len - this->_pos < len)
+			return false;
+
+		value.assign(reinterpret_cast<const char*>(this->_data + this->_pos), len);
+		this->_pos += len;
+
+		return true;
+	}
+
+	bool atEnd() const
+	{
+		return this->_pos == this->_len;
+	}
+
+private:
+	const uint8_t* _data;
+	size_t _len;
+	size_t _pos{ 0 };
+};
+
+bool WorkerStats::apply(const uint8_t* data, size_t len, json& changed, json& removed)
+{
+	StatsReader reader(data, len);
+	uint8_t version;
+	uint8_t flags;
+	uint64_t seq;
+	uint64_t timestamp;
+
+	if (!reader.readByte(version) || !reader.readByte(flags) ||
+		!reader.readVarint(seq) || !reader.readVarint(timestamp))
+	{
+		MSC_ERROR("invalid stats snapshot header");
+
+		return false;
+	}
+
+	if (version != StatsVersion)
+	{
+		MSC_ERROR("unsupported stats snapshot version %" PRIu8, version);
+
+		return false;
+	}
+
+	if (flags & StatsFlagFull)
+	{
+		this->_entries.clear();
+		this->_synced = true;
+	}
+	else if (!this->_synced)
+	{
+		// Deltas are useless without the previous values.
+		return false;
+	}
+
+	this->_timestamp = timestamp;
+
+	// Keys of the changed entries, in order of appearance.
+	std::vector<uint32_t> changedKeys;
+	bool valid = true;
+
+	while (valid && !reader.atEnd())
+	{
+		uint8_t recordType;
+		uint64_t key;
+
+		if (!reader.readByte(recordType) || !reader.readVarint(key))
+		{
+			valid = false;
+
+			break;
+		}
+
+		if (recordType == RecordEntity)
+		{
+			Entry entry;
+			uint64_t ssrc;
+			uint64_t idLen;
+			uint8_t numCounters;
+
+			if (!reader.readByte(entry.type) || !reader.readVarint(ssrc) ||
+				!reader.readVarint(idLen) || !reader.readString(entry.id, idLen) ||
+				!reader.readByte(numCounters))
+			{
+				valid = false;
+
+				break;
+			}
+
+			entry.ssrc = static_cast<uint32_t>(ssrc);
+			entry.counters.resize(numCounters, 0);
+
+			this->_entries[static_cast<uint32_t>(key)] = std::move(entry);
+
+			// Reported even if all its counters are zero.
+			changedKeys.push_back(static_cast<uint32_t>(key));
+		}
+		else if (recordType == RecordCounters)
+		{
+			auto it = this->_entries.find(static_cast<uint32_t>(key));
+			uint64_t changedMask;
+
+			if (it == this->_entries.end() || !reader.readVarint(changedMask))
+			{
+				valid = false;
+
+				break;
+			}
+
+			auto& counters = it->second.counters;
+
+			for (size_t idx = 0; idx < counters.size(); ++idx)
+			{
+				if ((changedMask & (static_cast<uint64_t>(1) << idx)) == 0)
+					continue;
+
+				int64_t delta;
+
+				if (!reader.readDelta(delta))
+				{
+					valid = false;
+
+					break;
+				}
+
+				counters[idx] = static_cast<int64_t>(
+					static_cast<uint64_t>(counters[idx]) + static_cast<uint64_t>(delta));
+			}
+
+			// Counters of a new entry follow its ENTITY record.
+			if (changedKeys.empty() || changedKeys.back() != static_cast<uint32_t>(key))
+				changedKeys.push_back(static_cast<uint32_t>(key));
+		}
+		else if (recordType == RecordRemoved)
+		{
+			auto it = this->_entries.find(static_cast<uint32_t>(key));
+
+			if (it == this->_entries.end())
+			{
+				valid = false;
+
+				break;
+			}
+
+			removed.push_back(this->entryToJson(it->second));
+
+			this->_entries.erase(it);
+		}
+		else
+		{
+			valid = false;
+		}
+	}
+
+	if (!valid)
+	{
+		MSC_ERROR("invalid stats snapshot, waiting for a full one");
+
+		this->_entries.clear();
+		this->_synced = false;
+
+		return false;
+	}
+
+	for (auto key : changedKeys)
+	{
+		auto it = this->_entries.find(key);
+
+		// Removed later in the same snapshot.
+		if (it == this->_entries.end())
+			continue;
+
+		changed.push_back(this->entryToJson(it->second));
+	}
+
+	return true;
+}
+
+json WorkerStats::dump() const
+{
+	json entries = json::array();
+
+	for (auto& kv : this->_entries)
+	{
+		entries.push_back(this->entryToJson(kv.second));
+	}
+
+	return entries;
+}
+
+uint64_t WorkerStats::timestamp() const
+{
+	return this->_timestamp;
+}
+
+json WorkerStats::entryToJson(const Entry& entry) const
+{
+	json jsonEntry = json::object();
+	const std::vector<std::string>* counterNames = nullptr;
+	auto typeIt = StatsEntryTypes.find(entry.type);
+
+	if (typeIt != StatsEntryTypes.end())
+	{
+		jsonEntry["type"] = typeIt->second.name;
+		counterNames = typeIt->second.counterNames;
+	}
+	else
+	{
+		jsonEntry["type"] = "unknown";
+	}
+
+	jsonEntry["id"] = entry.id;
+	jsonEntry["timestamp"] = this->_timestamp;
+
+	if (entry.ssrc != 0)
+		jsonEntry["ssrc"] = entry.ssrc;
+
+	for (size_t idx = 0; idx < entry.counters.size(); ++idx)
+	{
+		// Counters added by a newer worker.
+		if (!counterNames || idx >= counterNames->size())
+			break;
+
+		auto& name = (*counterNames)[idx];
+
+		// Sent in microseconds.
+		if (name == "roundTripTime")
+			jsonEntry[name] = static_cast<double>(entry.counters[idx]) / 1000;
+		else
+			jsonEntry[name] = entry.counters[idx];
+	}
+
+	return jsonEntry;
+}
+
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+namespace mediasoup {
+
+/**
+ * @private
+ * Decodes the binary stats snapshots sent by the worker (see the worker
+ * RTC::StatsPublisher) and keeps the current counters of every entry.
+ */
+class WorkerStats
+{
+public:
+	/**
+	 * Apply a snapshot. The entries whose counters changed are appended to
+	 * changed (with all their current counters) and the closed ones to
+	 * removed. Returns false if the snapshot is malformed, in which case
+	 * the state is dropped until the next full snapshot.
+	 */
+	bool apply(const uint8_t* data, size_t len, json& changed, json& removed);
+	/**
+	 * Current counters of every entry.
+	 */
+	json dump() const;
+	/**
+	 * Timestamp (ms) of the last applied snapshot.
+	 */
+	uint64_t timestamp() const;
+
+private:
+	struct Entry
+	{
+		uint8_t type{ 0 };
+		std::string id;
+		uint32_t ssrc{ 0 };
+		std::vector<int64_t> counters;
+	};
+
+private:
+	json entryToJson(const Entry& entry) const;
+
+private:
+	// Entries indexed by key.
+	std::map<uint32_t, Entry> _entries;
+	// Whether a full snapshot has been applied.
+	bool _synced = false;
+	// Timestamp of the last snapshot.
+	uint64_t _timestamp{ 0 };
+};
+
+}
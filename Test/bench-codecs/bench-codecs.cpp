@@ -0,0 +1,187 @@
+// bench-codecs.cpp : Codec payload parsing benchmark.
+//
+// Parses RTP packets of every codec the Worker inspects (VP8, VP9, H264,
+// H264_SVC and Opus) and runs RTC::Codecs::Tools::ProcessRtpPacket() on
+// them, as the Producer does for every received packet, and reports the
+// time and the heap allocations per packet. Packet instances come from the
+// Worker RtpPacketPool, so once warmed up any allocation left belongs to the
+// codec payload descriptor handling.
+//
+// Usage:
+//   bench-codecs [--packets=N]
+
+#define MS_CLASS "bench-codecs"
+
+#include "RTC/Codecs/Tools.hpp"
+#include "RTC/RtpDictionaries.hpp"
+#include "RTC/RtpPacket.hpp"
+#include "bench-options.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <string>
+#include <vector>
+
+// Counts the heap allocations of the process.
+static uint64_t allocations{ 0u };
+
+void* operator new(size_t size)
+{
+	++allocations;
+
+	if (void* ptr = std::malloc(size == 0u ? 1u : size))
+		return ptr;
+
+	throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept
+{
+	std::free(ptr);
+}
+
+void operator delete(void* ptr, size_t /*size*/) noexcept
+{
+	std::free(ptr);
+}
+
+struct Options
+{
+	uint32_t packets{ 1000000 };
+};
+
+struct Codec
+{
+	const char* name;
+	RTC::RtpCodecMimeType::Type type;
+	RTC::RtpCodecMimeType::Subtype subtype;
+	// Start of the payload (the rest is filled with 0xAB).
+	std::vector<uint8_t> payload;
+	size_t payloadLength;
+};
+
+static Options options;
+
+// clang-format off
+static const std::vector<Codec> Codecs =
+{
+	{
+		"VP8",
+		RTC::RtpCodecMimeType::Type::VIDEO,
+		RTC::RtpCodecMimeType::Subtype::VP8,
+		// X=1 S=1, I=1 L=1 T=1, two bytes PictureID, TL0PICIDX, TID=1, VP8
+		// payload header (inter frame).
+		{ 0x90, 0xE0, 0x80, 0x01, 0x05, 0x40, 0x01 },
+		1000
+	},
+	{
+		"VP9",
+		RTC::RtpCodecMimeType::Type::VIDEO,
+		RTC::RtpCodecMimeType::Subtype::VP9,
+		// I=1 P=1 L=1 B=1, two bytes PictureID, TID=1 SID=1, TL0PICIDX.
+		{ 0xE8, 0x80, 0x01, 0x22, 0x05 },
+		1000
+	},
+	{
+		"H264",
+		RTC::RtpCodecMimeType::Type::VIDEO,
+		RTC::RtpCodecMimeType::Subtype::H264,
+		// FU-A of a non IDR slice.
+		{ 0x7C, 0x81 },
+		1000
+	},
+	{
+		"H264_SVC",
+		RTC::RtpCodecMimeType::Type::VIDEO,
+		RTC::RtpCodecMimeType::Subtype::H264_SVC,
+		// Prefix NAL unit with its SVC extension (SID=1, TID=1).
+		{ 0x6E, 0x00, 0x10, 0x20 },
+		1000
+	},
+	{
+		"OPUS",
+		RTC::RtpCodecMimeType::Type::AUDIO,
+		RTC::RtpCodecMimeType::Subtype::OPUS,
+		// TOC (SILK 20 ms, one frame).
+		{ 0x78 },
+		80
+	}
+};
+// clang-format on
+
+// Writes the packet and returns its length.
+static size_t writePacket(uint8_t* buffer, const Codec& codec)
+{
+	// clang-format off
+	const uint8_t header[] =
+	{
+		0x80, 0x65, 0x00, 0x01, // V=2, PT=101, seq.
+		0x00, 0x00, 0x03, 0xE8, // Timestamp.
+		0x11, 0x22, 0x33, 0x44  // SSRC.
+	};
+	// clang-format on
+
+	std::memcpy(buffer, header, sizeof(header));
+	std::memset(buffer + sizeof(header), 0xAB, codec.payloadLength);
+	std::memcpy(buffer + sizeof(header), codec.payload.data(), codec.payload.size());
+
+	return sizeof(header) + codec.payloadLength;
+}
+
+static void run(const Codec& codec)
+{
+	RTC::RtpCodecMimeType mimeType;
+
+	mimeType.type    = codec.type;
+	mimeType.subtype = codec.subtype;
+
+	std::vector<uint8_t> buffer(RTC::MtuSize + 100);
+	const size_t len = writePacket(buffer.data(), codec);
+
+	auto process = [&]()
+	{
+		auto* packet = RTC::RtpPacket::Parse(buffer.data(), len);
+
+		RTC::Codecs::Tools::ProcessRtpPacket(packet, mimeType);
+
+		sink = sink + packet->GetTemporalLayer() + packet->GetSpatialLayer() + packet->IsKeyFrame();
+
+		delete packet;
+	};
+
+	// Warm the RtpPacketPool up.
+	process();
+
+	const uint64_t allocationsBefore = allocations;
+	const auto start                 = std::chrono::steady_clock::now();
+
+	for (uint32_t i = 0; i < options.packets; ++i)
+	{
+		process();
+	}
+
+	const auto elapsed = std::chrono::steady_clock::now() - start;
+
+	printf(
+	  "%-9s %6.1f ns/packet  allocations:%5.2f /packet\n",
+	  codec.name,
+	  static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()) /
+	    options.packets,
+	  static_cast<double>(allocations - allocationsBefore) / options.packets);
+}
+
+int main(int argc, char* argv[])
+{
+	parseOptions(argc, argv, { { "packets", &options.packets } });
+
+	printf("packets:%u\n", options.packets);
+
+	for (const auto& codec : Codecs)
+	{
+		run(codec);
+	}
+
+	return 0;
+}
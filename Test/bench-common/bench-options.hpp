@@ -0,0 +1,101 @@
+// bench-options.hpp : Command line options of the benchmarks.
+
+#ifndef BENCH_OPTIONS_HPP
+#define BENCH_OPTIONS_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <functional>
+#include <initializer_list>
+#include <string>
+#include <vector>
+
+// Results of the measured code are accumulated here so the compiler cannot
+// drop that code.
+inline volatile uint64_t sink{ 0u };
+
+// Option given as --name=value.
+struct Option
+{
+	Option(const char* name, uint32_t* value) : name(name)
+	{
+		this->set = [value](const std::string& text)
+		{
+			*value = static_cast<uint32_t>(std::stoul(text));
+		};
+	}
+
+	Option(const char* name, std::string* value) : name(name)
+	{
+		this->set = [value](const std::string& text)
+		{
+			*value = text;
+		};
+	}
+
+	// Comma separated values.
+	Option(const char* name, std::vector<uint32_t>* values) : name(name)
+	{
+		this->set = [values](const std::string& text)
+		{
+			values->clear();
+
+			for (size_t start = 0; start <= text.size();)
+			{
+				size_t end = text.find(',', start);
+
+				if (end == std::string::npos)
+					end = text.size();
+
+				values->push_back(static_cast<uint32_t>(std::stoul(text.substr(start, end - start))));
+				start = end + 1;
+			}
+		};
+	}
+
+	const char* name;
+	std::function<void(const std::string&)> set;
+};
+
+// Exits on unknown options and invalid values.
+inline void parseOptions(int argc, char* argv[], std::initializer_list<Option> options)
+{
+	for (int i = 1; i < argc; ++i)
+	{
+		std::string arg(argv[i]);
+		auto pos = arg.find('=');
+
+		if (arg.compare(0, 2, "--") != 0 || pos == std::string::npos)
+		{
+			printf("invalid argument: %s\n", arg.c_str());
+			std::exit(EXIT_FAILURE);
+		}
+
+		std::string name = arg.substr(2, pos - 2);
+		auto it          = std::find_if(
+		  options.begin(),
+		  options.end(),
+		  [&name](const Option& option) { return name == option.name; });
+
+		if (it == options.end())
+		{
+			printf("unknown option: %s\n", name.c_str());
+			std::exit(EXIT_FAILURE);
+		}
+
+		try
+		{
+			it->set(arg.substr(pos + 1));
+		}
+		catch (const std::exception& /*error*/)
+		{
+			printf("invalid value: %s\n", arg.c_str());
+			std::exit(EXIT_FAILURE);
+		}
+	}
+}
+
+#endif
@@ -0,0 +1,18 @@
+// bench-stubs.cpp : Worker globals of the benchmarks.
+//
+// The Worker sources compiled into the benchmarks log through the Channel,
+// which is not available there.
+
+#include "Logger.hpp"
+#include "MediaSoupErrors.hpp"
+#include "Settings.hpp"
+
+thread_local struct Settings::Configuration Settings::configuration;
+thread_local Channel::ChannelSocket* Logger::channel{ nullptr };
+thread_local char Logger::buffer[Logger::bufferSize];
+thread_local Logger::Ring* Logger::ring{ nullptr };
+thread_local char MediaSoupError::buffer[MediaSoupError::bufferSize];
+
+void Channel::ChannelSocket::SendLog(const char* /*message*/, uint32_t /*messageLen*/)
+{
+}
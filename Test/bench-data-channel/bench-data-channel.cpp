@@ -0,0 +1,412 @@
+// bench-data-channel.cpp : DataChannel fan-out benchmark.
+//
+// Sends --rate messages per second from one DataProducer to --consumers
+// DataConsumers of a DirectTransport. Every message is notified per
+// DataConsumer through the in-process PayloadChannel to a main loop thread,
+// which parses the notification and reads the payload as
+// PayloadChannelNative::CallbackWrite() does:
+//
+// - copy: the notification is built with nlohmann::json and the writer copies
+//   it and the payload into a ring slot, per DataConsumer, as before.
+// - shared: the message is a RTC::MessageBuffer taking the buffer given by
+//   usrsctp, the notification is built by hand and the writer keeps a
+//   reference to the message instead of copying it.
+//
+// Reports the notifications delivered per second (until the main loop thread
+// got them all), the time the Worker thread spends per message (not counting
+// the time it waits for the main loop thread when the ring is full), the CPU
+// time of the process per message, and the payload bytes copied and heap
+// allocations per message.
+//
+// Usage:
+//   bench-data-channel [--consumers=N] [--rate=MESSAGES_PER_SECOND] [--size=BYTES]
+//                      [--duration=SECONDS]
+
+#define MS_CLASS "bench-data-channel"
+
+#include "SpscRing.h"
+#include "RTC/MessageBuffer.hpp"
+#include "bench-options.hpp"
+#include <uv.h>
+#include <nlohmann/json.hpp>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <string>
+#include <thread>
+#include <vector>
+
+using json = nlohmann::json;
+
+// Counts the heap allocations of the process.
+static std::atomic<uint64_t> allocations{ 0u };
+
+void* operator new(size_t size)
+{
+	allocations.fetch_add(1, std::memory_order_relaxed);
+
+	if (void* ptr = std::malloc(size == 0u ? 1u : size))
+		return ptr;
+
+	throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept
+{
+	std::free(ptr);
+}
+
+void operator delete(void* ptr, size_t /*size*/) noexcept
+{
+	std::free(ptr);
+}
+
+struct Options
+{
+	uint32_t consumers{ 1000 };
+	uint32_t rate{ 10000 };
+	uint32_t size{ 1000 };
+	uint32_t duration{ 5 };
+};
+
+struct Result
+{
+	uint64_t messages{ 0 };
+	uint64_t delivered{ 0 };
+	uint64_t elapsedNs{ 0 };
+	uint64_t workerNs{ 0 };
+	uint64_t cpuUs{ 0 };
+	uint64_t copiedBytes{ 0 };
+	uint64_t allocations{ 0 };
+};
+
+enum class Mode
+{
+	COPY,
+	SHARED
+};
+
+// Emulates mediasoup::PayloadChannelNative: a ring of slots from the Worker
+// thread to the main loop thread, woken up with a uv_async_t.
+class PayloadChannel
+{
+public:
+	struct Slot
+	{
+		std::string message;
+		std::string payload;
+		RTC::MessageBuffer* payloadRef{ nullptr };
+	};
+
+public:
+	// Called on the Worker thread.
+	void Write(const std::string& message, const uint8_t* payload, size_t payloadLen)
+	{
+		Slot* slot = Prepare();
+
+		slot->message.assign(message);
+		slot->payload.assign(reinterpret_cast<const char*>(payload), payloadLen);
+
+		this->copiedBytes += payloadLen;
+
+		Commit();
+	}
+
+	// Called on the Worker thread.
+	void Write(const std::string& message, RTC::MessageBuffer* payload)
+	{
+		Slot* slot = Prepare();
+
+		slot->message.assign(message);
+		slot->payloadRef = payload;
+
+		payload->Ref();
+
+		Commit();
+	}
+
+	// Called on the main loop thread.
+	void Read()
+	{
+		this->writePending.store(false);
+
+		while (Slot* slot = this->ring.Front())
+		{
+			json msg = json::parse(slot->message);
+
+			const uint8_t* payload;
+			size_t payloadLen;
+
+			if (slot->payloadRef)
+			{
+				payload    = slot->payloadRef->GetData();
+				payloadLen = slot->payloadRef->GetSize();
+			}
+			else
+			{
+				payload    = reinterpret_cast<const uint8_t*>(slot->payload.data());
+				payloadLen = slot->payload.size();
+			}
+
+			// What the DataConsumer listener reads.
+			this->checksum += msg["data"]["ppid"].get<uint32_t>() + payload[payloadLen - 1];
+
+			if (slot->payloadRef)
+			{
+				slot->payloadRef->Unref();
+				slot->payloadRef = nullptr;
+			}
+
+			this->ring.PopAndRelease();
+
+			this->delivered.fetch_add(1, std::memory_order_relaxed);
+		}
+	}
+
+private:
+	Slot* Prepare()
+	{
+		Slot* slot = this->ring.Prepare();
+
+		if (slot)
+			return slot;
+
+		// The main loop is behind. Wait for it rather than dropping a message.
+		const auto waitStart = std::chrono::steady_clock::now();
+
+		while (!(slot = this->ring.Prepare()))
+		{
+			std::this_thread::yield();
+		}
+
+		this->waitNs += std::chrono::duration_cast<std::chrono::nanoseconds>(
+		                  std::chrono::steady_clock::now() - waitStart)
+		                  .count();
+
+		return slot;
+	}
+
+	void Commit()
+	{
+		this->ring.Commit();
+
+		if (!this->writePending.exchange(true))
+			uv_async_send(&this->uvHandle);
+	}
+
+public:
+	uv_async_t uvHandle;
+	std::atomic<uint64_t> delivered{ 0u };
+	uint64_t copiedBytes{ 0u };
+	uint64_t waitNs{ 0u };
+	uint64_t checksum{ 0u };
+
+private:
+	mediasoup::SpscRing<Slot, 1024> ring;
+	std::atomic<bool> writePending{ false };
+};
+
+static Options options;
+static std::vector<std::string> consumerIds;
+
+static uint64_t getCpuUs()
+{
+	uv_rusage_t rusage;
+
+	uv_getrusage(&rusage);
+
+	return static_cast<uint64_t>(rusage.ru_utime.tv_sec + rusage.ru_stime.tv_sec) * 1000000u +
+	       rusage.ru_utime.tv_usec + rusage.ru_stime.tv_usec;
+}
+
+// Notifies a message to every DataConsumer as DirectTransport::SendMessage()
+// did.
+static void sendCopy(PayloadChannel& payloadChannel, uint32_t ppid, const uint8_t* data, size_t len)
+{
+	for (const auto& consumerId : consumerIds)
+	{
+		json jsonData = json::object();
+
+		jsonData["ppid"] = ppid;
+
+		json jsonNotification = json::object();
+
+		jsonNotification["targetId"] = consumerId;
+		jsonNotification["event"]    = "message";
+		jsonNotification["data"]     = jsonData;
+
+		payloadChannel.Write(jsonNotification.dump(), data, len);
+	}
+}
+
+// Notifies a message to every DataConsumer as DirectTransport::SendMessage()
+// and PayloadChannelNotifier::Emit() do now.
+static void sendShared(PayloadChannel& payloadChannel, uint32_t ppid, RTC::MessageBuffer* message)
+{
+	static std::string notification;
+
+	for (const auto& consumerId : consumerIds)
+	{
+		std::string data("{\"ppid\":");
+
+		data.append(std::to_string(ppid));
+		data.append("}");
+
+		notification.assign("{\"targetId\":\"");
+		notification.append(consumerId);
+		notification.append("\",\"event\":\"message\",\"data\":");
+		notification.append(data);
+		notification.append("}");
+
+		payloadChannel.Write(notification, message);
+	}
+}
+
+static Result run(Mode mode)
+{
+	Result result;
+	PayloadChannel payloadChannel;
+	uv_loop_t loop;
+	std::atomic<bool> running{ true };
+	std::vector<uint8_t> source(options.size, 0xAB);
+
+	uv_loop_init(&loop);
+	uv_async_init(
+	  &loop,
+	  &payloadChannel.uvHandle,
+	  [](uv_async_t* handle) { static_cast<PayloadChannel*>(handle->data)->Read(); });
+	payloadChannel.uvHandle.data = &payloadChannel;
+
+	// Main loop thread.
+	std::thread mainThread(
+	  [&loop, &running]()
+	  {
+		  while (running.load())
+		  {
+			  uv_run(&loop, UV_RUN_ONCE);
+		  }
+	  });
+
+	const uint32_t messagesPerMs = std::max(1u, options.rate / 1000u);
+	const uint64_t allocationsBefore = allocations.load();
+	const uint64_t cpuUs             = getCpuUs();
+	const auto start                 = std::chrono::steady_clock::now();
+
+	for (uint32_t ms = 0; ms < options.duration * 1000u; ++ms)
+	{
+		const auto workStart = std::chrono::steady_clock::now();
+
+		for (uint32_t i = 0; i < messagesPerMs; ++i, ++result.messages)
+		{
+			// usrsctp hands every received message in a new malloc'ed buffer.
+			auto* data = static_cast<uint8_t*>(std::malloc(options.size));
+
+			std::memcpy(data, source.data(), options.size);
+
+			if (mode == Mode::COPY)
+			{
+				sendCopy(payloadChannel, 53, data, options.size);
+
+				std::free(data);
+			}
+			else
+			{
+				auto* message = RTC::MessageBuffer::Adopt(data, options.size);
+
+				sendShared(payloadChannel, 53, message);
+
+				message->Unref();
+			}
+		}
+
+		result.workerNs += std::chrono::duration_cast<std::chrono::nanoseconds>(
+		                     std::chrono::steady_clock::now() - workStart)
+		                     .count();
+
+		std::this_thread::sleep_until(start + std::chrono::milliseconds(ms + 1));
+	}
+
+	// Let the main loop thread deliver the rest.
+	while (payloadChannel.delivered.load() < result.messages * options.consumers)
+	{
+		std::this_thread::yield();
+	}
+
+	result.elapsedNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+	                     std::chrono::steady_clock::now() - start)
+	                     .count();
+	result.workerNs -= payloadChannel.waitNs;
+
+	result.cpuUs       = getCpuUs() - cpuUs;
+	result.allocations = allocations.load() - allocationsBefore;
+	result.delivered   = payloadChannel.delivered.load();
+	result.copiedBytes = payloadChannel.copiedBytes;
+
+	running.store(false);
+	uv_async_send(&payloadChannel.uvHandle);
+	mainThread.join();
+
+	uv_close(reinterpret_cast<uv_handle_t*>(&payloadChannel.uvHandle), nullptr);
+	uv_run(&loop, UV_RUN_NOWAIT);
+	uv_loop_close(&loop);
+
+	return result;
+}
+
+static void printResult(const char* name, const Result& result)
+{
+	const double messages = result.messages > 0 ? static_cast<double>(result.messages) : 1.0;
+
+	printf(
+	  "%-6s delivered:%9.0f /s  worker:%8.1f us/message  cpu:%8.1f us/message  copied:%9.0f "
+	  "B/message  allocations:%7.1f /message\n",
+	  name,
+	  static_cast<double>(result.delivered) * 1000000000 / static_cast<double>(result.elapsedNs),
+	  static_cast<double>(result.workerNs) / 1000 / messages,
+	  static_cast<double>(result.cpuUs) / messages,
+	  static_cast<double>(result.copiedBytes) / messages,
+	  static_cast<double>(result.allocations) / messages);
+}
+
+int main(int argc, char* argv[])
+{
+	parseOptions(
+	  argc,
+	  argv,
+	  {
+	    { "consumers", &options.consumers },
+	    { "rate", &options.rate },
+	    { "size", &options.size },
+	    { "duration", &options.duration }
+	  });
+
+	if (options.size == 0)
+	{
+		printf("size must be greater than 0\n");
+		std::exit(EXIT_FAILURE);
+	}
+
+	for (uint32_t i = 0; i < options.consumers; ++i)
+	{
+		char id[37];
+
+		std::snprintf(id, sizeof(id), "6c0d7b55-1b9e-4f2a-9c3e-%012u", i);
+
+		consumerIds.emplace_back(id);
+	}
+
+	printf(
+	  "consumers:%u, rate:%u messages/s, size:%u bytes, duration:%us\n",
+	  options.consumers,
+	  options.rate,
+	  options.size,
+	  options.duration);
+
+	printResult("copy", run(Mode::COPY));
+	printResult("shared", run(Mode::SHARED));
+
+	return 0;
+}
@@ -0,0 +1,431 @@
+// bench-in-process-pipe.cpp : In-process pipe benchmark.
+//
+// Runs two Worker-like threads, each one with its own libuv loop, and sends
+// RTP sized packets from one to the other in bursts every millisecond, as the
+// PipeConsumers of a Router do, through:
+//
+// - udp: a pair of UDP sockets on 127.0.0.1, as a PipeTransport does unless
+//   created with inProcess.
+// - ring: RTC::InProcessPipe.
+//
+// and reports the received and dropped packets, the one way latency and the
+// CPU time of both threads per packet.
+//
+// It first checks that an endpoint can be connected to again once the
+// endpoint connected to it, or the one it was connected to, is destroyed.
+//
+// Usage:
+//   bench-in-process-pipe [--rate=PACKETS_PER_SECOND] [--size=BYTES] [--duration=SECONDS]
+
+#define MS_CLASS "bench-in-process-pipe"
+
+#include "DepLibUV.hpp"
+#include "MediaSoupErrors.hpp"
+#include "RTC/InProcessPipe.hpp"
+#include "bench-options.hpp"
+#include <uv.h>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+
+struct Options
+{
+	uint32_t rate{ 100000 };
+	uint32_t size{ 1200 };
+	uint32_t duration{ 5 };
+};
+
+struct Result
+{
+	uint64_t sent{ 0 };
+	uint64_t dropped{ 0 };
+	uint64_t received{ 0 };
+	uint64_t latencyNs{ 0 };
+	uint64_t cpuUs{ 0 };
+};
+
+enum class Mode
+{
+	UDP,
+	RING
+};
+
+static Options options;
+
+// Counts the packets received by an endpoint.
+class Counter : public RTC::InProcessPipe::Listener
+{
+public:
+	void OnInProcessPipePacketReceived(RTC::InProcessPipe* /*pipe*/, uint8_t* /*data*/, size_t /*len*/) override
+	{
+		++this->received;
+	}
+
+public:
+	uint64_t received{ 0 };
+};
+
+static void expect(bool condition, const char* what)
+{
+	if (!condition)
+	{
+		printf("reconnect check failed: %s\n", what);
+		std::exit(EXIT_FAILURE);
+	}
+}
+
+static void checkReconnect()
+{
+	DepLibUV::ClassInit();
+
+	uint8_t packet[100];
+	Counter counter;
+
+	std::memset(packet, 0xAB, sizeof(packet));
+	packet[0] = 0x80;
+
+	auto* receiver = new RTC::InProcessPipe(&counter, "check-receiver");
+	auto* sender   = new RTC::InProcessPipe(nullptr, "check-sender");
+
+	sender->Connect("check-receiver");
+	expect(sender->Send(packet, sizeof(packet)), "send");
+
+	// A single sender per endpoint.
+	{
+		RTC::InProcessPipe other(nullptr, "check-other");
+		bool thrown{ false };
+
+		try
+		{
+			other.Connect("check-receiver");
+		}
+		catch (const MediaSoupError& /*error*/)
+		{
+			thrown = true;
+		}
+
+		expect(thrown, "second sender rejected");
+	}
+
+	// Destroy the sender and connect a new one.
+	delete sender;
+	sender = new RTC::InProcessPipe(nullptr, "check-sender");
+	sender->Connect("check-receiver");
+	expect(sender->Send(packet, sizeof(packet)), "send after sender reconnected");
+
+	uv_run(DepLibUV::GetLoop(), UV_RUN_NOWAIT);
+	expect(counter.received == 2, "packets received after sender reconnected");
+
+	// Destroy the receiver, the sender must see it gone and connect to a new
+	// one with the same id.
+	delete receiver;
+	expect(!sender->IsConnected(), "sender disconnected");
+	expect(!sender->Send(packet, sizeof(packet)), "send to destroyed receiver dropped");
+
+	receiver = new RTC::InProcessPipe(&counter, "check-receiver");
+	sender->Connect("check-receiver");
+	expect(sender->IsConnected(), "sender connected to new receiver");
+	expect(sender->Send(packet, sizeof(packet)), "send after receiver recreated");
+
+	uv_run(DepLibUV::GetLoop(), UV_RUN_NOWAIT);
+	expect(counter.received == 3, "packets received after receiver recreated");
+
+	delete sender;
+	delete receiver;
+
+	// Let the UV handles close.
+	uv_run(DepLibUV::GetLoop(), UV_RUN_DEFAULT);
+
+	DepLibUV::ClassDestroy();
+}
+
+static uint64_t getCpuUs()
+{
+	uv_rusage_t rusage;
+
+	uv_getrusage(&rusage);
+
+	return static_cast<uint64_t>(rusage.ru_utime.tv_sec + rusage.ru_stime.tv_sec) * 1000000u +
+	       rusage.ru_utime.tv_usec + rusage.ru_stime.tv_usec;
+}
+
+// Receives the packets in its own thread and loop until stopped.
+class Receiver : public RTC::InProcessPipe::Listener
+{
+public:
+	void Run(Mode mode)
+	{
+		DepLibUV::ClassInit();
+
+		uv_async_init(
+		  DepLibUV::GetLoop(),
+		  &this->stopAsync,
+		  [](uv_async_t* handle) { uv_stop(handle->loop); });
+
+		if (mode == Mode::RING)
+		{
+			this->pipe = new RTC::InProcessPipe(this, "receiver");
+		}
+		else
+		{
+			struct sockaddr_in addr;
+			struct sockaddr_storage bound;
+			int len = sizeof(bound);
+
+			uv_ip4_addr("127.0.0.1", 0, &addr);
+			uv_udp_init(DepLibUV::GetLoop(), &this->udp);
+			this->udp.data = this;
+			uv_udp_bind(&this->udp, reinterpret_cast<const struct sockaddr*>(&addr), 0);
+			uv_udp_getsockname(&this->udp, reinterpret_cast<struct sockaddr*>(&bound), &len);
+
+			this->port = ntohs(reinterpret_cast<struct sockaddr_in*>(&bound)->sin_port);
+
+			uv_udp_recv_start(
+			  &this->udp,
+			  [](uv_handle_t* /*handle*/, size_t /*suggested*/, uv_buf_t* buf)
+			  {
+				  static thread_local char buffer[65536];
+
+				  buf->base = buffer;
+				  buf->len  = sizeof(buffer);
+			  },
+			  [](uv_udp_t* handle, ssize_t nread, const uv_buf_t* buf, const struct sockaddr* /*addr*/, unsigned /*flags*/)
+			  {
+				  if (nread <= 0)
+					  return;
+
+				  static_cast<Receiver*>(handle->data)
+				    ->OnPacket(reinterpret_cast<uint8_t*>(buf->base), static_cast<size_t>(nread));
+			  });
+		}
+
+		this->ready = true;
+
+		uv_run(DepLibUV::GetLoop(), UV_RUN_DEFAULT);
+
+		delete this->pipe;
+		this->pipe = nullptr;
+
+		if (mode == Mode::UDP)
+			uv_close(reinterpret_cast<uv_handle_t*>(&this->udp), nullptr);
+
+		uv_close(reinterpret_cast<uv_handle_t*>(&this->stopAsync), nullptr);
+		uv_run(DepLibUV::GetLoop(), UV_RUN_DEFAULT);
+
+		DepLibUV::ClassDestroy();
+	}
+
+	void Stop()
+	{
+		uv_async_send(&this->stopAsync);
+	}
+
+	void OnInProcessPipePacketReceived(RTC::InProcessPipe* /*pipe*/, uint8_t* data, size_t len) override
+	{
+		OnPacket(data, len);
+	}
+
+	void OnPacket(const uint8_t* data, size_t len)
+	{
+		uint64_t sentAt;
+
+		std::memcpy(&sentAt, data + 12, sizeof(sentAt));
+
+		++this->received;
+		this->latencyNs += uv_hrtime() - sentAt;
+		this->bytes += len;
+	}
+
+public:
+	std::atomic<bool> ready{ false };
+	uint16_t port{ 0 };
+	uint64_t received{ 0 };
+	uint64_t latencyNs{ 0 };
+	uint64_t bytes{ 0 };
+
+private:
+	uv_async_t stopAsync;
+	uv_udp_t udp;
+	RTC::InProcessPipe* pipe{ nullptr };
+};
+
+// Sends the packets in its own thread and loop for the configured duration.
+class Sender
+{
+public:
+	void Run(Mode mode, uint16_t port)
+	{
+		DepLibUV::ClassInit();
+
+		this->mode = mode;
+		std::memset(this->packet, 0xAB, sizeof(this->packet));
+		// RTP version 2.
+		this->packet[0] = 0x80;
+
+		if (mode == Mode::RING)
+		{
+			this->pipe = new RTC::InProcessPipe(nullptr, "sender");
+			this->pipe->Connect("receiver");
+		}
+		else
+		{
+			uv_ip4_addr("127.0.0.1", port, &this->remoteAddr);
+			uv_udp_init(DepLibUV::GetLoop(), &this->udp);
+		}
+
+		uv_timer_init(DepLibUV::GetLoop(), &this->timer);
+		this->timer.data = this;
+		this->startMs    = uv_now(DepLibUV::GetLoop());
+
+		uv_timer_start(
+		  &this->timer, [](uv_timer_t* handle) { static_cast<Sender*>(handle->data)->OnTick(); }, 1, 1);
+
+		// Runs until OnTick() closes everything.
+		uv_run(DepLibUV::GetLoop(), UV_RUN_DEFAULT);
+
+		DepLibUV::ClassDestroy();
+	}
+
+private:
+	void OnTick()
+	{
+		const uint64_t nowMs = uv_now(DepLibUV::GetLoop());
+
+		if (nowMs - this->startMs >= options.duration * 1000u)
+		{
+			uv_close(reinterpret_cast<uv_handle_t*>(&this->timer), nullptr);
+
+			delete this->pipe;
+			this->pipe = nullptr;
+
+			if (this->mode == Mode::UDP)
+				uv_close(reinterpret_cast<uv_handle_t*>(&this->udp), nullptr);
+
+			return;
+		}
+
+		// Packets due until now.
+		const uint64_t due = (nowMs - this->startMs) * options.rate / 1000u;
+
+		for (; this->sent + this->dropped < due;)
+		{
+			const uint64_t sentAt = uv_hrtime();
+
+			std::memcpy(this->packet + 12, &sentAt, sizeof(sentAt));
+
+			if (Send())
+				++this->sent;
+			else
+				++this->dropped;
+		}
+	}
+
+	bool Send()
+	{
+		if (this->mode == Mode::RING)
+			return this->pipe->Send(this->packet, options.size);
+
+		uv_buf_t buffer = uv_buf_init(reinterpret_cast<char*>(this->packet), options.size);
+
+		return uv_udp_try_send(
+		         &this->udp, &buffer, 1, reinterpret_cast<const struct sockaddr*>(&this->remoteAddr)) >= 0;
+	}
+
+public:
+	uint64_t sent{ 0 };
+	uint64_t dropped{ 0 };
+
+private:
+	Mode mode{ Mode::UDP };
+	uint8_t packet[RTC::InProcessPipe::MaxPacketSize];
+	uv_timer_t timer;
+	uv_udp_t udp;
+	struct sockaddr_in remoteAddr;
+	RTC::InProcessPipe* pipe{ nullptr };
+	uint64_t startMs{ 0 };
+};
+
+static Result run(Mode mode)
+{
+	Receiver receiver;
+	Sender sender;
+
+	const uint64_t cpuUs = getCpuUs();
+
+	std::thread receiverThread([&receiver, mode]() { receiver.Run(mode); });
+
+	while (!receiver.ready)
+	{
+		std::this_thread::yield();
+	}
+
+	std::thread senderThread([&sender, &receiver, mode]() { sender.Run(mode, receiver.port); });
+
+	senderThread.join();
+
+	// Let the last packets arrive.
+	std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+	receiver.Stop();
+	receiverThread.join();
+
+	Result result;
+
+	result.sent      = sender.sent;
+	result.dropped   = sender.dropped + (sender.sent - receiver.received);
+	result.received  = receiver.received;
+	result.latencyNs = receiver.received ? receiver.latencyNs / receiver.received : 0;
+	result.cpuUs     = getCpuUs() - cpuUs;
+
+	return result;
+}
+
+static void printResult(const char* name, const Result& result)
+{
+	printf(
+	  "%-5s received:%9.0f /s  dropped:%7.3f%%  latency:%7.1f us  cpu:%6.1f ms/s  cpu per packet:%6.0f ns\n",
+	  name,
+	  static_cast<double>(result.received) / options.duration,
+	  result.sent + result.dropped > 0
+	    ? static_cast<double>(result.dropped) * 100 / static_cast<double>(result.sent + result.dropped)
+	    : 0.0,
+	  static_cast<double>(result.latencyNs) / 1000,
+	  static_cast<double>(result.cpuUs) / 1000 / options.duration,
+	  result.received > 0 ? static_cast<double>(result.cpuUs) * 1000 / static_cast<double>(result.received)
+	                      : 0.0);
+}
+
+int main(int argc, char* argv[])
+{
+	parseOptions(
+	  argc,
+	  argv,
+	  {
+	    { "rate", &options.rate },
+	    { "size", &options.size },
+	    { "duration", &options.duration }
+	  });
+
+	if (options.size < 20 || options.size > RTC::InProcessPipe::MaxPacketSize)
+	{
+		printf("size must be between 20 and %zu\n", RTC::InProcessPipe::MaxPacketSize);
+		std::exit(EXIT_FAILURE);
+	}
+
+	checkReconnect();
+
+	printf(
+	  "rate:%u packets/s size:%u bytes duration:%us\n", options.rate, options.size, options.duration);
+
+	const Result udpResult  = run(Mode::UDP);
+	const Result ringResult = run(Mode::RING);
+
+	printResult("udp", udpResult);
+	printResult("ring", ringResult);
+
+	return 0;
+}
@@ -0,0 +1,188 @@
+// bench-logger.cpp : Worker Logger benchmark.
+//
+// Logs --rate lines per second, like MS_DEBUG_TAG(rtp, ...) does for every
+// received packet, first formatting each one with snprintf() and sending it
+// right away (as the Logger did before records were deferred) and then
+// writing records into the Worker ring, formatted by the Logger thread and
+// sent from the Worker loop. Reports the time the Worker thread spends per
+// logged line (including the Channel copy done in SendLog()), the lines sent
+// and the dropped ones.
+//
+// Usage:
+//   bench-logger [--rate=LINES_PER_SECOND] [--duration=SECONDS]
+
+#define MS_CLASS "bench-logger"
+
+#include "DepLibUV.hpp"
+#include "Logger.hpp"
+#include "MediaSoupErrors.hpp"
+#include "Settings.hpp"
+#include "bench-options.hpp"
+#include <uv.h>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+
+// The Logger and DepLibUV sources compiled into this benchmark log through
+// the Channel, which is emulated by SendLog() below.
+thread_local struct Settings::Configuration Settings::configuration;
+thread_local char MediaSoupError::buffer[MediaSoupError::bufferSize];
+
+// Copy of the last line, as the in-process Channel copies every log line
+// into a slot of its ring.
+static std::string lastLine;
+static uint64_t sentLines{ 0 };
+
+void Channel::ChannelSocket::SendLog(const char* message, uint32_t messageLen)
+{
+	lastLine.assign(message, messageLen);
+
+	// Do not count the warnings about dropped records.
+	if (message[0] != 'W')
+		++sentLines;
+}
+
+struct Options
+{
+	uint32_t rate{ 100000 };
+	uint32_t duration{ 5 };
+};
+
+struct Result
+{
+	uint64_t workerNs{ 0 };
+	uint64_t logged{ 0 };
+	uint64_t sent{ 0 };
+	uint64_t dropped{ 0 };
+};
+
+static Options options;
+
+// Logs the lines of one millisecond.
+static void logSnprintf(uint32_t lines, uint32_t& seq)
+{
+	for (uint32_t i = 0; i < lines; ++i, ++seq)
+	{
+		const int loggerWritten = std::snprintf(
+		  Logger::buffer,
+		  Logger::bufferSize,
+		  "D" _MS_LOG_STR_DESC "received RTP packet [ssrc:%" PRIu32 ", seq:%" PRIu16
+		  ", timestamp:%" PRIu32 ", size:%zu, mid:%s]",
+		  _MS_LOG_ARG,
+		  uint32_t{ 12345678 },
+		  static_cast<uint16_t>(seq),
+		  seq * 90u,
+		  size_t{ 1200 },
+		  "0");
+
+		Logger::channel->SendLog(Logger::buffer, static_cast<uint32_t>(loggerWritten));
+	}
+}
+
+// Logs the lines of one millisecond. Call sites are rate limited, so this
+// uses MS_DUMP(), which is not.
+static void logRecord(uint32_t lines, uint32_t& seq)
+{
+	for (uint32_t i = 0; i < lines; ++i, ++seq)
+	{
+		MS_DUMP(
+		  "received RTP packet [ssrc:%" PRIu32 ", seq:%" PRIu16 ", timestamp:%" PRIu32
+		  ", size:%zu, mid:%s]",
+		  uint32_t{ 12345678 },
+		  static_cast<uint16_t>(seq),
+		  seq * 90u,
+		  size_t{ 1200 },
+		  "0");
+	}
+}
+
+static Result run(void (*log)(uint32_t, uint32_t&))
+{
+	Result result;
+	uint32_t seq{ 0 };
+	const uint32_t linesPerMs = options.rate / 1000u;
+	const auto start          = std::chrono::steady_clock::now();
+
+	sentLines = 0;
+
+	for (uint32_t ms = 0; ms < options.duration * 1000u; ++ms)
+	{
+		const auto workStart = std::chrono::steady_clock::now();
+
+		log(linesPerMs, seq);
+
+		// Send the records formatted meanwhile, as the Worker loop does.
+		uv_run(DepLibUV::GetLoop(), UV_RUN_NOWAIT);
+
+		result.workerNs += std::chrono::duration_cast<std::chrono::nanoseconds>(
+		                     std::chrono::steady_clock::now() - workStart)
+		                     .count();
+
+		std::this_thread::sleep_until(start + std::chrono::milliseconds(ms + 1));
+	}
+
+	result.logged = seq;
+
+	return result;
+}
+
+static void printResult(const char* name, const Result& result)
+{
+	printf(
+	  "%-9s worker:%6.1f ms/s  %6.0f ns/line  sent:%9.0f /s  dropped:%9.0f /s\n",
+	  name,
+	  static_cast<double>(result.workerNs) / 1000000 / options.duration,
+	  result.logged > 0 ? static_cast<double>(result.workerNs) / result.logged : 0.0,
+	  static_cast<double>(result.sent) / options.duration,
+	  static_cast<double>(result.dropped) / options.duration);
+}
+
+int main(int argc, char* argv[])
+{
+	parseOptions(argc, argv, { { "rate", &options.rate }, { "duration", &options.duration } });
+
+	Settings::configuration.logLevel = LogLevel::LOG_DEBUG;
+
+	DepLibUV::ClassInit();
+
+	// SendLog() above does not use the instance.
+	alignas(Channel::ChannelSocket) static uint8_t channel[sizeof(Channel::ChannelSocket)];
+
+	Logger::ClassInit(reinterpret_cast<Channel::ChannelSocket*>(channel));
+
+	// Keep the loop alive, as the Worker handles do.
+	uv_timer_t timer;
+
+	uv_timer_init(DepLibUV::GetLoop(), &timer);
+	uv_timer_start(&timer, [](uv_timer_t* /*handle*/) {}, 1000, 1000);
+
+	printf("rate:%u lines/s, duration:%us\n", options.rate, options.duration);
+
+	auto snprintfResult = run(logSnprintf);
+
+	snprintfResult.sent = sentLines;
+
+	auto recordResult = run(logRecord);
+
+	json jsonLogger = json::object();
+
+	Logger::FillJson(jsonLogger);
+
+	// Send what is left.
+	Logger::ClassDestroy();
+
+	recordResult.sent    = sentLines;
+	recordResult.dropped = jsonLogger["droppedRecords"].get<uint64_t>();
+
+	printResult("snprintf", snprintfResult);
+	printResult("record", recordResult);
+
+	uv_close(reinterpret_cast<uv_handle_t*>(&timer), nullptr);
+	uv_run(DepLibUV::GetLoop(), UV_RUN_NOWAIT);
+
+	DepLibUV::ClassDestroy();
+
+	return 0;
+}
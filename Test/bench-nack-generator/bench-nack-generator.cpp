@@ -0,0 +1,514 @@
+// bench-nack-generator.cpp : NackGenerator benchmark.
+//
+// Feeds a video stream with random losses (5%, 10%, 15% and 20% by default)
+// to the NackGenerator, retransmits the NACKed packets (losing some of the
+// retransmissions too) and fires its timer periodically, as RtpStreamRecv
+// and the Worker loop do, and measures the cost per received packet:
+//
+// - map: the NackGenerator as it was, keeping NACKed, key frame and
+//   recovered seqs in btree containers and returning a new vector on every
+//   batch.
+// - bitmap: the NackGenerator now, with seq bitmaps, a ring of NACKed seqs
+//   and a reused batch vector.
+//
+// The RTT is 0 so every timer tick NACKs again the pending seqs (up to the
+// max retries) regardless of the clock, which keeps both runs identical.
+// They must NACK the same seqs.
+//
+// Usage:
+//   bench-nack-generator [--packets=N] [--timer=PACKETS] [--rtx-delay=PACKETS]
+//     [--key-frame=PACKETS]
+
+#define MS_CLASS "bench-nack-generator"
+
+#include "DepLibUV.hpp"
+#include "RTC/Codecs/PayloadDescriptorHandler.hpp"
+#include "RTC/NackGenerator.hpp"
+#include "RTC/RtpPacket.hpp"
+#include "RTC/SeqManager.hpp"
+#include "bench-options.hpp"
+#include <absl/container/btree_map.h>
+#include <absl/container/btree_set.h>
+#include <uv.h>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <string>
+#include <vector>
+
+struct Options
+{
+	uint32_t packets{ 2000000 };
+	// Received packets between two timer ticks (40 ms at 10k packets/s, about
+	// 100 Mbps).
+	uint32_t timer{ 400 };
+	// Received packets until a NACKed packet is retransmitted.
+	uint32_t rtxDelay{ 500 };
+	// Received packets between two key frames.
+	uint32_t keyFrame{ 30000 };
+};
+
+struct Result
+{
+	double nsPerPacket{ 0 };
+	uint64_t nacks{ 0 };
+	uint64_t nackedSeqs{ 0 };
+	uint64_t keyFrameRequests{ 0 };
+	uint64_t repaired{ 0 };
+	uint64_t checksum{ 0 };
+};
+
+static Options options;
+
+// Cheap deterministic random numbers, so both runs lose the same packets.
+class Random
+{
+public:
+	explicit Random(uint64_t seed) : state(seed)
+	{
+	}
+
+public:
+	// Returns true with the given probability (in percent).
+	bool Chance(uint32_t percent)
+	{
+		this->state ^= this->state << 13;
+		this->state ^= this->state >> 7;
+		this->state ^= this->state << 17;
+
+		return this->state % 100 < percent;
+	}
+
+private:
+	uint64_t state;
+};
+
+// Lets the benchmark flag the packets of key frames.
+class KeyFrameHandler : public RTC::Codecs::PayloadDescriptorHandler
+{
+public:
+	void Dump() const override
+	{
+	}
+	bool Process(RTC::Codecs::EncodingContext* /*context*/, uint8_t* /*data*/, bool& /*marker*/) override
+	{
+		return true;
+	}
+	void Restore(uint8_t* /*data*/) override
+	{
+	}
+	uint8_t GetSpatialLayer() const override
+	{
+		return 0u;
+	}
+	uint8_t GetTemporalLayer() const override
+	{
+		return 0u;
+	}
+	bool IsKeyFrame() const override
+	{
+		return this->keyFrame;
+	}
+
+public:
+	bool keyFrame{ false };
+};
+
+// RTC::NackGenerator as it was before using bitmaps.
+class MapNackGenerator : public Timer::Listener
+{
+private:
+	struct NackInfo
+	{
+		NackInfo() = default;
+		explicit NackInfo(uint64_t createdAtMs, uint16_t seq, uint16_t sendAtSeq)
+		  : createdAtMs(createdAtMs), seq(seq), sendAtSeq(sendAtSeq)
+		{
+		}
+
+		uint64_t createdAtMs{ 0u };
+		uint16_t seq{ 0u };
+		uint16_t sendAtSeq{ 0u };
+		uint64_t sentAtMs{ 0u };
+		uint8_t retries{ 0u };
+	};
+
+	enum class NackFilter
+	{
+		SEQ,
+		TIME
+	};
+
+public:
+	static constexpr size_t MaxPacketAge{ 10000u };
+	static constexpr size_t MaxNackPackets{ 1000u };
+	static constexpr uint8_t MaxNackRetries{ 10u };
+	static constexpr uint64_t TimerInterval{ 40u };
+
+public:
+	explicit MapNackGenerator(RTC::NackGenerator::Listener* listener, unsigned int /*sendNackDelayMs*/)
+	  : listener(listener)
+	{
+		this->timer = new Timer(this);
+	}
+	~MapNackGenerator() override
+	{
+		delete this->timer;
+	}
+
+	bool ReceivePacket(RTC::RtpPacket* packet, bool isRecovered)
+	{
+		uint16_t seq          = packet->GetSequenceNumber();
+		const bool isKeyFrame = packet->IsKeyFrame();
+
+		if (!this->started)
+		{
+			this->started = true;
+			this->lastSeq = seq;
+
+			if (isKeyFrame)
+				this->keyFrameList.insert(seq);
+
+			return false;
+		}
+
+		if (seq == this->lastSeq)
+			return false;
+
+		if (RTC::SeqManager<uint16_t>::IsSeqLowerThan(seq, this->lastSeq))
+		{
+			auto it = this->nackList.find(seq);
+
+			if (it != this->nackList.end())
+			{
+				auto retries = it->second.retries;
+
+				this->nackList.erase(it);
+
+				return retries != 0;
+			}
+
+			return false;
+		}
+
+		if (isKeyFrame)
+			this->keyFrameList.insert(seq);
+
+		{
+			auto it = this->keyFrameList.lower_bound(seq - MaxPacketAge);
+
+			if (it != this->keyFrameList.begin())
+				this->keyFrameList.erase(this->keyFrameList.begin(), it);
+		}
+
+		if (isRecovered)
+		{
+			this->recoveredList.insert(seq);
+
+			auto it = this->recoveredList.lower_bound(seq - MaxPacketAge);
+
+			if (it != this->recoveredList.begin())
+				this->recoveredList.erase(this->recoveredList.begin(), it);
+
+			return false;
+		}
+
+		AddPacketsToNackList(this->lastSeq + 1, seq);
+
+		this->lastSeq = seq;
+
+		std::vector<uint16_t> nackBatch = GetNackBatch(NackFilter::SEQ);
+
+		if (!nackBatch.empty())
+			this->listener->OnNackGeneratorNackRequired(nackBatch);
+
+		if (!this->timer->IsActive())
+			MayRunTimer();
+
+		return false;
+	}
+	void UpdateRtt(uint32_t rtt)
+	{
+		this->rtt = rtt;
+	}
+
+private:
+	void AddPacketsToNackList(uint16_t seqStart, uint16_t seqEnd)
+	{
+		auto it = this->nackList.lower_bound(seqEnd - MaxPacketAge);
+
+		this->nackList.erase(this->nackList.begin(), it);
+
+		const uint16_t numNewNacks = seqEnd - seqStart;
+
+		if (static_cast<uint16_t>(this->nackList.size()) + numNewNacks > MaxNackPackets)
+		{
+			// clang-format off
+			while (
+				RemoveNackItemsUntilKeyFrame() &&
+				static_cast<uint16_t>(this->nackList.size()) + numNewNacks > MaxNackPackets
+			)
+			// clang-format on
+			{
+			}
+
+			if (static_cast<uint16_t>(this->nackList.size()) + numNewNacks > MaxNackPackets)
+			{
+				this->nackList.clear();
+				this->listener->OnNackGeneratorKeyFrameRequired();
+
+				return;
+			}
+		}
+
+		for (uint16_t seq = seqStart; seq != seqEnd; ++seq)
+		{
+			if (this->recoveredList.find(seq) != this->recoveredList.end())
+				continue;
+
+			this->nackList.emplace(std::make_pair(seq, NackInfo{ DepLibUV::GetTimeMs(), seq, seq }));
+		}
+	}
+	bool RemoveNackItemsUntilKeyFrame()
+	{
+		while (!this->keyFrameList.empty())
+		{
+			auto it = this->nackList.lower_bound(*this->keyFrameList.begin());
+
+			if (it != this->nackList.begin())
+			{
+				this->nackList.erase(this->nackList.begin(), it);
+
+				return true;
+			}
+
+			this->keyFrameList.erase(this->keyFrameList.begin());
+		}
+
+		return false;
+	}
+	std::vector<uint16_t> GetNackBatch(NackFilter filter)
+	{
+		const uint64_t nowMs = DepLibUV::GetTimeMs();
+		std::vector<uint16_t> nackBatch;
+
+		auto it = this->nackList.begin();
+
+		while (it != this->nackList.end())
+		{
+			NackInfo& nackInfo = it->second;
+			uint16_t seq       = nackInfo.seq;
+
+			// clang-format off
+			if (
+				(
+					filter == NackFilter::SEQ &&
+					nackInfo.sentAtMs == 0 &&
+					(
+						nackInfo.sendAtSeq == this->lastSeq ||
+						RTC::SeqManager<uint16_t>::IsSeqHigherThan(this->lastSeq, nackInfo.sendAtSeq)
+					)
+				) ||
+				(
+					filter == NackFilter::TIME &&
+					(nackInfo.sentAtMs == 0 || nowMs - nackInfo.sentAtMs >= this->rtt)
+				)
+			)
+			// clang-format on
+			{
+				nackBatch.emplace_back(seq);
+				nackInfo.retries++;
+				nackInfo.sentAtMs = nowMs;
+
+				if (nackInfo.retries >= MaxNackRetries)
+					it = this->nackList.erase(it);
+				else
+					++it;
+
+				continue;
+			}
+
+			++it;
+		}
+
+		return nackBatch;
+	}
+	void MayRunTimer() const
+	{
+		if (!this->nackList.empty())
+			this->timer->Start(TimerInterval);
+	}
+
+	/* Pure virtual methods inherited from Timer::Listener. */
+public:
+	void OnTimer(Timer* /*timer*/) override
+	{
+		std::vector<uint16_t> nackBatch = GetNackBatch(NackFilter::TIME);
+
+		if (!nackBatch.empty())
+			this->listener->OnNackGeneratorNackRequired(nackBatch);
+
+		MayRunTimer();
+	}
+
+private:
+	RTC::NackGenerator::Listener* listener{ nullptr };
+	Timer* timer{ nullptr };
+	absl::btree_map<uint16_t, NackInfo, RTC::SeqManager<uint16_t>::SeqLowerThan> nackList;
+	absl::btree_set<uint16_t, RTC::SeqManager<uint16_t>::SeqLowerThan> keyFrameList;
+	absl::btree_set<uint16_t, RTC::SeqManager<uint16_t>::SeqLowerThan> recoveredList;
+	bool started{ false };
+	uint16_t lastSeq{ 0u };
+	uint32_t rtt{ 0u };
+};
+
+// Stand-in for RtpStreamRecv: schedules the retransmission of the NACKed
+// packets.
+class Stream : public RTC::NackGenerator::Listener
+{
+public:
+	explicit Stream(uint32_t loss) : loss(loss), random(loss + 1u)
+	{
+	}
+
+public:
+	void OnNackGeneratorNackRequired(const std::vector<uint16_t>& seqNumbers) override
+	{
+		++this->result.nacks;
+		this->result.nackedSeqs += seqNumbers.size();
+
+		for (auto seq : seqNumbers)
+		{
+			this->result.checksum = this->result.checksum * 31u + seq;
+
+			// Retransmissions get lost too.
+			if (!this->random.Chance(this->loss))
+				this->retransmissions.push_back({ this->now + options.rtxDelay, seq });
+		}
+	}
+	void OnNackGeneratorKeyFrameRequired() override
+	{
+		++this->result.keyFrameRequests;
+	}
+
+public:
+	uint32_t loss{ 0u };
+	Random random;
+	uint64_t now{ 0u };
+	std::deque<std::pair<uint64_t, uint16_t>> retransmissions;
+	Result result;
+};
+
+template<typename Generator>
+static Result run(uint32_t loss)
+{
+	Stream stream(loss);
+	Generator generator(&stream, 0u);
+	Random random(loss);
+	uint8_t buffer[12] = { 0x80, 0x65, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x11, 0x22, 0x33, 0x44 };
+	auto* packet       = RTC::RtpPacket::Parse(buffer, sizeof(buffer));
+	auto* handler      = packet->SetPayloadDescriptorHandler<KeyFrameHandler>();
+	uint16_t seq{ 0u };
+
+	generator.UpdateRtt(0u);
+
+	const auto start = std::chrono::steady_clock::now();
+
+	for (uint64_t i{ 0u }; i < options.packets; ++i, ++seq)
+	{
+		stream.now = i;
+
+		// Retransmitted packets due now.
+		while (!stream.retransmissions.empty() && stream.retransmissions.front().first <= i)
+		{
+			packet->SetSequenceNumber(stream.retransmissions.front().second);
+			handler->keyFrame = false;
+
+			if (generator.ReceivePacket(packet, /*isRecovered*/ true))
+				++stream.result.repaired;
+
+			stream.retransmissions.pop_front();
+		}
+
+		if (i % options.timer == 0u)
+			generator.OnTimer(nullptr);
+
+		if (random.Chance(loss))
+			continue;
+
+		packet->SetSequenceNumber(seq);
+		handler->keyFrame = i % options.keyFrame == 0u;
+
+		generator.ReceivePacket(packet, /*isRecovered*/ false);
+	}
+
+	const auto elapsed = std::chrono::steady_clock::now() - start;
+
+	stream.result.nsPerPacket =
+	  static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()) /
+	  options.packets;
+
+	delete packet;
+
+	return stream.result;
+}
+
+static void printResult(const char* name, const Result& result)
+{
+	printf(
+	  "  %-7s %6.1f ns/packet  nacks:%8" PRIu64 "  nacked seqs:%9" PRIu64 "  repaired:%8" PRIu64
+	  "  key frame requests:%4" PRIu64 "\n",
+	  name,
+	  result.nsPerPacket,
+	  result.nacks,
+	  result.nackedSeqs,
+	  result.repaired,
+	  result.keyFrameRequests);
+}
+
+int main(int argc, char* argv[])
+{
+	parseOptions(
+	  argc,
+	  argv,
+	  {
+	    { "packets", &options.packets },
+	    { "timer", &options.timer },
+	    { "rtx-delay", &options.rtxDelay },
+	    { "key-frame", &options.keyFrame }
+	  });
+
+	DepLibUV::ClassInit();
+
+	printf(
+	  "packets:%u timer:%u rtx-delay:%u key-frame:%u\n",
+	  options.packets,
+	  options.timer,
+	  options.rtxDelay,
+	  options.keyFrame);
+
+	for (uint32_t loss : { 5u, 10u, 15u, 20u })
+	{
+		const Result mapResult    = run<MapNackGenerator>(loss);
+		const Result bitmapResult = run<RTC::NackGenerator>(loss);
+
+		printf("loss:%u%%\n", loss);
+		printResult("map", mapResult);
+		printResult("bitmap", bitmapResult);
+
+		// Both must NACK the same seqs.
+		if (mapResult.checksum != bitmapResult.checksum || mapResult.repaired != bitmapResult.repaired)
+		{
+			printf("NACK mismatch\n");
+			std::exit(EXIT_FAILURE);
+		}
+	}
+
+	// Let the handles close.
+	uv_run(DepLibUV::GetLoop(), UV_RUN_DEFAULT);
+
+	DepLibUV::ClassDestroy();
+
+	return 0;
+}
@@ -0,0 +1,527 @@
+// bench-router.cpp : Router fan-out benchmark.
+//
+// Runs an in-process Worker with one Router, one producing PlainTransport fed
+// with synthetic RTP from this process and N consuming PlainTransports that
+// all send to a local sink socket. Once the warmup is over it reports the
+// forwarding rate, the per stage latencies of worker.getMetrics and the
+// RtpPacketPool misses (heap allocations) per forwarded packet.
+//
+// Several numbers of Consumers can be given, each one is run with a new
+// Router once the previous one is reported. The fan-out of 1k and 10k
+// Consumers per Producer is measured with:
+//
+//   bench-router --codec=vp8 --consumers=1000,10000
+//
+// (each Consumer has its own UDP socket, so the limit of open files may
+// need to be raised).
+//
+// Usage:
+//   bench-router [--codec=opus|vp8|vp9|h264] [--consumers=N[,N...]] [--rate=PPS]
+//                [--warmup=SECONDS] [--duration=SECONDS]
+
+#define MSC_CLASS "bench-router"
+
+#include "common.h"
+#include "Logger.h"
+#include "Worker.h"
+#include "Router.h"
+#include "PlainTransport.h"
+#include "Producer.h"
+#include "Consumer.h"
+#include "bench-options.hpp"
+#include <uv.h>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+using namespace mediasoup;
+
+struct Options
+{
+	std::string codec{ "vp8" };
+	// Number of Consumers of each run.
+	std::vector<uint32_t> consumers{ 100 };
+	// Packets per second sent to the Producer (all its streams).
+	uint32_t rate{ 1000 };
+	uint32_t warmup{ 5 };
+	uint32_t duration{ 10 };
+};
+
+struct Stream
+{
+	uint32_t ssrc;
+	uint16_t seq{ 0 };
+	uint32_t timestamp{ 0 };
+	uint16_t pictureId{ 0 };
+	uint8_t tl0PictureIndex{ 0 };
+};
+
+static Options options;
+static size_t currentRun{ 0 };
+static Router* router{ nullptr };
+static json codec;
+static json encodings;
+static std::vector<Stream> streams;
+static uint8_t payloadType{ 100 };
+static size_t payloadSize{ 1000 };
+static bool isVideo{ true };
+
+static uv_udp_t senderSocket;
+static uv_udp_t sinkSocket;
+static uv_timer_t senderTimer;
+static struct sockaddr_in producerAddr;
+static uint64_t senderStartMs{ 0 };
+static uint64_t framesSent{ 0 };
+static uint64_t packetsSent{ 0 };
+static uint64_t packetsReceived{ 0 };
+static uint8_t sinkBuffer[65536];
+
+static void setupCodec()
+{
+	if (options.codec == "opus")
+	{
+		codec = {
+			{ "kind", "audio" },
+			{ "mimeType", "audio/opus" },
+			{ "clockRate", 48000 },
+			{ "channels", 2 }
+		};
+		encodings = json::array({ { { "ssrc", 11111111 } } });
+		streams = { { 11111111 } };
+		payloadSize = 160;
+		isVideo = false;
+	}
+	else if (options.codec == "vp8")
+	{
+		// Three simulcast streams.
+		codec = {
+			{ "kind", "video" },
+			{ "mimeType", "video/VP8" },
+			{ "clockRate", 90000 }
+		};
+		encodings = json::array({
+			{ { "ssrc", 22222221 } },
+			{ { "ssrc", 22222222 } },
+			{ { "ssrc", 22222223 } }
+		});
+		streams = { { 22222221 }, { 22222222 }, { 22222223 } };
+	}
+	else if (options.codec == "vp9")
+	{
+		// One stream with three spatial layers.
+		codec = {
+			{ "kind", "video" },
+			{ "mimeType", "video/VP9" },
+			{ "clockRate", 90000 },
+			{ "parameters", { { "profile-id", 0 } } }
+		};
+		encodings = json::array({ { { "ssrc", 33333333 }, { "scalabilityMode", "L3T1" } } });
+		streams = { { 33333333 } };
+	}
+	else if (options.codec == "h264")
+	{
+		codec = {
+			{ "kind", "video" },
+			{ "mimeType", "video/H264" },
+			{ "clockRate", 90000 },
+			{ "parameters",
+				{
+					{ "packetization-mode", 1 },
+					{ "profile-level-id", "42e01f" },
+					{ "level-asymmetry-allowed", 1 }
+				}
+			}
+		};
+		encodings = json::array({ { { "ssrc", 44444444 } } });
+		streams = { { 44444444 } };
+	}
+	else
+	{
+		printf("unknown codec: %s\n", options.codec.c_str());
+		std::exit(EXIT_FAILURE);
+	}
+}
+
+// Writes the payload descriptor of the given codec and returns its length.
+static size_t writePayloadDescriptor(uint8_t* data, Stream& stream, bool keyFrame, uint8_t spatialLayer)
+{
+	if (options.codec == "vp8")
+	{
+		// X, S, PID 0 / I, L, T / 15 bits picture id / TL0PICIDX / TID 0.
+		data[0] = 0x90;
+		data[1] = 0xE0;
+		data[2] = 0x80 | ((stream.pictureId >> 8) & 0x7F);
+		data[3] = stream.pictureId & 0xFF;
+		data[4] = stream.tl0PictureIndex;
+		data[5] = 0x00;
+		// VP8 payload header, P bit unset on key frames.
+		data[6] = keyFrame ? 0x00 : 0x01;
+
+		return 7;
+	}
+	else if (options.codec == "vp9")
+	{
+		// I, P, L, B, E / 15 bits picture id / TID 0, SID, D / TL0PICIDX.
+		data[0] = 0x80 | (keyFrame ? 0x00 : 0x40) | 0x20 | 0x08 | 0x04;
+		data[1] = 0x80 | ((stream.pictureId >> 8) & 0x7F);
+		data[2] = stream.pictureId & 0xFF;
+		data[3] = (spatialLayer << 1) | (spatialLayer > 0 ? 0x01 : 0x00);
+		data[4] = stream.tl0PictureIndex;
+
+		return 5;
+	}
+	else if (options.codec == "h264")
+	{
+		// Single NAL unit: SPS on key frames, non-IDR slice otherwise.
+		data[0] = keyFrame ? 0x67 : 0x41;
+
+		return 1;
+	}
+
+	return 0;
+}
+
+static void onSent(uv_udp_send_t* req, int /*status*/)
+{
+	delete[] static_cast<uint8_t*>(req->data);
+	delete req;
+}
+
+static void sendPacket(Stream& stream, bool keyFrame, bool marker, uint8_t spatialLayer)
+{
+	auto* data = new uint8_t[12 + payloadSize];
+
+	data[0] = 0x80;
+	data[1] = (marker ? 0x80 : 0x00) | payloadType;
+	data[2] = stream.seq >> 8;
+	data[3] = stream.seq & 0xFF;
+	data[4] = stream.timestamp >> 24;
+	data[5] = (stream.timestamp >> 16) & 0xFF;
+	data[6] = (stream.timestamp >> 8) & 0xFF;
+	data[7] = stream.timestamp & 0xFF;
+	data[8] = stream.ssrc >> 24;
+	data[9] = (stream.ssrc >> 16) & 0xFF;
+	data[10] = (stream.ssrc >> 8) & 0xFF;
+	data[11] = stream.ssrc & 0xFF;
+
+	size_t offset = 12 + writePayloadDescriptor(data + 12, stream, keyFrame, spatialLayer);
+
+	std::memset(data + offset, 0xAA, 12 + payloadSize - offset);
+
+	auto* req = new uv_udp_send_t;
+	uv_buf_t buffer = uv_buf_init(reinterpret_cast<char*>(data), 12 + payloadSize);
+
+	req->data = data;
+
+	if (uv_udp_send(
+		req, &senderSocket, &buffer, 1, reinterpret_cast<const struct sockaddr*>(&producerAddr), onSent) != 0)
+	{
+		onSent(req, 0);
+
+		return;
+	}
+
+	++stream.seq;
+	++packetsSent;
+}
+
+// Sends the next frame: one packet per stream (simulcast) or per spatial layer
+// (SVC). Every stream gets a key frame once per second.
+static void sendFrame(uint64_t frameIdx, uint32_t framesPerSecond)
+{
+	bool keyFrame = isVideo && frameIdx % framesPerSecond == 0;
+
+	for (auto& stream : streams)
+	{
+		if (options.codec == "vp9")
+		{
+			for (uint8_t spatialLayer = 0; spatialLayer < 3; ++spatialLayer)
+			{
+				sendPacket(stream, keyFrame, spatialLayer == 2, spatialLayer);
+			}
+		}
+		else
+		{
+			sendPacket(stream, keyFrame, true, 0);
+		}
+
+		stream.timestamp += isVideo ? 90000 / framesPerSecond : 48000 / framesPerSecond;
+		++stream.pictureId;
+		++stream.tl0PictureIndex;
+	}
+}
+
+static void onSenderTimer(uv_timer_t* /*handle*/)
+{
+	uint32_t packetsPerFrame = options.codec == "vp9" ? 3 : static_cast<uint32_t>(streams.size());
+	uint32_t framesPerSecond = std::max<uint32_t>(1, options.rate / packetsPerFrame);
+	uint64_t elapsedMs = uv_now(uv_default_loop()) - senderStartMs;
+	uint64_t frames = elapsedMs * framesPerSecond / 1000;
+
+	for (; framesSent < frames; ++framesSent)
+	{
+		sendFrame(framesSent, framesPerSecond);
+	}
+}
+
+static void onSinkAlloc(uv_handle_t* /*handle*/, size_t /*suggestedSize*/, uv_buf_t* buf)
+{
+	buf->base = reinterpret_cast<char*>(sinkBuffer);
+	buf->len = sizeof(sinkBuffer);
+}
+
+static void onSinkRecv(
+	uv_udp_t* /*handle*/, ssize_t nread, const uv_buf_t* /*buf*/, const struct sockaddr* addr, unsigned /*flags*/)
+{
+	if (nread <= 0 || !addr)
+		return;
+
+	// Skip RTCP.
+	if (nread >= 2 && sinkBuffer[1] >= 192 && sinkBuffer[1] <= 223)
+		return;
+
+	++packetsReceived;
+}
+
+static void onTimeout(uv_timer_t* handle)
+{
+	auto* fn = static_cast<std::function<void()>*>(handle->data);
+
+	(*fn)();
+
+	delete fn;
+	uv_close(reinterpret_cast<uv_handle_t*>(handle), [](uv_handle_t* handle) {
+		delete reinterpret_cast<uv_timer_t*>(handle);
+	});
+}
+
+static void runAfter(uint64_t ms, std::function<void()> fn)
+{
+	auto* handle = new uv_timer_t;
+
+	handle->data = new std::function<void()>(std::move(fn));
+
+	uv_timer_init(uv_default_loop(), handle);
+	uv_timer_start(handle, onTimeout, ms, 0);
+}
+
+static uint64_t poolMisses(const json& dump)
+{
+	const json& pool = dump["rtpPacketPool"];
+
+	return pool.value("packetMisses", uint64_t{ 0 }) + pool.value("bufferMisses", uint64_t{ 0 });
+}
+
+struct Snapshot
+{
+	uint64_t timeMs;
+	uint64_t packetsSent;
+	uint64_t packetsReceived;
+	uint64_t poolMisses;
+};
+
+static Snapshot start;
+
+async_simple::coro::Lazy<void> runConsumers(Worker* worker);
+
+static void onDone(async_simple::Try<void>&& result)
+{
+	if (result.hasError())
+	{
+		try
+		{
+			std::rethrow_exception(result.getException());
+		}
+		catch (const std::exception& error)
+		{
+			printf("failed: %s\n", error.what());
+		}
+
+		std::_Exit(EXIT_FAILURE);
+	}
+}
+
+async_simple::coro::Lazy<void> report(Worker* worker)
+{
+	const uint32_t consumers = options.consumers[currentRun];
+
+	json metrics = co_await worker->getMetrics();
+	json dump = co_await worker->dump();
+
+	double seconds = (uv_now(uv_default_loop()) - start.timeMs) / 1000.0;
+	uint64_t sent = packetsSent - start.packetsSent;
+	uint64_t received = packetsReceived - start.packetsReceived;
+	uint64_t misses = poolMisses(dump) - start.poolMisses;
+	const json& stages = metrics["stages"];
+	const json& fanOut = stages["routerFanOut"];
+	uint64_t fanOutMeanNs = fanOut.value("meanNs", uint64_t{ 0 });
+
+	printf("codec: %s, consumers: %u, rate: %u pps, duration: %.1f s\n",
+		options.codec.c_str(), consumers, options.rate, seconds);
+	printf("packets sent: %" PRIu64 " (%.0f pps), forwarded: %" PRIu64 " (%.0f pps)\n",
+		sent, sent / seconds, received, received / seconds);
+	printf("fan-out: mean %" PRIu64 " ns/packet, %.1f ns/packet/consumer, p99 %" PRIu64 " ns\n",
+		fanOutMeanNs,
+		static_cast<double>(fanOutMeanNs) / consumers,
+		fanOut.value("p99", uint64_t{ 0 }));
+	printf("allocations: %.3f per received packet (RtpPacketPool misses)\n",
+		fanOut.value("count", uint64_t{ 0 }) > 0 ? static_cast<double>(misses) / fanOut.value("count", uint64_t{ 0 }) : 0.0);
+	printf("\n%-28s %12s %12s %10s %10s %10s %10s\n", "stage", "count", "rate", "meanNs", "p50", "p99", "p999");
+
+	for (auto& item : stages.items())
+	{
+		const json& stage = item.value();
+
+		printf("%-28s %12" PRIu64 " %12.0f %10" PRIu64 " %10" PRIu64 " %10" PRIu64 " %10" PRIu64 "\n",
+			item.key().c_str(),
+			stage.value("count", uint64_t{ 0 }),
+			stage.value("rate", 0.0),
+			stage.value("meanNs", uint64_t{ 0 }),
+			stage.value("p50", uint64_t{ 0 }),
+			stage.value("p99", uint64_t{ 0 }),
+			stage.value("p999", uint64_t{ 0 }));
+	}
+
+	printf("\n");
+	fflush(stdout);
+
+	// Closing thousands of transports is not part of the measure.
+	if (++currentRun == options.consumers.size())
+		std::_Exit(EXIT_SUCCESS);
+
+	// Next run, with a new Router.
+	uv_timer_stop(&senderTimer);
+	router->close();
+
+	runConsumers(worker).start(onDone);
+}
+
+async_simple::coro::Lazy<void> startMeasure(Worker* worker)
+{
+	// Discard the warmup histograms.
+	co_await worker->getMetrics(true);
+
+	json dump = co_await worker->dump();
+
+	start.timeMs = uv_now(uv_default_loop());
+	start.packetsSent = packetsSent;
+	start.packetsReceived = packetsReceived;
+	start.poolMisses = poolMisses(dump);
+
+	runAfter(options.duration * 1000, [=]() { report(worker).start(onDone); });
+}
+
+async_simple::coro::Lazy<void> runConsumers(Worker* worker)
+{
+	const uint32_t consumers = options.consumers[currentRun];
+
+	json mediaCodecs = json::array({ codec });
+
+	router = co_await worker->createRouter(mediaCodecs);
+
+	// Producer side, learns the remote address from the first packet.
+	PlainTransport* producerTransport = co_await router->createPlainTransport("127.0.0.1", 0, true, true);
+
+	json rtpParameters = {
+		{ "codecs", json::array({ {
+			{ "mimeType", codec["mimeType"] },
+			{ "payloadType", payloadType },
+			{ "clockRate", codec["clockRate"] },
+			{ "parameters", codec.value("parameters", json::object()) }
+		} }) },
+		{ "encodings", encodings },
+		{ "rtcp", { { "cname", "bench-router" } } }
+	};
+
+	if (codec.count("channels"))
+		rtpParameters["codecs"][0]["channels"] = codec["channels"];
+
+	Producer* producer = co_await producerTransport->produce(std::string(), codec["kind"].get<std::string>(), rtpParameters);
+
+	// Consumer side, every consumer sends to the sink.
+	struct sockaddr_in sinkAddr;
+	int sinkAddrLen = sizeof(sinkAddr);
+
+	uv_udp_getsockname(&sinkSocket, reinterpret_cast<struct sockaddr*>(&sinkAddr), &sinkAddrLen);
+
+	json rtpCapabilities = router->rtpCapabilities();
+
+	for (uint32_t i = 0; i < consumers; ++i)
+	{
+		PlainTransport* consumerTransport = co_await router->createPlainTransport("127.0.0.1", 0);
+
+		co_await consumerTransport->connect("127.0.0.1", ntohs(sinkAddr.sin_port), 0, SrtpParameters());
+
+		ConsumerOptions consumerOptions;
+
+		consumerOptions.producerId = producer->id();
+		consumerOptions.rtpCapabilities = rtpCapabilities;
+
+		co_await consumerTransport->consume(consumerOptions);
+	}
+
+	printf("%u consumers created, sending...\n", consumers);
+	fflush(stdout);
+
+	// Start sending, every stream starting with a key frame.
+	uv_ip4_addr("127.0.0.1", producerTransport->tuple().localPort, &producerAddr);
+
+	senderStartMs = uv_now(uv_default_loop());
+	framesSent = 0;
+
+	uv_timer_start(&senderTimer, onSenderTimer, 1, 1);
+
+	runAfter(options.warmup * 1000, [=]() { startMeasure(worker).start(onDone); });
+}
+
+async_simple::coro::Lazy<void> run()
+{
+	json settings = {
+		{ "logLevel", "warn" },
+		{ "logTags", json::array() },
+		{ "rtcMinPort", 10000 },
+		{ "rtcMaxPort", 59999 }
+	};
+
+	Worker* worker = Worker::Create(settings, true);
+
+	worker->on("died", []() {
+		printf("worker died\n");
+		std::_Exit(EXIT_FAILURE);
+	});
+
+	struct sockaddr_in sinkAddr;
+
+	uv_udp_init(uv_default_loop(), &sinkSocket);
+	uv_ip4_addr("127.0.0.1", 0, &sinkAddr);
+	uv_udp_bind(&sinkSocket, reinterpret_cast<const struct sockaddr*>(&sinkAddr), 0);
+	uv_udp_recv_start(&sinkSocket, onSinkAlloc, onSinkRecv);
+
+	uv_udp_init(uv_default_loop(), &senderSocket);
+	uv_timer_init(uv_default_loop(), &senderTimer);
+
+	co_await runConsumers(worker);
+}
+
+int main(int argc, char* argv[])
+{
+	Logger::SetLogLevel(Logger::LogLevel::LOG_WARN);
+	Logger::SetDefaultHandler();
+
+	parseOptions(
+	  argc,
+	  argv,
+	  {
+	    { "codec", &options.codec },
+	    { "consumers", &options.consumers },
+	    { "rate", &options.rate },
+	    { "warmup", &options.warmup },
+	    { "duration", &options.duration }
+	  });
+	setupCodec();
+
+	run().start(onDone);
+
+	return uv_run(uv_default_loop(), UV_RUN_DEFAULT);
+}
@@ -0,0 +1,301 @@
+// bench-rtp-extensions.cpp : RTP header extension access benchmark.
+//
+// Builds the packets the Router forwards (One-Byte header extension with the
+// extensions set by Producer::MangleRtpPacket()) and measures, per packet:
+//
+// - parse: RtpPacket::Parse(), which indexes the extensions once.
+// - lookup: the GetExtension() calls done while forwarding a packet, using
+//   the extensions table and walking the header extension on every call.
+// - rewrite: updating MID, abs-send-time and transport-wide-cc, in place and
+//   by rebuilding the header extension with SetExtensions().
+//
+// Usage:
+//   bench-rtp-extensions [--packets=N] [--rounds=N]
+
+#define MS_CLASS "bench-rtp-extensions"
+
+#include "RTC/RtpDictionaries.hpp"
+#include "RTC/RtpPacket.hpp"
+#include "bench-options.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+using Type = RTC::RtpHeaderExtensionUri::Type;
+
+struct Options
+{
+	uint32_t packets{ 1000 };
+	uint32_t rounds{ 2000 };
+};
+
+static Options options;
+
+// Writes a video packet as forwarded by the Router: MID (with MidMaxLength
+// room), abs-send-time, transport-wide-cc, frame-marking and
+// video-orientation in One-Byte form, followed by a 1000 bytes payload.
+static size_t writePacket(uint8_t* buffer, uint16_t seq)
+{
+	// clang-format off
+	const uint8_t header[] =
+	{
+		0x90, 0x65, 0x00, 0x00, // V=2, X=1, PT=101, seq.
+		0x00, 0x00, 0x03, 0xE8, // Timestamp.
+		0x12, 0x34, 0x56, 0x78, // SSRC.
+		0xBE, 0xDE, 0x00, 0x06  // One-Byte header extension, 24 bytes.
+	};
+	// clang-format on
+
+	uint8_t* ptr = buffer;
+
+	std::memcpy(ptr, header, sizeof(header));
+	ptr[2] = static_cast<uint8_t>(seq >> 8);
+	ptr[3] = static_cast<uint8_t>(seq);
+	ptr += sizeof(header);
+
+	auto writeExtension = [&ptr](Type type, const char* value, uint8_t len)
+	{
+		*ptr++ = (static_cast<uint8_t>(type) << 4) | ((len - 1) & 0x0F);
+		std::memcpy(ptr, value, len);
+		ptr += len;
+	};
+
+	writeExtension(Type::MID, "0\0\0\0\0\0\0\0", RTC::MidMaxLength);
+	writeExtension(Type::ABS_SEND_TIME, "\0\0\0", 3);
+	writeExtension(Type::TRANSPORT_WIDE_CC_01, "\0\0", 2);
+	writeExtension(Type::FRAME_MARKING, "\x80", 1);
+	writeExtension(Type::VIDEO_ORIENTATION, "\x01", 1);
+
+	// Padding up to the announced header extension length.
+	while ((ptr - buffer - 16) % 4 != 0)
+	{
+		*ptr++ = 0u;
+	}
+
+	std::memset(ptr, 0xAB, 1000);
+	ptr += 1000;
+
+	return static_cast<size_t>(ptr - buffer);
+}
+
+// What GetExtension() did before packets had an extensions table: walk the
+// One-Byte header extension until the requested id is found.
+static uint8_t* scanExtension(RTC::RtpPacket* packet, uint8_t id, uint8_t& len)
+{
+	len = 0u;
+
+	if (id == 0u || !packet->HasOneByteExtensions())
+		return nullptr;
+
+	uint8_t* ptr = packet->GetHeaderExtensionValue();
+	uint8_t* end = ptr + packet->GetHeaderExtensionLength();
+
+	while (ptr < end)
+	{
+		const uint8_t elementId = (*ptr & 0xF0) >> 4;
+		const uint8_t elementLen = (*ptr & 0x0F) + 1;
+
+		if (elementId == 15u)
+			break;
+
+		if (elementId == 0u)
+		{
+			++ptr;
+
+			continue;
+		}
+
+		if (elementId == id)
+		{
+			len = elementLen;
+
+			return ptr + 1;
+		}
+
+		ptr += 1 + elementLen;
+	}
+
+	return nullptr;
+}
+
+// The lookups done while forwarding a video packet (Producer, Router,
+// Consumer and sending Transport).
+static const uint8_t LookupIds[] = {
+	static_cast<uint8_t>(Type::MID),
+	static_cast<uint8_t>(Type::FRAME_MARKING_07),
+	static_cast<uint8_t>(Type::FRAME_MARKING),
+	static_cast<uint8_t>(Type::VIDEO_ORIENTATION),
+	static_cast<uint8_t>(Type::TOFFSET),
+	static_cast<uint8_t>(Type::ABS_SEND_TIME),
+	static_cast<uint8_t>(Type::TRANSPORT_WIDE_CC_01)
+};
+
+template<typename Fn>
+static double measure(Fn fn)
+{
+	const auto start = std::chrono::steady_clock::now();
+
+	for (uint32_t round = 0; round < options.rounds; ++round)
+	{
+		fn(round);
+	}
+
+	const auto elapsed = std::chrono::steady_clock::now() - start;
+
+	// ns per packet.
+	return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()) /
+	       (static_cast<double>(options.rounds) * options.packets);
+}
+
+int main(int argc, char* argv[])
+{
+	parseOptions(argc, argv, { { "packets", &options.packets }, { "rounds", &options.rounds } });
+
+	printf("packets:%u rounds:%u\n", options.packets, options.rounds);
+
+	std::vector<std::vector<uint8_t>> buffers(options.packets, std::vector<uint8_t>(RTC::MtuSize + 100));
+	std::vector<size_t> lengths(options.packets);
+	std::vector<RTC::RtpPacket*> packets(options.packets);
+
+	for (uint32_t i = 0; i < options.packets; ++i)
+	{
+		lengths[i] = writePacket(buffers[i].data(), static_cast<uint16_t>(i));
+		packets[i] = RTC::RtpPacket::Parse(buffers[i].data(), lengths[i]);
+
+		if (!packets[i])
+		{
+			printf("failed to parse packet\n");
+
+			return EXIT_FAILURE;
+		}
+
+		packets[i]->SetMidExtensionId(static_cast<uint8_t>(Type::MID));
+		packets[i]->SetAbsSendTimeExtensionId(static_cast<uint8_t>(Type::ABS_SEND_TIME));
+		packets[i]->SetTransportWideCc01ExtensionId(static_cast<uint8_t>(Type::TRANSPORT_WIDE_CC_01));
+	}
+
+	const double parseNs = measure(
+	  [&](uint32_t /*round*/)
+	  {
+		  for (uint32_t i = 0; i < options.packets; ++i)
+		  {
+			  auto* packet = RTC::RtpPacket::Parse(buffers[i].data(), lengths[i]);
+
+			  sink = sink + packet->GetSize();
+
+			  delete packet;
+		  }
+	  });
+
+	const double tableNs = measure(
+	  [&](uint32_t /*round*/)
+	  {
+		  uint64_t sum{ 0u };
+
+		  for (auto* packet : packets)
+		  {
+			  for (auto id : LookupIds)
+			  {
+				  uint8_t len;
+
+				  if (packet->GetExtension(id, len))
+					  sum += len;
+			  }
+		  }
+
+		  sink = sink + sum;
+	  });
+
+	const double scanNs = measure(
+	  [&](uint32_t /*round*/)
+	  {
+		  uint64_t sum{ 0u };
+
+		  for (auto* packet : packets)
+		  {
+			  for (auto id : LookupIds)
+			  {
+				  uint8_t len;
+
+				  if (scanExtension(packet, id, len))
+					  sum += len;
+			  }
+		  }
+
+		  sink = sink + sum;
+	  });
+
+	const std::string mids[] = { "0", "1", "video-2" };
+
+	const double inPlaceNs = measure(
+	  [&](uint32_t round)
+	  {
+		  for (auto* packet : packets)
+		  {
+			  packet->UpdateMid(mids[round % 3]);
+			  packet->UpdateAbsSendTime(round);
+			  packet->UpdateTransportWideCc01(static_cast<uint16_t>(round));
+		  }
+	  });
+
+	const double rebuildNs = measure(
+	  [&](uint32_t round)
+	  {
+		  uint8_t values[RTC::MidMaxLength + 3 + 2 + 1 + 1];
+		  std::vector<RTC::RtpPacket::GenericExtension> extensions;
+
+		  extensions.reserve(5);
+
+		  for (auto* packet : packets)
+		  {
+			  uint8_t* ptr = values;
+			  uint8_t* extenValue;
+			  uint8_t extenLen;
+
+			  extensions.clear();
+
+			  std::memset(ptr, 0, RTC::MidMaxLength);
+			  std::memcpy(ptr, mids[round % 3].c_str(), mids[round % 3].length());
+			  extensions.emplace_back(static_cast<uint8_t>(Type::MID), RTC::MidMaxLength, ptr);
+			  ptr += RTC::MidMaxLength;
+
+			  Utils::Byte::Set3Bytes(ptr, 0, round);
+			  extensions.emplace_back(static_cast<uint8_t>(Type::ABS_SEND_TIME), 3, ptr);
+			  ptr += 3;
+
+			  Utils::Byte::Set2Bytes(ptr, 0, static_cast<uint16_t>(round));
+			  extensions.emplace_back(static_cast<uint8_t>(Type::TRANSPORT_WIDE_CC_01), 2, ptr);
+			  ptr += 2;
+
+			  extenValue = packet->GetExtension(static_cast<uint8_t>(Type::FRAME_MARKING), extenLen);
+			  std::memcpy(ptr, extenValue, extenLen);
+			  extensions.emplace_back(static_cast<uint8_t>(Type::FRAME_MARKING), extenLen, ptr);
+			  ptr += extenLen;
+
+			  extenValue = packet->GetExtension(static_cast<uint8_t>(Type::VIDEO_ORIENTATION), extenLen);
+			  std::memcpy(ptr, extenValue, extenLen);
+			  extensions.emplace_back(static_cast<uint8_t>(Type::VIDEO_ORIENTATION), extenLen, ptr);
+
+			  packet->SetExtensions(1, extensions);
+			  packet->SetMidExtensionId(static_cast<uint8_t>(Type::MID));
+			  packet->SetAbsSendTimeExtensionId(static_cast<uint8_t>(Type::ABS_SEND_TIME));
+			  packet->SetTransportWideCc01ExtensionId(static_cast<uint8_t>(Type::TRANSPORT_WIDE_CC_01));
+		  }
+	  });
+
+	printf("parse              %7.1f ns/packet\n", parseNs);
+	printf("lookup (table)     %7.1f ns/packet\n", tableNs);
+	printf("lookup (scan)      %7.1f ns/packet\n", scanNs);
+	printf("rewrite (in place) %7.1f ns/packet\n", inPlaceNs);
+	printf("rewrite (rebuild)  %7.1f ns/packet\n", rebuildNs);
+
+	for (auto* packet : packets)
+	{
+		delete packet;
+	}
+
+	return 0;
+}
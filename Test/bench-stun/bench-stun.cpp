@@ -0,0 +1,246 @@
+// bench-stun.cpp : STUN Binding (ICE consent) benchmark.
+//
+// Handles Binding requests like the ones browsers send every few seconds per
+// ICE candidate pair (USERNAME, PRIORITY, ICE-CONTROLLING, USE-CANDIDATE,
+// MESSAGE-INTEGRITY and FINGERPRINT) as IceServer does, and reports the
+// requests handled per second on a single core:
+//
+// - legacy: as IceServer did before, checking MESSAGE-INTEGRITY with
+//   Utils::Crypto::GetHmacSha1() (which keys the HMAC context with the
+//   password on every call) and building the success response with
+//   CreateSuccessResponse(), SetXorMappedAddress(), Authenticate() and
+//   Serialize().
+// - fast: as IceServer does now, with an HMAC-SHA1 context keyed once with
+//   the password and the success response patched into a pre-serialized
+//   template by SerializeSuccessResponse().
+//
+// Both must produce the same responses, which is checked first.
+//
+// Usage:
+//   bench-stun [--requests=N]
+
+#define MS_CLASS "bench-stun"
+
+#include "Utils.hpp"
+#include "RTC/StunPacket.hpp"
+#include "bench-options.hpp"
+#include <uv.h>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+struct Options
+{
+	uint32_t requests{ 2000000 };
+};
+
+static Options options;
+
+static const std::string LocalUsernameFragment{ "yt9bq53k1h4r3a6e" };
+static const std::string LocalPassword{ "p5eb7dpsoqhzpgyx4f4kfjrxbt8bqqu9" };
+static const std::string RemoteUsernameFragment{ "Zx3a" };
+
+// Different transaction IDs, as every request has its own.
+static constexpr size_t NumRequests{ 256 };
+static constexpr size_t MaxStunSize{ 256 };
+
+struct Request
+{
+	uint8_t data[MaxStunSize];
+	size_t size;
+};
+
+static std::vector<Request> createRequests()
+{
+	std::vector<Request> requests(NumRequests);
+	const std::string username = LocalUsernameFragment + ":" + RemoteUsernameFragment;
+
+	for (auto& request : requests)
+	{
+		uint8_t transactionId[12];
+
+		for (auto& byte : transactionId)
+		{
+			byte = static_cast<uint8_t>(Utils::Crypto::GetRandomUInt(0, 255));
+		}
+
+		RTC::StunPacket packet(
+		  RTC::StunPacket::Class::REQUEST, RTC::StunPacket::Method::BINDING, transactionId, nullptr, 0);
+
+		packet.SetUsername(username.c_str(), username.length());
+		packet.SetPriority(1853817087);
+		packet.SetIceControlling(Utils::Crypto::GetRandomUInt(0, UINT32_MAX));
+		packet.SetUseCandidate();
+		packet.Authenticate(LocalPassword);
+		packet.Serialize(request.data);
+
+		request.size = packet.GetSize();
+	}
+
+	return requests;
+}
+
+// Returns the response size.
+static size_t handleLegacy(const Request& request, const struct sockaddr* remoteAddress, uint8_t* response)
+{
+	RTC::StunPacket* packet = RTC::StunPacket::Parse(request.data, request.size);
+
+	if (
+	  !packet ||
+	  packet->CheckAuthentication(LocalUsernameFragment, LocalPassword) !=
+	    RTC::StunPacket::Authentication::OK)
+	{
+		printf("invalid request\n");
+		std::exit(EXIT_FAILURE);
+	}
+
+	RTC::StunPacket* successResponse = packet->CreateSuccessResponse();
+
+	successResponse->SetXorMappedAddress(remoteAddress);
+	successResponse->Authenticate(LocalPassword);
+	successResponse->Serialize(response);
+
+	const size_t size = successResponse->GetSize();
+
+	delete successResponse;
+	delete packet;
+
+	return size;
+}
+
+// Returns the response size.
+static size_t handleFast(
+  const Request& request,
+  const struct sockaddr* remoteAddress,
+  Utils::Crypto::HmacSha1& hmacSha1,
+  uint8_t* response)
+{
+	RTC::StunPacket* packet = RTC::StunPacket::Parse(request.data, request.size);
+
+	if (
+	  !packet ||
+	  packet->CheckAuthentication(LocalUsernameFragment, hmacSha1) != RTC::StunPacket::Authentication::OK)
+	{
+		printf("invalid request\n");
+		std::exit(EXIT_FAILURE);
+	}
+
+	const size_t size = packet->SerializeSuccessResponse(response, remoteAddress, hmacSha1);
+
+	delete packet;
+
+	return size;
+}
+
+static void check(
+  const std::vector<Request>& requests,
+  const struct sockaddr* remoteAddress,
+  Utils::Crypto::HmacSha1& hmacSha1)
+{
+	uint8_t legacyResponse[MaxStunSize];
+	uint8_t fastResponse[MaxStunSize];
+
+	for (auto& request : requests)
+	{
+		const size_t legacySize = handleLegacy(request, remoteAddress, legacyResponse);
+		const size_t fastSize   = handleFast(request, remoteAddress, hmacSha1, fastResponse);
+
+		if (legacySize != fastSize || std::memcmp(legacyResponse, fastResponse, legacySize) != 0)
+		{
+			printf("responses differ\n");
+			std::exit(EXIT_FAILURE);
+		}
+
+		// The fast response must be a valid one.
+		RTC::StunPacket* response = RTC::StunPacket::Parse(fastResponse, fastSize);
+
+		if (!response || response->GetClass() != RTC::StunPacket::Class::SUCCESS_RESPONSE)
+		{
+			printf("invalid response\n");
+			std::exit(EXIT_FAILURE);
+		}
+
+		delete response;
+	}
+}
+
+template<typename Handle>
+static double run(const std::vector<Request>& requests, Handle handle)
+{
+	uint8_t response[MaxStunSize];
+	size_t bytes{ 0 };
+	const auto start = std::chrono::steady_clock::now();
+
+	for (uint32_t i = 0; i < options.requests; ++i)
+	{
+		bytes += handle(requests[i % NumRequests], response);
+	}
+
+	const auto elapsedNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+	                         std::chrono::steady_clock::now() - start)
+	                         .count();
+
+	// Keep the compiler from dropping the responses.
+	if (bytes == 0)
+		printf("no responses\n");
+
+	return static_cast<double>(options.requests) * 1000000000 / elapsedNs;
+}
+
+int main(int argc, char* argv[])
+{
+	parseOptions(argc, argv, { { "requests", &options.requests } });
+
+	Utils::Crypto::ClassInit();
+
+	auto requests = createRequests();
+
+	struct sockaddr_in remoteAddressIPv4;
+	struct sockaddr_in6 remoteAddressIPv6;
+
+	std::memset(&remoteAddressIPv4, 0, sizeof(remoteAddressIPv4));
+	uv_ip4_addr("203.0.113.17", 54321, &remoteAddressIPv4);
+	std::memset(&remoteAddressIPv6, 0, sizeof(remoteAddressIPv6));
+	uv_ip6_addr("2001:db8::5:1234", 54321, &remoteAddressIPv6);
+
+	{
+		Utils::Crypto::HmacSha1 hmacSha1;
+
+		hmacSha1.SetKey(LocalPassword);
+
+		printf("requests:%u\n", options.requests);
+
+		const std::pair<const char*, const struct sockaddr*> families[] = {
+			{ "IPv4", reinterpret_cast<const struct sockaddr*>(&remoteAddressIPv4) },
+			{ "IPv6", reinterpret_cast<const struct sockaddr*>(&remoteAddressIPv6) }
+		};
+
+		for (auto& family : families)
+		{
+			auto* remoteAddress = family.second;
+
+			check(requests, remoteAddress, hmacSha1);
+
+			const double legacy = run(requests, [remoteAddress](const Request& request, uint8_t* response) {
+				return handleLegacy(request, remoteAddress, response);
+			});
+			const double fast   = run(requests, [&](const Request& request, uint8_t* response) {
+				return handleFast(request, remoteAddress, hmacSha1, response);
+			});
+
+			printf(
+			  "%s  legacy:%10.0f requests/s  fast:%10.0f requests/s  (x%.2f)\n",
+			  family.first,
+			  legacy,
+			  fast,
+			  fast / legacy);
+		}
+	}
+
+	Utils::Crypto::ClassDestroy();
+
+	return 0;
+}
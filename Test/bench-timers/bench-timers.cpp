@@ -0,0 +1,304 @@
+// bench-timers.cpp : Worker Timer benchmark.
+//
+// Keeps N Timers active on the Worker loop, with the mix of timeouts the
+// Worker uses (short repeating ones like NackGenerator, RTCP-like ones and
+// inactivity checks restarted on every received packet), first with the
+// Worker Timer class (TimerWheel) and then with a uv_timer_t per timer, and
+// reports the CPU time the loop spends per second in each case.
+//
+// Usage:
+//   bench-timers [--timers=N] [--restarts=PER_SECOND] [--duration=SECONDS]
+
+#define MS_CLASS "bench-timers"
+
+#include "DepLibUV.hpp"
+#include "handles/Timer.hpp"
+#include "bench-options.hpp"
+#include <uv.h>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+struct Options
+{
+	uint32_t timers{ 50000 };
+	// Inactivity-like timers restarted per second (one per received packet).
+	uint32_t restarts{ 100000 };
+	uint32_t duration{ 10 };
+};
+
+struct Result
+{
+	uint64_t cpuUs{ 0 };
+	uint64_t fired{ 0 };
+	uint64_t restarted{ 0 };
+	uint64_t loopIterations{ 0 };
+};
+
+static Options options;
+static std::mt19937 rng(1);
+static uint64_t fired{ 0 };
+static uint64_t restarted{ 0 };
+static uint64_t loopIterations{ 0 };
+
+// Timeout and repeat of the i-th timer: 20% repeat every 40 ms, 30% every
+// 1000 ms and the rest are 1500 ms one shot inactivity checks.
+static void getTimeout(uint32_t i, uint64_t& timeout, uint64_t& repeat)
+{
+	switch (i % 10)
+	{
+		case 0:
+		case 1:
+			timeout = 40;
+			repeat  = 40;
+			break;
+
+		case 2:
+		case 3:
+		case 4:
+			timeout = 1000;
+			repeat  = 1000;
+			break;
+
+		default:
+			timeout = 1500;
+			repeat  = 0;
+	}
+
+	// Spread the first expirations.
+	timeout = 1 + rng() % timeout;
+}
+
+static uint64_t getCpuUs()
+{
+	uv_rusage_t rusage;
+
+	uv_getrusage(&rusage);
+
+	return static_cast<uint64_t>(rusage.ru_utime.tv_sec + rusage.ru_stime.tv_sec) * 1000000u +
+	       rusage.ru_utime.tv_usec + rusage.ru_stime.tv_usec;
+}
+
+// Drives the run: restarts inactivity-like timers at the configured rate and
+// stops the loop once the duration is over.
+class Driver
+{
+public:
+	using RestartFn = void (*)(uint32_t index);
+
+public:
+	explicit Driver(RestartFn restart) : restart(restart)
+	{
+		uv_prepare_init(DepLibUV::GetLoop(), &this->prepare);
+		uv_prepare_start(&this->prepare, [](uv_prepare_t* /*handle*/) { ++loopIterations; });
+
+		uv_timer_init(DepLibUV::GetLoop(), &this->ticker);
+		this->ticker.data = this;
+		uv_timer_start(
+		  &this->ticker, [](uv_timer_t* handle) { static_cast<Driver*>(handle->data)->OnTick(); }, 1, 1);
+
+		this->startMs = uv_now(DepLibUV::GetLoop());
+	}
+
+public:
+	void Close()
+	{
+		uv_close(reinterpret_cast<uv_handle_t*>(&this->prepare), nullptr);
+		uv_close(reinterpret_cast<uv_handle_t*>(&this->ticker), nullptr);
+	}
+
+private:
+	void OnTick()
+	{
+		const uint64_t nowMs = uv_now(DepLibUV::GetLoop());
+
+		if (nowMs - this->startMs >= options.duration * 1000u)
+		{
+			uv_stop(DepLibUV::GetLoop());
+
+			return;
+		}
+
+		// Restarts due until now.
+		const uint64_t due = (nowMs - this->startMs) * options.restarts / 1000u;
+
+		for (; this->restarts < due; ++this->restarts)
+		{
+			// Only inactivity-like timers (index % 10 >= 5) are restarted.
+			uint32_t index = static_cast<uint32_t>(rng() % options.timers);
+
+			if (index % 10 < 5)
+				index += 5 - (index % 10);
+
+			if (index < options.timers)
+			{
+				this->restart(index);
+				++restarted;
+			}
+		}
+	}
+
+private:
+	RestartFn restart;
+	uv_prepare_t prepare;
+	uv_timer_t ticker;
+	uint64_t startMs{ 0 };
+	uint64_t restarts{ 0 };
+};
+
+/* Worker Timer (TimerWheel). */
+
+class WheelListener : public Timer::Listener
+{
+public:
+	void OnTimer(Timer* /*timer*/) override
+	{
+		++fired;
+	}
+};
+
+static WheelListener wheelListener;
+static std::vector<Timer*> wheelTimers;
+
+static Result runWheel()
+{
+	for (uint32_t i = 0; i < options.timers; ++i)
+	{
+		uint64_t timeout;
+		uint64_t repeat;
+
+		getTimeout(i, timeout, repeat);
+
+		auto* timer = new Timer(&wheelListener);
+
+		timer->Start(timeout, repeat);
+		wheelTimers.push_back(timer);
+	}
+
+	Driver driver(
+	  [](uint32_t index)
+	  {
+		  auto* timer = wheelTimers[index];
+
+		  timer->Start(1500);
+	  });
+
+	fired          = 0;
+	restarted      = 0;
+	loopIterations = 0;
+
+	const uint64_t cpuUs = getCpuUs();
+
+	uv_run(DepLibUV::GetLoop(), UV_RUN_DEFAULT);
+
+	Result result{ getCpuUs() - cpuUs, fired, restarted, loopIterations };
+
+	driver.Close();
+
+	for (auto* timer : wheelTimers)
+	{
+		delete timer;
+	}
+	wheelTimers.clear();
+
+	// Let the handles close.
+	uv_run(DepLibUV::GetLoop(), UV_RUN_DEFAULT);
+
+	return result;
+}
+
+/* One uv_timer_t per timer. */
+
+static std::vector<uv_timer_t*> uvTimers;
+
+static void onUvTimer(uv_timer_t* /*handle*/)
+{
+	++fired;
+}
+
+static Result runUv()
+{
+	for (uint32_t i = 0; i < options.timers; ++i)
+	{
+		uint64_t timeout;
+		uint64_t repeat;
+
+		getTimeout(i, timeout, repeat);
+
+		auto* handle = new uv_timer_t;
+
+		uv_timer_init(DepLibUV::GetLoop(), handle);
+		uv_timer_start(handle, onUvTimer, timeout, repeat);
+		uvTimers.push_back(handle);
+	}
+
+	Driver driver([](uint32_t index) { uv_timer_start(uvTimers[index], onUvTimer, 1500, 0); });
+
+	fired          = 0;
+	restarted      = 0;
+	loopIterations = 0;
+
+	const uint64_t cpuUs = getCpuUs();
+
+	uv_run(DepLibUV::GetLoop(), UV_RUN_DEFAULT);
+
+	Result result{ getCpuUs() - cpuUs, fired, restarted, loopIterations };
+
+	driver.Close();
+
+	for (auto* handle : uvTimers)
+	{
+		uv_close(
+		  reinterpret_cast<uv_handle_t*>(handle),
+		  [](uv_handle_t* handle) { delete reinterpret_cast<uv_timer_t*>(handle); });
+	}
+	uvTimers.clear();
+
+	// Let the handles close.
+	uv_run(DepLibUV::GetLoop(), UV_RUN_DEFAULT);
+
+	return result;
+}
+
+static void printResult(const char* name, const Result& result)
+{
+	printf(
+	  "%-12s cpu:%6.1f ms/s  fired:%9.0f /s  restarted:%9.0f /s  loop iterations:%7.0f /s  cpu per op:%5.0f ns\n",
+	  name,
+	  static_cast<double>(result.cpuUs) / 1000 / options.duration,
+	  static_cast<double>(result.fired) / options.duration,
+	  static_cast<double>(result.restarted) / options.duration,
+	  static_cast<double>(result.loopIterations) / options.duration,
+	  result.fired + result.restarted > 0
+	    ? static_cast<double>(result.cpuUs) * 1000 / static_cast<double>(result.fired + result.restarted)
+	    : 0.0);
+}
+
+int main(int argc, char* argv[])
+{
+	parseOptions(
+	  argc,
+	  argv,
+	  {
+	    { "timers", &options.timers },
+	    { "restarts", &options.restarts },
+	    { "duration", &options.duration }
+	  });
+
+	DepLibUV::ClassInit();
+
+	printf(
+	  "timers:%u restarts:%u/s duration:%us\n", options.timers, options.restarts, options.duration);
+
+	const Result wheelResult = runWheel();
+	const Result uvResult    = runUv();
+
+	printResult("TimerWheel", wheelResult);
+	printResult("uv_timer_t", uvResult);
+
+	DepLibUV::ClassDestroy();
+
+	return 0;
+}